@@ -4625,6 +4625,18 @@ namespace CNTK
                                      bool sequential = false,
                                      const std::wstring& name = L"");
 
+    ///
+    /// Convolution of the binarized operand with the binarized convolution map: every value v is replaced by +1 if v > 0 and by -1
+    /// otherwise. Evaluated with XNOR and popcount on bit-packed values, on the CPU only. Gradients are those of the real-valued
+    /// convolution (straight-through estimator).
+    ///
+    CNTK_API FunctionPtr BinaryConvolution(const Variable& convolutionMap,
+                                           const Variable& operand,
+                                           const NDShape& strides = { 1 },
+                                           const std::vector<bool>& sharing = { true },
+                                           const std::vector<bool>& autoPadding = { true },
+                                           const std::wstring& name = L"");
+
     ///
     /// Convolution transpose with auto padding
     ///
@@ -4725,6 +4737,31 @@ namespace CNTK
                                             bool disableRegularization = false,
                                             const std::wstring& name = L"");
 
+    ///
+    /// Create an instance of the layer normalization operation: every sample of 'operand' is normalized to zero mean and
+    /// unit variance over all of its elements and then scaled and shifted elementwise by 'scale' and 'bias'. 'scale' and
+    /// 'bias' have the shape of the operand or a single element; inferred dimensions are taken from the operand.
+    ///
+    CNTK_API FunctionPtr LayerNormalization(const Variable& operand,
+                                            const Variable& scale,
+                                            const Variable& bias,
+                                            double epsilon = 0.00001,
+                                            const std::wstring& name = L"");
+
+    ///
+    /// Create an instance of the scaled dot-product attention operation, softmax(scale * key^T * query) applied to 'value',
+    /// computed within each sample without materializing the attention matrix.
+    /// 'query', 'key', and 'value' are of shape [dimQK x numQueries], [dimQK x numKeys], and [dimV x numKeys], optionally
+    /// with a trailing numHeads axis; the result is of shape [dimV x numQueries (x numHeads)].
+    /// A 'scale' of 0 means 1/sqrt(dimQK). If 'causal', query i only attends to keys up to i + numKeys - numQueries.
+    ///
+    CNTK_API FunctionPtr ScaledDotProductAttention(const Variable& query,
+                                                   const Variable& key,
+                                                   const Variable& value,
+                                                   double scale = 0,
+                                                   bool causal = false,
+                                                   const std::wstring& name = L"");
+
     //
     // Local response normalization as described in http://papers.nips.cc/paper/4824-imagenet-classification-with-deep-convolutional-neural-networks 
     //
@@ -5710,6 +5747,35 @@ namespace CNTK
         ///
         CNTK_API virtual void PrintNodeTiming();
 
+        ///
+        /// Enable dynamic loss scaling, for training models with Float16 parameters. The gradient of the loss is multiplied by LossScale()
+        /// before backpropagation, and the parameter gradients are divided by it before they are passed to the learners.
+        /// Minibatches whose gradients overflow are skipped and halve the loss scale; after 'growthInterval' consecutive
+        /// minibatches without overflow the loss scale is doubled. Overflows at loss scale 1 are reported as warnings,
+        /// and training fails if they persist for 10 consecutive minibatches.
+        ///
+        CNTK_API void EnableDynamicLossScaling(double initialLossScale = 32768.0, size_t growthInterval = 2000);
+
+        ///
+        /// Returns the current loss scale (1 unless dynamic loss scaling is enabled).
+        ///
+        double LossScale() const { return m_lossScale; }
+
+        ///
+        /// Emulate minibatches 'numMicroBatches' times as large as the ones passed to TrainMinibatch(). The parameter gradients of
+        /// that many consecutive calls are summed up in place, and the learners update the parameters (distributed learners also
+        /// aggregate the gradients across workers) once for all of them, normalized by their total sample count.
+        /// Without distributed learners, an empty minibatch or the end of a sweep ends the accumulation early.
+        /// Checkpoints can only be saved between accumulation windows.
+        /// 1 (the default) updates the parameters after every minibatch.
+        ///
+        CNTK_API void SetGradientAccumulation(size_t numMicroBatches);
+
+        ///
+        /// Returns the number of minibatches whose gradients are accumulated for one parameter update.
+        ///
+        size_t GradientAccumulationMicroBatches() const { return m_gradientAccumulationMicroBatches; }
+
     private:
         template <typename T1, typename ...CtorArgTypes>
         friend std::shared_ptr<T1> MakeSharedObject(CtorArgTypes&& ...ctorArgs);
@@ -5735,6 +5801,9 @@ namespace CNTK
 
         void UpdateTrainingProgress(size_t numSamples, const ValuePtr& loss, const ValuePtr& evalCriterion, const DeviceDescriptor& computeDevice);
         void AddProgressWriters(const std::vector<ProgressWriterPtr>& progressWriters);
+        bool UnscaleGradients(const std::unordered_map<Parameter, NDArrayViewPtr>& gradients);
+        bool UpdateLocalLearners(std::unordered_map<Parameter, NDArrayViewPtr>& gradients, size_t numSamples, bool sweepEnd);
+        void ResetGradientAccumulation();
 
         FunctionPtr m_model;
         FunctionPtr m_combinedTrainingFunction;
@@ -5755,6 +5824,20 @@ namespace CNTK
         AccumulatorPtr m_aggregatedTrainingEvalCriterionValue;
 
         size_t m_prevDistributedTotalNumSamples;
+
+        bool   m_dynamicLossScaling;
+        double m_lossScale;
+        size_t m_lossScaleGrowthInterval;
+        size_t m_numStepsSinceLossScaleChange;
+        size_t m_numOverflowsAtUnitLossScale;
+
+        size_t m_gradientAccumulationMicroBatches;
+        size_t m_numAccumulatedMicroBatches; // in the current accumulation window, including empty ones
+        size_t m_accumulatedNumSamples;
+        bool   m_accumulatedSweepEnd;
+        std::unordered_map<Parameter, NDArrayViewPtr> m_accumulatedGradients; // the network's parameter gradients, which hold the sum of the window
+        AccumulatorPtr m_accumulatedTrainingLoss;   // distributed only, to report the loss of the whole window
+        AccumulatorPtr m_accumulatedEvalCriterion;
     };
 
     ///
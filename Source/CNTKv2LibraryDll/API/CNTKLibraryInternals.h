@@ -287,6 +287,22 @@ namespace CNTK
         CNTK_API void SetAutomaticUnpackingOfPackedValues(bool disable);
         CNTK_API bool IsAutomaticUnpackingOfPackedValuesDisabled();
 
+        // Bind dense argument Values of Forward to the network's input nodes by reference instead of copying them. The caller's
+        // storage then stays referenced by the network until the next Forward and must not be modified before the corresponding
+        // Backward. Outputs for which no storage is specified are returned as read-only references into the network's buffers,
+        // which are valid until the next Forward; use DeepClone to keep them longer.
+        CNTK_API void SetZeroCopyInputBinding(bool enable);
+        CNTK_API bool IsZeroCopyInputBindingEnabled();
+
+        // Besides its active network, a composite Function keeps up to this many networks compiled for the other (outputs, backprop
+        // roots, excluded inputs) of recent Forward calls, together with their buffers. 0 releases a network as soon as it is retired.
+        CNTK_API void SetMaxCachedComputationNetworks(size_t maxNetworks);
+        CNTK_API size_t GetMaxCachedComputationNetworks();
+        // Releases the networks, and their buffers, that 'function' keeps cached besides its active network.
+        CNTK_API void ReleaseCachedComputationNetworks(const ::CNTK::FunctionPtr& function);
+        // Number of networks that 'function' keeps cached besides its active network, for testing.
+        CNTK_API size_t GetNumCachedComputationNetworks(const ::CNTK::FunctionPtr& function);
+
         CNTK_API void SetComputationNetworkTraceLevel(int traceLevel);
         int GetComputationNetworkTraceLevel();
 
@@ -315,6 +331,19 @@ namespace CNTK
         CNTK_API void EnableGradientAccumulationOptimization();
         CNTK_API void DisableGradientAccumulationOptimization();
 
+        // Trade compute for memory in training: intermediate values between checkpoint nodes are released after
+        // forward and recomputed segment by segment during backward. Takes effect for networks compiled afterwards.
+        CNTK_API void EnableActivationRecomputation();
+        CNTK_API void DisableActivationRecomputation();
+
+        // Keep compact encodings of activations for backward instead of the full values: 1-bit masks for ReLU and Clip
+        // and, if 'lossy', fp16 copies of other activations whose gradient is computed from the output (e.g. Sigmoid, Tanh).
+        // Takes effect for networks compiled afterwards.
+        CNTK_API void EnableActivationCompression(bool lossy = false);
+        CNTK_API void DisableActivationCompression();
+        // Number of node outputs that forward passes have kept in compressed form so far, for testing.
+        CNTK_API size_t GetNumActivationStashes();
+
         static const uint64_t DefaultProfilerBufferSize = 32 * 1024 * 1024;
         CNTK_API void StartProfiler(const std::wstring& profilerDir = L"profiler", bool profilerSyncGpu = false, size_t profilerBufferSize = DefaultProfilerBufferSize);
         CNTK_API void EnableProfiler();
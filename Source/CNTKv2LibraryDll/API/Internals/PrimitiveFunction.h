@@ -122,6 +122,8 @@ namespace CNTK
         { PrimitiveOpType::Tan, L"Tan" },
         { PrimitiveOpType::Atan, L"Atan" },
         { PrimitiveOpType::ConvolutionSequenceShape, L"ConvolutionSequenceShape" },
+        { PrimitiveOpType::LayerNormalization, L"LayerNormalization" },
+        { PrimitiveOpType::ScaledDotProductAttention, L"ScaledDotProductAttention" },
     };
 
     inline const std::wstring& PrimitiveOpTypeName(PrimitiveOpType opType)
@@ -166,6 +168,8 @@ namespace CNTK
             indexMap = std::unordered_map<size_t, size_t>({ { 0, 2 }, { 1, 0 }, { 2, 1 } });
         else if (op == PrimitiveOpType::OptimizedRNNStack)
             indexMap = std::unordered_map<size_t, size_t>({ { 0, 1 }, { 1, 0 } });
+        else if (op == PrimitiveOpType::LayerNormalization)
+            indexMap = std::unordered_map<size_t, size_t>({ { 0, 1 }, { 1, 2 }, { 2, 0 } });
         else
         {
             for (size_t i = 0; i < numFunctionInputs; ++i)
@@ -732,7 +736,8 @@ namespace CNTK
         // Version 22: Add StraightThrough
         // Version 23: Add Tan and Atan.
         // Version 24: Add ConvolutionSequenceShape.
-        static const size_t s_serializationVersion = 24;
+        // Version 25: Add LayerNormalization and ScaledDotProductAttention.
+        static const size_t s_serializationVersion = 25;
     };
 
     std::vector<DictionaryValue> GetInputUids(const Function& f);
@@ -135,9 +135,12 @@ namespace CNTK
         CNTK_API static const std::wstring AttributeNameUseStatsAcrossChannels;
         CNTK_API static const std::wstring AttributeNameDoVarianceScaling;
         CNTK_API static const std::wstring AttributeNameGroups;
+        CNTK_API static const std::wstring AttributeNameBinary;
         CNTK_API static const std::wstring AttributeNameCustomOp;
         CNTK_API static const std::wstring AttributeNameTransposeLeftOperand;
         CNTK_API static const std::wstring AttributeNameTransposeRightOperand;
+        CNTK_API static const std::wstring AttributeNameScale;
+        CNTK_API static const std::wstring AttributeNameCausal;
 
         CNTK_API static const std::vector<std::wstring> s_rngStateAttributes;
     };
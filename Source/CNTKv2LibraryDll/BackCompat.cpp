@@ -459,6 +459,21 @@ namespace CNTK
 
                     opType = PrimitiveOpType::BatchNormalization;
                 }
+                else if (node->OperationName() == OperationNameOf(LayerNormalizationNode))
+                {
+                    auto layerNormalizationNode = node->As<LayerNormalizationNode<ElementType>>();
+                    primitiveFunctionConfigParameters[PrimitiveFunctionAttribute::AttributeNameEpsilon] = layerNormalizationNode->Epsilon();
+
+                    opType = PrimitiveOpType::LayerNormalization;
+                }
+                else if (node->OperationName() == OperationNameOf(ScaledDotProductAttentionNode))
+                {
+                    auto attentionNode = node->As<ScaledDotProductAttentionNode<ElementType>>();
+                    primitiveFunctionConfigParameters[PrimitiveFunctionAttribute::AttributeNameScale] = attentionNode->ScaleAttribute();
+                    primitiveFunctionConfigParameters[PrimitiveFunctionAttribute::AttributeNameCausal] = attentionNode->IsCausal();
+
+                    opType = PrimitiveOpType::ScaledDotProductAttention;
+                }
                 else if (node->OperationName() == OperationNameOf(ClipNode))
                     opType = PrimitiveOpType::Clip;
                 else if (node->OperationName() == OperationNameOf(IfNode))
@@ -151,6 +151,28 @@ namespace CNTK
             return s_disableAutomaticUnpackingOfPackedValues.load();
         }
 
+        std::atomic<bool> s_zeroCopyInputBinding(false);
+        void SetZeroCopyInputBinding(bool enable)
+        {
+            s_zeroCopyInputBinding.store(enable);
+        }
+
+        bool IsZeroCopyInputBindingEnabled()
+        {
+            return s_zeroCopyInputBinding.load();
+        }
+
+        std::atomic<size_t> s_maxCachedComputationNetworks(4);
+        void SetMaxCachedComputationNetworks(size_t maxNetworks)
+        {
+            s_maxCachedComputationNetworks.store(maxNetworks);
+        }
+
+        size_t GetMaxCachedComputationNetworks()
+        {
+            return s_maxCachedComputationNetworks.load();
+        }
+
         void EnableForwardValuesSharing()
         {
             Microsoft::MSR::CNTK::Globals::SetShareNodeValueMatrices(/* enable = */ true);
@@ -171,6 +193,31 @@ namespace CNTK
             Microsoft::MSR::CNTK::Globals::SetGradientAccumulationOptimization(/* enable = */ false);
         }
 
+        void EnableActivationRecomputation()
+        {
+            Microsoft::MSR::CNTK::Globals::SetActivationRecomputation(/* enable = */ true);
+        }
+
+        void DisableActivationRecomputation()
+        {
+            Microsoft::MSR::CNTK::Globals::SetActivationRecomputation(/* enable = */ false);
+        }
+
+        void EnableActivationCompression(bool lossy)
+        {
+            Microsoft::MSR::CNTK::Globals::SetActivationCompression(/* enable = */ true, lossy);
+        }
+
+        void DisableActivationCompression()
+        {
+            Microsoft::MSR::CNTK::Globals::SetActivationCompression(/* enable = */ false);
+        }
+
+        size_t GetNumActivationStashes()
+        {
+            return Microsoft::MSR::CNTK::Globals::GetNumActivationStashes();
+        }
+
         void StartProfiler(const wstring& profilerDir, bool profilerSyncGpu, size_t profilerBufferSize)
         {
 #ifndef CNTK_UWP
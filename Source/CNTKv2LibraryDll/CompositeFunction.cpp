@@ -1108,11 +1108,14 @@ namespace CNTK
                     if (functionConfig.Contains(PrimitiveFunctionAttribute::AttributeNameGroups))
                         groups = functionConfig[PrimitiveFunctionAttribute::AttributeNameGroups].Value<size_t>();
                     auto maxTempMemSizeInSamples = functionConfig[PrimitiveFunctionAttribute::AttributeNameMaxTempMemSizeInSamples].Value<size_t>();
+                    auto enabledEngines = ConvolutionEngineKind::All;
+                    if (functionConfig.Contains(PrimitiveFunctionAttribute::AttributeNameBinary) && functionConfig[PrimitiveFunctionAttribute::AttributeNameBinary].Value<bool>())
+                        enabledEngines = ConvolutionEngineKind::Binary;
                     ASSIGN_NEW_NODE(ConvolutionNode, network->GetDeviceId(), internalNodeName,
                                     AsTensorShape(kernelShape), AsTensorShape(outputMapCount), AsTensorShape(strides),
                                     sharing, autoPadding, AsTensorShape(lowerPad), AsTensorShape(upperPad), transpose,
                                     outputShape.IsUnknown() ? TensorShape(0) : AsTensorShape(outputShape),
-                                    ImageLayoutKind::CHW, maxTempMemSizeInSamples, AsTensorShape(dilation), groups);
+                                    ImageLayoutKind::CHW, maxTempMemSizeInSamples, AsTensorShape(dilation), groups, enabledEngines);
                     break;
                 }
                 case PrimitiveOpType::ConvolutionSequenceShape:
@@ -1261,6 +1264,19 @@ namespace CNTK
                     ASSIGN_NEW_NODE(BatchNormalizationNode, network->GetDeviceId(), internalNodeName, spatial, normalizationTimeConstant, blendTimeConstant, epsilon, !useCuDNNEngine, disableRegularization, ImageLayoutKind::CHW);
                     break;
                 }
+                case PrimitiveOpType::LayerNormalization:
+                {
+                    auto epsilon = functionConfig[PrimitiveFunctionAttribute::AttributeNameEpsilon].Value<double>();
+                    ASSIGN_NEW_NODE(LayerNormalizationNode, network->GetDeviceId(), internalNodeName, epsilon);
+                    break;
+                }
+                case PrimitiveOpType::ScaledDotProductAttention:
+                {
+                    auto scale = functionConfig[PrimitiveFunctionAttribute::AttributeNameScale].Value<double>();
+                    auto causal = functionConfig[PrimitiveFunctionAttribute::AttributeNameCausal].Value<bool>();
+                    ASSIGN_NEW_NODE(ScaledDotProductAttentionNode, network->GetDeviceId(), internalNodeName, scale, causal);
+                    break;
+                }
                 case PrimitiveOpType::Combine:
                     // This operation is just a no-op and is a means to combine multiple functions to create a single Function
                     // whose outputs are a union of the outputs of the Functions being combined.
@@ -1692,6 +1708,104 @@ namespace CNTK
         return { computationNetwork, variableToNodeMap };
     }
 
+    /*static*/ bool CompositeFunction::IsCompiledNetworkCompatible(const CompiledNetwork& network,
+                                                                   const std::unordered_set<Variable>& backpropRoots,
+                                                                   const std::unordered_set<Variable>& outputs,
+                                                                   const std::unordered_set<Variable>& inputsToExcludeGradientsFor)
+    {
+        // A network compiled just for evaluation cannot be used for gradient backpropagation, while a network compiled
+        // for backpropagation can also be used for plain evaluation
+        if (network.m_currentBackpropRoots.empty() && !backpropRoots.empty())
+            return false;
+
+        if (!backpropRoots.empty() && ((network.m_currentBackpropRoots != backpropRoots) || (network.m_inputsExcludedFromGradientComputation != inputsToExcludeGradientsFor)))
+            return false;
+
+        // The matrix allocation plan of the network covers only the outputs it was compiled for
+        if (network.m_networkMatricesAllocated)
+        {
+            for (auto output : outputs)
+            {
+                if (network.m_allNetworkRoots.find(output) == network.m_allNetworkRoots.end())
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    CompositeFunction::CompiledNetwork CompositeFunction::TakeComputationNetwork()
+    {
+        CompiledNetwork network;
+        network.m_computationNetwork = std::move(m_computationNetwork);
+        network.m_variableToNodeMap = std::move(m_variableToNodeMap);
+        network.m_currentBackpropRoots = std::move(m_currentBackpropRoots);
+        network.m_inputsExcludedFromGradientComputation = std::move(m_inputsExcludedFromGradientComputation);
+        network.m_allNetworkRoots = std::move(m_allNetworkRoots);
+        network.m_lastRecordedTimeStamps = std::move(m_lastRecordedTimeStamps);
+        network.m_inputNodesBoundByReference = std::move(m_inputNodesBoundByReference);
+        network.m_networkMatricesAllocated = m_networkMatricesAllocated;
+
+        m_computationNetwork = nullptr;
+        m_variableToNodeMap.clear();
+        m_currentBackpropRoots.clear();
+        m_inputsExcludedFromGradientComputation.clear();
+        m_allNetworkRoots.clear();
+        m_lastRecordedTimeStamps.clear();
+        m_inputNodesBoundByReference.clear();
+        m_networkMatricesAllocated = false;
+        return network;
+    }
+
+    void CompositeFunction::PutComputationNetwork(CompiledNetwork&& network)
+    {
+        m_computationNetwork = std::move(network.m_computationNetwork);
+        m_variableToNodeMap = std::move(network.m_variableToNodeMap);
+        m_currentBackpropRoots = std::move(network.m_currentBackpropRoots);
+        m_inputsExcludedFromGradientComputation = std::move(network.m_inputsExcludedFromGradientComputation);
+        m_allNetworkRoots = std::move(network.m_allNetworkRoots);
+        m_lastRecordedTimeStamps = std::move(network.m_lastRecordedTimeStamps);
+        m_inputNodesBoundByReference = std::move(network.m_inputNodesBoundByReference);
+        m_networkMatricesAllocated = network.m_networkMatricesAllocated;
+    }
+
+    void CompositeFunction::SelectComputationNetwork(const std::unordered_set<Variable>& backpropRoots,
+                                                     const std::unordered_set<Variable>& outputs,
+                                                     const std::unordered_set<Variable>& inputsToExcludeGradientsFor)
+    {
+        if (m_computationNetwork == nullptr)
+            return;
+
+        CompiledNetwork activeNetwork = TakeComputationNetwork();
+        if (IsCompiledNetworkCompatible(activeNetwork, backpropRoots, outputs, inputsToExcludeGradientsFor))
+        {
+            PutComputationNetwork(std::move(activeNetwork));
+            return;
+        }
+
+        // Retire the active network into the cache. References to its buffers handed out by the last Forward/Backward
+        // are invalidated just as a subsequent Forward on the same network would, and a pending backward state is dropped.
+        ClearExistingOutputOrGradientStorageReferences();
+        if (!m_currentOutputsToEvaluate.empty())
+        {
+            activeNetwork.m_computationNetwork->PostForwardAndBackProp(m_currentOutputsToEvaluate);
+            m_currentOutputsToEvaluate.clear();
+        }
+
+        auto cachedNetworkIter = std::find_if(m_cachedNetworks.begin(), m_cachedNetworks.end(), [&](const CompiledNetwork& network) {
+            return IsCompiledNetworkCompatible(network, backpropRoots, outputs, inputsToExcludeGradientsFor);
+        });
+        if (cachedNetworkIter != m_cachedNetworks.end())
+        {
+            PutComputationNetwork(std::move(*cachedNetworkIter));
+            m_cachedNetworks.erase(cachedNetworkIter);
+        }
+
+        m_cachedNetworks.push_front(std::move(activeNetwork));
+        while (m_cachedNetworks.size() > Internal::GetMaxCachedComputationNetworks())
+            m_cachedNetworks.pop_back();
+    }
+
     template <typename ElementType>
     ComputationNetworkPtr CompositeFunction::GetComputationNetwork(const DeviceDescriptor& device,
                                                                    const std::unordered_set<Variable>& backpropRoots,
@@ -1699,28 +1813,20 @@ namespace CNTK
                                                                    const std::unordered_set<Variable>& inputsToExcludeGradientsFor,
                                                                    bool allocateNetworkMatrices)
     {
-        // Lets purge the current computation network and regenerate the network if the CompositeFunction
-        // was previously compiled just for evaluation and not for gradient backpropagation.
-        if ((m_computationNetwork != nullptr) && (m_currentBackpropRoots.empty() && !backpropRoots.empty()))
-            PurgeComputationNetwork();
+        // The Parameter and Constant nodes of every compiled network reference the storage of the Function's Parameters and Constants,
+        // so all networks must live on the device the Function was first compiled for
+        // TODO: Support changing the device across different invocations of the forward method on a Function instance
+        auto compiledNetwork = (m_computationNetwork != nullptr) ? m_computationNetwork : (!m_cachedNetworks.empty() ? m_cachedNetworks.front().m_computationNetwork : nullptr);
+        if ((compiledNetwork != nullptr) && (AsDeviceDescriptor(compiledNetwork->GetDeviceId()) != device))
+            LogicError("Function '%S': Changing device (Current = '%S', New = %S') across different Forward calls on a CNTK composite Function is currently unsupported.",
+                       AsString().c_str(), AsDeviceDescriptor(compiledNetwork->GetDeviceId()).AsString().c_str(), device.AsString().c_str());
+
+        // Switch to a network compiled for these outputs and backprop roots. If neither the active nor a cached
+        // network fits, a new network is compiled below.
+        SelectComputationNetwork(backpropRoots, outputs, inputsToExcludeGradientsFor);
 
         if (m_computationNetwork != nullptr)
         {
-            // TODO: We should either invalidate and readapt the network if the backpropRoots change compared to what was specified when the network
-            // was last constructed, to just recreate a new network.
-            // For now just disallow changing the backpropRoots after the network is created
-            if (!backpropRoots.empty() && (m_currentBackpropRoots != backpropRoots))
-                LogicError("Function '%S': Changing backprop roots (Current = '%S', New = '%S') across different Forward calls on a CNTK composite Function is currently unsupported.",
-                            AsString().c_str(), NamedListString(m_currentBackpropRoots).c_str(), NamedListString(backpropRoots).c_str());
-
-            // TODO: Support changing the device across different invocations of the forward method on a Function instance
-            if (AsDeviceDescriptor(m_computationNetwork->GetDeviceId()) != device)
-                LogicError("Function '%S': Changing device (Current = '%S', New = %S') across different Forward calls on a CNTK composite Function is currently unsupported.",
-                            AsString().c_str(), AsDeviceDescriptor(m_computationNetwork->GetDeviceId()).AsString().c_str(), device.AsString().c_str());
-
-            if (!backpropRoots.empty() && (inputsToExcludeGradientsFor != m_inputsExcludedFromGradientComputation))
-                LogicError("Function '%S': Changing the set of inputs to exclude from gradient computation, across different Forward calls on a CNTK composite Function, is currently unsupported.", AsString().c_str());
-
             // Verify if the free dimensions of any of the arguments have changed, and if so, update the corresponding
             // input ComputationNodes and rerun validation on the computation network
             for (auto freeDimensionArgumentMapping : m_fullyDefinedArgumentsMap)
@@ -1833,7 +1939,8 @@ namespace CNTK
     }
 
     template <typename ElementType>
-    /*static*/ void CompositeFunction::PopulateComputationNodeValue(const std::pair<Variable, ValuePtr>& variableValue, ComputationNodeBasePtr& computationNode, std::unordered_map<MBLayoutPtr, Variable>& layoutsPopulated)
+    /*static*/ bool CompositeFunction::PopulateComputationNodeValue(const std::pair<Variable, ValuePtr>& variableValue, ComputationNodeBasePtr& computationNode, std::unordered_map<MBLayoutPtr, Variable>& layoutsPopulated,
+                                                                    bool bindByReference /*= false*/, bool isBoundByReference /*= false*/)
     {
         NDShape inferredVariableShape;
         std::pair<std::shared_ptr<const Matrix<ElementType>>, MBLayoutPtr> CNTKMatrixAndMBLayout = Utils::GetCNTKImplMatrixAndMBLayoutFromValueObject<ElementType>(variableValue.first, variableValue.second, &inferredVariableShape);
@@ -1843,7 +1950,23 @@ namespace CNTK
 
         // Switch the node matrix to the right matrix type
         auto& nodeData = computationNode->As<ComputationNode<ElementType>>()->Value();
-        nodeData.AssignValuesOf(*CNTKMatrixAndMBLayout.first);
+        auto& argumentData = *CNTKMatrixAndMBLayout.first;
+        // Consumers write into the gap columns of their inputs (MaskMissingValueColumnsToZero(), InvalidateMissingValueColumns()),
+        // so only a writable argument without masked samples or gaps may be shared with the caller
+        bindByReference = bindByReference &&
+                          (argumentData.GetMatrixType() == DENSE) && (nodeData.GetMatrixType() == DENSE) &&
+                          (argumentData.GetDeviceId() == nodeData.GetDeviceId()) &&
+                          !variableValue.second->IsReadOnly() && (variableValue.second->MaskedCount() == 0) &&
+                          (!CNTKMatrixAndMBLayout.second || !CNTKMatrixAndMBLayout.second->HasGaps());
+        if (bindByReference)
+            nodeData = argumentData.AsReference(); // the node's matrix now shares (and keeps alive) the argument's storage
+        else
+        {
+            // A node still referencing a previous argument gets storage of its own again before the copy
+            if (isBoundByReference)
+                nodeData = Matrix<ElementType>(nodeData.GetDeviceId());
+            nodeData.AssignValuesOf(argumentData);
+        }
 
         auto layout = CNTKMatrixAndMBLayout.second;
         auto& nodeLayout = computationNode->GetMBLayout();
@@ -1864,6 +1987,8 @@ namespace CNTK
                                      variableValue.first.AsString().c_str(), layoutsPopulated.at(nodeLayout).AsString().c_str(), DynamicAxesAsString(variableValue.first.DynamicAxes(), Internal::IsReversingTensorShapesInErrorMessagesEnabled()).c_str());
             }
         }
+
+        return bindByReference;
     }
 
     std::unordered_map<Variable, NDShape> CompositeFunction::InferFreeDimensionsOfArguments(const std::unordered_map<Variable, ValuePtr>& arguments)
@@ -1915,6 +2040,7 @@ namespace CNTK
     {
         std::unordered_map<MBLayoutPtr, Variable> layoutsPopulated;
         std::vector<ComputationNodeBasePtr> inputNodes;
+        bool bindByReference = Internal::IsZeroCopyInputBindingEnabled();
         for (auto argumentValuePair : arguments)
         {
             auto argument = argumentValuePair.first;
@@ -1922,22 +2048,27 @@ namespace CNTK
             assert(argumentComputationNode);
             inputNodes.push_back(argumentComputationNode);
 
+            bool isBoundByReference = (m_inputNodesBoundByReference.erase(argumentComputationNode) > 0);
+            bool boundByReference = false;
             ValuePtr argumentValue = arguments.at(argument);
             switch (argumentValue->GetDataType())
             {
             case DataType::Float:
-                PopulateComputationNodeValue<float>({ argument, argumentValue }, argumentComputationNode, layoutsPopulated);
+                boundByReference = PopulateComputationNodeValue<float>({ argument, argumentValue }, argumentComputationNode, layoutsPopulated, bindByReference, isBoundByReference);
                 break;
             case DataType::Double:
-                PopulateComputationNodeValue<double>({ argument, argumentValue }, argumentComputationNode, layoutsPopulated);
+                boundByReference = PopulateComputationNodeValue<double>({ argument, argumentValue }, argumentComputationNode, layoutsPopulated, bindByReference, isBoundByReference);
                 break;
             case DataType::Float16:
-                PopulateComputationNodeValue<half>({ argument, argumentValue }, argumentComputationNode, layoutsPopulated);
+                boundByReference = PopulateComputationNodeValue<half>({ argument, argumentValue }, argumentComputationNode, layoutsPopulated, bindByReference, isBoundByReference);
                 break;
             default:
                 LogicError("Function '%S' Forward: Unsupported DataType %s.", AsString().c_str(), DataTypeName(argumentValue->GetDataType()));
                 break;
             }
+
+            if (boundByReference)
+                m_inputNodesBoundByReference.insert(argumentComputationNode);
         }
 
         m_computationNetwork->BumpEvalTimeStamp(inputNodes);
@@ -2001,13 +2132,15 @@ namespace CNTK
 
         ValuePtr nodeValue;
         auto layout = computationNode->GetMBLayout();
+        // Outputs handed out as references into the network's buffers are read-only in zero-copy mode
+        bool readOnlyReference = !getGradient && Internal::IsZeroCopyInputBindingEnabled();
         switch (var.GetDataType())
         {
         case DataType::Float:
         {
             auto& matrix = getGradient ? computationNode->As<ComputationNode<float>>()->Gradient() : computationNode->As<ComputationNode<float>>()->Value();
             if (varValue == nullptr)
-                nodeValue = MakeSharedObject<PackedValue>(varShape, var.DynamicAxes(), std::make_shared<Matrix<float>>(matrix.AsReference()), layout, /*readOnly =*/ false);
+                nodeValue = MakeSharedObject<PackedValue>(varShape, var.DynamicAxes(), std::make_shared<Matrix<float>>(matrix.AsReference()), layout, readOnlyReference);
             else
                 nodeValue = Utils::GetValueObjectFromCNTKImplMatrixAndMBLayout<float>(var, computationNode, matrix, layout);
             break;
@@ -2016,7 +2149,7 @@ namespace CNTK
         {
             auto& matrix = getGradient ? computationNode->As<ComputationNode<double>>()->Gradient() : computationNode->As<ComputationNode<double>>()->Value();
             if (varValue == nullptr)
-                nodeValue = MakeSharedObject<PackedValue>(varShape, var.DynamicAxes(), std::make_shared<Matrix<double>>(matrix.AsReference()), layout, /*readOnly =*/ false);
+                nodeValue = MakeSharedObject<PackedValue>(varShape, var.DynamicAxes(), std::make_shared<Matrix<double>>(matrix.AsReference()), layout, readOnlyReference);
             else
                 nodeValue = Utils::GetValueObjectFromCNTKImplMatrixAndMBLayout<double>(var, computationNode, matrix, layout);
             break;
@@ -2025,7 +2158,7 @@ namespace CNTK
         {
             auto& matrix = getGradient ? computationNode->As<ComputationNode<half>>()->Gradient() : computationNode->As<ComputationNode<half>>()->Value();
             if (varValue == nullptr)
-                nodeValue = MakeSharedObject<PackedValue>(varShape, var.DynamicAxes(), std::make_shared<Matrix<half>>(matrix.AsReference()), layout, /*readOnly =*/ false);
+                nodeValue = MakeSharedObject<PackedValue>(varShape, var.DynamicAxes(), std::make_shared<Matrix<half>>(matrix.AsReference()), layout, readOnlyReference);
             else
                 nodeValue = Utils::GetValueObjectFromCNTKImplMatrixAndMBLayout<half>(var, computationNode, matrix, layout);
             break;
@@ -2285,9 +2418,14 @@ namespace CNTK
 
         // TODO: Avoid copying the data when possible
 
-        // Zero all gradients of nodes below the root nodes
+        // Zero all gradients of nodes below the root nodes, except for those of the Parameters when accumulating them
         for (auto rootGradientVarValuePair : rootGradientValues)
-            m_computationNetwork->ZeroInputGradients(m_variableToNodeMap.at(rootGradientVarValuePair.first));
+        {
+            if (m_accumulateParameterGradients)
+                m_computationNetwork->ZeroInputGradientsExceptLearnableParameters(m_variableToNodeMap.at(rootGradientVarValuePair.first));
+            else
+                m_computationNetwork->ZeroInputGradients(m_variableToNodeMap.at(rootGradientVarValuePair.first));
+        }
 
         // Feed data into the arguments of the network
         PopulateNetworkGradients(rootGradientValues);
@@ -2315,45 +2453,58 @@ namespace CNTK
         // Dropout nodes have an implicit input in the form of the random mask that is applied to its explicit input
         // This mask is regenerated every minibatch and hence dropout nodes with a non-zero dropout rate must me marked outdated
         // w.r.t. inputs to force evaluation in each minibatch
-        for (auto varNodePair : m_variableToNodeMap)
+
+        // The updates are applied to the cached networks as well, since the dirty flags are cleared afterwards
+        std::vector<std::unordered_map<Variable, ComputationNodeBasePtr>*> variableToNodeMaps = { &m_variableToNodeMap };
+        for (auto& cachedNetwork : m_cachedNetworks)
+            variableToNodeMaps.push_back(&cachedNetwork.m_variableToNodeMap);
+
+        std::unordered_set<FunctionPtr> updatedFunctions;
+        for (auto variableToNodeMap : variableToNodeMaps)
         {
-            auto var = varNodePair.first;
-            if (!var.IsOutput())
-                continue;
+            for (auto varNodePair : *variableToNodeMap)
+            {
+                auto var = varNodePair.first;
+                if (!var.IsOutput())
+                    continue;
 
-            auto function = var.Owner();
+                auto function = var.Owner();
 
-            if (function->m_dirtyAttributes.empty())
-                continue;
+                if (function->m_dirtyAttributes.empty())
+                    continue;
 
-            auto node = varNodePair.second;
+                auto node = varNodePair.second;
 
-            for (const wstring& attribute : function->m_dirtyAttributes)
-            {
-                if (attribute == PrimitiveFunctionAttribute::AttributeNameDropoutRate)
-                {
-                    auto dropoutRate = function->m_attributes[attribute].Value<double>();
-                    auto dropoutPtr = dynamic_cast<DropoutNodeBase*>(node.get());
-                    assert(dropoutPtr != nullptr);
-                    dropoutPtr->SetDropoutRate(dropoutRate);
-                }
-                else if (attribute == PrimitiveFunctionAttribute::AttributeNameRngSeed)
-                {
-                    auto seed = function->m_attributes[PrimitiveFunctionAttribute::AttributeNameRngSeed].Value<size_t>();
-                    auto rngUserPtr = dynamic_cast<RngUser*>(node.get());
-                    assert(rngUserPtr != nullptr);
-                    rngUserPtr->SetRngState(seed);
-                }
-                else
+                for (const wstring& attribute : function->m_dirtyAttributes)
                 {
-                    // Should never happen.
-                    LogicError("ApplyAttributeUpdates: function '%S' specified an unsupported attribute '%S'.",
-                        function->AsString().c_str(), attribute.c_str());
+                    if (attribute == PrimitiveFunctionAttribute::AttributeNameDropoutRate)
+                    {
+                        auto dropoutRate = function->m_attributes[attribute].Value<double>();
+                        auto dropoutPtr = dynamic_cast<DropoutNodeBase*>(node.get());
+                        assert(dropoutPtr != nullptr);
+                        dropoutPtr->SetDropoutRate(dropoutRate);
+                    }
+                    else if (attribute == PrimitiveFunctionAttribute::AttributeNameRngSeed)
+                    {
+                        auto seed = function->m_attributes[PrimitiveFunctionAttribute::AttributeNameRngSeed].Value<size_t>();
+                        auto rngUserPtr = dynamic_cast<RngUser*>(node.get());
+                        assert(rngUserPtr != nullptr);
+                        rngUserPtr->SetRngState(seed);
+                    }
+                    else
+                    {
+                        // Should never happen.
+                        LogicError("ApplyAttributeUpdates: function '%S' specified an unsupported attribute '%S'.",
+                            function->AsString().c_str(), attribute.c_str());
+                    }
                 }
+
+                updatedFunctions.insert(function);
+                node->SetEvalTimeStampOutdatedWrtAll();
             }
+        }
 
+        for (auto& function : updatedFunctions)
             function->m_dirtyAttributes.clear();
-            node->SetEvalTimeStampOutdatedWrtAll();
-        }
     }
 }
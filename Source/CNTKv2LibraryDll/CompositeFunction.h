@@ -11,6 +11,7 @@
 #include "ComputationNetwork.h"
 #include "BackCompat.h"
 #include "Value.h"
+#include <list>
 
 namespace CNTK
 {
@@ -198,6 +199,11 @@ namespace CNTK
                                      bool useMangledNamesForComputationNodes);
 
         const std::unordered_set<FunctionPtr> AllPrimaryFunctions() const { return m_allPrimitiveFunctions; }
+
+        // Releases the networks kept in 'm_cachedNetworks'; the active network is kept.
+        void ReleaseCachedComputationNetworks() { m_cachedNetworks.clear(); }
+        size_t NumCachedComputationNetworks() const { return m_cachedNetworks.size(); }
+
     private:
         // Replace any PlaceHolder Variables in the graph of Functions underlying 'this' CompositeFunction. All PlaceHolder variables
         // should have been replaced before performing any Forward compute of 'this' Function.
@@ -223,7 +229,7 @@ namespace CNTK
 
         CompositeFunction(const FunctionPtr& rootFunction, std::unordered_set<FunctionPtr>&& allPrimitiveFunctions, const std::wstring& name, const std::wstring& uid = Internal::GenerateUid(L"CompositeFunction"))
             : Function({}, Dictionary(), rootFunction, name, uid),
-            m_allPrimitiveFunctions(std::move(allPrimitiveFunctions)), m_networkMatricesAllocated(false)
+            m_allPrimitiveFunctions(std::move(allPrimitiveFunctions)), m_networkMatricesAllocated(false), m_accumulateParameterGradients(false)
         {}
 
         std::vector<Variable> DetermineInputs(bool pythonOperandOrder = false) const
@@ -264,6 +270,10 @@ namespace CNTK
         // Copy all new values for 'dirty' attributes from functions into corresponding network nodes.
         void ApplyAttributeUpdates();
 
+        // Gradient accumulation across minibatches (see Trainer::SetGradientAccumulation): when set, Backward adds the
+        // gradients of the Parameters to the ones computed by the previous Backward rather than overwriting them.
+        void SetAccumulateParameterGradients(bool accumulate) { m_accumulateParameterGradients = accumulate; }
+
         // Generate a dictionary representing the internal (local) state of the function graph.
         Dictionary GetInternalState() const;
 
@@ -320,7 +330,8 @@ namespace CNTK
                                                                     bool useMangledNamesForComputationNodes);
 
         template <typename ElementType>
-        static void PopulateComputationNodeValue(const std::pair<Variable, ValuePtr>& variableValue, Microsoft::MSR::CNTK::ComputationNodeBasePtr& computationNode, std::unordered_map< Microsoft::MSR::CNTK::MBLayoutPtr, Variable>& layoutsPopulated);
+        static bool PopulateComputationNodeValue(const std::pair<Variable, ValuePtr>& variableValue, Microsoft::MSR::CNTK::ComputationNodeBasePtr& computationNode, std::unordered_map< Microsoft::MSR::CNTK::MBLayoutPtr, Variable>& layoutsPopulated,
+                                                 bool bindByReference = false, bool isBoundByReference = false);
         void PopulateNetworkInputs(const std::unordered_map<Variable, ValuePtr>& arguments);
 
         template <typename ElementType>
@@ -350,13 +361,45 @@ namespace CNTK
             m_existingNetworkStorageReferences.clear();
         }
 
+        // A ComputationNetwork compiled for 'this' Function, together with the state that depends on the (outputs, backprop
+        // roots) it was compiled for. The active network lives in the individual members of this class; networks compiled
+        // for other signatures are kept in 'm_cachedNetworks' (most recently used first), so that alternating between
+        // evaluation and training, different backprop roots, or outputs beyond the root outputs does not recompile and
+        // reallocate. Subsets of the root outputs share one network, since its allocation plan covers all root outputs.
+        // At most Internal::GetMaxCachedComputationNetworks() networks are cached, and the least recently used one is released
+        // beyond that; Internal::ReleaseCachedComputationNetworks() releases them all.
+        // All networks share the storage of the Function's Parameters and Constants, and hence its device.
+        struct CompiledNetwork
+        {
+            Microsoft::MSR::CNTK::ComputationNetworkPtr m_computationNetwork;
+            std::unordered_map<Variable, Microsoft::MSR::CNTK::ComputationNodeBasePtr> m_variableToNodeMap;
+            std::unordered_set<Variable> m_currentBackpropRoots;
+            std::unordered_set<Variable> m_inputsExcludedFromGradientComputation;
+            std::unordered_set<Variable> m_allNetworkRoots;
+            std::unordered_map<Variable, size_t> m_lastRecordedTimeStamps;
+            std::unordered_set<Microsoft::MSR::CNTK::ComputationNodeBasePtr> m_inputNodesBoundByReference;
+            bool m_networkMatricesAllocated;
+        };
+
+        static bool IsCompiledNetworkCompatible(const CompiledNetwork& network,
+                                                const std::unordered_set<Variable>& backpropRoots,
+                                                const std::unordered_set<Variable>& outputs,
+                                                const std::unordered_set<Variable>& inputsToExcludeGradientsFor);
+        CompiledNetwork TakeComputationNetwork();
+        void PutComputationNetwork(CompiledNetwork&& network);
+        void SelectComputationNetwork(const std::unordered_set<Variable>& backpropRoots,
+                                      const std::unordered_set<Variable>& outputs,
+                                      const std::unordered_set<Variable>& inputsToExcludeGradientsFor);
+
         void PurgeComputationNetwork()
         {
+            m_cachedNetworks.clear();
             m_currentBackpropRoots.clear();
             m_inputsExcludedFromGradientComputation.clear();
             m_variableToNodeMap.clear();
             m_currentOutputsToEvaluate.clear();
             m_lastRecordedTimeStamps.clear();
+            m_inputNodesBoundByReference.clear();
 
             m_networkMatricesAllocated = false;
             m_computationNetwork = nullptr;
@@ -390,6 +433,11 @@ namespace CNTK
         // Map to keep track of any references to network output/gradient storage handed out so far
         std::vector<PackedValueWeakPtr> m_existingNetworkStorageReferences;
 
+        // Input nodes whose value currently references the storage of an argument Value (see Internal::SetZeroCopyInputBinding)
+        std::unordered_set<Microsoft::MSR::CNTK::ComputationNodeBasePtr> m_inputNodesBoundByReference;
+
+        std::list<CompiledNetwork> m_cachedNetworks;
+
         // The backpropRoots specified in the most recent 'Forward' call on 'this' Function.
         // This indicates for which of its roots has 'this' Function retained required intermediate 
         // states from the previos Forward call to be able to backpropagate gradients backwards from in
@@ -407,6 +455,8 @@ namespace CNTK
 
         bool m_networkMatricesAllocated;
 
+        bool m_accumulateParameterGradients;
+
         std::unordered_set<Variable> m_allNetworkRoots;
 
         std::unordered_map<Variable, size_t> m_lastRecordedTimeStamps;
@@ -2589,6 +2589,22 @@ namespace CNTK
 
     }
 
+    FunctionPtr BinaryConvolution(const Variable& convolutionMap,
+        const Variable& operand,
+        const NDShape& strides,
+        const std::vector<bool>& sharing,
+        const std::vector<bool>& autoPadding,
+        const std::wstring& name)
+    {
+        auto additionalProperties = Dictionary();
+        auto defaultPadVector = std::vector<size_t>({ 0 });
+        SetConvolutionProperties(additionalProperties, strides, sharing, autoPadding, defaultPadVector, defaultPadVector, /*dilation =*/{ 1 }, /*sequential =*/false,
+                                 /*transpose =*/false, /*outputShape =*/{ 0 }, PrimitiveFunction::convolutionOpDefaultValueForGroups, /*maxTempMemSizeInSamples =*/0);
+        additionalProperties[PrimitiveFunctionAttribute::AttributeNameBinary] = true;
+
+        return BinaryOp(PrimitiveOpType::Convolution, convolutionMap, operand, std::move(additionalProperties), name);
+    }
+
     FunctionPtr ConvolutionTranspose(const Variable& convolutionMap,
         const Variable& operand,
         const NDShape& strides,
@@ -2788,6 +2804,29 @@ namespace CNTK
             name);
     }
 
+    FunctionPtr LayerNormalization(const Variable& operand, const Variable& scale, const Variable& bias, double epsilon, const std::wstring& name)
+    {
+        auto additionalProperties = Dictionary();
+        additionalProperties[PrimitiveFunctionAttribute::AttributeNameEpsilon] = epsilon;
+
+        // operands are kept in the order of the ONNX LayerNormalization (scale, bias, operand)
+        std::vector<Variable> operands = { scale, bias, operand };
+        return AsComposite(MakeSharedObject<PrimitiveFunction>(PrimitiveOpType::LayerNormalization, operands, std::move(additionalProperties), name), name);
+    }
+
+    FunctionPtr ScaledDotProductAttention(const Variable& query, const Variable& key, const Variable& value, double scale, bool causal, const std::wstring& name)
+    {
+        if (scale < 0)
+            InvalidArgument("ScaledDotProductAttention: scale (%g) must not be negative.", scale);
+
+        auto additionalProperties = Dictionary();
+        additionalProperties[PrimitiveFunctionAttribute::AttributeNameScale] = scale;
+        additionalProperties[PrimitiveFunctionAttribute::AttributeNameCausal] = causal;
+
+        std::vector<Variable> operands = { query, key, value };
+        return AsComposite(MakeSharedObject<PrimitiveFunction>(PrimitiveOpType::ScaledDotProductAttention, operands, std::move(additionalProperties), name), name);
+    }
+
     FunctionPtr LocalResponseNormalization(const Variable& operand, size_t depthRadius, double bias, double alpha, double beta, const std::wstring& name)
     {
         auto additionalProperties = Dictionary();
@@ -3250,6 +3289,19 @@ namespace CNTK
 
     namespace Internal
     {
+        void ReleaseCachedComputationNetworks(const FunctionPtr& function)
+        {
+            auto compositeFunction = dynamic_cast<CompositeFunction*>(function.get());
+            if (compositeFunction)
+                compositeFunction->ReleaseCachedComputationNetworks();
+        }
+
+        size_t GetNumCachedComputationNetworks(const FunctionPtr& function)
+        {
+            auto compositeFunction = dynamic_cast<CompositeFunction*>(function.get());
+            return compositeFunction ? compositeFunction->NumCachedComputationNetworks() : 0;
+        }
+
         FunctionPtr IsWithin(const Variable& operand, int offset, const std::wstring& name)
         {
             Sequence::VerifyIsSequence(operand);
@@ -1039,6 +1039,53 @@ namespace CNTK
                             outputShape = BatchNormalizationOutputShape(m_inputs, spatial, true);
                             break;
                         }
+                        case PrimitiveOpType::LayerNormalization:
+                        {
+                            assert(m_inputs.size() == 3);
+                            // inputs are (scale, bias, operand); scale and bias have the operand's shape or a single element
+                            auto& operand = m_inputs[2];
+                            outputShape = operand.Shape();
+                            if (!operand.Shape().HasUnboundDimension())
+                            {
+                                std::vector<std::pair<Variable, NDShape>> newOperandShapes;
+                                for (size_t i = 0; i < 2; i++)
+                                {
+                                    const auto& paramShape = m_inputs[i].Shape();
+                                    if (paramShape.HasInferredDimension())
+                                        newOperandShapes.push_back({ m_inputs[i], operand.Shape() });
+                                    else if ((paramShape.TotalSize() != 1) && (paramShape.TotalSize() != operand.Shape().TotalSize()))
+                                        InvalidArgument("LayerNormalization: %s '%S' must have the shape of the operand '%S' or a single element.",
+                                                        i == 0 ? "scale" : "bias", m_inputs[i].AsString().c_str(), operand.AsString().c_str());
+                                }
+                                UpdateOperandShapes(newOperandShapes);
+                            }
+                            break;
+                        }
+                        case PrimitiveOpType::ScaledDotProductAttention:
+                        {
+                            assert(m_inputs.size() == 3);
+                            const auto& queryShape = m_inputs[0].Shape();
+                            const auto& keyShape = m_inputs[1].Shape();
+                            const auto& valueShape = m_inputs[2].Shape();
+                            const size_t rank = queryShape.Rank();
+                            if ((rank != 2) && (rank != 3))
+                                InvalidArgument("ScaledDotProductAttention: query '%S' must be of shape [dimQK x numQueries] or [dimQK x numQueries x numHeads].", m_inputs[0].AsString().c_str());
+                            if ((keyShape.Rank() != rank) || (valueShape.Rank() != rank))
+                                InvalidArgument("ScaledDotProductAttention: query '%S', key '%S', and value '%S' must have the same rank.",
+                                                m_inputs[0].AsString().c_str(), m_inputs[1].AsString().c_str(), m_inputs[2].AsString().c_str());
+                            if (!queryShape.HasUnboundDimension() && !keyShape.HasUnboundDimension() && !valueShape.HasUnboundDimension())
+                            {
+                                if ((keyShape[0] != queryShape[0]) || (valueShape[1] != keyShape[1]) || ((rank == 3) && ((keyShape[2] != queryShape[2]) || (valueShape[2] != queryShape[2]))))
+                                    InvalidArgument("ScaledDotProductAttention: incompatible shapes of query '%S', key '%S', and value '%S'.",
+                                                    m_inputs[0].AsString().c_str(), m_inputs[1].AsString().c_str(), m_inputs[2].AsString().c_str());
+                                if (m_attributes[PrimitiveFunctionAttribute::AttributeNameCausal].Value<bool>() && (keyShape[1] < queryShape[1]))
+                                    InvalidArgument("ScaledDotProductAttention: causal attention requires at least as many keys as queries; key '%S', query '%S'.",
+                                                    m_inputs[1].AsString().c_str(), m_inputs[0].AsString().c_str());
+                            }
+                            outputShape = valueShape;
+                            outputShape[1] = queryShape[1];
+                            break;
+                        }
                         case PrimitiveOpType::GatherPacked:
                         {
                             bool sourceHasDynamicAxis = !m_inputs[0].DynamicAxes().empty();
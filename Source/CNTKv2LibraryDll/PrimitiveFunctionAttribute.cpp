@@ -120,9 +120,12 @@ namespace CNTK
     /*static*/ const std::wstring PrimitiveFunctionAttribute::AttributeNameUseStatsAcrossChannels = L"useStatsAcrossChannels";
     /*static*/ const std::wstring PrimitiveFunctionAttribute::AttributeNameDoVarianceScaling = L"doVarianceScaling";
     /*static*/ const std::wstring PrimitiveFunctionAttribute::AttributeNameGroups = L"groups";
+    /*static*/ const std::wstring PrimitiveFunctionAttribute::AttributeNameBinary = L"binary";
     /*static*/ const std::wstring PrimitiveFunctionAttribute::AttributeNameCustomOp = L"customOp";
     /*static*/ const std::wstring PrimitiveFunctionAttribute::AttributeNameTransposeLeftOperand = L"transA";
     /*static*/ const std::wstring PrimitiveFunctionAttribute::AttributeNameTransposeRightOperand = L"transB";
+    /*static*/ const std::wstring PrimitiveFunctionAttribute::AttributeNameScale = L"scale";
+    /*static*/ const std::wstring PrimitiveFunctionAttribute::AttributeNameCausal = L"causal";
 
     /*static*/ const std::vector<std::wstring> PrimitiveFunctionAttribute::s_rngStateAttributes =
                    { PrimitiveFunctionAttribute::AttributeNameRngSeed,
@@ -23,6 +23,9 @@ namespace
     // 1 -- initial version: added a key-value pair for the checkpoint version info, added
     //      distributed state key to save all local state collected from distributed workers.
     static const size_t trainerCheckpointVersion = 1;
+
+    // Number of consecutive minibatches that may overflow at loss scale 1 before dynamic loss scaling gives up.
+    static const size_t maxOverflowsAtUnitLossScale = 10;
 }
 
 namespace CNTK
@@ -44,7 +47,18 @@ namespace CNTK
           m_distributed(false),
           m_aggregatedTrainingLossValue(std::make_shared<Accumulator>()),
           m_aggregatedTrainingEvalCriterionValue(),
-          m_prevDistributedTotalNumSamples(0)
+          m_prevDistributedTotalNumSamples(0),
+          m_dynamicLossScaling(false),
+          m_lossScale(1),
+          m_lossScaleGrowthInterval(0),
+          m_numStepsSinceLossScaleChange(0),
+          m_numOverflowsAtUnitLossScale(0),
+          m_gradientAccumulationMicroBatches(1),
+          m_numAccumulatedMicroBatches(0),
+          m_accumulatedNumSamples(0),
+          m_accumulatedSweepEnd(false),
+          m_accumulatedTrainingLoss(std::make_shared<Accumulator>()),
+          m_accumulatedEvalCriterion(std::make_shared<Accumulator>())
     {
         std::vector<Variable> combinedFunctionArgs;
         if (m_model) // model is optional, since it may not be adding any information on top of lossFunction
@@ -166,8 +180,10 @@ namespace CNTK
             TrainDistributedMinibatch(GetInputs(arguments), outputsToFetch, IsAtSweepEnd(arguments), computeDevice);
 
         // TODO: exclude updating progress writers from profiling?
-        UpdateTrainingProgress(m_prevMinibatchNumSamples, m_prevMinibatchAggregateTrainingLossValue,
-                               m_prevMinibatchAggregateEvalCriterionValue, computeDevice);
+        // Distributed learners aggregate the loss only at the end of a gradient accumulation window, which covers the minibatches before.
+        if (!m_distributed || m_numAccumulatedMicroBatches == 0)
+            UpdateTrainingProgress(m_prevMinibatchNumSamples, m_prevMinibatchAggregateTrainingLossValue,
+                                   m_prevMinibatchAggregateEvalCriterionValue, computeDevice);
         return result;
     }
 
@@ -188,8 +204,10 @@ namespace CNTK
             TrainDistributedMinibatch(arguments, outputsToFetch, isSweepEndInArguments, computeDevice);
 
         // TODO: exclude updating progress writers from profiling?
-        UpdateTrainingProgress(m_prevMinibatchNumSamples, m_prevMinibatchAggregateTrainingLossValue,
-                               m_prevMinibatchAggregateEvalCriterionValue, computeDevice);
+        // Distributed learners aggregate the loss only at the end of a gradient accumulation window, which covers the minibatches before.
+        if (!m_distributed || m_numAccumulatedMicroBatches == 0)
+            UpdateTrainingProgress(m_prevMinibatchNumSamples, m_prevMinibatchAggregateTrainingLossValue,
+                                   m_prevMinibatchAggregateEvalCriterionValue, computeDevice);
         return result;
     }
 
@@ -199,7 +217,14 @@ namespace CNTK
         if (emptyMinibatch) // Nothing to train with.
         {
             m_prevMinibatchNumSamples = 0;
-            return false;
+            if (m_numAccumulatedMicroBatches == 0)
+                return false;
+
+            // apply what has been accumulated so far
+            auto gradients = m_accumulatedGradients;
+            auto numSamples = m_accumulatedNumSamples;
+            ResetGradientAccumulation();
+            return UpdateLocalLearners(gradients, numSamples, sweepEnd);
         }
 
         std::unordered_map<Variable, ValuePtr> parameterGradients;
@@ -212,7 +237,155 @@ namespace CNTK
         std::unordered_map<Parameter, NDArrayViewPtr> gradients;
         for (const auto& parameter : m_learnerParameters)
             gradients[parameter] = parameterGradients[parameter]->Data();
-        return m_parameterLearners->Update(gradients, m_prevMinibatchNumSamples, sweepEnd);
+
+        if (m_gradientAccumulationMicroBatches == 1)
+            return UpdateLocalLearners(gradients, m_prevMinibatchNumSamples, sweepEnd);
+
+        // the parameter gradients now hold the sum over the window so far (see ExecuteForwardBackward())
+        m_accumulatedGradients = gradients;
+        m_accumulatedNumSamples += m_prevMinibatchNumSamples;
+        if (++m_numAccumulatedMicroBatches < m_gradientAccumulationMicroBatches && !sweepEnd)
+            return true;
+
+        auto numSamples = m_accumulatedNumSamples;
+        ResetGradientAccumulation();
+        return UpdateLocalLearners(gradients, numSamples, sweepEnd);
+    }
+
+    // Update the parameters from the gradients of 'numSamples' samples, with dynamic loss scaling if enabled.
+    bool Trainer::UpdateLocalLearners(std::unordered_map<Parameter, NDArrayViewPtr>& gradients, size_t numSamples, bool sweepEnd)
+    {
+        if (m_dynamicLossScaling)
+        {
+            if (!UnscaleGradients(gradients))
+            {
+                // overflow: skip this minibatch and continue with a smaller scale
+                if (m_lossScale > 1)
+                {
+                    m_lossScale = std::max(m_lossScale / 2, 1.0);
+                    m_numStepsSinceLossScaleChange = 0;
+                    if (GetTraceLevel() >= TraceLevel::Info)
+                        fprintf(stderr, "Info: Trainer: gradient overflow, skipping minibatch and reducing the loss scale to %g.\n", m_lossScale);
+                    return true;
+                }
+
+                // The scale cannot go lower, the gradients are not finite by themselves (e.g. the model diverged).
+                if (++m_numOverflowsAtUnitLossScale >= maxOverflowsAtUnitLossScale)
+                    RuntimeError("Trainer: the gradients overflowed in %zu consecutive minibatches at loss scale 1.", m_numOverflowsAtUnitLossScale);
+                fprintf(stderr, "WARNING: Trainer: gradient overflow at loss scale 1, skipping minibatch (%zu in a row).\n", m_numOverflowsAtUnitLossScale);
+                return true;
+            }
+
+            m_numOverflowsAtUnitLossScale = 0;
+
+            if (++m_numStepsSinceLossScaleChange >= m_lossScaleGrowthInterval)
+            {
+                // the root gradient of a Float16 loss must stay representable in half
+                const double maxLossScale = m_aggregatedLossFunction->Output().GetDataType() == DataType::Float16 ? 32768 : std::numeric_limits<float>::max() / 2;
+                m_lossScale = std::min(m_lossScale * 2, maxLossScale);
+                m_numStepsSinceLossScaleChange = 0;
+            }
+        }
+
+        return m_parameterLearners->Update(gradients, numSamples, sweepEnd);
+    }
+
+    void Trainer::SetGradientAccumulation(size_t numMicroBatches)
+    {
+        if (numMicroBatches == 0)
+            InvalidArgument("Trainer: the number of minibatches to accumulate gradients over must be positive.");
+
+        if (m_numAccumulatedMicroBatches != 0)
+            InvalidArgument("Trainer: gradient accumulation cannot be changed while %zu minibatches are accumulated.", m_numAccumulatedMicroBatches);
+
+        m_gradientAccumulationMicroBatches = numMicroBatches;
+    }
+
+    // Start a new accumulation window. The next minibatch overwrites the parameter gradients.
+    void Trainer::ResetGradientAccumulation()
+    {
+        m_numAccumulatedMicroBatches = 0;
+        m_accumulatedNumSamples = 0;
+        m_accumulatedGradients.clear();
+        m_accumulatedSweepEnd = false;
+        m_accumulatedTrainingLoss->Reset();
+        m_accumulatedEvalCriterion->Reset();
+    }
+
+    void Trainer::EnableDynamicLossScaling(double initialLossScale, size_t growthInterval)
+    {
+        if (m_distributed)
+            InvalidArgument("Trainer: dynamic loss scaling is not supported with distributed learners.");
+
+        if (initialLossScale < 1 || growthInterval == 0)
+            InvalidArgument("Trainer: the initial loss scale (%g) must be at least 1 and the growth interval (%zu) must be positive.", initialLossScale, growthInterval);
+
+        if (m_aggregatedLossFunction->Output().GetDataType() == DataType::Float16 && initialLossScale > 32768)
+            InvalidArgument("Trainer: the initial loss scale (%g) must not exceed 32768 for a Float16 loss function.", initialLossScale);
+
+        m_dynamicLossScaling = true;
+        m_lossScale = initialLossScale;
+        m_lossScaleGrowthInterval = growthInterval;
+        m_numStepsSinceLossScaleChange = 0;
+        m_numOverflowsAtUnitLossScale = 0;
+    }
+
+    // Divide the gradients by the current loss scale. Returns false, leaving the gradients untouched, if any gradient
+    // contains Inf or NaN (for sparse gradients, any of the stored non-zero values).
+    bool Trainer::UnscaleGradients(const std::unordered_map<Parameter, NDArrayViewPtr>& gradients)
+    {
+        using Microsoft::MSR::CNTK::Matrix;
+
+        for (const auto& gradient : gradients)
+        {
+            const auto& value = gradient.second;
+            double sumOfAbs;
+            switch (value->GetDataType())
+            {
+            case DataType::Float:
+                sumOfAbs = value->GetMatrix<float>()->SumOfAbsElements();
+                break;
+            case DataType::Double:
+                sumOfAbs = value->GetMatrix<double>()->SumOfAbsElements();
+                break;
+            case DataType::Float16:
+            {
+                // sum in float: the sum of a finite half gradient can exceed the half range
+                auto valueAsHalf = value->GetMatrix<half>();
+                Matrix<float> valueAsFloat(valueAsHalf->GetNumRows(), valueAsHalf->GetNumCols(), AsCNTKImplDeviceId(value->Device()),
+                                           valueAsHalf->GetMatrixType(), valueAsHalf->GetFormat());
+                valueAsFloat.CastAssignValuesOf(*valueAsHalf);
+                sumOfAbs = valueAsFloat.SumOfAbsElements();
+                break;
+            }
+            default:
+                LogicError("Trainer: unsupported gradient DataType %s for dynamic loss scaling.", DataTypeName(value->GetDataType()));
+            }
+
+            if (!std::isfinite(sumOfAbs))
+                return false;
+        }
+
+        const double inverseScale = 1 / m_lossScale;
+        for (const auto& gradient : gradients)
+        {
+            const auto& value = gradient.second;
+            switch (value->GetDataType())
+            {
+            case DataType::Float:
+                Matrix<float>::Scale((float)inverseScale, *value->GetWritableMatrix<float>());
+                break;
+            case DataType::Double:
+                Matrix<double>::Scale(inverseScale, *value->GetWritableMatrix<double>());
+                break;
+            case DataType::Float16:
+                Matrix<half>::Scale((half)inverseScale, *value->GetWritableMatrix<half>());
+                break;
+            default:
+                LogicError("Trainer: unsupported gradient DataType %s for dynamic loss scaling.", DataTypeName(value->GetDataType()));
+            }
+        }
+        return true;
     }
 
     bool Trainer::TrainDistributedMinibatch(const std::unordered_map<Variable, ValuePtr>& arguments, std::unordered_map<Variable, ValuePtr>& outputsToFetch, bool sweepEnd, const DeviceDescriptor& computeDevice /*= DeviceDescriptor::UseDefaultDevice()*/)
@@ -246,10 +419,41 @@ namespace CNTK
             evalCriterion = m_prevMinibatchAggregateEvalCriterionValue->Data();
         }
 
+        // Gradient accumulation: sum up locally. All workers aggregate after the same number of calls, including empty minibatches.
+        bool accumulated = false;
+        if (m_gradientAccumulationMicroBatches > 1)
+        {
+            if (!emptyMinibatch)
+            {
+                // the parameter gradients now hold the sum over the window so far (see ExecuteForwardBackward())
+                m_accumulatedGradients = gradients;
+                m_accumulatedNumSamples += m_prevMinibatchNumSamples;
+                m_accumulatedTrainingLoss->Update(m_prevMinibatchAggregateTrainingLossValue, trainingLoss->Device());
+                if (m_aggregatedEvaluationFunction)
+                    m_accumulatedEvalCriterion->Update(m_prevMinibatchAggregateEvalCriterionValue, evalCriterion->Device());
+            }
+            m_accumulatedSweepEnd |= sweepEnd;
+            if (++m_numAccumulatedMicroBatches < m_gradientAccumulationMicroBatches)
+                return true;
+
+            if (m_accumulatedNumSamples > 0)
+            {
+                gradients = m_accumulatedGradients;
+                trainingLoss = m_accumulatedTrainingLoss->Data()->DeepClone();
+                if (m_aggregatedEvaluationFunction)
+                    evalCriterion = m_accumulatedEvalCriterion->Data()->DeepClone();
+                accumulated = true;
+            }
+            m_prevMinibatchNumSamples = m_accumulatedNumSamples;
+            sweepEnd = m_accumulatedSweepEnd;
+            ResetGradientAccumulation();
+        }
+
         auto currentWorkerNumSamples = m_prevMinibatchNumSamples;
         auto prevTotalNumSamples = TotalNumberOfSamplesSeen();
 
-        MinibatchInfo info{ arguments.empty(), sweepEnd, m_prevMinibatchNumSamples, trainingLoss, evalCriterion };
+        // a window that ends on an empty minibatch still contributes its accumulated gradients
+        MinibatchInfo info{ arguments.empty() && !accumulated, sweepEnd, m_prevMinibatchNumSamples, trainingLoss, evalCriterion };
         bool updated = m_parameterLearners->Update(gradients, info);
 
         // Here we update m_prevMinibatchNumSamples with aggregated value in the
@@ -257,7 +461,7 @@ namespace CNTK
         m_prevMinibatchNumSamples = info.numberOfSamples;
     
         // Update internal state.
-        if (emptyMinibatch)
+        if (emptyMinibatch || accumulated)
         {
             // Have to reassign loss and criterion.
             m_prevMinibatchAggregateEvalCriterionValue = std::make_shared<Value>(info.evalCriterionValue);
@@ -382,18 +586,26 @@ namespace CNTK
 
         DataType aggregateDataType = m_aggregatedLossFunction->Output().GetDataType();
 
+        // m_lossScale is 1 unless dynamic loss scaling is enabled
         if (aggregateDataType == DataType::Float)
-            m_rootGradientValue->Data()->SetValue(1.0f);
+            m_rootGradientValue->Data()->SetValue((float)m_lossScale);
         else if (aggregateDataType == DataType::Double)
-            m_rootGradientValue->Data()->SetValue(1.0);
+            m_rootGradientValue->Data()->SetValue(m_lossScale);
         else if (aggregateDataType == DataType::Float16)
-            m_rootGradientValue->Data()->SetValue(float16(1.0));
+            m_rootGradientValue->Data()->SetValue(float16(m_lossScale));
         else
             RuntimeError("DataType %s is not supported for root gradients", DataTypeName(aggregateDataType));
 
         for (const auto& parameter : m_learnerParameters)
             parameterGradients[parameter] = nullptr;
 
+        // Gradient accumulation: after the first minibatch of a window, Backward adds to the parameter gradients in place
+        auto compositeFunction = dynamic_cast<CompositeFunction*>(m_combinedTrainingFunction.get());
+        if (compositeFunction)
+            compositeFunction->SetAccumulateParameterGradients(m_accumulatedNumSamples > 0);
+        else if (m_accumulatedNumSamples > 0)
+            RuntimeError("Combined training function is not a CompositeFunction.");
+
         // TODO: Why Backward signature does not take Parameter instead of Variable for gradients?
         m_combinedTrainingFunction->Backward(backPropSate, { { m_aggregatedLossFunction, m_rootGradientValue } }, parameterGradients);
         m_prevMinibatchNumSamples = GetSampleCount(m_trainingSampleCountVar, outputs[m_trainingSampleCountVar]);
@@ -407,6 +619,11 @@ namespace CNTK
 
     void Trainer::SaveCheckpoint(const std::wstring& modelFilePath, Dictionary externalState)
     {
+        // the partial sums of the gradients live in the network only, and are not part of the checkpoint
+        if (m_numAccumulatedMicroBatches != 0)
+            RuntimeError("Trainer: cannot save a checkpoint in the middle of a gradient accumulation window (%zu of %zu minibatches accumulated); "
+                         "save it after a multiple of %zu minibatches.", m_numAccumulatedMicroBatches, m_gradientAccumulationMicroBatches, m_gradientAccumulationMicroBatches);
+
         auto learnersState = m_parameterLearners->CreateCheckpoint();
 
         if (!m_distributed)
@@ -478,6 +695,7 @@ namespace CNTK
         auto externalState = checkpoint[externalStatePropertyName].Value<Dictionary>();
 
         m_parameterLearners->RestoreFromCheckpoint(learnerState);
+        ResetGradientAccumulation();
 
         if (!m_distributed)
         {
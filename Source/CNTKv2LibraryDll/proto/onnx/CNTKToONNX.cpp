@@ -17,7 +17,13 @@
 #include <vector>
 #include <tuple>
 #include <numeric>
+#include <algorithm>
 #include <iostream>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <functional>
 #include "RNNHelper.h"
 #include "Matrix.h"
 #include "ConvolveGeometry.h"
@@ -30,10 +36,8 @@ using namespace CNTK;
 using namespace onnxruntime;
 using namespace onnx;
 
-// parameters in an ONNX model can be saved in external files. 
-// use this limit so that small parameters are not saved into
-// external files to avoid too many external files for a model.
-// update related code once parameters can be saved into a single external file.
+// parameters in an ONNX model can be saved in an external data file.
+// use this limit so that small parameters stay in the model file.
 const size_t ParameterSizeForExternalLocation = 1024;
 namespace CNTK
 {
@@ -751,6 +755,15 @@ private:
                                                                 std::unordered_map<Variable, onnxruntime::Node*>& variableNodes,
                                                                 std::vector<ScanLoop> &scanLoops, int createLoopIndex);
     //
+    // Takes CNTK's ScaledDotProductAttention node and converts it into a series of
+    // Transpose+MatMul+Mul(+Add)+Softmax+MatMul nodes on the ONNX side.
+    //
+    static onnxruntime::Node* CreateONNXNodesForScaledDotProductAttention(const FunctionPtr &src,
+                                                                          onnxruntime::Graph* graph,
+                                                                          std::unordered_map<FunctionPtr, onnxruntime::Node*>& functionNodes,
+                                                                          std::unordered_map<Variable, onnxruntime::Node*>& variableNodes,
+                                                                          std::vector<ScanLoop> &scanLoops, int createLoopIndex);
+    //
     // Takes CNTK's OptimizedRNNStack node and converts it into a series of RNN/LSTM/GRU nodes
     // on the ONNX side.
     //
@@ -1056,36 +1069,19 @@ onnxruntime::Graph* CNTKToONNXHelper::globalGraph = nullptr;
 
 } // namespace CNTK
 
-// convert tensor to raw data and save to an external file if required.
-void ConvertTensorToRawDataAndSave(std::string folder, TensorProto* tensor, bool useDataLocationExternal)
+// convert tensor to raw data. The typed copy of the data is released right away.
+static void ConvertTensorToRawData(TensorProto* tensor)
 {
     // tensor of bools are stored as int32. however it could be treated as either 1, 8, or 32 bits in raw format.
     // to avoid this uncertainty, tensor of boolean type is not to be converted to raw data. 
     if (tensor->data_type() == TensorProto_DataType_BOOL)
         return;
 
-    FILE* fp = nullptr;
-    std::string tensorName = tensor->name();
-    if (useDataLocationExternal)
-    {
-        const std::string illegalChars = "\\/:?\"<>|";
-        for (int i = 0; i < tensorName.size(); i++)
-            if (illegalChars.find(tensorName[i]) != std::string::npos)
-                tensorName[i] = '_';
-
-        std::string tensorPath = folder + "/" + tensorName;
-
-        _wfopen_s(&fp, ToFixedWString(tensorPath).c_str(), L"wb");
-    }
-
     std::string errMsg = "tensor data type not supported for external localtion storage";
     switch (tensor->data_type())
     {
     case TensorProto_DataType_FLOAT:
-        if (fp)
-            fwrite(tensor->float_data().data(), sizeof(float), tensor->float_data_size(), fp);
-        else
-            tensor->set_raw_data(tensor->float_data().data(), sizeof(float) * tensor->float_data_size());
+        tensor->set_raw_data(tensor->float_data().data(), sizeof(float) * tensor->float_data_size());
         tensor->clear_float_data();
         break;
     case TensorProto_DataType_UINT8:
@@ -1094,17 +1090,11 @@ void ConvertTensorToRawDataAndSave(std::string folder, TensorProto* tensor, bool
     case TensorProto_DataType_INT16:
         CNTK::LogicError("%s", errMsg.c_str());
     case TensorProto_DataType_INT32:
-        if (fp)
-            fwrite(tensor->int32_data().data(), sizeof(int32_t), tensor->int32_data_size(), fp);
-        else
-            tensor->set_raw_data(tensor->int32_data().data(), sizeof(int32_t) * tensor->int32_data_size());
+        tensor->set_raw_data(tensor->int32_data().data(), sizeof(int32_t) * tensor->int32_data_size());
         tensor->clear_int32_data();
         break;
     case TensorProto_DataType_INT64:
-        if (fp)
-            fwrite(tensor->int64_data().data(), sizeof(int64_t), tensor->int64_data_size(), fp);
-        else
-            tensor->set_raw_data(tensor->int64_data().data(), sizeof(int64_t) * tensor->int64_data_size());
+        tensor->set_raw_data(tensor->int64_data().data(), sizeof(int64_t) * tensor->int64_data_size());
         tensor->clear_int64_data();
         break;
     case TensorProto_DataType_STRING:
@@ -1116,18 +1106,12 @@ void ConvertTensorToRawDataAndSave(std::string folder, TensorProto* tensor, bool
         std::vector<uint16_t> h(tensor->int32_data_size());
         for (int i = 0; i < tensor->int32_data_size(); i++)
             h[i] = static_cast<uint16_t>(tensor->int32_data(i));
-        if (fp)
-            fwrite(&h[0], sizeof(uint16_t), tensor->int32_data_size(), fp);
-        else
-            tensor->set_raw_data(&h[0], sizeof(uint16_t) * tensor->int32_data_size());
+        tensor->set_raw_data(h.data(), sizeof(uint16_t) * h.size());
         tensor->clear_int32_data();
     }
     break;
     case TensorProto_DataType_DOUBLE:
-        if (fp)
-            fwrite(tensor->double_data().data(), sizeof(double), tensor->double_data_size(), fp);
-        else
-            tensor->set_raw_data(tensor->double_data().data(), sizeof(double) * tensor->double_data_size());
+        tensor->set_raw_data(tensor->double_data().data(), sizeof(double) * tensor->double_data_size());
         tensor->clear_double_data();
         break;
     case TensorProto_DataType_UINT32:
@@ -1137,23 +1121,126 @@ void ConvertTensorToRawDataAndSave(std::string folder, TensorProto* tensor, bool
     case TensorProto_DataType_BFLOAT16:
         CNTK::LogicError("%s", errMsg.c_str());
     }
+}
+
+// Writes the data of externally stored tensors into a single side file next to the model.
+// Following the ONNX external data format, every tensor records the file 'location' and the 'offset' and 'length'
+// of its bytes within that file. The tensors are converted to raw data in parallel, laid out one after the other
+// in the order they are given, and then written in parallel, each through its own file handle at its own offset.
+class ExternalTensorDataWriter
+{
+public:
+    ExternalTensorDataWriter(const std::string& folder, const std::string& location)
+        : m_path(folder + "/" + location), m_location(location)
+    {}
+
+    void Write(const std::vector<TensorProto*>& tensors)
+    {
+        // tensor of bools are not converted to raw data (see ConvertTensorToRawData), they stay in the model
+        std::vector<TensorProto*> externalTensors;
+        for (auto tensor : tensors)
+            if (tensor->data_type() != TensorProto_DataType_BOOL)
+                externalTensors.push_back(tensor);
+        if (externalTensors.empty())
+            return;
+
+        ParallelFor(externalTensors.size(), [&](size_t i) { ConvertTensorToRawData(externalTensors[i]); });
+
+        std::vector<size_t> offsets;
+        size_t offset = 0;
+        for (auto tensor : externalTensors)
+        {
+            size_t size = tensor->raw_data().size();
+            AddEntry(tensor, "location", m_location);
+            AddEntry(tensor, "offset", std::to_string(offset));
+            AddEntry(tensor, "length", std::to_string(size));
+            tensor->set_data_location(onnx::TensorProto_DataLocation_EXTERNAL);
+            offsets.push_back(offset);
+            offset += size;
+        }
+
+        // create (or truncate) the file, so that the writers below can all open it for update
+        FILE* file = OpenFile(L"wb");
+        if (fclose(file) != 0)
+            CNTK::RuntimeError("Failed to create '%s' for writing the model parameters.", m_path.c_str());
+
+        ParallelFor(externalTensors.size(), [&](size_t i) {
+            TensorProto* tensor = externalTensors[i];
+            const std::string& data = tensor->raw_data();
+            FILE* fp = OpenFile(L"r+b");
+            bool written = _fseeki64(fp, (int64_t)offsets[i], SEEK_SET) == 0 && fwrite(data.data(), 1, data.size(), fp) == data.size();
+            if (fclose(fp) != 0 || !written)
+                CNTK::RuntimeError("Failed to write the data of tensor '%s' to '%s'.", tensor->name().c_str(), m_location.c_str());
+            tensor->clear_raw_data();
+        });
+    }
 
-    if (useDataLocationExternal)
+private:
+    FILE* OpenFile(const wchar_t* mode) const
     {
-        onnx::StringStringEntryProto* location = tensor->mutable_external_data()->Add();
-        location->set_key("location");
-        location->set_value(ToMBString(tensorName));
-        tensor->set_data_location(onnx::TensorProto_DataLocation_EXTERNAL);
-        if (fp)
-            fclose(fp);
+        FILE* fp = nullptr;
+        _wfopen_s(&fp, ToFixedWString(m_path).c_str(), mode);
+        if (!fp)
+            CNTK::RuntimeError("Failed to open '%s' for writing the model parameters.", m_path.c_str());
+        return fp;
     }
-}
+
+    // Runs body(0), ..., body(count - 1) on up to one thread per core. The first exception thrown by 'body'
+    // is rethrown on the calling thread once all threads are done.
+    static void ParallelFor(size_t count, const std::function<void(size_t)>& body)
+    {
+        size_t numThreads = std::min<size_t>(count, std::max(1u, std::thread::hardware_concurrency()));
+        std::atomic<size_t> next(0);
+        std::exception_ptr error;
+        std::mutex errorLock;
+        auto worker = [&]() {
+            for (size_t i = next++; i < count; i = next++)
+            {
+                try
+                {
+                    body(i);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(errorLock);
+                    if (!error)
+                        error = std::current_exception();
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (size_t t = 1; t < numThreads; t++)
+            threads.emplace_back(worker);
+        worker();
+        for (auto& thread : threads)
+            thread.join();
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    static void AddEntry(TensorProto* tensor, const std::string& key, const std::string& value)
+    {
+        onnx::StringStringEntryProto* entry = tensor->mutable_external_data()->Add();
+        entry->set_key(key);
+        entry->set_value(value);
+    }
+
+    std::string m_path;
+    std::string m_location;
+};
 
 void ConvertInitializerTensorsToRawDataAndSaveExternalFiles(Graph *graph, const std::wstring& wFilepath, 
     bool useExternalFilesToStoreParameters)
 {
+    // all externally stored parameters go to '<model file name>.data' in the folder of the model
     std::string filepath = ToLegacyString(ToUTF8(wFilepath));
-    std::string folder = useExternalFilesToStoreParameters ? GetRootPath(filepath) : "";
+    std::string folder = GetRootPath(filepath);
+    std::replace(filepath.begin(), filepath.end(), '\\', '/');
+    std::string location = filepath.substr(filepath.find_last_of('/') + 1) + ".data";
+
+    std::vector<TensorProto*> externalTensors;
     InitializedTensorSet& initializedTensorSet = const_cast<InitializedTensorSet&>(graph->GetAllInitializedTensors());
     for (InitializedTensorSet::iterator it = initializedTensorSet.begin(); it != initializedTensorSet.end(); ++it)
     {
@@ -1161,9 +1248,13 @@ void ConvertInitializerTensorsToRawDataAndSaveExternalFiles(Graph *graph, const
         int64_t dataSize = 1;
         for (int i = 0; i < tensor->dims_size(); i++)
             dataSize *= tensor->dims(i);
-        bool useExternalLocationForThisTensor = useExternalFilesToStoreParameters && dataSize > ParameterSizeForExternalLocation;
-        ConvertTensorToRawDataAndSave(folder, tensor, useExternalLocationForThisTensor);
+        if (useExternalFilesToStoreParameters && dataSize > ParameterSizeForExternalLocation)
+            externalTensors.push_back(tensor);
+        else
+            ConvertTensorToRawData(tensor);
     }
+
+    ExternalTensorDataWriter(folder, location).Write(externalTensors);
 }
 
 std::unique_ptr<onnxruntime::Model> CNTKToONNX::CreateModel(const FunctionPtr& src, const std::wstring& filepath,
@@ -2076,7 +2167,8 @@ std::vector<int64_t> CNTKToONNXHelper::ToINTS(const std::vector<int>& shape,
 bool IsUnSupportedLayerNormalization(const FunctionPtr src)
 {
     std::string cntkOpName = ToLegacyString(ToUTF8(src->OpName()));
-    return cntkOpName == "LayerNormalization" && src->Output().HasSequenceAxis();
+    // the primitive LayerNormalization normalizes over the static axes only, so it has no such restriction
+    return cntkOpName == "LayerNormalization" && src->IsBlock() && src->Output().HasSequenceAxis();
 }
 
 bool CNTKToONNXHelper::CheckCorrectTransposeAxisToSkipForSequenceAxisOpWrapper(FunctionPtr currentOp)
@@ -5582,6 +5674,11 @@ onnxruntime::Node* CNTKToONNXHelper::CreateNode(const FunctionPtr& src,
         return CreateONNXNodesForStraightThrough(src, graph, functionNodes, variableNodes,
                                                  scanLoops, createLoopIndex);
     }
+    else if (cntkOpName == "ScaledDotProductAttention")
+    {
+        return CreateONNXNodesForScaledDotProductAttention(src, graph, functionNodes, variableNodes,
+                                                           scanLoops, createLoopIndex);
+    }
     else if (cntkOpName == "OneHotOp")
     {
         return CreateONNXNodesForOneHotOp(src, graph, functionNodes, variableNodes,
@@ -7058,6 +7155,8 @@ void CNTKToONNXHelper::CopyAttributes(const FunctionPtr& src, onnxruntime::Node*
         // Some nodes map one to many.
         if (src->OpName() == L"Convolution")
         {
+            if (src->Attributes().Contains(L"binary") && (bool)src->Attributes()[L"binary"].Value<bool>())
+                RuntimeError("Exporting binary convolution to ONNX is not supported.");
             AssignConvAttributes(src, node);
         }
         else if (src->OpName() == L"Pooling" || src->OpName() == L"Unpooling")
@@ -7558,7 +7657,9 @@ onnxruntime::Node* CNTKToONNXHelper::AddNode(const FunctionPtr& src, onnxruntime
                                                          "", {input0}, {&mvnTensorOutputArg});
             std::vector<int64_t> axes;
             size_t input0Rank = ToINTS(input0ArgType).size();
-            for (size_t i = 0; i < input0Rank; ++i) axes.push_back(static_cast<int64_t>(i));
+            // The primitive op (unlike the layer block) normalizes each sample separately, so leave out the dynamic axes.
+            size_t firstAxis = src->IsBlock() ? 0 : input0Rank - src->Inputs()[operandIndexInCntkInputs].Shape().Rank();
+            for (size_t i = firstAxis; i < input0Rank; ++i) axes.push_back(static_cast<int64_t>(i));
             mvnNode->AddAttribute("axes", axes);
 
             auto input1 = inputs[scaleIndexInOnnxInputs];
@@ -7971,6 +8072,97 @@ onnxruntime::Node* CNTKToONNXHelper::CreateONNXNodesForStraightThrough(const Fun
     return subNode;
 }
 
+onnxruntime::Node* CNTKToONNXHelper::CreateONNXNodesForScaledDotProductAttention(const FunctionPtr &src,
+                                                                                 onnxruntime::Graph* graph,
+                                                                                 std::unordered_map<FunctionPtr, onnxruntime::Node*>& functionNodes,
+                                                                                 std::unordered_map<Variable, onnxruntime::Node*>& variableNodes,
+                                                                                 std::vector<ScanLoop> &scanLoops, int createLoopIndex)
+{
+    // This method exports CNTK's fused attention op through an ONNX sub-graph. With the reversed axis order
+    // on the ONNX side, query, key, and value are [..., (numHeads,) T, dim] tensors, and
+    // ScaledDotProductAttention(Q, K, V) = MatMul(Softmax(MatMul(Q, Transpose(K)) * scale (+ causalMask)), V)
+    // where the causal mask is 0 for visible and -1e9 for hidden keys.
+    std::vector<onnxruntime::NodeArg*> inputs;
+    ProcessInputs(src, graph, functionNodes, variableNodes, inputs,
+                  scanLoops, createLoopIndex);
+
+    std::vector<onnxruntime::NodeArg*> outputs;
+    ProcessOutputs(src, inputs, outputs, graph);
+
+    const std::string& nodeName = UniqueNodeNameStorage::GetUniqueNodeName(src);
+    const auto& query = src->Inputs()[0];
+    const auto& key = src->Inputs()[1];
+    const size_t dimQK = query.Shape()[0];
+    const size_t numQueries = query.Shape()[1];
+    const size_t numKeys = key.Shape()[1];
+    double scale = src->Attributes()[L"scale"].Value<double>();
+    if (scale == 0)
+        scale = 1 / sqrt((double)dimQK);
+    const bool causal = src->Attributes()[L"causal"].Value<bool>();
+
+    // swap the last two axes of the key
+    const int64_t rank = (int64_t)key.Shape().Rank() + (key.HasBatchAxis() ? 1 : 0) + (key.HasSequenceAxis() ? 1 : 0);
+    std::vector<int64_t> perm(rank);
+    std::iota(perm.begin(), perm.end(), 0);
+    std::swap(perm[rank - 1], perm[rank - 2]);
+    onnxruntime::NodeArg& transposeOutputArg = graph->GetOrCreateNodeArg(UniqueNodeNameStorage::GetUniqueNodeNameWithoutUid(nodeName + "_key_transpose_out"), nullptr);
+    onnxruntime::Node* transposeNode = &graph->AddNode(UniqueNodeNameStorage::GetUniqueNodeNameWithoutUid(nodeName + "_key_transpose"),
+                                                       "Transpose", "", {inputs[1]}, {&transposeOutputArg});
+    transposeNode->AddAttribute("perm", perm);
+
+    onnxruntime::NodeArg& scoresOutputArg = graph->GetOrCreateNodeArg(UniqueNodeNameStorage::GetUniqueNodeNameWithoutUid(nodeName + "_scores_out"), nullptr);
+    graph->AddNode(UniqueNodeNameStorage::GetUniqueNodeNameWithoutUid(nodeName + "_scores"),
+                   "MatMul", "", {inputs[0], &transposeOutputArg}, {&scoresOutputArg});
+
+    onnxruntime::NodeArg& scalarScaleOutputArg = CreateScalarNode(graph, UniqueNodeNameStorage::GetUniqueNodeNameWithoutUid(nodeName + "_scale_out"),
+                                                                  query.GetDataType(), scale);
+    onnxruntime::NodeArg* scaledOutputArg = &graph->GetOrCreateNodeArg(UniqueNodeNameStorage::GetUniqueNodeNameWithoutUid(nodeName + "_scaled_out"), nullptr);
+    graph->AddNode(UniqueNodeNameStorage::GetUniqueNodeNameWithoutUid(nodeName + "_mul"),
+                   "Mul", "", {&scoresOutputArg, &scalarScaleOutputArg}, {scaledOutputArg});
+
+    if (causal)
+    {
+        // [numQueries x numKeys] additive mask, broadcast over heads and dynamic axes
+        const size_t offset = numKeys - numQueries;
+        const std::string maskName = UniqueNodeNameStorage::GetUniqueNodeNameWithoutUid(nodeName + "_mask");
+        onnxruntime::NodeArg* maskArg = nullptr;
+        if (query.GetDataType() == DataType::Double)
+        {
+            std::vector<double> mask(numQueries * numKeys);
+            for (size_t i = 0; i < numQueries; i++)
+                for (size_t j = 0; j < numKeys; j++)
+                    mask[i * numKeys + j] = (j <= i + offset) ? 0 : -1e9;
+            maskArg = &AddConstantNodeArg(graph, maskName, mask, onnx::TensorProto_DataType_DOUBLE);
+        }
+        else
+        {
+            std::vector<float> mask(numQueries * numKeys);
+            for (size_t i = 0; i < numQueries; i++)
+                for (size_t j = 0; j < numKeys; j++)
+                    mask[i * numKeys + j] = (j <= i + offset) ? 0 : -1e9f;
+            maskArg = &AddConstantNodeArg(graph, maskName, mask, onnx::TensorProto_DataType_FLOAT);
+        }
+        onnxruntime::Node* maskReshapeNode = AddReshapeNode(*maskArg, {(int64_t)numQueries, (int64_t)numKeys},
+                                                            UniqueNodeNameStorage::GetUniqueNodeNameWithoutUid(nodeName + "_mask_reshaped"), graph);
+
+        onnxruntime::NodeArg* maskedOutputArg = &graph->GetOrCreateNodeArg(UniqueNodeNameStorage::GetUniqueNodeNameWithoutUid(nodeName + "_masked_out"), nullptr);
+        graph->AddNode(UniqueNodeNameStorage::GetUniqueNodeNameWithoutUid(nodeName + "_add_mask"),
+                       "Add", "", {scaledOutputArg, const_cast<NodeArg*>(maskReshapeNode->OutputDefs()[0])}, {maskedOutputArg});
+        scaledOutputArg = maskedOutputArg;
+    }
+
+    onnxruntime::NodeArg& softmaxOutputArg = graph->GetOrCreateNodeArg(UniqueNodeNameStorage::GetUniqueNodeNameWithoutUid(nodeName + "_softmax_out"), nullptr);
+    onnxruntime::Node* softmaxNode = &graph->AddNode(UniqueNodeNameStorage::GetUniqueNodeNameWithoutUid(nodeName + "_softmax"),
+                                                     "Softmax", "", {scaledOutputArg}, {&softmaxOutputArg});
+    softmaxNode->AddAttribute("axis", rank - 1);
+
+    onnxruntime::Node* outputNode = &graph->AddNode(UniqueNodeNameStorage::GetUniqueNodeNameWithoutUid(nodeName + "_matmul"),
+                                                    "MatMul", "", {&softmaxOutputArg, inputs[2]}, {outputs[0]});
+
+    functionNodes.emplace(src, outputNode);
+    return outputNode;
+}
+
 onnxruntime::Node* CNTKToONNXHelper::CreateONNXNodesForOptimizedRNNStack(const FunctionPtr &src,
                                                                          onnxruntime::Graph* graph,
                                                                          std::unordered_map<FunctionPtr, onnxruntime::Node*>& functionNodes,
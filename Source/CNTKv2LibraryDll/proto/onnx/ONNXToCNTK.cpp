@@ -10,6 +10,7 @@
 #include "Operators.h"
 #include <algorithm>
 #include <iostream>
+#include <fstream>
 #include "RNNHelper.h"
 #include "ONNXToCNTK.h"
 
@@ -46,6 +47,8 @@ private:
     static Constant CreateConstant(const Node *node, const DeviceDescriptor &computeDevice);
     static Constant CreateConstant(const onnx::TensorProto &valueProto, const std::string &nodeName,
                                    const DeviceDescriptor &computeDevice);
+    static Constant CreateConstantFromLoadedTensor(const onnx::TensorProto &valueProto, const std::string &nodeName,
+                                                   const DeviceDescriptor &computeDevice);
     template <typename TDst, typename TSrc>
     static const CNTK::Constant CreateConstantWithTensorData(CNTK::NDShape &shape, google::protobuf::int32 tensorProtoDataType,
                                                              CNTK::DataType cntkDataType, const TSrc *srcData, CNTK::NDShape &reversedShape,
@@ -457,31 +460,67 @@ int64_t GetTensorElementTotal(const onnx::TensorProto &tensor_proto)
     return count;
 }
 
-void LoadRawDataAndUnpack(onnx::TensorProto &tensor_proto, bool doUnpack)
+// Read the bytes of a tensor stored in an external data file. With 'offset' and 'length' entries (one data file shared
+// by all tensors), only the tensor's own range is read; otherwise the file holds just this tensor.
+static void LoadExternalRawData(onnx::TensorProto &tensor_proto)
 {
-    if (tensor_proto.data_location() == TensorProto_DataLocation_EXTERNAL && tensor_proto.raw_data().empty())
+    std::string location;
+    size_t offset = 0;
+    size_t length = SIZE_MAX;
+    for (const auto& entry : tensor_proto.external_data())
     {
-        ::google::protobuf::RepeatedPtrField<::onnx::StringStringEntryProto> external_data = tensor_proto.external_data();
-        ::google::protobuf::RepeatedPtrField<::onnx::StringStringEntryProto>::iterator it =
-            std::find_if(external_data.begin(), external_data.end(), [](const ::onnx::StringStringEntryProto& StringStringEntryProto)
-        {
-            return StringStringEntryProto.has_key() && StringStringEntryProto.key() == "location";
-        });
-        if (it != external_data.end())
-        {
-            std::string filename = it->value();
-            std::string raw_data_from_file;
+        if (entry.key() == "location")
+            location = entry.value();
+        else if (entry.key() == "offset")
+            offset = std::stoull(entry.value());
+        else if (entry.key() == "length")
+            length = std::stoull(entry.value());
+    }
+    if (location.empty())
+        return;
+
+    std::string path = ONNXToCNTKHelper::model_location_ + "/" + location;
 #ifdef _WIN32
-            Env::Default().ReadFileAsString(ToFixedWString(ONNXToCNTKHelper::model_location_ + "/" + filename).c_str(), &raw_data_from_file);
+    std::ifstream file(ToFixedWString(path), std::ios::binary);
 #else
-            Env::Default().ReadFileAsString((ONNXToCNTKHelper::model_location_ + "/" + filename).c_str(), &raw_data_from_file);
+    std::ifstream file(path, std::ios::binary);
 #endif
-            const void* raw_data = raw_data_from_file.data();
-            size_t raw_data_len = raw_data_from_file.size();
-            tensor_proto.set_raw_data(raw_data, raw_data_len);
-        }
+    if (!file)
+        RuntimeError("Failed to open the external data file '%s' of tensor '%s'.", path.c_str(), tensor_proto.name().c_str());
+
+    if (length == SIZE_MAX)
+    {
+        file.seekg(0, std::ios::end);
+        length = (size_t)file.tellg() - offset;
     }
 
+    std::string raw_data_from_file(length, '\0');
+    file.seekg(offset);
+    if (!file.read(&raw_data_from_file[0], length))
+        RuntimeError("Failed to read %llu bytes at offset %llu of '%s' for tensor '%s'.", (unsigned long long)length, (unsigned long long)offset, path.c_str(), tensor_proto.name().c_str());
+    tensor_proto.set_raw_data(std::move(raw_data_from_file));
+}
+
+// Externally stored tensors are loaded on demand. Once their data has been copied into a CNTK constant, the in-memory
+// copy is dropped again, so that importing a model holds at most one external tensor at a time; should the tensor be
+// needed again, it is simply reloaded.
+static void ReleaseExternalData(onnx::TensorProto &tensor_proto)
+{
+    if (tensor_proto.data_location() != TensorProto_DataLocation_EXTERNAL)
+        return;
+
+    tensor_proto.clear_raw_data();
+    tensor_proto.clear_float_data();
+    tensor_proto.clear_double_data();
+    tensor_proto.clear_int32_data();
+    tensor_proto.clear_int64_data();
+}
+
+void LoadRawDataAndUnpack(onnx::TensorProto &tensor_proto, bool doUnpack)
+{
+    if (tensor_proto.data_location() == TensorProto_DataLocation_EXTERNAL && tensor_proto.raw_data().empty())
+        LoadExternalRawData(tensor_proto);
+
     // unpack
     if (!doUnpack)
         return;
@@ -535,6 +574,16 @@ void LoadRawDataAndUnpack(onnx::TensorProto &tensor_proto, bool doUnpack)
 
 Constant ONNXToCNTKHelper::CreateConstant(const onnx::TensorProto &valueProto, const std::string &nodeName,
                                           const DeviceDescriptor &computeDevice)
+{
+    onnx::TensorProto &tensorProto = const_cast<onnx::TensorProto &>(valueProto);
+    LoadRawDataAndUnpack(tensorProto, false);
+    Constant constant = CreateConstantFromLoadedTensor(valueProto, nodeName, computeDevice);
+    ReleaseExternalData(tensorProto);
+    return constant;
+}
+
+Constant ONNXToCNTKHelper::CreateConstantFromLoadedTensor(const onnx::TensorProto &valueProto, const std::string &nodeName,
+                                                          const DeviceDescriptor &computeDevice)
 {
     auto tensorProtoDataType = valueProto.data_type();
 
@@ -475,6 +475,9 @@ namespace ONNX
         { L"StraightThrough",{ {
             { L"StraightThrough", "StraightThrough" },
         } } },
+        { L"ScaledDotProductAttention",{ {
+            { L"ScaledDotProductAttention", "ScaledDotProductAttention" },
+        } } },
         { L"LogPlus",{ {
             { L"LogPlus", "LogPlus" },
         } } },
@@ -653,7 +656,12 @@ namespace ONNX
             std::regex trailer("/+$");
             std::string root = std::regex_replace(rootPath_, trailer, std::string());
 
-            std::string folder = root.substr(0, root.find_last_of('/'));
+            // a bare file name refers to the current directory
+            size_t pos = root.find_last_of('/');
+            if (pos == std::string::npos)
+                return ".";
+
+            std::string folder = root.substr(0, pos);
 
             return folder;
         }
@@ -16,6 +16,10 @@ namespace Microsoft { namespace MSR { namespace CNTK {
 
     std::atomic<bool> Globals::m_enableShareNodeValueMatrices(true);
     std::atomic<bool> Globals::m_optimizeGradientAccumulation(true);
+    std::atomic<bool> Globals::m_recomputeActivations(false);
+    std::atomic<bool> Globals::m_compressActivations(false);
+    std::atomic<bool> Globals::m_lossyActivationCompression(false);
+    std::atomic<std::size_t> Globals::m_numActivationStashes(0);
     std::atomic<bool> Globals::m_enableNodeTiming(false);
     std::atomic<bool> Globals::m_useV2Aggregator(false);
     std::atomic<std::size_t> Globals::m_mpiPackThresholdInBytes(DEFAULT_PACK_THRESHOLD_SIZE_IN_BYTES);
@@ -28,6 +28,19 @@ namespace Microsoft { namespace MSR { namespace CNTK {
         static void SetShareNodeValueMatrices(bool enable) { m_enableShareNodeValueMatrices = enable; }
         static bool ShouldEnableShareNodeValueMatrices() { return m_enableShareNodeValueMatrices; }
 
+        // release intermediate values after forward prop and recompute them segment by segment during backprop
+        static void SetActivationRecomputation(bool enable) { m_recomputeActivations = enable; }
+        static bool ShouldRecomputeActivations() { return m_recomputeActivations; }
+
+        // keep compact encodings of activations for backprop (e.g. one bit per ReLU output) instead of the full values;
+        // 'lossy' additionally stashes smooth activations (sigmoid, tanh, ...) in fp16
+        static void SetActivationCompression(bool enable, bool lossy = false) { m_compressActivations = enable; m_lossyActivationCompression = enable && lossy; }
+        static bool ShouldCompressActivations() { return m_compressActivations; }
+        static bool ShouldCompressActivationsLossy() { return m_lossyActivationCompression; }
+        // number of node outputs stashed in compressed form by forward prop so far (for testing)
+        static void CountActivationStash() { m_numActivationStashes++; }
+        static std::size_t GetNumActivationStashes() { return m_numActivationStashes; }
+
         static void SetNodeTiming(bool enable) { m_enableNodeTiming = enable; }
         static bool ShouldEnableNodeTiming() { return m_enableNodeTiming; }
 
@@ -39,6 +52,10 @@ namespace Microsoft { namespace MSR { namespace CNTK {
         static std::atomic<bool> m_enableShareNodeValueMatrices;
         static std::atomic<bool> m_forceConstantRandomSeed;
         static std::atomic<bool> m_optimizeGradientAccumulation;
+        static std::atomic<bool> m_recomputeActivations;
+        static std::atomic<bool> m_compressActivations;
+        static std::atomic<bool> m_lossyActivationCompression;
+        static std::atomic<std::size_t> m_numActivationStashes;
         static std::atomic<bool> m_enableNodeTiming;
         static std::atomic<bool> m_useV2Aggregator;
         static std::atomic<std::size_t> m_mpiPackThresholdInBytes;
@@ -109,7 +109,7 @@ struct MBLayout
     // -------------------------------------------------------------------
 
     MBLayout(size_t numParallelSequences, size_t numTimeSteps, const std::wstring &name)
-        : m_distanceToStart(CPUDEVICE), m_distanceToEnd(CPUDEVICE), m_columnsValidityMask(CPUDEVICE), m_rightSplice(0)
+        : m_distanceToStart(CPUDEVICE), m_distanceToEnd(CPUDEVICE), m_rightSplice(0)
     {
         Init(numParallelSequences, numTimeSteps);
         SetUniqueAxisName(name != L"" ? name : L"DynamicAxis");
@@ -139,7 +139,7 @@ struct MBLayout
 
         m_timeStepHasGap = other->m_timeStepHasGap;
 
-        m_columnsValidityMask.SetValue(other->m_columnsValidityMask);
+        m_columnsValidityMask = other->m_columnsValidityMask; // immutable, can be shared
         m_writable = other->m_writable;
         m_rightSplice = other->m_rightSplice;
 
@@ -191,7 +191,7 @@ public:
             m_distanceToNearestEnd.assign(m_numTimeSteps, PTRDIFF_MAX);
             m_timeStepHasGap.assign(m_numTimeSteps, false);
         }
-        m_columnsValidityMask.Resize(0, 0); // invalidate
+        m_columnsValidityMask.reset(); // invalidate
         // reset state
         m_numFramesDeclared = 0;
         m_numGapFrames = 0;
@@ -636,7 +636,14 @@ private:
     // TODO: We actually just need a boolean matrix for this.
     // A value of 1 indicates that the column has valid content
     // and 0 indicates invalid (aka MinibatchPackingFlags::NoInput)
-    mutable Matrix<char> m_columnsValidityMask;
+    // The mask is never modified once created. It is shared by copies of this layout,
+    // and by all layouts with the same gap structure on the same device (see GetOrCreateColumnsValidityMask()).
+    mutable std::shared_ptr<Matrix<char>> m_columnsValidityMask;
+
+    // Returns the validity mask for this layout on the given device. Readers create a new layout for
+    // every minibatch, but the gap structure tends to repeat (e.g. fixed-length sequences, or truncated
+    // BPTT with a constant width), so masks are kept in a small process-wide cache keyed by the device and that structure.
+    std::shared_ptr<Matrix<char>> GetOrCreateColumnsValidityMask(DEVICEID_TYPE deviceId) const;
 
     // A boolean flag indicating whether the MBLayout can be further modified
     // When it's value is false, no set operations are allowed on the MBLayout.
@@ -943,46 +950,18 @@ inline size_t MBLayout::GetActualNumSamples() const { return m_numFramesDeclared
 // return m_columnsValidityMask(,), which is lazily created here upon first call
 // only called from MaskMissingColumnsTo()
 // Update: also called from GatherNode::BackpropToNonLooping(). 
-// TODO: Can probably be faster by using the sequence array directly.
-// TODO: Or should we just blast m_distanceToStart to GPU, and maks based on that? It is small compared to features.
+// The mask is shared with other layouts, hence it is looked up again (instead of being moved) if requested for another device.
 inline const Matrix<char>& MBLayout::GetColumnsValidityMask(DEVICEID_TYPE deviceId) const
 {
     CheckIsValid();
     // lazily compute the validity mask
-    if (m_columnsValidityMask.IsEmpty())
+    if (!m_columnsValidityMask || m_columnsValidityMask->GetDeviceId() != deviceId)
     {
         assert(HasGaps() || m_rightSplice != 0); // must only be called if there are gaps
         Lock();
-
-        // Determine indices of all invalid columns in the minibatch
-        // TODO: This can be done more efficiently by using m_sequences[].
-        size_t nT = GetNumTimeSteps();
-        size_t nS = GetNumParallelSequences();
-
-        std::vector<char> columnsValidityMask(nT * nS, 1); // form the mask in a CPU-side STL vector first
-        size_t gapsFound = 0;
-        for (size_t t = 0; t < nT; t++)
-        {
-            FrameRange fr(nullptr, t);
-            if (IsGap(fr))
-            {
-                for (size_t s = 0; s < nS; s++)
-                {
-                    if (IsGap(fr.Sequence(s)))
-                    {
-                        columnsValidityMask[(t * nS) + s] = 0;
-                        gapsFound++;
-                    }
-                }
-            }
-        }
-        assert(gapsFound == m_numGapFrames); // sanity check
-
-        if (deviceId != m_columnsValidityMask.GetDeviceId())
-            m_columnsValidityMask = Matrix<char>(deviceId);
-        m_columnsValidityMask.SetValue(1, nS * nT, deviceId, columnsValidityMask.data());
+        m_columnsValidityMask = GetOrCreateColumnsValidityMask(deviceId);
     }
-    return m_columnsValidityMask;
+    return *m_columnsValidityMask;
 }
 
 // class for defining an iteration over a sequence, forward and backward
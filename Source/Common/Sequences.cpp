@@ -8,10 +8,116 @@
 #endif
 
 #include "Sequences.h"
+#include <list>
+#include <unordered_map>
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
     // Todo: After upgrade to VS2015, remove them after both statics are moved into SetUnqiueAxisName as local static variables.
     std::mutex MBLayout::s_nameIndiciesMutex;
     std::map<std::wstring, size_t> MBLayout::s_nameIndices;
+
+    // Process-wide cache of column validity masks, keyed by [deviceId, nS, nT, (s, tBegin, tEnd) of each gap].
+    // It is allocated on the heap and deliberately never destroyed, since static destructors may run after the
+    // GPU runtime has been shut down, when GPU masks can no longer be freed.
+    class ColumnsValidityMaskCache
+    {
+        typedef std::vector<size_t> Key;
+        typedef std::list<std::pair<Key, std::shared_ptr<Matrix<char>>>> Entries;
+
+        struct KeyHash
+        {
+            size_t operator()(const Key& key) const
+            {
+                size_t hash = key.size();
+                for (auto value : key)
+                    hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+                return hash;
+            }
+        };
+
+        // Maximum number of distinct masks kept in the cache, least recently used ones are dropped first.
+        static const size_t s_capacity = 32;
+
+        std::mutex m_mutex;
+        Entries m_entries; // most recently used first
+        std::unordered_map<Key, Entries::iterator, KeyHash> m_index;
+
+    public:
+        static ColumnsValidityMaskCache& Instance()
+        {
+            static ColumnsValidityMaskCache* instance = new ColumnsValidityMaskCache(); // never deleted, see above
+            return *instance;
+        }
+
+        std::shared_ptr<Matrix<char>> Find(const Key& key)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            auto iter = m_index.find(key);
+            if (iter == m_index.end())
+                return nullptr;
+            m_entries.splice(m_entries.begin(), m_entries, iter->second);
+            return iter->second->second;
+        }
+
+        // Returns the mask that ends up in the cache, which is an existing one if another thread got there first.
+        std::shared_ptr<Matrix<char>> Insert(Key&& key, const std::shared_ptr<Matrix<char>>& mask)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            auto iter = m_index.find(key);
+            if (iter != m_index.end())
+            {
+                m_entries.splice(m_entries.begin(), m_entries, iter->second);
+                return iter->second->second;
+            }
+            m_entries.emplace_front(std::move(key), mask);
+            m_index.emplace(m_entries.front().first, m_entries.begin());
+            if (m_entries.size() > s_capacity)
+            {
+                m_index.erase(m_entries.back().first);
+                m_entries.pop_back();
+            }
+            return mask;
+        }
+    };
+
+    std::shared_ptr<Matrix<char>> MBLayout::GetOrCreateColumnsValidityMask(DEVICEID_TYPE deviceId) const
+    {
+        // The mask only depends on the dimensions and the gaps of the layout, not on the sequence ids.
+        size_t nT = GetNumTimeSteps();
+        size_t nS = GetNumParallelSequences();
+        std::vector<size_t> key{ (size_t)deviceId, nS, nT };
+        for (const auto& seq : m_sequences)
+        {
+            if (seq.seqId != GAP_SEQUENCE_ID)
+                continue;
+            key.push_back(seq.s);
+            key.push_back((size_t)max(seq.tBegin, (ptrdiff_t)0));
+            key.push_back(min(seq.tEnd, nT));
+        }
+
+        auto& cache = ColumnsValidityMaskCache::Instance();
+        auto mask = cache.Find(key);
+        if (mask)
+            return mask;
+
+        // Not seen before: form the mask in a CPU-side STL vector first, straight from the gap ranges, then move it to the device.
+        std::vector<char> columnsValidityMask(nT * nS, 1);
+        size_t gapsFound = 0;
+        for (size_t i = 3; i < key.size(); i += 3)
+        {
+            size_t s = key[i];
+            for (size_t t = key[i + 1]; t < key[i + 2]; t++)
+            {
+                columnsValidityMask[(t * nS) + s] = 0;
+                gapsFound++;
+            }
+        }
+        assert(gapsFound == m_numGapFrames); // sanity check
+        UNUSED(gapsFound);
+
+        mask = std::make_shared<Matrix<char>>(deviceId);
+        mask->SetValue(1, nS * nT, deviceId, columnsValidityMask.data());
+        return cache.Insert(std::move(key), mask);
+    }
 }}}
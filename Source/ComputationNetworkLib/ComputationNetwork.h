@@ -252,7 +252,8 @@ public:
     void ValidateNetwork();
 
 private:
-    size_t ValidateNodes(list<ComputationNodeBasePtr> nodes, bool isFirstPass, bool isFinalValidationPass);
+    size_t ValidateNodes(const vector<ComputationNodeBasePtr>& nodes, bool isFirstPass, bool isFinalValidationPass);
+    bool ValidateNodeInPass(const ComputationNodeBasePtr& node, bool isFirstPass, bool isFinalValidationPass, bool& changed);
     bool ValidateNode(ComputationNodeBasePtr node, bool isFinalValidationPass) const;
     void MarkValueNonSharableNodes();
     void ChangeNodeInputs(ComputationNodeBasePtr fromNode, ComputationNodeBasePtr toNode);
@@ -274,6 +275,11 @@ public:
 private:
     void PrintMemorySharingStructure(const std::vector<ComputationNodeBasePtr>& nodes);
     void ReleaseMatricesAfterEvalForChildren(ComputationNodeBasePtr n, std::unordered_map<ComputationNodeBasePtr, std::unordered_set<ComputationNodeBasePtr>>& parentsMap);
+    std::map<ComputationNodeBasePtr, std::vector<ComputationNodeBasePtr>> FormRecomputationSegments(const ComputationNodeBasePtr& trainRootNode,
+                                                                                                   const std::unordered_map<ComputationNodeBasePtr, std::unordered_set<ComputationNodeBasePtr>>& parentsMap,
+                                                                                                   std::unordered_map<ComputationNodeBasePtr, bool>& outputValueNeededDuringBackProp);
+    void FormActivationStashes(const ComputationNodeBasePtr& trainRootNode,
+                               const std::unordered_map<ComputationNodeBasePtr, std::unordered_set<ComputationNodeBasePtr>>& parentsMap);
 
 public:
     // -----------------------------------------------------------------------
@@ -949,6 +955,10 @@ public:
             node->ZeroGradientsOfInputs();
     }
 
+    // like ZeroInputGradients(), but the gradients of the learnable parameters keep the values of the previous backprop
+    // and the next backprop adds to them (gradient accumulation across minibatches)
+    void ZeroInputGradientsExceptLearnableParameters(const ComputationNodeBasePtr& rootNode);
+
 private:
     bool IsTypicalCriterionNode(ComputationNodeBasePtr nodePtr);
     void PrintComputationTree(const ComputationNodeBasePtr& rootNode, const bool forwardCompute, const bool printMatrices = false);
@@ -1185,6 +1195,7 @@ protected:
         }
 
         static void ForwardProp(const ComputationNodeBasePtr& node, const FrameRange& fr);
+        static void Recompute(const ComputationNodeBasePtr& node, const FrameRange& fr);
         static void PostForwardAndBackProp(const ComputationNodeBasePtr& node);
 
         virtual void BeginForwardProp() override {}
@@ -1212,6 +1223,12 @@ protected:
         // There is currently no other constructor for inner nested PAR-traversed sub-networks, but there will be.
         PARTraversalFlowControlNode(const std::vector<shared_ptr<SEQTraversalFlowControlNode>>& recurrentInfo, const std::list<ComputationNodeBasePtr>& allNodes);
         // Base::m_nestedNodes contains all top-level nodes, in evaluation order
+
+        // activation recomputation: [segment end] -> nodes to recompute (in evaluation order) before backprop enters the segment
+        void SetRecomputationSegments(const std::map<ComputationNodeBasePtr, std::vector<ComputationNodeBasePtr>>& segments) { m_recomputationSegments = segments; }
+
+    private:
+        std::map<ComputationNodeBasePtr, std::vector<ComputationNodeBasePtr>> m_recomputationSegments;
     };
 
 public:
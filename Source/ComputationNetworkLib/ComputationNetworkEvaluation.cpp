@@ -12,12 +12,15 @@
 #include "InputAndParamNodes.h"
 #include "LinearAlgebraNodes.h"
 #include "SpecialPurposeNodes.h"
+#include "TrainingNodes.h"
 #include <string>
 #include <vector>
 #include <list>
 #include <set>
 #include <algorithm>
 #include <map>
+#include <numeric>
+#include <unordered_map>
 
 using namespace std;
 
@@ -89,6 +92,20 @@ void ComputationNetwork::Backprop(const ComputationNodeBasePtr rootNode) // trai
     GetNestedNetwork(rootNode)->Backprop(FrameRange(nullptr), true, true);
 }
 
+// gradient accumulation across minibatches: reset the gradients below rootNode like ZeroInputGradients(), except for
+// the learnable parameters, whose gradients keep the sum of the previous backprops. Their gradient matrices are never
+// reused by their parents (see AllocateAllMatrices()), so that no other gradient holds that sum.
+void ComputationNetwork::ZeroInputGradientsExceptLearnableParameters(const ComputationNodeBasePtr& rootNode)
+{
+    ZeroInputGradients(rootNode);
+
+    for (const auto& node : GetEvalOrder(rootNode))
+    {
+        if (node->NeedsGradient() && (node->OperationName() == OperationNameOf(LearnableParameter)))
+            node->MarkGradientInitialized();
+    }
+}
+
 void ComputationNetwork::FormNestedNetwork(const ComputationNodeBasePtr& rootNode)
 {
     if (m_nestedNetworks.find(rootNode) != m_nestedNetworks.end())
@@ -160,6 +177,17 @@ ComputationNetwork::PARTraversalFlowControlNode::PARTraversalFlowControlNode(con
 }
 
 
+// recompute a node's value that was released after forward prop (activation recomputation)
+// Unlike ForwardProp(), this does not check or bump the time stamp, since the value is logically unchanged.
+/*static*/ void ComputationNetwork::PARTraversalFlowControlNode::Recompute(const ComputationNodeBasePtr& node, const FrameRange& fr)
+{
+    node->BeginForwardProp();
+    node->BeginTiming(false /*backward*/);
+    node->ForwardProp(fr.WithLayout(node->GetMBLayout()));
+    node->EndTiming(false /*backward*/);
+    node->EndForwardProp();
+}
+
 /*virtual*/ void ComputationNetwork::PARTraversalFlowControlNode::ForwardProp(const FrameRange& fr) /*override*/
 {
     for (auto& node : m_nestedNodes)
@@ -185,6 +213,14 @@ ComputationNetwork::PARTraversalFlowControlNode::PARTraversalFlowControlNode(con
     {
         auto& node = *pnode;
 
+        // entering a recomputation segment: bring back the values that were released after forward prop
+        auto recompute = m_recomputationSegments.find(node);
+        if (recompute != m_recomputationSegments.end())
+        {
+            for (auto& recomputeNode : recompute->second)
+                Recompute(recomputeNode, fr);
+        }
+
         node->BeginBackprop();
         node->BeginTiming(true /*backward*/);
         node->Backprop(fr.WithLayout(node->GetMBLayout()), true /*childrenInThisLoop*/, true /*childrenInOuterLoop*/);
@@ -672,6 +708,12 @@ void ComputationNetwork::ResetMBLayouts()
 // validation
 // -----------------------------------------------------------------------
 
+// helper to discover dimension changes
+static pair<TensorShape, bool> GetDims(const ComputationNodeBasePtr& node)
+{
+    return make_pair(node->GetSampleLayout(), node->HasMBLayout());
+}
+
 // validate sub-network needed to evalute a specific output node
 // This calls Validate() on every node in evaluation order (allowing to propagate things forwards through the net).
 // This is called lazily but once only per node until next ClearCache().
@@ -681,7 +723,8 @@ void ComputationNetwork::ValidateNetwork()
     // we call all nodes' Validate() in order to validate, that is, set up MBLayout and FunctionValues dimension
     // A problem is that recurrent loops may require partial validation.
     // Nodes validated on partial input (i.e. some children not yet validated) will be revisited.
-    const auto& nodes = GetEvalOrder(nullptr);
+    const auto& evalOrder = GetEvalOrder(nullptr);
+    const vector<ComputationNodeBasePtr> nodes(evalOrder.begin(), evalOrder.end());
 
     for (auto& node : nodes)
     {
@@ -689,24 +732,89 @@ void ComputationNetwork::ValidateNetwork()
         node->m_needsGradient = node->IsParameterUpdateRequired(); // these get propagated upwards in the following
     }
 
+    // For each node, determine the positions of its consumers in the evaluation order.
+    // A node only needs to be revisited if it could not be validated yet, or if one of its inputs has changed
+    // since it was last validated. Revisiting only those keeps validation close to linear for large graphs.
+    unordered_map<const ComputationNodeBase*, size_t> positionOf;
+    positionOf.reserve(nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++)
+        positionOf[nodes[i].get()] = i;
+    vector<vector<size_t>> consumers(nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        for (const auto& input : nodes[i]->GetInputs())
+        {
+            auto iter = positionOf.find(input.get());
+            if (iter != positionOf.end())
+                consumers[iter->second].push_back(i);
+        }
+    }
+
     // loop and validate until we are done
     // steps:
     //  - validate (not final)          // not final means no dimension checks
-    //    Keep going through the list until all nodes have been validated and all inputs have been validated as well.
+    //    Keep going through the worklist until all nodes have been validated and all inputs have been validated as well.
+    //    The first pass visits all nodes; subsequent passes visit the affected nodes, still in evaluation order.
     //  - validate (final)              // final means consistency checks
     //    Fail if any change during this stage.
     size_t pass = 1;
-    size_t toValidate = nodes.size();
-    while (toValidate > 0)
+    vector<size_t> worklist(nodes.size());
+    iota(worklist.begin(), worklist.end(), 0);
+    vector<bool> scheduled(nodes.size(), false);
+    while (!worklist.empty())
     {
         if (TraceLevel() > 0)
-        fprintf(stderr, "\nValidating network. %d nodes to process in pass %d.\n\n", (int) toValidate, (int) pass);
-        toValidate = ValidateNodes(nodes, /*isFirstPass=*/pass == 1, false /*isFinalValidationPass*/);
+        fprintf(stderr, "\nValidating network. %d nodes to process in pass %d.\n\n", (int) worklist.size(), (int) pass);
+        vector<size_t> revisit;
+        auto schedule = [&](size_t i)
+        {
+            if (!scheduled[i])
+            {
+                scheduled[i] = true;
+                revisit.push_back(i);
+            }
+        };
+        vector<pair<TensorShape, bool>> inputDims;
+        for (auto i : worklist)
+        {
+            const auto& node = nodes[i];
+            const auto& inputs = node->GetInputs();
+            const bool wasVisited = node->m_visited;
+            inputDims.clear();
+            for (const auto& input : inputs)
+                inputDims.push_back(GetDims(input));
+            bool changed;
+            if (!ValidateNodeInPass(node, /*isFirstPass=*/pass == 1, false /*isFinalValidationPass*/, changed))
+                schedule(i);
+            // consumers must see the new state of this node, including the ones that precede it in a loop
+            if (changed || (!wasVisited && node->m_visited))
+            {
+                for (auto consumer : consumers[i])
+                    schedule(consumer);
+            }
+            // Some nodes infer the dimensions of their inputs (e.g. Times() those of a LearnableParameter).
+            // Such an input, and all of its other consumers, must be revisited as well.
+            for (size_t k = 0; k < inputs.size(); k++)
+            {
+                if (GetDims(inputs[k]) == inputDims[k])
+                    continue;
+                auto iter = positionOf.find(inputs[k].get());
+                if (iter == positionOf.end())
+                    continue;
+                schedule(iter->second);
+                for (auto consumer : consumers[iter->second])
+                    schedule(consumer);
+            }
+        }
+        sort(revisit.begin(), revisit.end());
+        for (auto i : revisit)
+            scheduled[i] = false;
+        worklist = move(revisit);
         pass++;
     }
     if (TraceLevel() > 0)
     fprintf(stderr, "\nValidating network, final pass.\n\n");
-    toValidate = ValidateNodes(nodes, /*isFirstPass=*/pass == 1, true /*isFinalValidationPass*/);
+    size_t toValidate = ValidateNodes(nodes, /*isFirstPass=*/pass == 1, true /*isFinalValidationPass*/);
     if (toValidate != 0)
         LogicError("ValidateSubNetwork: ValidateNodes(true) unexpectedly returned with work left to do.");
 
@@ -746,12 +854,6 @@ void ComputationNetwork::ValidateNetwork()
 #endif
 }
 
-// helper to discover dimension changes
-static pair<TensorShape, bool> GetDims(const ComputationNodeBasePtr& node)
-{
-    return make_pair(node->GetSampleLayout(), node->HasMBLayout());
-}
-
 bool ComputationNetwork::ValidateNode(ComputationNodeBasePtr node, bool isFinalValidationPass) const
 {
     const auto& children = node->GetInputs();
@@ -796,66 +898,76 @@ bool ComputationNetwork::ValidateNode(ComputationNodeBasePtr node, bool isFinalV
 
 // perform one pass of validation over the topologically-sorted node set
 // returns how many nodes either could not yet be validated yet or have changed and thus must be redone
-size_t ComputationNetwork::ValidateNodes(list<ComputationNodeBasePtr> nodes, bool isFirstPass, bool isFinalValidationPass)
+size_t ComputationNetwork::ValidateNodes(const vector<ComputationNodeBasePtr>& nodes, bool isFirstPass, bool isFinalValidationPass)
 {
     size_t todo = 0;
     for (auto& node : nodes)
     {
-        const auto& children = node->GetInputs();
-        const bool isLeaf = node->IsLeaf();
-        // only validate a node if it has at least one child
-        bool hasVisitedChild = false;
-        bool allChildrenVisited = true;
-        for (auto& child : children)
-        {
-            hasVisitedChild |= child->m_visited; // if not a single visited child then no point in validating
-            allChildrenVisited &= child->m_visited;
+        bool changed;
+        if (!ValidateNodeInPass(node, isFirstPass, isFinalValidationPass, changed))
+            todo++;
+    }
+    return todo;
+}
 
-            // Make sure we don't use DynamicAxis in places where it was not designed for.
-            // This is a stop-gap. We need a more coherent concept for passing of shapes.
-            if (child->OperationName() == L"DynamicAxis")
-                RuntimeError("%ls: Cannot be used as input to another node. It can only be used on the 'dynamicAxis' property of an Input node.", child->NodeDescription().c_str());
-        }
+// validate a single node as part of a validation pass
+// Returns whether the node is valid, i.e. it was validated with all inputs visited and did not change.
+// 'changed' is set if validating the node modified its state (which its consumers then need to see).
+bool ComputationNetwork::ValidateNodeInPass(const ComputationNodeBasePtr& node, bool isFirstPass, bool isFinalValidationPass, bool& changed)
+{
+    changed = false;
+    const auto& children = node->GetInputs();
+    const bool isLeaf = node->IsLeaf();
+    // only validate a node if it has at least one child
+    bool hasVisitedChild = false;
+    bool allChildrenVisited = true;
+    for (auto& child : children)
+    {
+        hasVisitedChild |= child->m_visited; // if not a single visited child then no point in validating
+        allChildrenVisited &= child->m_visited;
+
+        // Make sure we don't use DynamicAxis in places where it was not designed for.
+        // This is a stop-gap. We need a more coherent concept for passing of shapes.
+        if (child->OperationName() == L"DynamicAxis")
+            RuntimeError("%ls: Cannot be used as input to another node. It can only be used on the 'dynamicAxis' property of an Input node.", child->NodeDescription().c_str());
+    }
 
-        // if there is not at least one visited child
-        bool valid = false;
-        if (hasVisitedChild || isLeaf) // got at least one child: it makes sense to call Validate()
+    // if there is not at least one visited child
+    bool valid = false;
+    if (hasVisitedChild || isLeaf) // got at least one child: it makes sense to call Validate()
+    {
+        string prevPrototype = node->FormatOperationPrototype("");
+        bool unchanged;
+        try
         {
-            string prevPrototype = node->FormatOperationPrototype("");
-            bool unchanged;
-            try
-            {
-                unchanged = !ValidateNode(node, isFinalValidationPass);
-                string updatedPrototype = node->FormatOperationPrototype("");
-#if 0           // print prototype in final validation pass. Problematic for tracking down validation errors in loops.
-                unchanged;
-                if (isFinalValidationPass)
-#else           // print prototype upon every change (useful for debugging)
-                if (isFirstPass || !unchanged || prevPrototype != updatedPrototype)
+            unchanged = !ValidateNode(node, isFinalValidationPass);
+            string updatedPrototype = node->FormatOperationPrototype("");
+#if 0       // print prototype in final validation pass. Problematic for tracking down validation errors in loops.
+            unchanged;
+            if (isFinalValidationPass)
+#else       // print prototype upon every change (useful for debugging)
+            if (isFirstPass || !unchanged || prevPrototype != updatedPrototype)
 #endif
-                    if (TraceLevel() > 0)
-                    fprintf(stderr, "Validating --> %s\n", updatedPrototype.c_str());
-            }
-            catch (...) // if validation failed then print the prototype anyway so one can see the input args
-            {
-                fprintf(stderr, "Validating --> %s FAILED\n", prevPrototype.c_str());
-                throw;
-            }
-            node->m_visited = true;
-            // print the new type
-            // sanity checks
-            if (isFinalValidationPass && !unchanged)
-                LogicError("ValidateSubNetwork: %ls %ls operation changed during final validation.", node->NodeName().c_str(), node->OperationName().c_str());
-            if (isFinalValidationPass && !allChildrenVisited)
-                LogicError("ValidateSubNetwork: %ls %ls operation in final validation although not all children were visited?", node->NodeName().c_str(), node->OperationName().c_str());
-            // if all children valid then
-            valid = (allChildrenVisited && unchanged) || isLeaf;
+                if (TraceLevel() > 0)
+                fprintf(stderr, "Validating --> %s\n", updatedPrototype.c_str());
         }
-        // count those that we need to redo
-        if (!valid)
-            todo++;
+        catch (...) // if validation failed then print the prototype anyway so one can see the input args
+        {
+            fprintf(stderr, "Validating --> %s FAILED\n", prevPrototype.c_str());
+            throw;
+        }
+        node->m_visited = true;
+        changed = !unchanged;
+        // print the new type
+        // sanity checks
+        if (isFinalValidationPass && !unchanged)
+            LogicError("ValidateSubNetwork: %ls %ls operation changed during final validation.", node->NodeName().c_str(), node->OperationName().c_str());
+        if (isFinalValidationPass && !allChildrenVisited)
+            LogicError("ValidateSubNetwork: %ls %ls operation in final validation although not all children were visited?", node->NodeName().c_str(), node->OperationName().c_str());
+        // if all children valid then
+        valid = (allChildrenVisited && unchanged) || isLeaf;
     }
-    return todo;
+    return valid;
 }
 
 // -----------------------------------------------------------------------
@@ -1102,10 +1214,23 @@ void ComputationNetwork::AllocateAllMatrices(const std::vector<ComputationNodeBa
             if (uniqueForwardPropEvalNodes.find(node) == uniqueForwardPropEvalNodes.end())
                 uniqueForwardPropEvalNodes.insert(node);
 
+            for (int i = 0; i < node->GetNumInputs(); i++)
+                parentsMap[node->GetInputs()[i]].insert(node);
+        }
+    }
+
+    // activation compression: determine the nodes that keep only a compact encoding of their output for backprop
+    // This changes which values the gradient computation uses, so it must be decided before those are determined.
+    if (performingBackPropagation)
+        FormActivationStashes(trainRootNode, parentsMap);
+
+    for (auto& rootNode : forwardPropRoots)
+    {
+        for (const auto& node : GetEvalOrder(rootNode))
+        {
             for (int i = 0; i < node->GetNumInputs(); i++)
             {
                 ComputationNodeBasePtr input = node->GetInputs()[i];
-                parentsMap[input].insert(node);
 
                 if (performingBackPropagation)
                 {
@@ -1120,6 +1245,14 @@ void ComputationNetwork::AllocateAllMatrices(const std::vector<ComputationNodeBa
         }
     }
 
+    // activation recomputation: determine the values that are released after forward prop and recomputed during backprop
+    std::map<ComputationNodeBasePtr, std::vector<ComputationNodeBasePtr>> recomputationSegments;
+    if (performingBackPropagation)
+    {
+        recomputationSegments = FormRecomputationSegments(trainRootNode, parentsMap, outputValueNeededDuringBackProp);
+        GetNestedNetwork(trainRootNode)->As<PARTraversalFlowControlNode>()->SetRecomputationSegments(recomputationSegments);
+    }
+
     // gradient reuse maps
     std::unordered_map<MatrixPool::AliasNodePtr, std::unordered_set<MatrixPool::AliasNodePtr>> gradientReuseChildrenMap;
     std::unordered_map<MatrixPool::AliasNodePtr, MatrixPool::AliasNodePtr> gradientReuseParentMap;
@@ -1133,6 +1266,10 @@ void ComputationNetwork::AllocateAllMatrices(const std::vector<ComputationNodeBa
         {
             auto parent = *keyValue.second.begin();
             auto opt = parent->ImplementsGradientOptimization(keyValue.first.get());
+            // learnable parameters keep a gradient matrix of their own, so that it can accumulate across minibatches
+            // (see ZeroInputGradientsExceptLearnableParameters()); their parent overwrites it instead
+            if (opt == ParentGradientOptimization::Reuse && keyValue.first->OperationName() == OperationNameOf(LearnableParameter))
+                opt = ParentGradientOptimization::Overwrite;
             if (opt != ParentGradientOptimization::None && trainRootNode != parent)
             {
                 // We cannot enable the gradient overwrite/reuse optimization if this node's (lone) parent
@@ -1243,6 +1380,18 @@ void ComputationNetwork::AllocateAllMatrices(const std::vector<ComputationNodeBa
         for (auto iter = backPropNodes.rbegin(); iter != backPropNodes.rend(); iter++) // for gradient computation, traverse in reverse order
         {
             auto n = *iter;
+
+            // values of a recomputation segment come back to life right before backprop enters the segment
+            auto recompute = recomputationSegments.find(n);
+            if (recompute != recomputationSegments.end())
+            {
+                for (auto& recomputeNode : recompute->second)
+                    recomputeNode->RequestMatricesBeforeRecompute(m_matrixPool);
+            }
+
+            // a lossy stash of the node's value is expanded right before its own backprop
+            n->RequestMatricesBeforeUnstash(m_matrixPool);
+
             if (n->IsPartOfLoop())
             {
                 std::vector<ComputationNodeBasePtr> recurrentNodes;
@@ -1283,6 +1432,171 @@ void ComputationNetwork::AllocateAllMatrices(const std::vector<ComputationNodeBa
         PrintMemorySharingStructure(GetAllNodes());
 }
 
+// FormRecomputationSegments() -- plan activation recomputation (gradient checkpointing) for training 'trainRootNode'
+// The evaluation order is cut into segments, each ending in a checkpoint node: the nodes tagged 'checkpoint' or,
+// if there are none, every sqrt(N)-th non-leaf node. A node inside a segment is recomputed, i.e. its value is
+// released after forward prop and computed again right before backprop enters its segment, if
+//  - its node type declares ForwardProp() repeatable (IsForwardPropRepeatable()), uses no random numbers, and it is not part of a loop,
+//  - it needs a gradient (so that its value is released again during backprop), and
+//  - all its consumers are in the same segment.
+// Inputs of recomputed nodes that are not recomputed themselves are kept alive until their own backprop.
+// Returns, for each segment end, the nodes to recompute in evaluation order.
+std::map<ComputationNodeBasePtr, std::vector<ComputationNodeBasePtr>> ComputationNetwork::FormRecomputationSegments(const ComputationNodeBasePtr& trainRootNode,
+                                                                                                                  const std::unordered_map<ComputationNodeBasePtr, std::unordered_set<ComputationNodeBasePtr>>& parentsMap,
+                                                                                                                  std::unordered_map<ComputationNodeBasePtr, bool>& outputValueNeededDuringBackProp)
+{
+    std::map<ComputationNodeBasePtr, std::vector<ComputationNodeBasePtr>> segments;
+
+    for (auto& node : GetAllNodes())
+        node->SetRecomputedInBackprop(false);
+
+    if (!Globals::ShouldRecomputeActivations() || !Globals::ShouldEnableShareNodeValueMatrices())
+        return segments;
+
+    const auto& evalOrder = GetEvalOrder(trainRootNode);
+
+    // segment ends are non-leaf nodes outside of loops
+    auto isSegmentEndCandidate = [](const ComputationNodeBasePtr& node) { return !node->IsLeaf() && !node->IsPartOfLoop(); };
+    size_t numCandidates = 0;
+    bool hasUserCheckpoints = false;
+    for (const auto& node : evalOrder)
+    {
+        if (isSegmentEndCandidate(node))
+        {
+            numCandidates++;
+            hasUserCheckpoints |= node->HasTag(L"checkpoint");
+        }
+    }
+    const size_t stride = std::max<size_t>(1, (size_t)sqrt((double)numCandidates));
+
+    // assign each node its segment index; the training criterion closes the last segment
+    std::unordered_map<ComputationNodeBasePtr, size_t> segmentIndex;
+    std::vector<ComputationNodeBasePtr> segmentEnds;
+    std::unordered_set<ComputationNodeBasePtr> isSegmentEnd;
+    size_t candidateIndex = 0;
+    for (const auto& node : evalOrder)
+    {
+        segmentIndex[node] = segmentEnds.size();
+        if (!isSegmentEndCandidate(node))
+            continue;
+        candidateIndex++;
+        bool isCheckpoint = hasUserCheckpoints ? node->HasTag(L"checkpoint") : (candidateIndex % stride == 0);
+        if (isCheckpoint || node == trainRootNode)
+        {
+            segmentEnds.push_back(node);
+            isSegmentEnd.insert(node);
+        }
+    }
+
+    auto isRecomputable = [&](const ComputationNodeBasePtr& node)
+    {
+        if (isSegmentEnd.find(node) != isSegmentEnd.end() || node->IsPartOfLoop() || !node->NeedsGradient() ||
+            !node->SupportsRecomputation() || node->IsOutputStashed() || dynamic_pointer_cast<IRngUser>(node))
+            return false;
+
+        auto parents = parentsMap.find(node);
+        if (parents == parentsMap.end())
+            return false;
+        for (const auto& parent : parents->second)
+        {
+            auto parentSegment = segmentIndex.find(parent);
+            if (parentSegment == segmentIndex.end() || parentSegment->second != segmentIndex[node])
+                return false;
+        }
+        return true;
+    };
+
+    size_t numRecomputed = 0;
+    for (const auto& node : evalOrder)
+    {
+        if (!isRecomputable(node))
+            continue;
+
+        node->SetRecomputedInBackprop(true);
+        segments[segmentEnds[segmentIndex[node]]].push_back(node);
+        numRecomputed++;
+    }
+
+    // keep the inputs of recomputed nodes alive if they are not recomputed themselves
+    for (const auto& segment : segments)
+    {
+        for (const auto& node : segment.second)
+        {
+            for (const auto& input : node->GetInputs())
+            {
+                if (!input->IsRecomputedInBackprop())
+                {
+                    outputValueNeededDuringBackProp[input] = true;
+                    input->SetOutputStashed(false); // the full value is kept anyway
+                }
+            }
+        }
+    }
+
+    if (TraceLevel() > 0)
+        fprintf(stderr, "\nActivation recomputation: %d of %d nodes are recomputed during backprop, in %d segments (%s checkpoints).\n",
+                (int)numRecomputed, (int)evalOrder.size(), (int)segments.size(), hasUserCheckpoints ? "user-defined" : "automatic");
+
+    return segments;
+}
+
+// FormActivationStashes() -- plan activation compression for training 'trainRootNode'
+// A node keeps only the compact encoding of its output value given by OutputStashFormat(), if
+//  - it needs a gradient and is not part of a loop,
+//  - its value is a dense, pooled, single-output matrix (the same requirement as for recomputation), and
+//  - no consumer uses that value for its own gradient, since consumers cannot read the encoding.
+// The full-precision value then goes back to the pool after forward prop. A lossy (Half) stash is expanded into a
+// pooled matrix again right before the node's backprop.
+void ComputationNetwork::FormActivationStashes(const ComputationNodeBasePtr& trainRootNode,
+                                               const std::unordered_map<ComputationNodeBasePtr, std::unordered_set<ComputationNodeBasePtr>>& parentsMap)
+{
+    for (auto& node : GetAllNodes())
+        node->SetOutputStashed(false);
+
+    if (!Globals::ShouldCompressActivations() || !Globals::ShouldEnableShareNodeValueMatrices())
+        return;
+
+    auto isStashable = [&](const ComputationNodeBasePtr& node)
+    {
+        if (node->OutputStashFormat() == ActivationStashFormat::None || !node->NeedsGradient() || node->IsPartOfLoop() ||
+            !node->SupportsRecomputation())
+            return false;
+
+        auto parents = parentsMap.find(node);
+        if (parents == parentsMap.end())
+            return false;
+        for (const auto& parent : parents->second)
+        {
+            if (!parent->NeedsGradient())
+                continue;
+            for (size_t i = 0; i < parent->GetNumInputs(); i++)
+            {
+                if (parent->GetInputs()[i] == node && parent->InputUsedInComputingInputNodesGradients(i))
+                    return false;
+            }
+        }
+        return true;
+    };
+
+    size_t numSignBit = 0, numHalf = 0;
+    const auto& evalOrder = GetEvalOrder(trainRootNode);
+    for (const auto& node : evalOrder)
+    {
+        if (!isStashable(node))
+            continue;
+
+        node->SetOutputStashed(true);
+        if (node->OutputStashFormat() == ActivationStashFormat::SignBit)
+            numSignBit++;
+        else
+            numHalf++;
+    }
+
+    if (TraceLevel() > 0)
+        fprintf(stderr, "\nActivation compression: %d of %d nodes keep a 1-bit mask and %d an fp16 copy of their output for backprop.\n",
+                (int)numSignBit, (int)evalOrder.size(), (int)numHalf);
+}
+
 void ComputationNetwork::ReleaseMatricesAfterEvalForChildren(ComputationNodeBasePtr n, std::unordered_map<ComputationNodeBasePtr, std::unordered_set<ComputationNodeBasePtr>>& parentsMap)
 {
     for (int i = 0; i < n->GetNumInputs(); i++)
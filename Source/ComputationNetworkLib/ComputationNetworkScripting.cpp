@@ -155,6 +155,8 @@ void ComputationNetwork::ConstructFromRoots(DEVICEID_TYPE deviceId, deque<Comput
             if      (tag == L"criteria") tag = L"criterion";
             else if (tag == L"eval"    ) tag = L"evaluation";
 #endif
+            if (tag == L"checkpoint") // marks a segment end for activation recomputation, not a node group
+                continue;
             AddToNodeGroup(tag, node); // tag may be empty, or may have been set by array parameters
         }
 
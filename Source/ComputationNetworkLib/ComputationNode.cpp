@@ -715,15 +715,44 @@ template <class ElemType>
         InvalidateMissingValueColumns(FrameRange(m_pMBLayout)); // blast NaNs into columns that are gaps in a packed layout
     }
 
+    if (IsOutputStashed() && !(HasEnvironmentPtr() && Environment().IsInferring()))
+    {
+        StashOutput();
+        Globals::CountActivationStash();
+    }
+
     // tracing
     Trace();
 }
 
+template <class ElemType>
+/*virtual*/ void ComputationNode<ElemType>::StashOutput()
+{
+    switch (OutputStashFormat())
+    {
+    case ActivationStashFormat::SignBit:
+        m_stashedMaskBits.resize(Matrix<ElemType>::GetBitMaskWordsPerColumn(Value().GetNumRows()) * Value().GetNumCols());
+        Matrix<ElemType>::SetBitMaskOfPositive(m_stashedMaskBits.data(), Value());
+        break;
+    case ActivationStashFormat::Half:
+        if (!m_stashedValue)
+            m_stashedValue = make_shared<Matrix<half>>(m_deviceId);
+        m_stashedValue->CastAssignValuesOf(Value());
+        break;
+    default:
+        LogicError("%ls %ls operation has no output stash format.", NodeName().c_str(), OperationName().c_str());
+    }
+}
+
 template <class ElemType>
 /*virtual*/ void ComputationNode<ElemType>::BeginBackprop()
 {
     Base::BeginBackprop();
 
+    // expand a lossy stash of the output value into the value matrix, which was released after forward prop
+    if (IsOutputStashedAs(ActivationStashFormat::Half))
+        Value().CastAssignValuesOf(*m_stashedValue);
+
     if (NeedsGradient())
     {
         // Verify that the shapes of the output/input Value matrices that the gradient backprop for this node needs
@@ -177,6 +177,14 @@ enum class ParentGradientOptimization
     Reuse       // parent gradient matrix is reused by child
 };
 
+// compact encoding a node keeps of its output value for backprop, instead of the value itself (activation compression)
+enum class ActivationStashFormat
+{
+    None,       // the full output value is kept
+    SignBit,    // one bit per element, e.g. which ReLU outputs are positive; the node's gradient must be computable from it
+    Half        // lossy fp16 copy of the value, expanded back to full precision right before the node's backprop
+};
+
 class ComputationNetwork;
 class ComputationNodeBase;
 struct ComputationNetworkOwnedNodeState
@@ -314,7 +322,7 @@ public:
     // -----------------------------------------------------------------------
 
     ComputationNodeBase(DEVICEID_TYPE deviceId, const wstring& name) :
-        m_deviceId(deviceId), m_outputNeededDuringBackprop(true), m_learningRateMultiplier(0),
+        m_deviceId(deviceId), m_outputNeededDuringBackprop(true), m_recomputedInBackprop(false), m_outputStashed(false), m_learningRateMultiplier(0),
         m_gradientInitializedBy(nullptr),
         m_nodeName(name == L"" ? CreateUniqNodeName() : name), m_isValueSparse(false)
     {
@@ -817,6 +825,12 @@ public:
         }
     }
 
+    // mark the gradient as holding a partial sum, so that backprop adds to it rather than zeroing or overwriting it
+    void /*ComputationNodeBase::*/ MarkGradientInitialized()
+    {
+        m_gradientInitializedBy = this;
+    }
+
     // -----------------------------------------------------------------------
     // masking
     // -----------------------------------------------------------------------
@@ -847,6 +861,33 @@ public:
         return !Globals::ShouldEnableShareNodeValueMatrices() || m_outputNeededDuringBackprop; 
     }
 
+    // activation recomputation: the output value is released right after forward prop, and computed again
+    // by ComputationNetwork before the backprop of the segment that contains this node
+    void SetRecomputedInBackprop(bool f) { m_recomputedInBackprop = f; }
+    bool IsRecomputedInBackprop() const { return m_recomputedInBackprop; }
+
+    // Can ForwardProp() be run a second time on the same minibatch with identical result and without side effects?
+    virtual bool SupportsRecomputation() const { return !IsLeaf() && !RequiresPreCompute() && IsForwardPropRepeatable(); }
+
+    // Recomputation is opt-in per node type: override to return true only if ForwardProp() updates no state and
+    // writes nothing but the output value. Temporaries requested from the pool in RequestMatricesBeforeForwardProp()
+    // are not requested again for recomputation, and may be in use by backprop at that point.
+    virtual bool IsForwardPropRepeatable() const { return false; }
+
+    // request the value matrix again before the node is recomputed during backprop
+    virtual void RequestMatricesBeforeRecompute(MatrixPool& /*matrixPool*/) {}
+
+    // activation compression: which compact encoding of its output value this node can use for its own gradient.
+    // If ComputationNetwork decides to stash the output, the node computes the stash after forward prop, and the
+    // full-precision value is released to the pool until backprop (Half) or for good (SignBit).
+    virtual ActivationStashFormat OutputStashFormat() const { return ActivationStashFormat::None; }
+    void SetOutputStashed(bool f) { m_outputStashed = f; }
+    bool IsOutputStashed() const { return m_outputStashed; }
+    bool IsOutputStashedAs(ActivationStashFormat format) const { return m_outputStashed && OutputStashFormat() == format; }
+
+    // request the value matrix again before a Half stash is expanded during backprop
+    virtual void RequestMatricesBeforeUnstash(MatrixPool& /*matrixPool*/) {}
+
     // -----------------------------------------------------------------------
     // helpers for network traversal
     // -----------------------------------------------------------------------
@@ -980,6 +1021,8 @@ protected:
     float m_learningRateMultiplier;    // update parameters? Only used for LearnableParameters.    --TODO: Should we make this a member of LearnableParameters actually? And require a type cast? Currently it is read out for all leaves.
     const ComputationNodeBase* m_gradientInitializedBy; // indicates which node initialized the gradient matrix
     bool m_outputNeededDuringBackprop; // indicates whether the output value of the node is needed during backprop
+    bool m_recomputedInBackprop;       // output value is released after forward prop and recomputed before backprop
+    bool m_outputStashed;              // only a compact encoding of the output value (OutputStashFormat()) is kept for backprop
 };
 typedef ComputationNodeBase::ComputationNodeBasePtr ComputationNodeBasePtr;
 
@@ -1786,6 +1829,20 @@ public:
 
     virtual void /*IComputationNode::*/ EndBackprop() override;
 
+    // activation compression: compute the stash of the output value (see OutputStashFormat()); called from EndForwardProp()
+    // Default handles Half and, for SignBit, the mask of positive outputs. Override for other bit masks.
+    virtual void StashOutput();
+
+    // bit-mask words of the stashed output (SignBit) for the columns selected by 'fr'; columns start on word boundaries
+    // The value matrix itself may be in use by another node at this point, so the dimensions are derived from the layouts.
+    const uint32_t* StashedMaskBitsFor(const FrameRange& fr) const
+    {
+        size_t rows, cols;
+        DetermineDataSize(rows, cols);
+        auto columnRange = ColumnRangeWithMBLayoutFor(cols, fr, GetMBLayout());
+        return m_stashedMaskBits.data() + columnRange.first * Matrix<ElemType>::GetBitMaskWordsPerColumn(rows);
+    }
+
     virtual void /*IComputationNode::*/ BeginTiming(bool) override;
 
     virtual void /*IComputationNode::*/ EndTiming(bool) override;
@@ -1870,10 +1927,28 @@ public:
     // don't release matrices that need to be used in the gradient computation
     virtual void ReleaseMatricesAfterForwardProp(MatrixPool& matrixPool) override
     {
-        if (!IsOutputNeededDuringBackprop() && !m_isValueSparse && IsValueSharable())
+        if ((!IsOutputNeededDuringBackprop() || IsRecomputedInBackprop() || IsOutputStashed()) && !m_isValueSparse && IsValueSharable())
             ReleaseMatrixToPool(m_value, matrixPool);
     }
 
+    virtual void RequestMatricesBeforeRecompute(MatrixPool& matrixPool) override
+    {
+        if (IsRecomputedInBackprop())
+            matrixPool.RequestReallocate<ElemType>(&m_value);
+    }
+
+    virtual void RequestMatricesBeforeUnstash(MatrixPool& matrixPool) override
+    {
+        if (IsOutputStashedAs(ActivationStashFormat::Half))
+            matrixPool.RequestReallocate<ElemType>(&m_value);
+    }
+
+    // only single-output nodes with a dense, pooled value are recomputed
+    virtual bool SupportsRecomputation() const override
+    {
+        return Base::SupportsRecomputation() && IsValueSharable() && !m_isValueSparse && !dynamic_cast<const MultiOutputNode<ElemType>*>(this);
+    }
+
     virtual void AllocateGradientMatricesForInputs(MatrixPool& matrixPool) override
     {
         for (int i = 0; i < m_inputs.size(); i++)
@@ -1907,7 +1982,7 @@ public:
 
             // Release the Value matrix only if the output value is needed during backprop
             // since in the case it isn't used, we release it during forward prop itself
-            if (IsOutputNeededDuringBackprop() && !m_isValueSparse && IsValueSharable())
+            if ((IsOutputNeededDuringBackprop() || IsRecomputedInBackprop()) && !m_isValueSparse && IsValueSharable())
                 ReleaseMatrixToPool(m_value, matrixPool);
 
             auto multiOutputNode = dynamic_cast<MultiOutputNode<ElemType>*>(this);
@@ -2171,6 +2246,10 @@ protected:
 
     shared_ptr<Matrix<ElemType>> m_value, m_gradient;
 
+    // activation compression: what is kept of m_value for backprop if IsOutputStashed() (not pooled)
+    std::vector<uint32_t> m_stashedMaskBits;   // SignBit
+    shared_ptr<Matrix<half>> m_stashedValue;   // Half
+
     static std::map<size_t, std::map<size_t, shared_ptr<Matrix<ElemType>>>> s_constOnes;
 
     MatrixType m_preferredGradientMatrixType = UNDETERMINED;
@@ -2424,6 +2503,7 @@ protected:
     using Base::InvalidateMissingValueColumns;                                                                                                           \
     using Base::IsLeaf;                                                                                                                                  \
     using Base::IsOutOfDateWrtInputs;                                                                                                                    \
+    using Base::IsOutputStashedAs;                                                                                                                       \
     using Base::IsPartOfLoop;                                                                                                                            \
     using Base::LinkToMBLayout;                                                                                                                          \
     using Base::Load;                                                                                                                                    \
@@ -2449,6 +2529,7 @@ protected:
     using Base::SetDims;                                                                                                                                 \
     using Base::SetInput;                                                                                                                                \
     using Base::SetLearningRateMultiplier;                                                                                                               \
+    using Base::StashedMaskBitsFor;                                                                                                                      \
     using Base::UpdateFunctionMBSize;                                                                                                                    \
     using Base::UpdateFunctionValuesSize;                                                                                                                \
     using Base::Validate;                                                                                                                                \
@@ -2474,6 +2555,7 @@ protected:
     using Base::m_pMBLayout;                                                                                                                             \
     using Base::m_learningRateMultiplier;                                                                                                                \
     using Base::m_sampleLayout;                                                                                                                          \
+    using Base::m_stashedMaskBits;                                                                                                                       \
     using Base::m_value;                                                                                                                                 \
     using Base::m_valueSharable;                                                                                                                         \
     using Base::shared_from_this;                                                                                                                        \
@@ -2559,6 +2641,8 @@ public:
 #endif
     virtual bool InputUsedInComputingInputNodesGradients(size_t /*childIndex*/) const override { return false; }
 
+    virtual bool IsForwardPropRepeatable() const override { return true; }
+
     virtual void /*IComputationNode::*/ BeginForwardProp() override // called before first iteration step of ForwardProp()
     {
         Base::BeginForwardProp();
@@ -318,15 +318,15 @@ class ConvolutionNodeBaseExtended : public ConvolutionNodeBase<ElemType>, public
     
 public:
     ConvolutionNodeBaseExtended(DEVICEID_TYPE deviceId, const wstring& name)
-        : Base(deviceId, name), m_dilation(TensorShape(1)), m_groups(1)
+        : Base(deviceId, name), m_dilation(TensorShape(1)), m_groups(1), m_enabledEngines(ConvolutionEngineKind::All)
     {
     }
     ConvolutionNodeBaseExtended(DEVICEID_TYPE deviceId, const wstring& name, const TensorShape& kernelShape, const TensorShape& mapCount, const TensorShape& strideShape,
         const std::vector<bool>& sharing, const std::vector<bool>& autoPadding, const TensorShape& lowerPad, const TensorShape& upperPad,
         bool transpose, const TensorShape &outputShape, ImageLayoutKind imageLayout, size_t maxTempMemSizeInSamples, const TensorShape& dilation = TensorShape(1),
-        size_t groups = 1)
+        size_t groups = 1, ConvolutionEngineKind enabledEngines = ConvolutionEngineKind::All)
         : Base(deviceId, name, kernelShape, mapCount, strideShape, sharing, autoPadding, lowerPad, upperPad, PoolKind::None, false, transpose, outputShape, false, imageLayout, maxTempMemSizeInSamples),
-        m_convolution2D(false), m_dilation(dilation), m_groups(groups)
+        m_convolution2D(false), m_dilation(dilation), m_groups(groups), m_enabledEngines(enabledEngines)
     {
         // Make sure not using dilation on CPU
         if (deviceId < 0)
@@ -415,6 +415,7 @@ public:
         {
             auto node = dynamic_pointer_cast<ConvolutionNodeBaseExtended<ElemType>>(nodeP);
             node->m_convolution2D = m_convolution2D;
+            node->m_enabledEngines = m_enabledEngines;
         }
     }
 
@@ -448,6 +449,9 @@ public:
 protected:
     TensorShape m_dilation;
     size_t m_groups;
+    // Engines the node may use. ConvolutionEngineKind::Binary selects the XNOR-popcount convolution of the binarized
+    // input and weights (CPU only), which is never picked otherwise since it computes a different function.
+    ConvolutionEngineKind m_enabledEngines;
     // Flag that indicates whether the node is created using 2D-syntax.
     bool m_convolution2D;
 };
@@ -457,6 +461,7 @@ protected:
 protected:                                  \
     using Base::m_dilation;                 \
     using Base::m_groups;                   \
+    using Base::m_enabledEngines;           \
     using Base::m_convolution2D;            \
 public:
 
@@ -478,8 +483,8 @@ public:
     ConvolutionNode(DEVICEID_TYPE deviceId, const wstring& name, const TensorShape& kernelShape, const TensorShape& mapCount, const TensorShape& strideShape,
                     const std::vector<bool>& sharing, const std::vector<bool>& autoPadding, const TensorShape& lowerPad, const TensorShape& upperPad,
                     bool transpose, const TensorShape &outputShape, ImageLayoutKind imageLayout, size_t maxTempMemSizeInSamples, const TensorShape& dilation=TensorShape(1),
-                    size_t groups=1)
-        : Base(deviceId, name, kernelShape, mapCount, strideShape, sharing, autoPadding, lowerPad, upperPad, transpose, outputShape, imageLayout, maxTempMemSizeInSamples, dilation, groups)
+                    size_t groups=1, ConvolutionEngineKind enabledEngines=ConvolutionEngineKind::All)
+        : Base(deviceId, name, kernelShape, mapCount, strideShape, sharing, autoPadding, lowerPad, upperPad, transpose, outputShape, imageLayout, maxTempMemSizeInSamples, dilation, groups, enabledEngines)
     {
     }
     ConvolutionNode(DEVICEID_TYPE deviceId, const wstring& name, const size_t kernelWidth, const size_t kernelHeight, const size_t outputChannels,
@@ -676,7 +681,7 @@ public:
                                                                    m_sharing, m_autoPad, m_lowerPad, m_upperPad, m_dilation, false, m_groups);
                 m_convEng = ConvolutionEngine<ElemType>::Create(geometry, m_deviceId, m_imageLayout,
                                                                 m_maxTempMemSizeInSamples, m_poolKind,
-                                                                ConvolutionEngineKind::All, NodeName(), Globals::ShouldForceDeterministicAlgorithms(),
+                                                                m_enabledEngines, NodeName(), Globals::ShouldForceDeterministicAlgorithms(),
                                                                 false, recomputeConvGeometry);
             }
 
@@ -9,6 +9,8 @@
 #include "gammacalculation.h"
 #include "InputAndParamNodes.h"
 #include "Sequences.h"
+#include <algorithm>
+#include <limits>
 #include <map>
 #include <string>
 #include <vector>
@@ -460,6 +462,8 @@ template class NDCG1EvalNode<double>;
 
 // Edit distance error evaluation node with the option of specifying penalty of substitution, deletion and insertion, as well as squashing the input sequences and ignoring certain samples.
 // Using the classic DP algorithm as described in https://en.wikipedia.org/wiki/Edit_distance, adjusted to take into account the penalties.
+// When all penalties are equal, the bit-parallel algorithm of Myers is used instead, see "A fast bit-vector algorithm for approximate
+// string matching based on dynamic programming", Journal of the ACM 46(3), 1999. Sequences of a minibatch are processed in parallel.
 // 
 // The node allows to squash sequences of repeating labels and ignore certain labels. For example, if squashInputs is true and tokensToIgnore contains index of label '-' then
 // given first input sequence as s1="a-ab-" and second as s2="-aa--abb" the edit distance will be computed against s1' = "aab" and s2' = "aab".
@@ -579,27 +583,20 @@ public:
     ElemType ComputeEditDistanceError(Matrix<ElemType>& firstSeq, const Matrix<ElemType> & secondSeq, MBLayoutPtr pMBLayout, 
         float subPen, float delPen, float insPen, bool squashInputs, const vector<size_t>& tokensToIgnore)
     {
-        std::vector<int> firstSeqVec, secondSeqVec;
-
-        // Edit distance between subsequences
-        Matrix<float> grid(CPUDEVICE);
-        
-        // Number of insertions between subsequences
-        Matrix<float> insMatrix(CPUDEVICE);
-        
-        //Number of deletions between subsequences
-        Matrix<float> delMatrix(CPUDEVICE);
-
-        // Number of substitutions between subsequences
-        Matrix<float> subMatrix(CPUDEVICE);
-
-        float del, ins, sub;
         ElemType wrongSampleNum = 0.0;
         size_t totalSampleNum = 0, totalframeNum = 0;
-        size_t sequenceStartFrame = 0;
 
-        for (const auto& sequence : pMBLayout->GetAllSequences())
+        // extract the sample sequences, the edit distances are then computed for all sequences in parallel
+        const auto& sequences = pMBLayout->GetAllSequences();
+        m_firstSeqVecs.resize(sequences.size());
+        m_secondSeqVecs.resize(sequences.size());
+        m_numEdits.assign(sequences.size(), 0);
+        for (size_t k = 0; k < sequences.size(); k++)
         {
+            m_firstSeqVecs[k].clear();
+            m_secondSeqVecs[k].clear();
+
+            const auto& sequence = sequences[k];
             if (sequence.seqId == GAP_SEQUENCE_ID)
                 continue;
 
@@ -611,83 +608,42 @@ public:
 
                 auto columnIndices = pMBLayout->GetColumnIndices(sequence);
 
-                ExtractSampleSequence(firstSeq, columnIndices, squashInputs, tokensToIgnore, firstSeqVec);
-                ExtractSampleSequence(secondSeq, columnIndices, squashInputs, tokensToIgnore, secondSeqVec);
+                ExtractSampleSequence(firstSeq, columnIndices, squashInputs, tokensToIgnore, m_firstSeqVecs[k]);
+                ExtractSampleSequence(secondSeq, columnIndices, squashInputs, tokensToIgnore, m_secondSeqVecs[k]);
 
-                //calculate edit distance
-                size_t firstSize = firstSeqVec.size();
-                size_t secondSize = secondSeqVec.size();
+                size_t firstSize = m_firstSeqVecs[k].size();
+                size_t secondSize = m_secondSeqVecs[k].size();
                 if (Base::HasEnvironmentPtr() && Base::Environment().IsV2Library())
                     totalSampleNum += secondSize;
                 else 
                     totalSampleNum += firstSize;
+            }
+        }
 
-                grid.Resize(firstSize + 1, secondSize + 1);
-                insMatrix.Resize(firstSize + 1, secondSize + 1);
-                delMatrix.Resize(firstSize + 1, secondSize + 1);
-                subMatrix.Resize(firstSize + 1, secondSize + 1);
-                insMatrix.SetValue(0.0f);
-                delMatrix.SetValue(0.0f);
-                subMatrix.SetValue(0.0f);
-
-                for (size_t i = 0; i < firstSize + 1; i++)
-                {
-                    grid(i, 0) = (float)(i * delPen);
-                    delMatrix(i, 0) = (float)i;
-                }
+        // With equal penalties every edit costs the same, and the number of edits on the best path is the Levenshtein distance.
+        const bool isUnitCost = subPen == delPen && delPen == insPen && subPen > 0;
 
-                for (size_t j = 0; j < secondSize + 1; j++)
-                {
-                    grid(0, j) = (float)(j * insPen);
-                    insMatrix(0, j) = (float)j;
-                }
-                for (size_t i = 1; i < firstSize + 1; i++)
-                {
-                    for (size_t j = 1; j < secondSize + 1; j++)
-                    {
-                        if (firstSeqVec[i - 1] == secondSeqVec[j - 1])
-                        {
-                            grid(i, j) = grid(i - 1, j - 1);
-                            insMatrix(i, j) = insMatrix(i - 1, j - 1);
-                            delMatrix(i, j) = delMatrix(i - 1, j - 1);
-                            subMatrix(i, j) = subMatrix(i - 1, j - 1);
-                        }
-                        else
-                        {
-                            del = grid(i - 1, j) + delPen; //deletion 
-                            ins = grid(i, j - 1) + insPen;  //insertion
-                            sub = grid(i - 1, j - 1) + subPen; //substitution 
-                            if (sub <= del && sub <= ins)
-                            {
-                                insMatrix(i, j) = insMatrix(i - 1, j - 1);
-                                delMatrix(i, j) = delMatrix(i - 1, j - 1);
-                                subMatrix(i, j) = subMatrix(i - 1, j - 1) + 1.0f;
-                                grid(i, j) = sub;
-                            }
-                            else if (del < ins)
-                            {
-                                insMatrix(i, j) = insMatrix(i - 1, j);
-                                subMatrix(i, j) = subMatrix(i - 1, j);
-                                delMatrix(i, j) = delMatrix(i - 1, j) + 1.0f;
-                                grid(i, j) = del;
-                            }
-                            else
-                            {
-                                delMatrix(i, j) = delMatrix(i, j - 1);
-                                subMatrix(i, j) = subMatrix(i, j - 1);
-                                insMatrix(i, j) = insMatrix(i, j - 1) + 1.0f;
-                                grid(i, j) = ins;
-                            }
-                        }
-                    }
-                }
-
-                wrongSampleNum += insMatrix(firstSize, secondSize) + delMatrix(firstSize, secondSize) + subMatrix(firstSize, secondSize);
+#pragma omp parallel for schedule(dynamic)
+        for (long k = 0; k < (long)sequences.size(); k++)
+        {
+            static thread_local EditDistanceScratch scratch;
+            const auto& firstSeqVec = m_firstSeqVecs[k];
+            const auto& secondSeqVec = m_secondSeqVecs[k];
+            if (isUnitCost)
+            {
+                // the distance is symmetric, use the shorter sequence as the bit-parallel pattern
+                if (firstSeqVec.size() <= secondSeqVec.size())
+                    m_numEdits[k] = BitParallelEditDistance(firstSeqVec, secondSeqVec, scratch);
+                else
+                    m_numEdits[k] = BitParallelEditDistance(secondSeqVec, firstSeqVec, scratch);
             }
-
-            sequenceStartFrame += numFrames;
+            else
+                m_numEdits[k] = WeightedNumEdits(firstSeqVec, secondSeqVec, subPen, delPen, insPen, scratch);
         }
 
+        for (auto numEdits : m_numEdits)
+            wrongSampleNum += (ElemType)numEdits;
+
         return (ElemType)(wrongSampleNum * totalframeNum / totalSampleNum);
     }
 
@@ -726,6 +682,174 @@ private:
     float m_insPen;
     std::vector<size_t> m_tokensToIgnore;
 
+    // per-sequence sample sequences and edit counts of the current minibatch, kept to reuse their memory
+    std::vector<std::vector<int>> m_firstSeqVecs, m_secondSeqVecs;
+    std::vector<size_t> m_numEdits;
+
+    // Scratch memory of the edit distance computation. Each thread keeps one across sequences and minibatches.
+    struct EditDistanceScratch
+    {
+        std::vector<int> symbols;     // distinct symbols of the pattern, sorted
+        std::vector<uint64_t> peq;    // for each distinct symbol, the bit mask of its positions in the pattern
+        std::vector<uint64_t> pv, mv; // positive and negative vertical deltas of the current column
+        std::vector<float> grid[2];   // two rows of the weighted edit distance
+        std::vector<size_t> edits[2]; // number of edits on the best path to each cell of the two rows
+    };
+
+    // Levenshtein distance using the bit-vector algorithm of Myers (1999), in the multi-word form for patterns of any length.
+    // D[i][j] is encoded column by column as bit vectors of the vertical deltas D[i][j] - D[i-1][j].
+    static size_t BitParallelEditDistance(const std::vector<int>& pattern, const std::vector<int>& text, EditDistanceScratch& scratch)
+    {
+        const size_t n = pattern.size();
+        if (n == 0)
+            return text.size();
+
+        const size_t numWords = (n + 63) / 64;
+        auto& symbols = scratch.symbols;
+        symbols.assign(pattern.begin(), pattern.end());
+        std::sort(symbols.begin(), symbols.end());
+        symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
+
+        auto& peq = scratch.peq;
+        peq.assign(symbols.size() * numWords, 0);
+        for (size_t i = 0; i < n; i++)
+        {
+            size_t symbolIndex = std::lower_bound(symbols.begin(), symbols.end(), pattern[i]) - symbols.begin();
+            peq[symbolIndex * numWords + i / 64] |= (uint64_t)1 << (i % 64);
+        }
+
+        // first column: D[i][0] = i
+        auto& pv = scratch.pv;
+        auto& mv = scratch.mv;
+        pv.assign(numWords, ~(uint64_t)0);
+        mv.assign(numWords, 0);
+
+        const uint64_t lastBit = (uint64_t)1 << ((n - 1) % 64);
+        size_t score = n; // D[n][j]
+        for (int c : text)
+        {
+            auto symbol = std::lower_bound(symbols.begin(), symbols.end(), c);
+            const uint64_t* eq = (symbol != symbols.end() && *symbol == c) ? &peq[(symbol - symbols.begin()) * numWords] : nullptr;
+
+            int hin = 1; // first row: D[0][j] = j
+            for (size_t b = 0; b < numWords; b++)
+            {
+                uint64_t Eq = eq ? eq[b] : 0;
+                const uint64_t Pv = pv[b];
+                const uint64_t Mv = mv[b];
+                const uint64_t Xv = Eq | Mv;
+                if (hin < 0)
+                    Eq |= 1;
+                const uint64_t Xh = (((Eq & Pv) + Pv) ^ Pv) | Eq;
+                uint64_t Ph = Mv | ~(Xh | Pv);
+                uint64_t Mh = Pv & Xh;
+
+                // horizontal delta at the last row of the block, carried into the next block
+                const uint64_t highBit = b + 1 == numWords ? lastBit : (uint64_t)1 << 63;
+                int hout = (Ph & highBit) ? 1 : (Mh & highBit) ? -1 : 0;
+
+                Ph <<= 1;
+                Mh <<= 1;
+                if (hin < 0)
+                    Mh |= 1;
+                else if (hin > 0)
+                    Ph |= 1;
+                pv[b] = Mh | ~(Xv | Ph);
+                mv[b] = Ph & Xv;
+                hin = hout;
+            }
+            score += hin;
+        }
+        return score;
+    }
+
+    // Number of edits on the best path of the weighted edit distance, with the tie-breaking of the classic DP
+    // (match, then substitution, deletion, insertion).
+    // Only a band of diagonals |i - j| <= k is computed. A path leaving the band needs at least 2 (k + 1) - |n - m|
+    // insertions and deletions, so if the best path in the band is cheaper than that, it is also the best path overall,
+    // and no cell on it can have been influenced by the cells outside. Otherwise the band is doubled.
+    static size_t WeightedNumEdits(const std::vector<int>& firstSeqVec, const std::vector<int>& secondSeqVec, float subPen, float delPen, float insPen, EditDistanceScratch& scratch)
+    {
+        const size_t firstSize = firstSeqVec.size();
+        const size_t secondSize = secondSeqVec.size();
+        const size_t lengthDiff = firstSize > secondSize ? firstSize - secondSize : secondSize - firstSize;
+        const size_t maxBand = std::max(firstSize, secondSize);
+        const float minIndelPen = std::min(delPen, insPen);
+        const float inf = std::numeric_limits<float>::infinity();
+
+        for (size_t k = minIndelPen > 0 ? std::max<size_t>(lengthDiff, 16) : maxBand;; k = std::min(2 * k, maxBand))
+        {
+            for (auto& row : scratch.grid)
+                row.resize(secondSize + 1);
+            for (auto& row : scratch.edits)
+                row.resize(secondSize + 1);
+
+            for (size_t j = 0; j <= std::min(k, secondSize); j++)
+            {
+                scratch.grid[0][j] = (float)(j * insPen);
+                scratch.edits[0][j] = j;
+            }
+            if (k < secondSize)
+                scratch.grid[0][k + 1] = inf;
+
+            for (size_t i = 1; i <= firstSize; i++)
+            {
+                const float* prevGrid = scratch.grid[(i - 1) % 2].data();
+                const size_t* prevEdits = scratch.edits[(i - 1) % 2].data();
+                float* grid = scratch.grid[i % 2].data();
+                size_t* edits = scratch.edits[i % 2].data();
+
+                const size_t lo = i > k ? i - k : 0;
+                const size_t hi = std::min(i + k, secondSize);
+                size_t j = lo;
+                if (lo == 0)
+                {
+                    grid[0] = (float)(i * delPen);
+                    edits[0] = i;
+                    j = 1;
+                }
+                else
+                    grid[lo - 1] = inf;
+
+                for (; j <= hi; j++)
+                {
+                    if (firstSeqVec[i - 1] == secondSeqVec[j - 1])
+                    {
+                        grid[j] = prevGrid[j - 1];
+                        edits[j] = prevEdits[j - 1];
+                        continue;
+                    }
+
+                    float del = prevGrid[j] + delPen; //deletion 
+                    float ins = grid[j - 1] + insPen;  //insertion
+                    float sub = prevGrid[j - 1] + subPen; //substitution 
+                    if (sub <= del && sub <= ins)
+                    {
+                        grid[j] = sub;
+                        edits[j] = prevEdits[j - 1] + 1;
+                    }
+                    else if (del < ins)
+                    {
+                        grid[j] = del;
+                        edits[j] = prevEdits[j] + 1;
+                    }
+                    else
+                    {
+                        grid[j] = ins;
+                        edits[j] = edits[j - 1] + 1;
+                    }
+                }
+                if (hi < secondSize)
+                    grid[hi + 1] = inf;
+            }
+
+            const float cost = scratch.grid[firstSize % 2][secondSize];
+            const double costOutsideBand = (double)minIndelPen * (2 * (k + 1) - lengthDiff);
+            if (k >= maxBand || cost * (1 + 1e-5) < costOutsideBand)
+                return scratch.edits[firstSize % 2][secondSize];
+        }
+    }
+
     // Clear out_SampleSeqVec and extract a vector of samples from the matrix into out_SampleSeqVec.
     static void ExtractSampleSequence(const Matrix<ElemType>& firstSeq, vector<size_t>& columnIndices, bool squashInputs, const vector<size_t>& tokensToIgnore, std::vector<int>& out_SampleSeqVec)
     {
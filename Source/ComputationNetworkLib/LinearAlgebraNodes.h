@@ -1038,6 +1038,9 @@ public:
         }
     }
 
+    // the temporaries for reducing the sequence axis are pooled, so only the plain product is recomputed
+    virtual bool IsForwardPropRepeatable() const override { return !ReduceSequenceAxis(); }
+
     void RequestMatricesBeforeForwardProp(MatrixPool& matrixPool) override
     {
         Base::RequestMatricesBeforeForwardProp(matrixPool);
@@ -1670,6 +1673,191 @@ public:
 template class KhatriRaoProductNode<float>;
 template class KhatriRaoProductNode<double>;
 
+// -----------------------------------------------------------------------
+// ScaledDotProductAttentionNode (query, key, value, scale=0, causal=false)
+// Attention within each sample:
+//   output = value * softmax(scale * key^T * query)
+// The samples are [dimQK x numQueries], [dimQK x numKeys], and [dimV x numKeys] tensors, or carry a third
+// axis numHeads for multi-head attention; the output is [dimV x numQueries (x numHeads)].
+// A scale of 0 means 1/sqrt(dimQK). If 'causal', query i only attends to keys j <= i + (numKeys - numQueries).
+// The numQueries x numKeys score matrix is never stored: forward streams over blocks of keys with an online
+// softmax and keeps only the log of the softmax denominators, from which backprop recomputes the scores.
+// -----------------------------------------------------------------------
+
+template <class ElemType>
+class ScaledDotProductAttentionNode : public ComputationNode<ElemType>, public NumInputs<3>
+{
+    typedef ComputationNode<ElemType> Base;
+    UsingComputationNodeMembersBoilerplate;
+    static const std::wstring TypeName()
+    {
+        return L"ScaledDotProductAttention";
+    }
+
+    static const size_t QUERY = 0;
+    static const size_t KEY   = 1;
+    static const size_t VALUE = 2;
+
+public:
+    ScaledDotProductAttentionNode(DEVICEID_TYPE deviceId, const wstring& name, double scale = 0, bool causal = false)
+        : Base(deviceId, name), m_scale(scale), m_causal(causal)
+    {
+    }
+
+    ScaledDotProductAttentionNode(const ScriptableObjects::IConfigRecordPtr configp)
+        : ScaledDotProductAttentionNode(configp->Get(L"deviceId"), L"<placeholder>", configp->Get(L"scale"), configp->Get(L"causal"))
+    {
+        AttachInputsFromConfig(configp, this->GetExpectedNumInputs());
+    }
+
+    virtual void Save(File& fstream) const override
+    {
+        Base::Save(fstream);
+        fstream << m_scale;
+        fstream << m_causal;
+    }
+
+    virtual void Load(File& fstream, size_t modelVersion) override
+    {
+        Base::Load(fstream, modelVersion);
+        fstream >> m_scale;
+        fstream >> m_causal;
+    }
+
+    virtual void CopyTo(ComputationNodeBasePtr nodeP, const std::wstring& newName, const CopyNodeFlags flags) const override
+    {
+        Base::CopyTo(nodeP, newName, flags);
+        if (flags & CopyNodeFlags::copyNodeValue)
+        {
+            auto node = dynamic_pointer_cast<ScaledDotProductAttentionNode<ElemType>>(nodeP);
+            node->m_scale = m_scale;
+            node->m_causal = m_causal;
+        }
+    }
+
+    virtual void /*ComputationNode::*/ ForwardProp(const FrameRange& fr) override
+    {
+        Matrix<ElemType> sliceOutputValue = ValueFor(fr);
+        Matrix<ElemType> sliceLogSumExp = DataFor(*m_logSumExp, fr);
+        Matrix<ElemType>::ScaledDotProductAttentionForward(InputRef(QUERY).ValueFor(fr), InputRef(KEY).ValueFor(fr), InputRef(VALUE).ValueFor(fr),
+                                                           sliceOutputValue, sliceLogSumExp,
+                                                           DimQK(), DimV(), NumHeads(), Scale(), m_causal);
+    }
+
+    virtual void /*ComputationNode::*/ BackpropTo(const size_t inputIndex, const FrameRange& fr) override
+    {
+        Matrix<ElemType> sliceQueryValue = InputRef(QUERY).ValueFor(fr);
+        Matrix<ElemType> sliceKeyValue   = InputRef(KEY).ValueFor(fr);
+        Matrix<ElemType> sliceValueValue = InputRef(VALUE).ValueFor(fr);
+        Matrix<ElemType> sliceOutputValue = ValueFor(fr);
+        Matrix<ElemType> sliceOutputGrad = GradientFor(fr);
+        Matrix<ElemType> sliceLogSumExp = DataFor(*m_logSumExp, fr);
+
+        if (inputIndex == QUERY)
+        {
+            Matrix<ElemType> sliceQueryGrad = InputRef(QUERY).GradientFor(fr);
+            Matrix<ElemType>::ScaledDotProductAttentionBackwardQuery(sliceQueryValue, sliceKeyValue, sliceValueValue, sliceOutputValue, sliceOutputGrad, sliceLogSumExp,
+                                                                     sliceQueryGrad, DimQK(), DimV(), NumHeads(), Scale(), m_causal);
+            return;
+        }
+
+        // The key and value gradients come out of the same pass. It runs when the first of the two is requested,
+        // and the other one is picked up from the temporaries when its turn comes (for the same frame range).
+        if (inputIndex == KEY || !InputRef(KEY).NeedsGradient())
+        {
+            m_keyGrad->Resize(sliceKeyValue);
+            m_valueGrad->Resize(sliceValueValue);
+            m_keyGrad->SetValue(0);
+            m_valueGrad->SetValue(0);
+            Matrix<ElemType>::ScaledDotProductAttentionBackwardKeyValue(sliceQueryValue, sliceKeyValue, sliceValueValue, sliceOutputValue, sliceOutputGrad, sliceLogSumExp,
+                                                                        *m_keyGrad, *m_valueGrad, DimQK(), DimV(), NumHeads(), Scale(), m_causal);
+        }
+        InputRef(inputIndex).GradientFor(fr) += (inputIndex == KEY) ? *m_keyGrad : *m_valueGrad;
+    }
+
+    virtual void UpdateFunctionMBSize() override
+    {
+        Base::UpdateFunctionMBSize();
+        m_logSumExp->Resize(NumQueries() * NumHeads(), Value().GetNumCols());
+    }
+
+    virtual void /*ComputationNodeBase::*/ Validate(bool isFinalValidationPass) override
+    {
+        Base::Validate(isFinalValidationPass);
+        InferMBLayoutFromInputsForStandardCase(isFinalValidationPass);
+
+        const auto& queryLayout = Input(QUERY)->GetSampleLayout();
+        const auto& keyLayout   = Input(KEY)->GetSampleLayout();
+        const auto& valueLayout = Input(VALUE)->GetSampleLayout();
+        const size_t rank = queryLayout.GetRank();
+        if (rank != 2 && rank != 3)
+            InvalidArgument("%ls: query must be a [dimQK x numQueries] or [dimQK x numQueries x numHeads] tensor, but has shape %s.", NodeDescription().c_str(), string(queryLayout).c_str());
+
+        if (isFinalValidationPass)
+        {
+            if (keyLayout.GetRank() != rank || valueLayout.GetRank() != rank)
+                InvalidArgument("%ls: query, key, and value must have the same rank.", NodeDescription().c_str());
+            if (keyLayout[0] != queryLayout[0] || valueLayout[1] != keyLayout[1] || (rank == 3 && (keyLayout[2] != queryLayout[2] || valueLayout[2] != queryLayout[2])))
+                InvalidArgument("%ls: incompatible shapes: query %s, key %s, value %s.", NodeDescription().c_str(),
+                                string(queryLayout).c_str(), string(keyLayout).c_str(), string(valueLayout).c_str());
+            if (m_causal && keyLayout[1] < queryLayout[1])
+                InvalidArgument("%ls: causal attention requires at least as many keys as queries.", NodeDescription().c_str());
+            for (size_t i = 0; i < GetNumInputs(); i++)
+            {
+                if (Input(i)->GetMBLayout() != GetMBLayout())
+                    InvalidArgument("%ls: query, key, and value must have the same dynamic axes.", NodeDescription().c_str());
+            }
+        }
+
+        SmallVector<size_t> dims = valueLayout.GetDims();
+        if (dims.size() == rank)
+            dims[1] = queryLayout[1];
+        SetDims(TensorShape(dims), HasMBLayout());
+    }
+
+    virtual void RequestMatricesBeforeForwardProp(MatrixPool& matrixPool) override
+    {
+        Base::RequestMatricesBeforeForwardProp(matrixPool);
+        RequestMatrixFromPool(m_logSumExp, matrixPool);
+    }
+
+    virtual void RequestMatricesBeforeBackprop(MatrixPool& matrixPool) override
+    {
+        Base::RequestMatricesBeforeBackprop(matrixPool);
+        RequestMatrixFromPool(m_keyGrad, matrixPool);
+        RequestMatrixFromPool(m_valueGrad, matrixPool);
+    }
+
+    virtual void ReleaseMatricesAfterBackprop(MatrixPool& matrixPool) override
+    {
+        Base::ReleaseMatricesAfterBackprop(matrixPool);
+        ReleaseMatrixToPool(m_logSumExp, matrixPool);
+        ReleaseMatrixToPool(m_keyGrad, matrixPool);
+        ReleaseMatrixToPool(m_valueGrad, matrixPool);
+    }
+
+    double ScaleAttribute() const { return m_scale; }
+    bool IsCausal() const { return m_causal; }
+
+private:
+    size_t DimQK() const      { return Input(QUERY)->GetSampleLayout()[0]; }
+    size_t DimV() const       { return Input(VALUE)->GetSampleLayout()[0]; }
+    size_t NumQueries() const { return Input(QUERY)->GetSampleLayout()[1]; }
+    size_t NumHeads() const   { return Input(QUERY)->GetSampleLayout().GetRank() == 3 ? Input(QUERY)->GetSampleLayout()[2] : 1; }
+    double Scale() const      { return m_scale != 0 ? m_scale : 1 / sqrt((double)DimQK()); }
+
+    double m_scale;
+    bool m_causal;
+
+    shared_ptr<Matrix<ElemType>> m_logSumExp; // log of the softmax denominator of every query, saved for backprop
+    shared_ptr<Matrix<ElemType>> m_keyGrad;   // temporaries for the joint key/value gradient pass
+    shared_ptr<Matrix<ElemType>> m_valueGrad;
+};
+
+template class ScaledDotProductAttentionNode<float>;
+template class ScaledDotProductAttentionNode<double>;
+template class ScaledDotProductAttentionNode<half>;
+
 // -----------------------------------------------------------------------
 // CosDistanceWithNegativeSamplesNode (left, right, shift, neg)
 //
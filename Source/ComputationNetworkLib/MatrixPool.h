@@ -32,13 +32,29 @@ struct MemRequestInfo
     int allocStep;                              // at what step counter memory allocation is requested 
     int releaseStep;                            // at what step counter memory release is requested  
     int memoryId;                               // integer indexing the memory buffer ID 
+    vector<pair<int, int>> recomputeSteps;      // additional [alloc, release] step intervals of values that are recomputed during backprop 
     MemRequestInfo(DEVICEID_TYPE deviceId, shared_ptr<Matrix<ElemType>>*pMatrixPtr, size_t matrixSize, bool mbScale, bool isWorkSpace, int allocStep)
         :deviceId(deviceId), matrixSize(matrixSize), mbScale(mbScale), isWorkSpace(isWorkSpace), allocStep(allocStep), releaseStep(INT_MAX), memoryId(-1)
     {
         pMatrixPtrs.push_back(pMatrixPtr);
     }
-    void SetReleaseStep(int step) { releaseStep = step; }
+    void SetReleaseStep(int step)
+    {
+        if (recomputeSteps.empty())
+            releaseStep = step;
+        else
+            recomputeSteps.back().second = step;
+    }
+    void AddRecomputeStep(int step) { recomputeSteps.push_back(make_pair(step, INT_MAX)); }
     void SetMemoryId(int id) { memoryId = id;  }
+
+    // all step intervals during which the memory is in use
+    vector<pair<int, int>> GetOccupancy() const
+    {
+        vector<pair<int, int>> occ(1, make_pair(allocStep, releaseStep));
+        occ.insert(occ.end(), recomputeSteps.begin(), recomputeSteps.end());
+        return occ;
+    }
 };
 
 template <class ElemType>
@@ -147,6 +163,18 @@ public:
         *pMatrixPtr = make_shared<Matrix<ElemType>>(deviceId);
     }
 
+    // re-open the lifetime of a matrix that has been released before, for a value that is recomputed during backprop
+    // The matrix keeps its memory request; it just gets an additional interval, which ends with the next RequestRelease().
+    template <class ElemType>
+    void RequestReallocate(shared_ptr<Matrix<ElemType>> *pMatrixPtr)
+    {
+        auto memInfo = GetMemInfo(pMatrixPtr);
+        if (memInfo == nullptr)
+            LogicError("RequestReallocate: matrix was not requested from the pool before.");
+        memInfo->AddRecomputeStep(m_stepCounter);
+        m_stepCounter++;
+    }
+
     void OptimizedMemoryAllocation()
     {
         // MatrixPool is not templated, so we call both float and double versions here 
@@ -228,15 +256,20 @@ public:
     }
 
 private: 
-    bool CheckOverlap(pair<int, int>occ, vector<pair<int, int>>&occVec)
+    bool CheckOverlap(const vector<pair<int, int>>& occs, vector<pair<int, int>>&occVec)
     {
         bool bRet = false;
-        for (auto& o : occVec)
+        for (auto& occ : occs)
         {
-            if (occ.first <= o.second && occ.second >= o.first)
-            {
-                bRet = true;
+            if (bRet)
                 break;
+            for (auto& o : occVec)
+            {
+                if (occ.first <= o.second && occ.second >= o.first)
+                {
+                    bRet = true;
+                    break;
+                }
             }
         }
 //#define SUPRESS_MEMSHARING // #define this to disable memory sharing by always return true 
@@ -296,13 +329,12 @@ private:
                         // since we assign from highest memory to lowest, every memory that has been allocated can accommodate the 
                         // current memory request, unless there is a conflict (overlap) 
                         auto iter = memAllocInfoVec.begin();
-                        while (iter != memAllocInfoVec.end() && CheckOverlap(make_pair(memInfo.allocStep, memInfo.releaseStep), iter->occupancy))
+                        while (iter != memAllocInfoVec.end() && CheckOverlap(memInfo.GetOccupancy(), iter->occupancy))
                             iter++;
                         if (iter == memAllocInfoVec.end())
                         {
                             // no current memory can be assigned, need to create a new one 
-                            vector<pair<int, int>> occ;
-                            occ.push_back(make_pair(memInfo.allocStep, memInfo.releaseStep));
+                            vector<pair<int, int>> occ = memInfo.GetOccupancy();
                             MemAllocInfo ma(memoryCounter, memInfo.matrixSize, occ);
                             // insert in the front of the vector to maintain sorted order 
                             memAllocInfoVec.insert(memAllocInfoVec.begin(), ma);
@@ -311,14 +343,14 @@ private:
                         }
                         else
                         {
-                            iter->occupancy.push_back(make_pair(memInfo.allocStep, memInfo.releaseStep));
+                            auto occ = memInfo.GetOccupancy();
+                            iter->occupancy.insert(iter->occupancy.end(), occ.begin(), occ.end());
                             memInfo.SetMemoryId(iter->memoryId);
                         }
                     }
                     else
                     {
-                        vector<pair<int, int>> occ;
-                        occ.push_back(make_pair(memInfo.allocStep, memInfo.releaseStep));
+                        vector<pair<int, int>> occ = memInfo.GetOccupancy();
                         MemAllocInfo ma(memoryCounter, memInfo.matrixSize, occ);
                         memAllocInfoVec.push_back(ma);
                         memInfo.SetMemoryId(memoryCounter);
@@ -339,13 +371,12 @@ private:
                         auto workingAlloc = memAllocInfoVec.end();
                         for (auto iter = memAllocInfoVec.begin(); iter != memAllocInfoVec.end(); iter++)
                         {
-                            if (!CheckOverlap(make_pair(memInfo.allocStep, memInfo.releaseStep), iter->occupancy))
+                            if (!CheckOverlap(memInfo.GetOccupancy(), iter->occupancy))
                                 workingAlloc = iter;
                         }
                         if (workingAlloc == memAllocInfoVec.end())  // nothing works 
                         {
-                            vector<pair<int, int>> occ;
-                            occ.push_back(make_pair(memInfo.allocStep, memInfo.releaseStep));
+                            vector<pair<int, int>> occ = memInfo.GetOccupancy();
                             MemAllocInfo ma(memoryCounter, memInfo.matrixSize, occ);
                             memAllocInfoVec.push_back(ma);  // add as the last one 
                             memInfo.SetMemoryId(memoryCounter);
@@ -353,14 +384,14 @@ private:
                         }
                         else
                         {
-                            workingAlloc->occupancy.push_back(make_pair(memInfo.allocStep, memInfo.releaseStep));
+                            auto occ = memInfo.GetOccupancy();
+                            workingAlloc->occupancy.insert(workingAlloc->occupancy.end(), occ.begin(), occ.end());
                             memInfo.SetMemoryId(workingAlloc->memoryId);
                         }
                     }
                     else
                     {
-                        vector<pair<int, int>> occ;
-                        occ.push_back(make_pair(memInfo.allocStep, memInfo.releaseStep));
+                        vector<pair<int, int>> occ = memInfo.GetOccupancy();
                         MemAllocInfo ma(memoryCounter, memInfo.matrixSize, occ);
                         memAllocInfoVec.push_back(ma);
                         memInfo.SetMemoryId(memoryCounter);
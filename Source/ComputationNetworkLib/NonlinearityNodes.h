@@ -71,6 +71,12 @@ public:
         {
             // Do nothing
         }
+        else if (IsOutputStashedAs(ActivationStashFormat::SignBit))
+        {
+            // ReLU with compressed activations: the derivative is the stashed mask of positive outputs
+            auto sliceInputGradMatrix = InputRef(0).GradientFor(fr);
+            sliceInputGradMatrix.AssignElementProductOfBitMask(GradientFor(fr), StashedMaskBitsFor(fr), (ElemType)1, Input(inputIndex)->IsGradientInitializedBy(this) ? (ElemType)0 : (ElemType)1);
+        }
         else if (opTypeHolder == unaryGradient)
         {
             sliceInputGrad.DoUnaryOpOf(Input(inputIndex)->IsGradientInitializedBy(this) ? 0.0f : 1.0f, sliceOutputGrad, 1, opBackward, opSum);
@@ -92,7 +98,19 @@ public:
 
     virtual bool OutputUsedInComputingInputNodesGradients() const override
     {
-        return opType == binaryWithOutputGradient;
+        return opType == binaryWithOutputGradient && !IsOutputStashedAs(ActivationStashFormat::SignBit);
+    }
+
+    // ReLU keeps one bit per element (CPU only, since the bit-mask kernels are); with lossy compression,
+    // bounded activations whose derivative is computed from the output keep an fp16 copy
+    virtual ActivationStashFormat OutputStashFormat() const override
+    {
+        if (opBackward == opElementwiseProductWithLinearRectifierDerivativeFromOutput && m_deviceId == CPUDEVICE)
+            return ActivationStashFormat::SignBit;
+        if (Globals::ShouldCompressActivationsLossy() && !std::is_same<ElemType, half>::value &&
+            (opBackward == opElementwiseProductWithSigmoidDerivativeFromOutput || opBackward == opElementwiseProductWithTanhDerivativeFromOutput))
+            return ActivationStashFormat::Half;
+        return ActivationStashFormat::None;
     }
 
     virtual bool InputUsedInComputingInputNodesGradients(size_t /*childIndex*/) const override
@@ -100,6 +118,8 @@ public:
         return opType == binaryWithInputGradient;
     }
 
+    virtual bool IsForwardPropRepeatable() const override { return true; }
+
     virtual ParentGradientOptimization ImplementsGradientOptimization(const ComputationNodeBase*) const override { return (opType != noGradient) ? ParentGradientOptimization::Overwrite : ParentGradientOptimization::None; }
 };
 
@@ -680,6 +700,14 @@ public:
         // there is only a gradient for the input tensor that is to be clipped
         if (inputIndex == 2)
         {
+            // the input and output values have been released if the output is stashed
+            if (IsOutputStashedAs(ActivationStashFormat::SignBit))
+            {
+                auto inputGradientMatrix = InputRef(inputIndex).GradientFor(fr);
+                inputGradientMatrix.AssignElementProductOfBitMask(GradientFor(fr), StashedMaskBitsFor(fr), (ElemType)1, /*beta=*/(ElemType)1);
+                return;
+            }
+
             size_t rank = DetermineElementwiseTensorRank();
             auto gradient =                           GradientTensorFor(rank, fr);
             auto inputGradient = InputRef(inputIndex).GradientTensorFor(rank, fr.AllowBroadcast());
@@ -690,6 +718,25 @@ public:
         }        
     }
 
+    virtual bool OutputUsedInComputingInputNodesGradients() const override { return !IsOutputStashedAs(ActivationStashFormat::SignBit); }
+    virtual bool InputUsedInComputingInputNodesGradients(size_t /*childIndex*/) const override { return !IsOutputStashedAs(ActivationStashFormat::SignBit); }
+
+    virtual bool IsForwardPropRepeatable() const override { return true; }
+
+    // The gradient passes where the input was not clipped. Without broadcasting, that is one bit per output element.
+    virtual ActivationStashFormat OutputStashFormat() const override
+    {
+        if (m_deviceId == CPUDEVICE && Input(2)->GetSampleLayout() == GetSampleLayout() && Input(2)->GetMBLayout() == GetMBLayout())
+            return ActivationStashFormat::SignBit;
+        return ActivationStashFormat::None;
+    }
+
+    virtual void StashOutput() override
+    {
+        m_stashedMaskBits.resize(Matrix<ElemType>::GetBitMaskWordsPerColumn(Value().GetNumRows()) * Value().GetNumCols());
+        Matrix<ElemType>::SetBitMaskOfEqual(m_stashedMaskBits.data(), InputRef(2).Value(), Value());
+    }
+
     virtual void /*ComputationNodeBase::*/ Validate(bool isFinalValidationPass) override
     {
         ValidateNaryZip(isFinalValidationPass, /* allow broadcast */ true, /* num Inputs */ 3);
@@ -13,6 +13,8 @@
 
 #define __STDC_FORMAT_MACROS
 #include <inttypes.h>
+#include <algorithm>
+#include <limits>
 #include <map>
 #include <string>
 #include <vector>
@@ -1489,41 +1491,150 @@ public:
           m_softMax(deviceId),
           m_grdToSoftMaxInput(deviceId),
           m_clsLogSoftmax(deviceId),
-          m_clsSoftmax(deviceId)
+          m_clsSoftmax(deviceId),
+          m_obs(deviceId),
+          m_grdToObs(deviceId),
+          m_targetLogProbs(deviceId),
+          m_tokenColumns(deviceId),
+          m_targetPositions(deviceId),
+          m_classTargetPositions(deviceId)
     {
     }
 
 private:
-    // iterate over a large workspace that contains all class-conditioned probs concatenated
-    // 'sz' is the offset into that vector. We will iterate over these vectors at a few places. Always use this same boilerplate code.
-    template<class F>
-    size_t ForColumnsWithClass(const F& op)
-    {
-        const size_t nT = Input(LABELDATA)->GetNumTimeSteps();
-        const size_t nS = Input(LABELDATA)->GetNumParallelSequences();
-        size_t sz = 0; // iterate over the packed concatenated class-conditioned prob vectors
-        for (size_t s = 0; s < nS; s++)
-            for (size_t t = 0; t < nT; t++)
+    struct Token
+    {
+        size_t s, t;   // sequence and time step
+        size_t y, c;   // word and class index
+        size_t lftBnd; // index of the first word of the class
+        size_t nbrWrd; // number of words in the class
+    };
+    struct ClassGroup
+    {
+        size_t lftBnd;     // index of the first word of the class
+        size_t nbrWrd;     // number of words in the class
+        size_t firstToken; // index of the first token of the class in m_tokens
+        size_t numTokens;  // number of tokens of the class
+        size_t offset;     // offset of the [nbrWrd x numTokens] block of the class in the concatenated workspace
+    };
+    struct IndexRange
+    {
+        size_t firstToken; // index of the first token of the range in m_tokens
+        size_t numTokens;  // number of tokens of the range
+        size_t base;       // first column of the gather source/scatter target that the tokens of the range index
+        size_t size;       // number of those columns
+    };
+
+    // Add the token 'i' of a gather/scatter map to its ranges, and return its index relative to the range.
+    // The index maps are passed as ElemType, which holds integers exactly only up to 2^digits. The positions of the tokens
+    // increase within each class group, so a new range starts only at a class boundary or after 2^digits columns.
+    static ElemType AddToIndexRanges(std::vector<IndexRange>& ranges, size_t i, size_t position)
+    {
+        const size_t maxRelativePosition = (size_t)1 << std::numeric_limits<ElemType>::digits;
+        if (ranges.empty() || position < ranges.back().base || position - ranges.back().base >= maxRelativePosition)
+            ranges.push_back(IndexRange{ i, 0, position, 0 });
+
+        auto& range = ranges.back();
+        range.numTokens++;
+        range.size = std::max(range.size, position - range.base + 1);
+        return (ElemType)(position - range.base);
+    }
+
+    // Collect the tokens of the minibatch (skipping gaps) and group them by class, such that the class-conditioned
+    // probs of all tokens of a class form one contiguous [nbr_wrd x numTokens] block of the concatenated workspace.
+    // Each class then takes one matrix product and one column-wise softmax instead of one per token.
+    // Returns the total size of the concatenated workspace.
+    size_t GroupTokensByClass()
+    {
+        const auto& pMBLayout = Input(LABELDATA)->GetMBLayout();
+        const size_t nT = pMBLayout->GetNumTimeSteps();
+        const size_t nS = pMBLayout->GetNumParallelSequences();
+        const Matrix<ElemType>& labels = InputRef(LABELDATA).Value();
+
+        // in the order of the minibatch columns, so that the columns of the tokens of a class increase
+        m_tokens.clear();
+        for (size_t t = 0; t < nT; t++)
+            for (size_t s = 0; s < nS; s++)
             {
-                FrameRange fr = FrameRange(Input(LABELDATA)->GetMBLayout(), t).Sequence(s);
-                if (Input(LABELDATA)->GetMBLayout()->IsGap(fr)) // skip gaps
+                if (pMBLayout->IsGap(FrameRange(pMBLayout, t).Sequence(s))) // skip gaps
                     continue;
 
-                const Matrix<ElemType>& lbl_t = Input(LABELDATA)->ValueFor(fr);
-                size_t y_t = (size_t)lbl_t(0, 0);     // current word token index
-                size_t c_t = (size_t)lbl_t(1, 0);     // current word token's class index
-                size_t lft_bnd = (size_t)lbl_t(2, 0); // index of first word belonging to current word token's class
-                size_t rgt_bnd = (size_t)lbl_t(3, 0); // and end of that range
-                size_t nbr_wrd = (rgt_bnd - lft_bnd); // number of words in the class
+                const size_t j = t * nS + s;
+                Token token;
+                token.s = s;
+                token.t = t;
+                token.y = (size_t)labels(0, j);       // current word token index
+                token.c = (size_t)labels(1, j);       // current word token's class index
+                token.lftBnd = (size_t)labels(2, j);  // index of first word belonging to current word token's class
+                size_t rgt_bnd = (size_t)labels(3, j); // and end of that range
+                token.nbrWrd = rgt_bnd - token.lftBnd; // number of words in the class
+
+                if (rgt_bnd <= token.lftBnd)
+                    LogicError("ClassBasedCrossEntropyWithSoftmax: Encountered a class of size 0.");
+                if (token.y < token.lftBnd || token.y >= rgt_bnd)
+                    LogicError("ClassBasedCrossEntropyWithSoftmax: Word index out of bounds of class-member index range (word not a class member).");
+                m_tokens.push_back(token);
+            }
 
-                // perform the operation
-                op(s, t, fr, y_t, c_t, sz, lft_bnd, nbr_wrd);
+        // group by the range of class members, keeping the minibatch order within a class
+        std::stable_sort(m_tokens.begin(), m_tokens.end(), [](const Token& a, const Token& b)
+        {
+            return a.lftBnd != b.lftBnd ? a.lftBnd < b.lftBnd : a.nbrWrd < b.nbrWrd;
+        });
 
-                sz += nbr_wrd;
-            }
+        const size_t numTokens = m_tokens.size();
+        std::vector<ElemType> tokenColumns(numTokens), targetPositions(numTokens), classTargetPositions(numTokens);
+        m_classGroups.clear();
+        m_tokenColumnRanges.clear();
+        m_targetPositionRanges.clear();
+        m_classTargetPositionRanges.clear();
+        size_t sz = 0; // offset into the packed concatenated class-conditioned prob vectors
+        for (size_t i = 0; i < numTokens; i++)
+        {
+            const Token& token = m_tokens[i];
+            if (m_classGroups.empty() || m_classGroups.back().lftBnd != token.lftBnd || m_classGroups.back().nbrWrd != token.nbrWrd)
+                m_classGroups.push_back(ClassGroup{ token.lftBnd, token.nbrWrd, i, 0, sz });
+            m_classGroups.back().numTokens++;
+
+            const size_t j = token.t * nS + token.s;
+            tokenColumns[i] = AddToIndexRanges(m_tokenColumnRanges, i, j);
+            targetPositions[i] = AddToIndexRanges(m_targetPositionRanges, i, sz + token.y - token.lftBnd);
+            classTargetPositions[i] = AddToIndexRanges(m_classTargetPositionRanges, i, j * m_nbrCls + token.c);
+            sz += token.nbrWrd;
+        }
+
+        m_tokenColumns.SetValue(1, numTokens, m_deviceId, tokenColumns.data());
+        m_targetPositions.SetValue(1, numTokens, m_deviceId, targetPositions.data());
+        m_classTargetPositions.SetValue(1, numTokens, m_deviceId, classTargetPositions.data());
         return sz;
     }
 
+    // [nbr_wrd x numTokens] view of the block of a class in a concatenated workspace
+    static Matrix<ElemType> ClassBlock(const Matrix<ElemType>& workspace, const ClassGroup& group)
+    {
+        return workspace.ColumnSlice(group.offset, group.nbrWrd * group.numTokens).Reshaped(group.nbrWrd, group.numTokens);
+    }
+
+    // out[:, tokens] = in[:, map[tokens]] * alpha + out[:, tokens] * beta, range by range
+    static void GatherColumns(Matrix<ElemType>& out, ElemType beta, const std::vector<IndexRange>& ranges, const Matrix<ElemType>& map, const Matrix<ElemType>& in, ElemType alpha)
+    {
+        for (const auto& range : ranges)
+        {
+            Matrix<ElemType> outRange = out.ColumnSlice(range.firstToken, range.numTokens);
+            outRange.DoGatherColumnsOf(beta, map.ColumnSlice(range.firstToken, range.numTokens), in.ColumnSlice(range.base, range.size), alpha);
+        }
+    }
+
+    // out[:, map[tokens]] += in[:, tokens] * alpha, range by range
+    static void ScatterColumns(Matrix<ElemType>& out, const std::vector<IndexRange>& ranges, const Matrix<ElemType>& map, const Matrix<ElemType>& in, ElemType alpha)
+    {
+        for (const auto& range : ranges)
+        {
+            Matrix<ElemType> outRange = out.ColumnSlice(range.base, range.size);
+            outRange.DoScatterColumnsOf(1, map.ColumnSlice(range.firstToken, range.numTokens), in.ColumnSlice(range.firstToken, range.numTokens), alpha, /*idxHaveDups*/ false);
+        }
+    }
+
     // compute gradients to input observations, the weights to the observations, and the class log posterior probabilities
     virtual void BackpropToNonLooping(size_t inputIndex) override
     {
@@ -1531,40 +1642,49 @@ private:
         if (inputIndex != 1 && inputIndex != 2 && inputIndex != 3)
             InvalidArgument("ClassCrossEntropyWithSoftmaxNode criterion only takes with respect to input, weight to the input and class log posterior probability.");
 
+        if (m_tokens.empty())
+            return;
+
         ComputeSoftMaxPartial(); // Note: Flag m_needRecomputeGradientToSoftmaxInput guards so that this computes only once.
 
-        ForColumnsWithClass([&](size_t /*s*/, size_t /*t*/, const FrameRange& fr, size_t /*y_t*/, size_t c_t, size_t sz, size_t lft_bnd, size_t nbr_wrd)
+        switch (inputIndex)
         {
-            // compute prb - 1 and prb
-            Matrix<ElemType> weightForClass = InputRef(EMBEDDINGMATRIX).ValueAsMatrix().ColumnSlice(lft_bnd, nbr_wrd);
-            Matrix<ElemType> obs = InputRef(INPUTDATA).ValueFor(fr); // hidden activation vector for current word token
-            Matrix<ElemType> grd_to_soft_max_input = m_grdToSoftMaxInput.ColumnSlice(sz, nbr_wrd);
-
-            switch (inputIndex)
+            case 1:
             {
-                case 1:
+                // gradient to input, computed for all tokens of a class at once and then scattered to the token's columns
+                m_grdToObs.Resize(m_obs.GetNumRows(), m_tokens.size());
+                for (const auto& group : m_classGroups)
                 {
-                    // gradient to input
-                    Matrix<ElemType> grd_t = InputRef(INPUTDATA).GradientFor(fr);
-                    Matrix<ElemType>::MultiplyAndAdd(weightForClass, false, grd_to_soft_max_input, true, grd_t);
-                    break;
+                    Matrix<ElemType> weightForClass = InputRef(EMBEDDINGMATRIX).ValueAsMatrix().ColumnSlice(group.lftBnd, group.nbrWrd);
+                    Matrix<ElemType> grd_t = m_grdToObs.ColumnSlice(group.firstToken, group.numTokens);
+                    grd_t.AssignProductOf(weightForClass, false, ClassBlock(m_grdToSoftMaxInput, group), false);
                 }
-                case 2:
+                ScatterColumns(InputRef(INPUTDATA).Gradient(), m_tokenColumnRanges, m_tokenColumns, m_grdToObs, 1);
+                break;
+            }
+            case 2:
+            {
+                // gradient to input weight
+                for (const auto& group : m_classGroups)
                 {
-                    // gradient to input weight
-                    Matrix<ElemType> grd_to_wgt_t = InputRef(EMBEDDINGMATRIX).GradientAsMatrix().ColumnSlice(lft_bnd, nbr_wrd);
-                    Matrix<ElemType>::MultiplyAndAdd(obs, false, grd_to_soft_max_input, false, grd_to_wgt_t);
-                    break;
+                    Matrix<ElemType> grd_to_wgt_t = InputRef(EMBEDDINGMATRIX).GradientAsMatrix().ColumnSlice(group.lftBnd, group.nbrWrd);
+                    Matrix<ElemType> obs = m_obs.ColumnSlice(group.firstToken, group.numTokens);
+                    Matrix<ElemType>::MultiplyAndAdd(obs, false, ClassBlock(m_grdToSoftMaxInput, group), true, grd_to_wgt_t);
                 }
-                case 3:
+                break;
+            }
+            case 3:
+            {
+                for (const auto& token : m_tokens)
                 {
+                    FrameRange fr = FrameRange(Input(LABELDATA)->GetMBLayout(), token.t).Sequence(token.s);
                     Matrix<ElemType> grd_t = InputRef(CLASSPROBINDATA).GradientFor(fr);
                     grd_t.AssignValuesOf(InputRef(CLASSPROBINDATA).DataFor(m_clsSoftmax, fr));
-                    ComputeCEPartialToSoftmaxInputs(grd_t, Gradient(), c_t);
-                    break;
+                    ComputeCEPartialToSoftmaxInputs(grd_t, Gradient(), token.c);
                 }
+                break;
             }
-        });
+        }
     }
 
     virtual bool OutputUsedInComputingInputNodesGradients() const override { return false; }
@@ -1581,17 +1701,12 @@ private:
     {
         if (m_needRecomputeGradientToSoftmaxInput)
         {
-            m_grdToSoftMaxInput.Resize(1, m_totalNbrWords); // buffer that contains a concatenation of class-conditional values
-
-            ForColumnsWithClass([&](size_t /*s*/, size_t /*t*/, const FrameRange& /*fr*/, size_t y_t, size_t /*c_t*/, size_t sz, size_t lft_bnd, size_t nbr_wrd)
-            {
-                Matrix<ElemType> softMax = m_softMax.ColumnSlice(sz, nbr_wrd);
-
-                size_t idx_in_class = y_t - lft_bnd;
-                ComputeCEPartialToSoftmaxInputs(softMax, Gradient(), idx_in_class);
-
-                m_grdToSoftMaxInput.ColumnSlice(sz, nbr_wrd).AssignValuesOf(softMax);
-            });
+            // softmax - 1 at the target words, for all tokens at once
+            m_grdToSoftMaxInput.SetValue(m_softMax); // buffer that contains a concatenation of class-conditional values
+            m_targetLogProbs.Resize(1, m_tokens.size());
+            m_targetLogProbs.SetValue(1);
+            ScatterColumns(m_grdToSoftMaxInput, m_targetPositionRanges, m_targetPositions, m_targetLogProbs, -1);
+            Matrix<ElemType>::Scale(Gradient(), m_grdToSoftMaxInput);
 
             m_needRecomputeGradientToSoftmaxInput = false;
         }
@@ -1611,7 +1726,6 @@ public:
 
         auto& functionValues = Value();
 
-        const size_t hdSize = InputRef(INPUTDATA).GetSampleMatrixNumRows();
         assert(m_nbrCls == InputRef(CLASSPROBINDATA).GetSampleMatrixNumRows());
 
         // compute the class posteriors
@@ -1619,63 +1733,50 @@ public:
         m_clsLogSoftmax.InplaceLogSoftmax(true);   // log
         m_clsSoftmax.AssignExpOf(m_clsLogSoftmax); // non-log
 
-        // create a large workspace to contain all class-conditioned probs concatenated
-        m_totalNbrWords = ForColumnsWithClass([](size_t /*s*/, size_t /*t*/, const FrameRange& /*fr*/, size_t y_t, size_t /*c_t*/, size_t /*sz*/, size_t lft_bnd, size_t nbr_wrd)
-        {
-            if (nbr_wrd == 0)
-                LogicError("ClassBasedCrossEntropyWithSoftmax: Encountered a class of size 0.");
-            if (y_t < lft_bnd || y_t >= lft_bnd + nbr_wrd)
-                LogicError("ClassBasedCrossEntropyWithSoftmax: Word index out of bounds of class-member index range (word not a class member).");
-        });
-        // now m_totalNbrWords = total size of concatenated vector
+        // create a large workspace to contain all class-conditioned probs concatenated, grouped by class
+        m_totalNbrWords = GroupTokensByClass();
+        m_needRecomputeGradientToSoftmaxInput = true;
+
+        functionValues.SetValue(0);
+        if (m_tokens.empty())
+            return;
 
         // buffer to hold the concatenated class-conditioned prob vectors
         m_softMax.Resize(1, m_totalNbrWords);
         m_logSoftmax.Resize(1, m_totalNbrWords);
 
-        // accumulate objective
-        functionValues.SetValue(0);
-        ForColumnsWithClass([&](size_t s, size_t t, const FrameRange& fr, size_t y_t, size_t c_t, size_t sz, size_t lft_bnd, size_t nbr_wrd)
-        {
-            // now get views of various arrays that correspond to the index range of words belonging to this class
+        // hidden activation vectors of the tokens, in the order of the class groups
+        m_obs.Resize(InputRef(INPUTDATA).Value().GetNumRows(), m_tokens.size()); // [hdSize x numTokens]
+        GatherColumns(m_obs, 0, m_tokenColumnRanges, m_tokenColumns, InputRef(INPUTDATA).Value(), 1);
 
+        for (const auto& group : m_classGroups)
+        {
             // get hidden vectors for the words in this class
-            Matrix<ElemType> weightForClass = InputRef(EMBEDDINGMATRIX).ValueAsMatrix().ColumnSlice(lft_bnd, nbr_wrd); // [hdSize x nbr_wrd]
-
-            // buffer to hold the class-conditional distribution
-            Matrix<ElemType> softMax_t = m_softMax.ColumnSlice(sz, nbr_wrd); // TODO: declare these outside of the loop to avoid the malloc
-            Matrix<ElemType> logSoftMax_t = m_logSoftmax.ColumnSlice(sz, nbr_wrd);
-
-            Matrix<ElemType> obs = InputRef(INPUTDATA).ValueFor(fr); // hidden activation vector for current word token
-
-            // multiply hidden activation with weight matrix (the slice of the weight matrix for the range of class members)
-            // TODO: can we use 'true' here instead? Above transposition hack won't work with row slices. 'obs' not used elsewhere
-            obs.Reshape(1, hdSize);                                                                                // transpose it (make it a column vector)
-            logSoftMax_t.AssignProductOf(obs /*(1 x hdSize)*/, false, weightForClass /*hdSize x nbr_wrd*/, false); // -> 1 x nbr_word
-
-            // log softmax(W x_t)
-            logSoftMax_t.InplaceLogSoftmax(false);
-
-            // and non-log version
-            softMax_t.SetValue(logSoftMax_t);
-            softMax_t.InplaceExp();
-            // we now have a column vector of class-conditional probabilities over the class members
+            Matrix<ElemType> weightForClass = InputRef(EMBEDDINGMATRIX).ValueAsMatrix().ColumnSlice(group.lftBnd, group.nbrWrd); // [hdSize x nbr_wrd]
+            Matrix<ElemType> obs = m_obs.ColumnSlice(group.firstToken, group.numTokens);                                            // [hdSize x numTokens]
+
+            // multiply hidden activations with weight matrix (the slice of the weight matrix for the range of class members)
+            // and compute log softmax(W x_t) of all tokens of the class
+            Matrix<ElemType> logSoftMax = ClassBlock(m_logSoftmax, group);
+            logSoftMax.AssignProductOf(weightForClass, true, obs, false); // -> nbr_wrd x numTokens
+            logSoftMax.InplaceLogSoftmax(true);
+        }
 
-            // add  the word's class-conditional log posterior
-            size_t idx_in_class = y_t - lft_bnd;
-            Matrix<ElemType>::AddElementToElement(logSoftMax_t, 0, idx_in_class, functionValues, 0, 0); // (1x1)
+        // and non-log version
+        // we now have column vectors of class-conditional probabilities over the class members
+        m_softMax.AssignExpOf(m_logSoftmax);
 
-            // add the class log posterior probability (for backprop)
-            auto clsLogSoftmax_t = InputRef(CLASSPROBINDATA).DataFor(m_clsLogSoftmax, fr);
-            Matrix<ElemType>::AddElementToElement(clsLogSoftmax_t, c_t, 0, functionValues, 0, 0); // (1x1)
-        });
+        // add the words' class-conditional log posteriors and the class log posterior probabilities (for backprop)
+        m_targetLogProbs.Resize(1, m_tokens.size());
+        GatherColumns(m_targetLogProbs, 0, m_targetPositionRanges, m_targetPositions, m_logSoftmax, 1);
+        GatherColumns(m_targetLogProbs, 1, m_classTargetPositionRanges, m_classTargetPositions, m_clsLogSoftmax.Reshaped(1, m_clsLogSoftmax.GetNumElements()), 1);
+        functionValues.AssignSumOfElements(m_targetLogProbs);
 
         functionValues *= (-1);
 
 #if NANCHECK
         functionValues.HasNan("ClassBasedCrossEntropyWithSoftmax");
 #endif
-        m_needRecomputeGradientToSoftmaxInput = true;
     }
 
     virtual void /*ComputationNodeBase::*/ Validate(bool isFinalValidationPass) override
@@ -1711,6 +1812,22 @@ protected:
     Matrix<ElemType> m_grdToSoftMaxInput;
     bool m_needRecomputeGradientToSoftmaxInput;
 
+    // hidden activations of the tokens, in the order of the class groups, and the gradient w.r.t. them
+    Matrix<ElemType> m_obs;
+    Matrix<ElemType> m_grdToObs;
+    Matrix<ElemType> m_targetLogProbs; // per-token log posteriors of the objective, also used as a row of ones in backprop
+
+    // gather/scatter maps of the tokens in the order of the class groups (ElemType row vectors, relative to the base of their range)
+    Matrix<ElemType> m_tokenColumns;         // minibatch column of each token
+    Matrix<ElemType> m_targetPositions;      // position of the target word in the concatenated workspace
+    Matrix<ElemType> m_classTargetPositions; // position of the target class in the column-major class posteriors
+    std::vector<IndexRange> m_tokenColumnRanges;
+    std::vector<IndexRange> m_targetPositionRanges;
+    std::vector<IndexRange> m_classTargetPositionRanges;
+
+    std::vector<Token> m_tokens; // non-gap tokens, grouped by class
+    std::vector<ClassGroup> m_classGroups;
+
     size_t m_nbrCls;
     size_t m_totalNbrWords;
 };
@@ -2256,14 +2373,18 @@ public:
 
         if (InputRef(0).IsGradientInitializedBy(this))
         {
-            if (IsEnabled())
+            if (IsEnabled() && UseBitMask())
+                sliceInput0Grad.AssignElementProductOfBitMask(sliceOutputGrad, MaskBitsFor(fr), GetDropoutScale());
+            else if (IsEnabled())
                 sliceInput0Grad.AssignElementProductOf(sliceOutputGrad, DataFor(*m_maskOfDropout, fr));
             else
                 sliceInput0Grad.AssignValuesOf(sliceOutputGrad);
         }
         else
         {
-            if (IsEnabled())
+            if (IsEnabled() && UseBitMask())
+                sliceInput0Grad.AssignElementProductOfBitMask(sliceOutputGrad, MaskBitsFor(fr), GetDropoutScale(), /*beta=*/1);
+            else if (IsEnabled())
                 sliceInput0Grad.AddElementProductOf(sliceOutputGrad, DataFor(*m_maskOfDropout, fr));
             else
                 sliceInput0Grad += sliceOutputGrad;
@@ -2281,7 +2402,9 @@ public:
     {
         Base::UpdateFunctionMBSize();
         // resize temporaries to their proper size
-        if (IsEnabled())
+        if (IsEnabled() && UseBitMask())
+            m_maskBitsOfDropout.resize(Matrix<ElemType>::GetBitMaskWordsPerColumn(Input(0)->Value().GetNumRows()) * Input(0)->Value().GetNumCols());
+        else if (IsEnabled())
             m_maskOfDropout->Resize(Input(0)->Value());
     }
 
@@ -2294,11 +2417,20 @@ public:
         {
             sliceOutputValue.SetValue(sliceInput0Value);
         }
+        else if (UseBitMask())
+        {
+            // determine drop-out mask for this minibatch, one bit per element; it is expanded on the fly here and in BackpropTo()
+            uint32_t* sliceMaskBits = MaskBitsFor(fr);
+            Matrix<ElemType>::SetUniformRandomBitMask(sliceMaskBits, sliceOutputValue.GetNumRows(), sliceOutputValue.GetNumCols(), GetDropoutRate(), GetRNGHandle());
+            // apply dropout mask
+            sliceOutputValue.AssignElementProductOfBitMask(sliceInput0Value, sliceMaskBits, GetDropoutScale());
+            UpdateRngOffset(GetRngOffset() + sliceOutputValue.GetNumElements());
+        }
         else
         {
             // determine drop-out mask for this minibatch
             auto sliceMask = DataFor(*m_maskOfDropout, fr);
-            sliceMask.SetUniformRandomMask((ElemType)GetDropoutRate(), (ElemType)(1.0 / (1.0 - GetDropoutRate())) /*pre-scaled*/, GetRNGHandle());
+            sliceMask.SetUniformRandomMask((ElemType)GetDropoutRate(), GetDropoutScale() /*pre-scaled*/, GetRNGHandle());
             // apply dropout mask
             sliceOutputValue.AssignElementProductOf(sliceMask, sliceInput0Value);
             UpdateRngOffset(GetRngOffset() + sliceMask.GetNumElements());
@@ -2324,26 +2456,197 @@ public:
             node->SetDropoutRate(GetDropoutRate());
             node->SetRngState(GetRngSeed(), GetRngOffset());
             node->m_maskOfDropout = m_maskOfDropout;
+            node->m_maskBitsOfDropout = m_maskBitsOfDropout;
         }
     }
     // request matrices needed to do node function value evaluation
     virtual void RequestMatricesBeforeForwardProp(MatrixPool& matrixPool)
     {
         Base::RequestMatricesBeforeForwardProp(matrixPool);
-        RequestMatrixFromPool(m_maskOfDropout, matrixPool);
+        if (!UseBitMask())
+            RequestMatrixFromPool(m_maskOfDropout, matrixPool);
     }
 
     // release gradient and temp matrices that no longer needed after all the children's gradients are computed.
+    // The bit mask is not pooled; at 1/32 of the output size it is kept allocated across minibatches.
     virtual void ReleaseMatricesAfterBackprop(MatrixPool& matrixPool)
     {
         Base::ReleaseMatricesAfterBackprop(matrixPool);
-        ReleaseMatrixToPool(m_maskOfDropout, matrixPool);
+        if (!UseBitMask())
+            ReleaseMatrixToPool(m_maskOfDropout, matrixPool);
     }
 
 private:
-    shared_ptr<Matrix<ElemType>> m_maskOfDropout;
+    // On the CPU the mask is kept as one bit per element instead of a full ElemType matrix.
+    bool UseBitMask() const { return m_deviceId == CPUDEVICE; }
+
+    ElemType GetDropoutScale() const { return (ElemType)(1.0 / (1.0 - GetDropoutRate())); }
+
+    // bit-mask words of the columns selected by 'fr'; columns start on word boundaries
+    // (derived from the layouts, since the value matrix may be shared with other nodes during backprop)
+    uint32_t* MaskBitsFor(const FrameRange& fr)
+    {
+        size_t rows, cols;
+        this->DetermineDataSize(rows, cols);
+        auto columnRange = ColumnRangeWithMBLayoutFor(cols, fr, GetMBLayout());
+        return m_maskBitsOfDropout.data() + columnRange.first * Matrix<ElemType>::GetBitMaskWordsPerColumn(rows);
+    }
+
+    shared_ptr<Matrix<ElemType>> m_maskOfDropout;    // GPU: mask as a full matrix
+    std::vector<uint32_t> m_maskBitsOfDropout;       // CPU: bit-packed mask
 };
 
+// -----------------------------------------------------------------------
+// LayerNormalizationNode (input, scale, bias, epsilon=1e-5)
+// Normalizes every sample to zero mean and unit variance over all of its elements, then applies an elementwise
+// scale and bias. Unlike batch normalization there are no running statistics, and training and inference
+// compute the same function. Scale and bias have the shape of a sample, or a single element; if specified
+// with unknown dimensions, they are inferred from the input.
+// The per-sample mean and inverse standard deviation are kept from ForwardProp() for use in BackpropTo().
+// -----------------------------------------------------------------------
+
+template <class ElemType>
+class LayerNormalizationNode : public ComputationNode<ElemType>, public NumInputs<3>
+{
+    typedef ComputationNode<ElemType> Base;
+    UsingComputationNodeMembersBoilerplate;
+    static const std::wstring TypeName()
+    {
+        return L"LayerNormalization";
+    }
+
+    static const size_t DATA  = 0;
+    static const size_t SCALE = 1;
+    static const size_t BIAS  = 2;
+
+public:
+    LayerNormalizationNode(DEVICEID_TYPE deviceId, const wstring& name, double epsilon = 0.00001)
+        : Base(deviceId, name), m_epsilon(epsilon)
+    {
+    }
+
+    LayerNormalizationNode(const ScriptableObjects::IConfigRecordPtr configp)
+        : LayerNormalizationNode(configp->Get(L"deviceId"), L"<placeholder>", configp->Get(L"epsilon"))
+    {
+        AttachInputsFromConfig(configp, this->GetExpectedNumInputs());
+    }
+
+    virtual void Save(File& fstream) const override
+    {
+        Base::Save(fstream);
+        fstream << m_epsilon;
+    }
+
+    virtual void Load(File& fstream, size_t modelVersion) override
+    {
+        Base::Load(fstream, modelVersion);
+        fstream >> m_epsilon;
+    }
+
+    virtual void CopyTo(ComputationNodeBasePtr nodeP, const std::wstring& newName, const CopyNodeFlags flags) const override
+    {
+        Base::CopyTo(nodeP, newName, flags);
+        if (flags & CopyNodeFlags::copyNodeValue)
+        {
+            auto node = dynamic_pointer_cast<LayerNormalizationNode<ElemType>>(nodeP);
+            node->m_epsilon = m_epsilon;
+        }
+    }
+
+    virtual void /*ComputationNode::*/ ForwardProp(const FrameRange& fr) override
+    {
+        Matrix<ElemType> sliceOutputValue = ValueFor(fr);
+        Matrix<ElemType> sliceSavedMean = DataFor(*m_savedMean, fr);
+        Matrix<ElemType> sliceSavedInvStdDev = DataFor(*m_savedInvStdDev, fr);
+        InputRef(DATA).ValueFor(fr).LayerNormalizationForward(InputRef(SCALE).Value(), InputRef(BIAS).Value(), m_epsilon,
+                                                              sliceOutputValue, sliceSavedMean, sliceSavedInvStdDev);
+    }
+
+    virtual void /*ComputationNode::*/ BackpropTo(const size_t inputIndex, const FrameRange& fr) override
+    {
+        if (inputIndex == DATA)
+        {
+            Matrix<ElemType> sliceInputGrad = InputRef(DATA).GradientFor(fr);
+            GradientFor(fr).LayerNormalizationBackward(InputRef(DATA).ValueFor(fr), sliceInputGrad, InputRef(SCALE).Value(),
+                                                       DataFor(*m_savedMean, fr), DataFor(*m_savedInvStdDev, fr));
+        }
+        else if (inputIndex == SCALE)
+        {
+            // gaps must not contribute to the parameter gradients
+            MaskMissingGradientColumnsToZero(fr);
+            GradientFor(fr).LayerNormalizationScaleGradient(InputRef(DATA).ValueFor(fr), DataFor(*m_savedMean, fr), DataFor(*m_savedInvStdDev, fr),
+                                                            InputRef(SCALE).Gradient());
+        }
+        else if (inputIndex == BIAS)
+        {
+            MaskMissingGradientColumnsToZero(fr);
+            size_t rank = DetermineElementwiseTensorRank();
+            auto gradient = GradientTensorFor(rank, fr);
+            auto inputGradient = InputRef(BIAS).GradientTensorFor(rank, fr.AllowBroadcast());
+            inputGradient.AddCopyOf(gradient);
+        }
+    }
+
+    virtual bool OutputUsedInComputingInputNodesGradients() const override { return false; }
+    virtual bool InputUsedInComputingInputNodesGradients(size_t childIndex) const override { return childIndex != BIAS; }
+
+    virtual void UpdateFunctionMBSize() override
+    {
+        Base::UpdateFunctionMBSize();
+        m_savedMean->Resize(1, Value().GetNumCols());
+        m_savedInvStdDev->Resize(1, Value().GetNumCols());
+    }
+
+    virtual void /*ComputationNodeBase::*/ Validate(bool isFinalValidationPass) override
+    {
+        Base::Validate(isFinalValidationPass);
+        InferMBLayoutFromInputsForStandardCase(isFinalValidationPass);
+
+        SetDims(Input(DATA));
+
+        const auto& inputLayout = Input(DATA)->GetSampleLayout();
+        for (size_t i = SCALE; i <= BIAS; i++)
+        {
+            if (Input(i)->HasMBLayout())
+                InvalidArgument("%ls: %s must not have a dynamic axis.", NodeDescription().c_str(), i == SCALE ? "scale" : "bias");
+            Input(i)->ValidateInferInputDimsFrom(inputLayout);
+            if (isFinalValidationPass)
+            {
+                size_t paramSize = Input(i)->GetSampleLayout().GetNumElements();
+                if (paramSize != inputLayout.GetNumElements() && paramSize != 1)
+                    InvalidArgument("%ls: %s has %d elements; it must have the shape of the input %s, or a single element.", NodeDescription().c_str(),
+                                    i == SCALE ? "scale" : "bias", (int)paramSize, string(inputLayout).c_str());
+            }
+        }
+    }
+
+    virtual void RequestMatricesBeforeForwardProp(MatrixPool& matrixPool) override
+    {
+        Base::RequestMatricesBeforeForwardProp(matrixPool);
+        RequestMatrixFromPool(m_savedMean, matrixPool);
+        RequestMatrixFromPool(m_savedInvStdDev, matrixPool);
+    }
+
+    virtual void ReleaseMatricesAfterBackprop(MatrixPool& matrixPool) override
+    {
+        Base::ReleaseMatricesAfterBackprop(matrixPool);
+        ReleaseMatrixToPool(m_savedMean, matrixPool);
+        ReleaseMatrixToPool(m_savedInvStdDev, matrixPool);
+    }
+
+    double Epsilon() const { return m_epsilon; }
+
+private:
+    double m_epsilon;
+
+    shared_ptr<Matrix<ElemType>> m_savedMean;       // [1 x T]
+    shared_ptr<Matrix<ElemType>> m_savedInvStdDev;  // [1 x T]
+};
+
+template class LayerNormalizationNode<float>;
+template class LayerNormalizationNode<double>;
+template class LayerNormalizationNode<half>;
+
 // -----------------------------------------------------------------------
 // BatchNormalizationNode (input, scale, bias, runMean, runVariance, runCount,
 //                         spatial, normalizationTimeConstant = 0, blendTimeConstant = 0,
@@ -166,6 +166,11 @@ public:
     void SetGaussianRandomValue(const ElemType mean, const ElemType sigma, unsigned long seed = USE_TIME_BASED_SEED);
     void SetTruncatedNormalRandomValue(const ElemType mean, const ElemType sigma, unsigned long seed = USE_TIME_BASED_SEED);
     void SetUniformRandomMask(const ElemType maskRate, const ElemType scaleValue, RNGHandle& rngHandle);
+    static size_t GetBitMaskWordsPerColumn(const size_t numRows) { return (numRows + 31) / 32; }
+    static void SetUniformRandomBitMask(uint32_t* maskBits, const size_t numRows, const size_t numCols, const double maskRate, RNGHandle& rngHandle);
+    void AssignElementProductOfBitMask(const CPUMatrix<ElemType>& a, const uint32_t* maskBits, const ElemType scaleValue, const ElemType beta);
+    static void SetBitMaskOfPositive(uint32_t* maskBits, const CPUMatrix<ElemType>& a);
+    static void SetBitMaskOfEqual(uint32_t* maskBits, const CPUMatrix<ElemType>& a, const CPUMatrix<ElemType>& b);
     void AddGaussianRandomValue(const ElemType mean, const ElemType sigma, unsigned long seed = USE_TIME_BASED_SEED);
 
     CPUMatrix<ElemType> Transpose();
@@ -435,6 +440,24 @@ public:
     void BatchNormalizationBackward(const CPUMatrix<ElemType>& in, CPUMatrix<ElemType>& grad, const CPUMatrix<StatType>& scale, double blendFactor, const CPUMatrix<StatType>& saveMean, const CPUMatrix<StatType>& saveInvStdDev,
                                     CPUMatrix<StatType>& scaleGrad, CPUMatrix<StatType>& biasGrad) const;
 
+    void LayerNormalizationForward(const CPUMatrix<ElemType>& scale, const CPUMatrix<ElemType>& bias, double epsilon,
+                                   CPUMatrix<ElemType>& out, CPUMatrix<ElemType>& saveMean, CPUMatrix<ElemType>& saveInvStdDev) const;
+    void LayerNormalizationBackward(const CPUMatrix<ElemType>& in, CPUMatrix<ElemType>& grad, const CPUMatrix<ElemType>& scale,
+                                    const CPUMatrix<ElemType>& saveMean, const CPUMatrix<ElemType>& saveInvStdDev) const;
+    void LayerNormalizationScaleGradient(const CPUMatrix<ElemType>& in, const CPUMatrix<ElemType>& saveMean, const CPUMatrix<ElemType>& saveInvStdDev,
+                                         CPUMatrix<ElemType>& scaleGrad) const;
+
+    static void ScaledDotProductAttentionForward(const CPUMatrix<ElemType>& query, const CPUMatrix<ElemType>& key, const CPUMatrix<ElemType>& value,
+                                                 CPUMatrix<ElemType>& out, CPUMatrix<ElemType>& logSumExp,
+                                                 size_t dimQK, size_t dimV, size_t numHeads, double scale, bool causal);
+    static void ScaledDotProductAttentionBackwardQuery(const CPUMatrix<ElemType>& query, const CPUMatrix<ElemType>& key, const CPUMatrix<ElemType>& value,
+                                                       const CPUMatrix<ElemType>& out, const CPUMatrix<ElemType>& outGrad, const CPUMatrix<ElemType>& logSumExp,
+                                                       CPUMatrix<ElemType>& queryGrad, size_t dimQK, size_t dimV, size_t numHeads, double scale, bool causal);
+    static void ScaledDotProductAttentionBackwardKeyValue(const CPUMatrix<ElemType>& query, const CPUMatrix<ElemType>& key, const CPUMatrix<ElemType>& value,
+                                                          const CPUMatrix<ElemType>& out, const CPUMatrix<ElemType>& outGrad, const CPUMatrix<ElemType>& logSumExp,
+                                                          CPUMatrix<ElemType>& keyGrad, CPUMatrix<ElemType>& valueGrad,
+                                                          size_t dimQK, size_t dimV, size_t numHeads, double scale, bool causal);
+
 public:
     // This functions do not depend on <ElemType>, i.e. you can call them on any <ElemType>
     static int SetNumThreads(int numThreads);
@@ -566,8 +589,12 @@ public:
     static void RCRFBackwardCompute(const CPUMatrix<ElemType>& alpha, CPUMatrix<ElemType>& beta,
                                     const CPUMatrix<ElemType>& lbls,
                                     const CPUMatrix<ElemType>& pair_scores);
+    static void _rcrfBackwardComputeZeta(size_t t, const CPUMatrix<ElemType>& alpha,
+                                         ElemType* zeta,
+                                         const CPUMatrix<ElemType>& pair_scores);
     static void _rcrfBackwardCompute(size_t t, size_t k, const CPUMatrix<ElemType>& alpha,
                                      CPUMatrix<ElemType>& beta,
+                                     const ElemType* zeta,
                                      const CPUMatrix<ElemType>& pair_scores);
 
     static void RCRFTransGrdCompute(const CPUMatrix<ElemType>& lbls,
@@ -576,10 +603,13 @@ public:
                                     const CPUMatrix<ElemType>& pair_scores,
                                     CPUMatrix<ElemType>& grd);
 
+    static void _rcrfTransGrdComputeZeta(const ElemType* prevAlpha,
+                                         ElemType* zeta,
+                                         const CPUMatrix<ElemType>& pair_scores);
     static void _rcrfTransGrdCompute(size_t i,
-                                     const CPUMatrix<ElemType>& lbls,
-                                     const CPUMatrix<ElemType>& alpha,
+                                     const ElemType* prevAlpha,
                                      const CPUMatrix<ElemType>& beta,
+                                     const ElemType* zeta,
                                      const CPUMatrix<ElemType>& pair_scores,
                                      CPUMatrix<ElemType>& grd,
                                      const size_t tPos // position
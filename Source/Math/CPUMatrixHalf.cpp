@@ -7,9 +7,14 @@
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
-// General conversion function with no performance optimization
-// this should only be used in CPU half precision
-// For performance on inference on CPU, user should convert fp16 model to fp32 first, unless MKL supports half precision
+// Conversion between half storage and float compute buffers. half <-> float conversions use the F16C
+// instructions when available (see HalfConverter.hpp) and are split across threads for large buffers.
+// half kernels below keep the data in half and convert blocks of it to float on the fly, so that no
+// full-size fp32 copy of the operands is needed.
+static_assert(sizeof(half) == sizeof(unsigned short), "half is expected to be stored as 16 bits");
+
+static const size_t c_halfConvertBlockSize = 4096; // elements converted per block / per thread work item
+
 template<typename SrcT, typename DstT>
 static void ConvertBuffer(DstT* dst, const SrcT* src, size_t count)
 {
@@ -19,32 +24,208 @@ static void ConvertBuffer(DstT* dst, const SrcT* src, size_t count)
     }
 }
 
-// specialization to convert from half to float for computation, and then store in half
+template<>
+void ConvertBuffer<half, float>(float* dst, const half* src, size_t count)
+{
+    const long numBlocks = (long)((count + c_halfConvertBlockSize - 1) / c_halfConvertBlockSize);
+#pragma omp parallel for if (numBlocks > 1)
+    for (long b = 0; b < numBlocks; b++)
+    {
+        const size_t offset = b * c_halfConvertBlockSize;
+        ::CNTK::float16ToFloatN(reinterpret_cast<const unsigned short*>(src) + offset, dst + offset, min(c_halfConvertBlockSize, count - offset));
+    }
+}
+
+template<>
+void ConvertBuffer<float, half>(half* dst, const float* src, size_t count)
+{
+    const long numBlocks = (long)((count + c_halfConvertBlockSize - 1) / c_halfConvertBlockSize);
+#pragma omp parallel for if (numBlocks > 1)
+    for (long b = 0; b < numBlocks; b++)
+    {
+        const size_t offset = b * c_halfConvertBlockSize;
+        ::CNTK::floatToFloat16N(src + offset, reinterpret_cast<unsigned short*>(dst) + offset, min(c_halfConvertBlockSize, count - offset));
+    }
+}
+
+static const size_t c_halfScratchMaxRetained = (size_t)1 << 21; // float elements of scratch kept per thread between calls
+
+// Per-thread scratch for the float copies used by the half kernels, reused across calls. Buffers larger than
+// c_halfScratchMaxRetained are released when they go out of scope. Only one may be in use per thread at a time.
+class HalfScratch
+{
+public:
+    HalfScratch(size_t count)
+        : m_scratch(ThreadBuffer())
+    {
+        if (m_scratch.size() < count)
+            m_scratch.resize(count);
+    }
+
+    ~HalfScratch()
+    {
+        if (m_scratch.size() > c_halfScratchMaxRetained)
+            std::vector<float>().swap(m_scratch);
+    }
+
+    float* Data() { return m_scratch.data(); }
+
+private:
+    static std::vector<float>& ThreadBuffer()
+    {
+        static thread_local std::vector<float> scratch;
+        return scratch;
+    }
+
+    std::vector<float>& m_scratch;
+};
+
+// Apply 'reduce(float* block, size_t count, Accumulator& acc)' to consecutive float blocks of a half buffer.
+// Blocks are distributed over threads and the per-thread partials are combined with 'combine'.
+template <class Accumulator, class ReduceFn, class CombineFn>
+static Accumulator ReduceHalfBuffer(const half* src, size_t count, Accumulator init, const ReduceFn& reduce, const CombineFn& combine)
+{
+    const long numBlocks = (long)((count + c_halfConvertBlockSize - 1) / c_halfConvertBlockSize);
+    Accumulator result = init;
+#pragma omp parallel if (numBlocks > 1)
+    {
+        float block[c_halfConvertBlockSize];
+        Accumulator local = init;
+#pragma omp for
+        for (long b = 0; b < numBlocks; b++)
+        {
+            const size_t offset = b * c_halfConvertBlockSize;
+            const size_t n = min(c_halfConvertBlockSize, count - offset);
+            ::CNTK::float16ToFloatN(reinterpret_cast<const unsigned short*>(src) + offset, block, n);
+            reduce(block, n, local);
+        }
+#pragma omp critical
+        result = combine(result, local);
+    }
+    return result;
+}
+
 template <>
-void CPUMatrix<half>::MultiplyAndWeightedAdd(half alpha, const CPUMatrix<half>& a, const bool transposeA, const CPUMatrix<half>& b, const bool transposeB,
-    half beta, CPUMatrix<half>& c, shared_ptr<QuantizedMultiplier<half>> pQuantizedMultiplier)
+/*static*/ void CPUMatrix<half>::Scale(half alpha, CPUMatrix<half>& a)
 {
-    CPUMatrix<float> af(a.GetNumRows(), a.GetNumCols());
-    CPUMatrix<float> bf(b.GetNumRows(), b.GetNumCols());
-    CPUMatrix<float> cf(c.GetNumRows(), c.GetNumCols());
+    if (a.IsEmpty())
+        LogicError("Scale:  Input matrix a is empty.");
 
-    if (alpha != 0)
+    const float scale = (float)alpha;
+    const size_t count = a.GetNumElements();
+    if (scale == 0)
     {
-        ConvertBuffer<half, float>(af.Data(), a.Data(), a.GetNumElements());
-        ConvertBuffer<half, float>(bf.Data(), b.Data(), b.GetNumElements());
+        memset(a.Data(), 0, sizeof(half) * count);
+        return;
     }
 
-    if (beta != 0)
+    unsigned short* data = reinterpret_cast<unsigned short*>(a.Data());
+    const long numBlocks = (long)((count + c_halfConvertBlockSize - 1) / c_halfConvertBlockSize);
+#pragma omp parallel for if (numBlocks > 1)
+    for (long b = 0; b < numBlocks; b++)
     {
-        ConvertBuffer<half, float>(cf.Data(), c.Data(), c.GetNumElements());
+        float block[c_halfConvertBlockSize];
+        const size_t offset = b * c_halfConvertBlockSize;
+        const size_t n = min(c_halfConvertBlockSize, count - offset);
+        ::CNTK::float16ToFloatN(data + offset, block, n);
+        for (size_t i = 0; i < n; i++)
+            block[i] *= scale;
+        ::CNTK::floatToFloat16N(block, data + offset, n);
     }
+}
 
+// specialization to convert from half to float for computation, and then store in half
+// The product is computed in column panels of c, and each panel as a sum over blocks of the inner dimension,
+// converting the matching blocks of op(a) and op(b) to float on the fly. The float working set is thereby bounded
+// by the block sizes instead of growing with the size of the operands.
+template <>
+void CPUMatrix<half>::MultiplyAndWeightedAdd(half alpha, const CPUMatrix<half>& a, const bool transposeA, const CPUMatrix<half>& b, const bool transposeB,
+    half beta, CPUMatrix<half>& c, shared_ptr<QuantizedMultiplier<half>> pQuantizedMultiplier)
+{
     if (pQuantizedMultiplier)
         RuntimeError("Quantized matrix multiply not supported for Half");
 
-    CPUMatrix<float>::MultiplyAndWeightedAdd((float)alpha, af, transposeA, bf, transposeB, (float)beta, cf, nullptr);
+    if (a.IsEmpty() || b.IsEmpty())
+        return;
+
+    const size_t m = transposeA ? a.GetNumCols() : a.GetNumRows();
+    const size_t k = transposeA ? a.GetNumRows() : a.GetNumCols();
+    const size_t kb = transposeB ? b.GetNumCols() : b.GetNumRows();
+    const size_t n = transposeB ? b.GetNumRows() : b.GetNumCols();
+    if (k != kb)
+        InvalidArgument("CPUMatrix<half>::MultiplyAndWeightedAdd : The inner dimensions of a and b must match.");
+
+    if (beta == 0)
+        c.RequireSize(m, n);
+    else
+        c.VerifySize(m, n); // Can't resize if beta != 0
+
+    if ((float)alpha == 0)
+    {
+        Scale(beta, c);
+        return;
+    }
+
+    // block sizes: keep the float copies of a block of op(a), and of a block of op(b) together with a panel of c,
+    // around 1M elements each, but no narrower than 64 columns
+    const size_t blockElements = (size_t)1 << 20;
+    const size_t blockK = min(k, max((size_t)64, blockElements / m));
+    const size_t panelCols = min(n, max((size_t)64, blockElements / (blockK + m)));
+
+    HalfScratch scratch(m * blockK + (blockK + m) * panelCols);
+    float* af = scratch.Data();
+    float* bf = af + m * blockK;
+    float* cf = bf + blockK * panelCols;
+
+    const half* ap = a.Data();
+    const half* bp = b.Data();
+    const size_t lda = a.GetNumRows();
+    const size_t ldb = b.GetNumRows();
+    for (size_t j0 = 0; j0 < n; j0 += panelCols)
+    {
+        const size_t cols = min(panelCols, n - j0);
+
+        if ((float)beta != 0)
+            ConvertBuffer<half, float>(cf, c.Data() + j0 * m, m * cols);
+        CPUMatrix<float> cfm(m, cols, cf, matrixFlagDontOwnBuffer);
+
+        for (size_t k0 = 0; k0 < k; k0 += blockK)
+        {
+            const size_t depth = min(blockK, k - k0);
+
+            // op(a)(:, k0 : k0 + depth), as an m x depth float matrix, or its transpose if transposeA
+            if (!transposeA)
+                ConvertBuffer<half, float>(af, ap + k0 * lda, m * depth);
+            else
+            {
+#pragma omp parallel for if (m * depth > c_halfConvertBlockSize)
+                for (long i = 0; i < (long)m; i++)
+                    ::CNTK::float16ToFloatN(reinterpret_cast<const unsigned short*>(ap + i * lda + k0), af + i * depth, depth);
+            }
+            CPUMatrix<float> afm(transposeA ? depth : m, transposeA ? m : depth, af, matrixFlagDontOwnBuffer);
+
+            // op(b)(k0 : k0 + depth, j0 : j0 + cols) as a depth x cols float matrix
+            if (!transposeB)
+            {
+#pragma omp parallel for if (depth * cols > c_halfConvertBlockSize)
+                for (long j = 0; j < (long)cols; j++)
+                    ::CNTK::float16ToFloatN(reinterpret_cast<const unsigned short*>(bp + (j0 + j) * ldb + k0), bf + j * depth, depth);
+            }
+            else
+            {
+#pragma omp parallel for if (depth * cols > c_halfConvertBlockSize)
+                for (long kk = 0; kk < (long)depth; kk++)
+                    for (size_t j = 0; j < cols; j++)
+                        bf[j * depth + kk] = (float)bp[(k0 + kk) * ldb + j0 + j];
+            }
+            CPUMatrix<float> bfm(depth, cols, bf, matrixFlagDontOwnBuffer);
 
-    ConvertBuffer<float, half>(c.Data(), cf.Data(), c.GetNumElements());
+            // the first block applies beta, the following ones accumulate
+            CPUMatrix<float>::MultiplyAndWeightedAdd((float)alpha, afm, transposeA, bfm, false, k0 == 0 ? (float)beta : 1.0f, cfm, nullptr);
+        }
+
+        ConvertBuffer<float, half>(c.Data() + j0 * m, cf, m * cols);
+    }
 }
 
 // specialization to RunTimeError for now due to omp implementation only support build-in type
@@ -61,34 +242,134 @@ void CPUMatrix<half>::AssignNCEUnnormalizedEval(const CPUMatrix<half>& a,
     RuntimeError("half AssignNCEUnnormalizedEval not supported.");
 }
 
+// half reductions convert blocks to float and accumulate in float (double for the full-matrix reductions)
+
 template <>
 void CPUMatrix<half>::VectorSum(const CPUMatrix<half>& a, CPUMatrix<half>& c, const bool isColWise)
 {
-    RuntimeError("half VectorSum not supported.");
+    if (a.IsEmpty())
+        LogicError("VectorSum:  Input matrix a is empty.");
+
+    const size_t m = a.GetNumRows();
+    const size_t n = a.GetNumCols();
+
+    if (isColWise) // col-wise
+    {
+        c.RequireSize(1, n);
+
+#pragma omp parallel for
+        for (long j = 0; j < (long)n; j++)
+        {
+            HalfScratch scratch(m);
+            float* col = scratch.Data();
+            ConvertBuffer<half, float>(col, a.Data() + j * m, m);
+            double v = 0;
+            for (size_t i = 0; i < m; i++)
+                v += col[i];
+            c(0, j) = (half)(float)v;
+        }
+    }
+    else
+    {
+        c.RequireSize(m, 1);
+
+        HalfScratch scratch(2 * m);
+        float* acc = scratch.Data();
+        float* col = acc + m;
+        memset(acc, 0, sizeof(float) * m);
+        for (size_t j = 0; j < n; j++)
+        {
+            ::CNTK::float16ToFloatN(reinterpret_cast<const unsigned short*>(a.Data()) + j * m, col, m);
+            for (size_t i = 0; i < m; i++)
+                acc[i] += col[i];
+        }
+        ConvertBuffer<float, half>(c.Data(), acc, m);
+    }
 }
 
 template <>
 void CPUMatrix<half>::VectorNorm1(CPUMatrix<half>& c, const bool isColWise) const
 {
-    RuntimeError("half VectorNorm1 not supported.");
+    if (IsEmpty())
+        LogicError("VectorNorm1: Matrix is empty.");
+
+    const size_t m = GetNumRows();
+    const size_t n = GetNumCols();
+
+    if (isColWise) // col-wise
+    {
+        c.RequireSize(1, n);
+
+#pragma omp parallel for
+        for (long j = 0; j < (long)n; j++)
+        {
+            HalfScratch scratch(m);
+            float* col = scratch.Data();
+            ConvertBuffer<half, float>(col, Data() + j * m, m);
+            double v = 0;
+            for (size_t i = 0; i < m; i++)
+                v += fabs(col[i]);
+            c(0, j) = (half)(float)v;
+        }
+    }
+    else
+    {
+        c.RequireSize(m, 1);
+
+        HalfScratch scratch(2 * m);
+        float* acc = scratch.Data();
+        float* col = acc + m;
+        memset(acc, 0, sizeof(float) * m);
+        for (size_t j = 0; j < n; j++)
+        {
+            ::CNTK::float16ToFloatN(reinterpret_cast<const unsigned short*>(Data()) + j * m, col, m);
+            for (size_t i = 0; i < m; i++)
+                acc[i] += fabs(col[i]);
+        }
+        ConvertBuffer<float, half>(c.Data(), acc, m);
+    }
 }
 
 template <>
 half CPUMatrix<half>::SumOfElements() const
 {
-    RuntimeError("half SumOfElements not supported.");
+    if (IsEmpty())
+        LogicError("SumOfElements: Matrix is empty.");
+
+    return (half)(float)ReduceHalfBuffer(Data(), GetNumElements(), 0.0,
+        [](const float* p, size_t n, double& acc) { for (size_t i = 0; i < n; i++) acc += p[i]; },
+        [](double x, double y) { return x + y; });
+}
+
+template <>
+half CPUMatrix<half>::SumOfAbsElements() const
+{
+    if (IsEmpty())
+        LogicError("SumOfAbsElements: Matrix is empty.");
+
+    return (half)(float)ReduceHalfBuffer(Data(), GetNumElements(), 0.0,
+        [](const float* p, size_t n, double& acc) { for (size_t i = 0; i < n; i++) acc += fabs(p[i]); },
+        [](double x, double y) { return x + y; });
 }
 
 template <>
 half CPUMatrix<half>::MatrixNorm1() const
 {
-    RuntimeError("half MatrixNorm1 not supported.");
+    if (IsEmpty())
+        LogicError("MatrixNorm1: Matrix is empty.");
+
+    return SumOfAbsElements();
 }
 
 template <>
-    half CPUMatrix<half>::FrobeniusNorm() const
+half CPUMatrix<half>::FrobeniusNorm() const
 {
-    RuntimeError("half FrobeniusNorm not supported.");
+    if (IsEmpty())
+        LogicError("FrobeniusNorm: Matrix is empty.");
+
+    return (half)(float)sqrt(ReduceHalfBuffer(Data(), GetNumElements(), 0.0,
+        [](const float* p, size_t n, double& acc) { for (size_t i = 0; i < n; i++) acc += (double)p[i] * p[i]; },
+        [](double x, double y) { return x + y; }));
 }
 
 template <>
@@ -113,6 +394,52 @@ void CPUMatrix<half>::AveragePoolingBackward(const CPUMatrix<int>& mpRowCol, con
     RuntimeError("half AveragePoolingBackward not supported.");
 }
 
+template <>
+void CPUMatrix<half>::LayerNormalizationForward(const CPUMatrix<half>& scale, const CPUMatrix<half>& bias, double epsilon,
+                                                CPUMatrix<half>& out, CPUMatrix<half>& saveMean, CPUMatrix<half>& saveInvStdDev) const
+{
+    RuntimeError("half LayerNormalizationForward not supported.");
+}
+
+template <>
+void CPUMatrix<half>::LayerNormalizationBackward(const CPUMatrix<half>& in, CPUMatrix<half>& grad, const CPUMatrix<half>& scale,
+                                                 const CPUMatrix<half>& saveMean, const CPUMatrix<half>& saveInvStdDev) const
+{
+    RuntimeError("half LayerNormalizationBackward not supported.");
+}
+
+template <>
+void CPUMatrix<half>::LayerNormalizationScaleGradient(const CPUMatrix<half>& in, const CPUMatrix<half>& saveMean, const CPUMatrix<half>& saveInvStdDev,
+                                                      CPUMatrix<half>& scaleGrad) const
+{
+    RuntimeError("half LayerNormalizationScaleGradient not supported.");
+}
+
+template <>
+void CPUMatrix<half>::ScaledDotProductAttentionForward(const CPUMatrix<half>& query, const CPUMatrix<half>& key, const CPUMatrix<half>& value,
+                                                       CPUMatrix<half>& out, CPUMatrix<half>& logSumExp,
+                                                       size_t dimQK, size_t dimV, size_t numHeads, double scale, bool causal)
+{
+    RuntimeError("half ScaledDotProductAttentionForward not supported.");
+}
+
+template <>
+void CPUMatrix<half>::ScaledDotProductAttentionBackwardQuery(const CPUMatrix<half>& query, const CPUMatrix<half>& key, const CPUMatrix<half>& value,
+                                                             const CPUMatrix<half>& out, const CPUMatrix<half>& outGrad, const CPUMatrix<half>& logSumExp,
+                                                             CPUMatrix<half>& queryGrad, size_t dimQK, size_t dimV, size_t numHeads, double scale, bool causal)
+{
+    RuntimeError("half ScaledDotProductAttentionBackwardQuery not supported.");
+}
+
+template <>
+void CPUMatrix<half>::ScaledDotProductAttentionBackwardKeyValue(const CPUMatrix<half>& query, const CPUMatrix<half>& key, const CPUMatrix<half>& value,
+                                                                const CPUMatrix<half>& out, const CPUMatrix<half>& outGrad, const CPUMatrix<half>& logSumExp,
+                                                                CPUMatrix<half>& keyGrad, CPUMatrix<half>& valueGrad,
+                                                                size_t dimQK, size_t dimV, size_t numHeads, double scale, bool causal)
+{
+    RuntimeError("half ScaledDotProductAttentionBackwardKeyValue not supported.");
+}
+
 // explicit instantiations, due to CPUMatrix being too big and causing VS2015 cl crash.
 template class MATH_API CPUMatrix<half>;
 template<> int CPUMatrix<half>::m_optimizationFlags = 0;
@@ -1157,6 +1157,8 @@ void CPUMatrix<ElemType>::AddGaussianRandomValue(const ElemType mean, const Elem
 
 //maskRate: percentage of values masked out (similar to dropout rate)
 //scaleValue: which scale value to set to the left ones (unmasked items).
+// Values are drawn from the counter-based Philox generator: element i uses lane (i % 4) of block (i / 4) of a
+// stream reserved for this call, so the mask is filled in parallel and does not depend on the number of threads.
 template <class ElemType>
 void CPUMatrix<ElemType>::SetUniformRandomMask(const ElemType maskRate, const ElemType scaleValue, RNGHandle& rngHandle)
 {
@@ -1167,29 +1169,143 @@ void CPUMatrix<ElemType>::SetUniformRandomMask(const ElemType maskRate, const El
     if (cpuRNGHandle == nullptr)
         LogicError("rngHandle must be a CPURNGHandle.");
 
-    auto& us = *this;
-    boost::random::uniform_real_distribution<double> r(0, 1);
-    long m = (long) GetNumRows(), n = (long) GetNumCols();
-    ElemType v;
-    for (long j = 0; j < n; j++)
+    const size_t n = GetNumElements();
+    const uint64_t key = cpuRNGHandle->PhiloxKey();
+    const uint64_t stream = cpuRNGHandle->ReservePhiloxStream(n);
+    const uint64_t threshold = Philox4x32::Threshold((double)maskRate);
+    ElemType* data = Data();
+
+    const long numBlocks = (long)((n + 3) / 4);
+#pragma omp parallel for
+    for (long b = 0; b < numBlocks; b++)
     {
-        // four-way unrolling
-        for (long i = 0; i < (m & ~3); i += 4)
+        uint32_t r[4];
+        Philox4x32::Generate(key, stream, (uint64_t)b, r);
+        const size_t i0 = (size_t)b * 4;
+        const size_t count = std::min<size_t>(4, n - i0);
+        for (size_t k = 0; k < count; k++)
+            data[i0 + k] = (uint64_t)r[k] < threshold ? (ElemType)0 : scaleValue;
+    }
+}
+
+// Dropout mask with one bit per element (bit set = element kept). Each column occupies
+// GetBitMaskWordsPerColumn(numRows) 32-bit words, so column slices of the mask start on word boundaries.
+// Word w of column j is generated from Philox blocks [(j * wordsPerColumn + w) * 8, +8) of the reserved stream,
+// so the mask is identical for any number of threads.
+template <class ElemType>
+/*static*/ void CPUMatrix<ElemType>::SetUniformRandomBitMask(uint32_t* maskBits, const size_t numRows, const size_t numCols, const double maskRate, RNGHandle& rngHandle)
+{
+    CPURNGHandle* cpuRNGHandle = dynamic_cast<CPURNGHandle*>(&rngHandle);
+    if (cpuRNGHandle == nullptr)
+        LogicError("rngHandle must be a CPURNGHandle.");
+
+    const size_t wordsPerColumn = GetBitMaskWordsPerColumn(numRows);
+    const uint64_t key = cpuRNGHandle->PhiloxKey();
+    const uint64_t stream = cpuRNGHandle->ReservePhiloxStream(numRows * numCols);
+    const uint64_t threshold = Philox4x32::Threshold(maskRate);
+
+    const long numWords = (long)(wordsPerColumn * numCols);
+#pragma omp parallel for
+    for (long w = 0; w < numWords; w++)
+    {
+        uint32_t word = 0;
+        for (size_t b = 0; b < 8; b++)
         {
-            v = (ElemType)r(cpuRNGHandle->Generator());
-            us(i, j) = v <= maskRate ? (ElemType)0 : scaleValue;
-            v = r(cpuRNGHandle->Generator());
-            us(i + 1, j) = v <= maskRate ? (ElemType)0 : scaleValue;
-            v = r(cpuRNGHandle->Generator());
-            us(i + 2, j) = v <= maskRate ? (ElemType)0 : scaleValue;
-            v = r(cpuRNGHandle->Generator());
-            us(i + 3, j) = v <= maskRate ? (ElemType)0 : scaleValue;
+            uint32_t r[4];
+            Philox4x32::Generate(key, stream, (uint64_t)w * 8 + b, r);
+            for (size_t k = 0; k < 4; k++)
+                word |= (uint32_t)((uint64_t)r[k] >= threshold) << (b * 4 + k);
         }
-        // handle remaining stuffs
-        for (long i = m & ~3; i < m; i++)
+        // clear the padding bits beyond the last row, so that the mask is fully deterministic
+        const size_t firstRow = (w % wordsPerColumn) * 32;
+        if (firstRow + 32 > numRows)
+            word &= (uint32_t)(((uint64_t)1 << (numRows - firstRow)) - 1);
+        maskBits[w] = word;
+    }
+}
+
+// this = beta * this + scaleValue * (a .* mask), where 'mask' is a bit mask as produced by SetUniformRandomBitMask().
+// The mask is expanded on the fly; beta == 0 overwrites this without reading it.
+template <class ElemType>
+void CPUMatrix<ElemType>::AssignElementProductOfBitMask(const CPUMatrix<ElemType>& a, const uint32_t* maskBits, const ElemType scaleValue, const ElemType beta)
+{
+    if (a.IsEmpty())
+        LogicError("AssignElementProductOfBitMask: Matrix is empty.");
+
+    const size_t m = a.GetNumRows(), n = a.GetNumCols();
+    if (beta == 0)
+        RequireSize(m, n);
+    else if (GetNumRows() != m || GetNumCols() != n)
+        InvalidArgument("AssignElementProductOfBitMask: The input matrix dimensions do not match.");
+
+    const size_t wordsPerColumn = GetBitMaskWordsPerColumn(m);
+    const ElemType* src = a.Data();
+    ElemType* dst = Data();
+
+#pragma omp parallel for
+    for (long j = 0; j < (long)n; j++)
+    {
+        const uint32_t* colMask = maskBits + j * wordsPerColumn;
+        const ElemType* srcCol = src + j * m;
+        ElemType* dstCol = dst + j * m;
+        for (size_t i = 0; i < m; i++)
+        {
+            const bool keep = ((colMask[i / 32] >> (i % 32)) & 1) != 0;
+            const ElemType v = keep ? scaleValue * srcCol[i] : (ElemType)0;
+            dstCol[i] = beta == 0 ? v : beta * dstCol[i] + v;
+        }
+    }
+}
+
+// bit mask of (a > 0), in the layout of SetUniformRandomBitMask(); padding bits are cleared
+template <class ElemType>
+/*static*/ void CPUMatrix<ElemType>::SetBitMaskOfPositive(uint32_t* maskBits, const CPUMatrix<ElemType>& a)
+{
+    const size_t m = a.GetNumRows(), n = a.GetNumCols();
+    const size_t wordsPerColumn = GetBitMaskWordsPerColumn(m);
+    const ElemType* src = a.Data();
+
+#pragma omp parallel for
+    for (long j = 0; j < (long)n; j++)
+    {
+        const ElemType* srcCol = src + j * m;
+        uint32_t* colMask = maskBits + j * wordsPerColumn;
+        for (size_t w = 0; w < wordsPerColumn; w++)
+        {
+            const size_t i0 = w * 32, i1 = std::min(m, i0 + 32);
+            uint32_t word = 0;
+            for (size_t i = i0; i < i1; i++)
+                word |= (uint32_t)(srcCol[i] > 0) << (i - i0);
+            colMask[w] = word;
+        }
+    }
+}
+
+// bit mask of (a == b), in the layout of SetUniformRandomBitMask(); padding bits are cleared
+template <class ElemType>
+/*static*/ void CPUMatrix<ElemType>::SetBitMaskOfEqual(uint32_t* maskBits, const CPUMatrix<ElemType>& a, const CPUMatrix<ElemType>& b)
+{
+    const size_t m = a.GetNumRows(), n = a.GetNumCols();
+    if (b.GetNumRows() != m || b.GetNumCols() != n)
+        InvalidArgument("SetBitMaskOfEqual: The input matrix dimensions do not match.");
+
+    const size_t wordsPerColumn = GetBitMaskWordsPerColumn(m);
+    const ElemType* srcA = a.Data();
+    const ElemType* srcB = b.Data();
+
+#pragma omp parallel for
+    for (long j = 0; j < (long)n; j++)
+    {
+        const ElemType* colA = srcA + j * m;
+        const ElemType* colB = srcB + j * m;
+        uint32_t* colMask = maskBits + j * wordsPerColumn;
+        for (size_t w = 0; w < wordsPerColumn; w++)
         {
-            v = (ElemType)r(cpuRNGHandle->Generator());
-            us(i, j) = v <= maskRate ? (ElemType)0 : scaleValue;
+            const size_t i0 = w * 32, i1 = std::min(m, i0 + 32);
+            uint32_t word = 0;
+            for (size_t i = i0; i < i1; i++)
+                word |= (uint32_t)(colA[i] == colB[i]) << (i - i0);
+            colMask[w] = word;
         }
     }
 }
@@ -3867,6 +3983,57 @@ CPUMatrix<ElemType>& CPUMatrix<ElemType>::AddSignOf(const CPUMatrix<ElemType>& a
     return us;
 }
 //I decided to use CPUMatrix<ElemType>& maxIndexes instead of integer vector because the result may be used to do additional calculation
+// Selects the topK largest of the n values in 'data' in descending order, ties are broken by the lower index.
+// The values are scanned in blocks, and a block is only inspected element by element if one of its values beats the
+// smallest value selected so far (a branch-free test the compiler can vectorize). Selected values are kept in a heap of size topK.
+// heap (scratch): reused by the caller across calls
+template <class ElemType>
+static void _selectTopK(const ElemType* data, const size_t n, const size_t topK, std::vector<std::pair<ElemType, size_t>>& heap,
+                        ElemType* maxValues, ElemType* maxIndexes, const size_t outStride)
+{
+    // 'a' better than 'b'; the heap keeps the worst selected value on top
+    auto isBetter = [](const std::pair<ElemType, size_t>& a, const std::pair<ElemType, size_t>& b)
+    {
+        return a.first > b.first || (a.first == b.first && a.second < b.second);
+    };
+
+    heap.clear();
+    for (size_t i = 0; i < topK; i++)
+        heap.emplace_back(data[i], i);
+    std::make_heap(heap.begin(), heap.end(), isBetter);
+
+    const size_t blockSize = 32;
+    ElemType threshold = heap.front().first;
+    for (size_t begin = topK; begin < n; begin += blockSize)
+    {
+        const size_t end = std::min(begin + blockSize, n);
+        bool anyAbove = false;
+        for (size_t i = begin; i < end; i++)
+            anyAbove |= data[i] > threshold;
+        if (!anyAbove)
+            continue;
+
+        // later indices lose ties, so only values strictly above the threshold get in
+        for (size_t i = begin; i < end; i++)
+        {
+            if (data[i] > threshold)
+            {
+                std::pop_heap(heap.begin(), heap.end(), isBetter);
+                heap.back() = std::make_pair(data[i], i);
+                std::push_heap(heap.begin(), heap.end(), isBetter);
+                threshold = heap.front().first;
+            }
+        }
+    }
+
+    std::sort_heap(heap.begin(), heap.end(), isBetter); // best first
+    for (size_t i = 0; i < topK; i++)
+    {
+        maxValues[i * outStride] = heap[i].first;
+        maxIndexes[i * outStride] = (ElemType) heap[i].second;
+    }
+}
+
 template <class ElemType>
 void CPUMatrix<ElemType>::VectorMax(CPUMatrix<ElemType>& maxIndexes, CPUMatrix<ElemType>& maxValues, const bool isColWise, int topK) const
 {
@@ -3876,8 +4043,10 @@ void CPUMatrix<ElemType>::VectorMax(CPUMatrix<ElemType>& maxIndexes, CPUMatrix<E
     auto& us = *this;
     const int m = (int) GetNumRows();
     const int n = (int) GetNumCols();
-    if (topK > m)
+    if (isColWise && topK > m)
         InvalidArgument("VectorMax: TopK must be less or equal than the number of rows");
+    if (!isColWise && topK > n)
+        InvalidArgument("VectorMax: TopK must be less or equal than the number of columns");
 
     assert(m > 0 && n > 0); // converting from size_t to int may cause overflow
 
@@ -3907,53 +4076,58 @@ void CPUMatrix<ElemType>::VectorMax(CPUMatrix<ElemType>& maxIndexes, CPUMatrix<E
         }
         else
         {
-            std::vector<int> indices(m);
-
-            const ElemType* curVal =            Data();
-            ElemType* curIdx       = maxIndexes.Data();
-            ElemType* curMax       =  maxValues.Data();
-            for (int icol = 0; icol < n; icol++, curVal += m, curIdx += topK, curMax += topK)
+#pragma omp parallel
             {
-                std::iota(indices.begin(), indices.end(), 0);
-                // Partial sort, descending order.
-                std::partial_sort(indices.begin(), indices.begin() + topK, indices.end(),
-                                    [curVal](const int& a, const int& b)
-                                    {
-                                        return curVal[a] > curVal[b];
-                                    });
-                // REVIEW alexeyk: the following produces warning (see SCL_SECURE_NO_WARNINGS) so use loop instead.
-                // std::transform(indices.begin(), indices.begin() + topK, curIdx, [](const int& a) { return static_cast<ElemType>(a); });
-                for (int i2 = 0; i2 < topK; i2++)
-                {
-                    curIdx[i2] = static_cast<ElemType>(indices[i2]);
-                    curMax[i2] = curVal[indices[i2]];
-                }
+                std::vector<std::pair<ElemType, size_t>> heap;
+                heap.reserve(topK);
+
+#pragma omp for
+                for (int j = 0; j < n; j++)
+                    _selectTopK(Data() + (size_t) j * m, m, topK, heap, maxValues.Data() + (size_t) j * topK, maxIndexes.Data() + (size_t) j * topK, 1);
             }
         }
     }
     else
     {
-        if (topK > 1)
-            RuntimeError("Row-wise TopK max is not supported.");
-
-        maxValues.RequireSize(m, 1);
-        maxIndexes.RequireSize(m, 1);
+        maxValues.RequireSize(m, topK);
+        maxIndexes.RequireSize(m, topK);
 
+        if (topK == 1)
+        {
 #pragma omp parallel for
-        for (int i = 0; i < m; i++)
+            for (int i = 0; i < m; i++)
+            {
+                ElemType v = us(i, 0);
+                size_t index = 0;
+                foreach_column (j, us)
+                {
+                    if (v < us(i, j))
+                    {
+                        index = j;
+                        v = us(i, j);
+                    }
+                }
+                maxValues(i, 0) = v;
+                maxIndexes(i, 0) = (ElemType) index;
+            }
+        }
+        else
         {
-            ElemType v = us(i, 0);
-            size_t index = 0;
-            foreach_column (j, us)
+#pragma omp parallel
             {
-                if (v < us(i, j))
+                std::vector<std::pair<ElemType, size_t>> heap;
+                heap.reserve(topK);
+                std::vector<ElemType> row(n);
+
+#pragma omp for
+                for (int i = 0; i < m; i++)
                 {
-                    index = j;
-                    v = us(i, j);
+                    // gather the row so that it can be scanned contiguously
+                    foreach_column (j, us)
+                        row[j] = us(i, j);
+                    _selectTopK(row.data(), n, topK, heap, maxValues.Data() + i, maxIndexes.Data() + i, m);
                 }
             }
-            maxValues(i, 0) = v;
-            maxIndexes(i, 0) = (ElemType) index;
         }
     }
 }
@@ -5131,6 +5305,324 @@ void CPUMatrix<ElemType>::BatchNormalizationBackward(const CPUMatrix<ElemType>&
     RuntimeError("Batch normalization training on CPU is not yet implemented.");
 }
 
+// Layer normalization: every column is normalized over its rows, then scaled and shifted.
+//   out = scale .* (in - mean) / sqrt(var + epsilon) + bias
+// 'scale' and 'bias' are column vectors with either one entry per row or a single entry.
+// The statistics are computed in a single pass over each column (Welford) and saved as row vectors for the backward pass.
+template <class ElemType>
+void CPUMatrix<ElemType>::LayerNormalizationForward(const CPUMatrix<ElemType>& scale, const CPUMatrix<ElemType>& bias, double epsilon,
+                                                    CPUMatrix<ElemType>& out, CPUMatrix<ElemType>& saveMean, CPUMatrix<ElemType>& saveInvStdDev) const
+{
+    const long numRows = (long)GetNumRows();
+    const long numCols = (long)GetNumCols();
+    if ((scale.GetNumRows() != numRows && scale.GetNumRows() != 1) || scale.GetNumRows() != bias.GetNumRows())
+        LogicError("LayerNormalizationForward: scale and bias must have one entry per row or a single entry.");
+    if (numRows == 0)
+        LogicError("LayerNormalizationForward: the input must not be empty.");
+
+    out.RequireSize(numRows, numCols);
+    saveMean.RequireSize(1, numCols);
+    saveInvStdDev.RequireSize(1, numCols);
+    const size_t scaleStride = scale.GetNumRows() == 1 ? 0 : 1;
+
+#pragma omp parallel for
+    for (long j = 0; j < numCols; j++)
+    {
+        const ElemType* x = Data() + j * numRows;
+        ElemType* y = out.Data() + j * numRows;
+
+        ElemType mean = 0;
+        ElemType m2 = 0;
+        for (long i = 0; i < numRows; i++)
+        {
+            ElemType delta = x[i] - mean;
+            mean += delta / (ElemType)(i + 1);
+            m2 += delta * (x[i] - mean);
+        }
+        ElemType invStdDev = (ElemType)(1 / sqrt(m2 / numRows + epsilon));
+
+        for (long i = 0; i < numRows; i++)
+            y[i] = scale.Data()[i * scaleStride] * (x[i] - mean) * invStdDev + bias.Data()[i * scaleStride];
+
+        saveMean.Data()[j] = mean;
+        saveInvStdDev.Data()[j] = invStdDev;
+    }
+}
+
+// gradient of LayerNormalizationForward() w.r.t. its input, added to 'grad'; 'this' is the output gradient
+//   xhat = (in - mean) * invStdDev, g = outGrad .* scale
+//   grad += invStdDev * (g - mean(g) - xhat * mean(g .* xhat))
+template <class ElemType>
+void CPUMatrix<ElemType>::LayerNormalizationBackward(const CPUMatrix<ElemType>& in, CPUMatrix<ElemType>& grad, const CPUMatrix<ElemType>& scale,
+                                                     const CPUMatrix<ElemType>& saveMean, const CPUMatrix<ElemType>& saveInvStdDev) const
+{
+    const long numRows = (long)GetNumRows();
+    const long numCols = (long)GetNumCols();
+    if (in.GetNumRows() != numRows || in.GetNumCols() != numCols || grad.GetNumRows() != numRows || grad.GetNumCols() != numCols)
+        LogicError("LayerNormalizationBackward: input, gradient, and output gradient must have the same dimensions.");
+    const size_t scaleStride = scale.GetNumRows() == 1 ? 0 : 1;
+
+#pragma omp parallel for
+    for (long j = 0; j < numCols; j++)
+    {
+        const ElemType* x = in.Data() + j * numRows;
+        const ElemType* dy = Data() + j * numRows;
+        ElemType* dx = grad.Data() + j * numRows;
+        const ElemType mean = saveMean.Data()[j];
+        const ElemType invStdDev = saveInvStdDev.Data()[j];
+
+        ElemType sumG = 0;
+        ElemType sumGXhat = 0;
+        for (long i = 0; i < numRows; i++)
+        {
+            ElemType g = dy[i] * scale.Data()[i * scaleStride];
+            sumG += g;
+            sumGXhat += g * (x[i] - mean) * invStdDev;
+        }
+        const ElemType meanG = sumG / numRows;
+        const ElemType meanGXhat = sumGXhat / numRows;
+
+        for (long i = 0; i < numRows; i++)
+        {
+            ElemType g = dy[i] * scale.Data()[i * scaleStride];
+            dx[i] += invStdDev * (g - meanG - (x[i] - mean) * invStdDev * meanGXhat);
+        }
+    }
+}
+
+// gradient of LayerNormalizationForward() w.r.t. 'scale', added to 'scaleGrad'; 'this' is the output gradient
+//   scaleGrad += sum over columns of outGrad .* xhat
+template <class ElemType>
+void CPUMatrix<ElemType>::LayerNormalizationScaleGradient(const CPUMatrix<ElemType>& in, const CPUMatrix<ElemType>& saveMean, const CPUMatrix<ElemType>& saveInvStdDev,
+                                                          CPUMatrix<ElemType>& scaleGrad) const
+{
+    const long numRows = (long)GetNumRows();
+    const long numCols = (long)GetNumCols();
+    if (scaleGrad.GetNumRows() != numRows && scaleGrad.GetNumRows() != 1)
+        LogicError("LayerNormalizationScaleGradient: the scale gradient must have one entry per row or a single entry.");
+
+    std::vector<ElemType> rowSums(numRows);
+#pragma omp parallel for
+    for (long i = 0; i < numRows; i++)
+    {
+        ElemType sum = 0;
+        for (long j = 0; j < numCols; j++)
+            sum += Data()[i + j * numRows] * (in.Data()[i + j * numRows] - saveMean.Data()[j]) * saveInvStdDev.Data()[j];
+        rowSums[i] = sum;
+    }
+
+    if (scaleGrad.GetNumRows() == 1)
+        scaleGrad.Data()[0] += std::accumulate(rowSums.begin(), rowSums.end(), (ElemType)0);
+    else
+    {
+        for (long i = 0; i < numRows; i++)
+            scaleGrad.Data()[i] += rowSums[i];
+    }
+}
+
+// Scaled dot-product attention, independently for each column and head:
+//   out = value * softmax(scale * key^T * query)
+// Each column of 'query' holds a [dimQK x numQueries x numHeads] tensor, 'key' a [dimQK x numKeys x numHeads] tensor,
+// and 'value' a [dimV x numKeys x numHeads] tensor; the output is [dimV x numQueries x numHeads].
+// If 'causal', query i only attends to keys j <= i + (numKeys - numQueries).
+// The forward pass streams over blocks of keys with an online softmax (running maximum and sum), so that the
+// numQueries x numKeys score matrix is never stored. The log of each softmax denominator is saved in
+// 'logSumExp' ([numQueries * numHeads] x numCols) for the backward pass, which recomputes the scores.
+static const size_t AttentionKeyBlockSize = 64;
+
+struct AttentionDims
+{
+    size_t dimQK, dimV, numHeads, numQueries, numKeys;
+    bool causal;
+
+    AttentionDims(size_t queryRows, size_t keyRows, size_t valueRows, size_t dimQK, size_t dimV, size_t numHeads, bool causal)
+        : dimQK(dimQK), dimV(dimV), numHeads(numHeads), causal(causal)
+    {
+        if (dimQK == 0 || dimV == 0 || numHeads == 0 || queryRows % (dimQK * numHeads) != 0 || keyRows % (dimQK * numHeads) != 0)
+            LogicError("ScaledDotProductAttention: query and key dimensions are not compatible with dimQK = %d and numHeads = %d.", (int)dimQK, (int)numHeads);
+        numQueries = queryRows / (dimQK * numHeads);
+        numKeys = keyRows / (dimQK * numHeads);
+        if (valueRows != dimV * numKeys * numHeads)
+            LogicError("ScaledDotProductAttention: value dimension %d does not match dimV = %d, %d keys, and %d heads.", (int)valueRows, (int)dimV, (int)numKeys, (int)numHeads);
+        if (causal && numKeys < numQueries)
+            LogicError("ScaledDotProductAttention: causal attention requires at least as many keys (%d) as queries (%d).", (int)numKeys, (int)numQueries);
+    }
+
+    // number of keys visible to query i
+    size_t NumVisibleKeys(size_t i) const { return causal ? i + 1 + (numKeys - numQueries) : numKeys; }
+    // index of the first query that sees key j
+    size_t FirstQuerySeeing(size_t j) const { return (causal && j > numKeys - numQueries) ? j - (numKeys - numQueries) : 0; }
+};
+
+template <class ElemType>
+static inline ElemType AttentionDot(const ElemType* a, const ElemType* b, size_t n)
+{
+    ElemType sum = 0;
+    for (size_t k = 0; k < n; k++)
+        sum += a[k] * b[k];
+    return sum;
+}
+
+template <class ElemType>
+/*static*/ void CPUMatrix<ElemType>::ScaledDotProductAttentionForward(const CPUMatrix<ElemType>& query, const CPUMatrix<ElemType>& key, const CPUMatrix<ElemType>& value,
+                                                                   CPUMatrix<ElemType>& out, CPUMatrix<ElemType>& logSumExp,
+                                                                   size_t dimQK, size_t dimV, size_t numHeads, double scale, bool causal)
+{
+    const AttentionDims dims(query.GetNumRows(), key.GetNumRows(), value.GetNumRows(), dimQK, dimV, numHeads, causal);
+    const size_t numCols = query.GetNumCols();
+    if (key.GetNumCols() != numCols || value.GetNumCols() != numCols)
+        LogicError("ScaledDotProductAttentionForward: query, key, and value must have the same number of columns.");
+
+    out.RequireSize(dimV * dims.numQueries * numHeads, numCols);
+    logSumExp.RequireSize(dims.numQueries * numHeads, numCols);
+    const long numRowsTotal = (long)(dims.numQueries * numHeads * numCols);
+
+#pragma omp parallel
+    {
+        std::vector<ElemType> scores(AttentionKeyBlockSize);
+        std::vector<ElemType> acc(dimV);
+
+#pragma omp for
+        for (long r = 0; r < numRowsTotal; r++) // r enumerates (query, head, column)
+        {
+            const size_t i = r % dims.numQueries;
+            const size_t h = (r / dims.numQueries) % numHeads;
+            const size_t j = r / (dims.numQueries * numHeads);
+
+            const ElemType* q = query.Data() + j * query.GetNumRows() + dimQK * (i + dims.numQueries * h);
+            const ElemType* k = key.Data() + j * key.GetNumRows() + dimQK * dims.numKeys * h;
+            const ElemType* v = value.Data() + j * value.GetNumRows() + dimV * dims.numKeys * h;
+
+            ElemType runMax = -std::numeric_limits<ElemType>::infinity();
+            ElemType runSum = 0;
+            std::fill(acc.begin(), acc.end(), (ElemType)0);
+
+            const size_t numVisibleKeys = dims.NumVisibleKeys(i);
+            for (size_t kb = 0; kb < numVisibleKeys; kb += AttentionKeyBlockSize)
+            {
+                const size_t ke = std::min(numVisibleKeys, kb + AttentionKeyBlockSize);
+                ElemType blockMax = -std::numeric_limits<ElemType>::infinity();
+                for (size_t kk = kb; kk < ke; kk++)
+                {
+                    scores[kk - kb] = (ElemType)scale * AttentionDot(q, k + dimQK * kk, dimQK);
+                    blockMax = std::max(blockMax, scores[kk - kb]);
+                }
+
+                // rescale what has been accumulated so far to the new maximum
+                const ElemType newMax = std::max(runMax, blockMax);
+                const ElemType correction = exp(runMax - newMax);
+                runSum *= correction;
+                for (size_t d = 0; d < dimV; d++)
+                    acc[d] *= correction;
+
+                for (size_t kk = kb; kk < ke; kk++)
+                {
+                    const ElemType p = exp(scores[kk - kb] - newMax);
+                    runSum += p;
+                    const ElemType* vk = v + dimV * kk;
+                    for (size_t d = 0; d < dimV; d++)
+                        acc[d] += p * vk[d];
+                }
+                runMax = newMax;
+            }
+
+            ElemType* o = out.Data() + j * out.GetNumRows() + dimV * (i + dims.numQueries * h);
+            for (size_t d = 0; d < dimV; d++)
+                o[d] = acc[d] / runSum;
+            logSumExp.Data()[r] = runMax + log(runSum);
+        }
+    }
+}
+
+// gradient of ScaledDotProductAttentionForward() w.r.t. the query, added to 'queryGrad'
+//   P = softmax(scale * K^T q), dS = P .* (V^T outGrad - outGrad . out), queryGrad += scale * K dS
+template <class ElemType>
+/*static*/ void CPUMatrix<ElemType>::ScaledDotProductAttentionBackwardQuery(const CPUMatrix<ElemType>& query, const CPUMatrix<ElemType>& key, const CPUMatrix<ElemType>& value,
+                                                                         const CPUMatrix<ElemType>& out, const CPUMatrix<ElemType>& outGrad, const CPUMatrix<ElemType>& logSumExp,
+                                                                         CPUMatrix<ElemType>& queryGrad, size_t dimQK, size_t dimV, size_t numHeads, double scale, bool causal)
+{
+    const AttentionDims dims(query.GetNumRows(), key.GetNumRows(), value.GetNumRows(), dimQK, dimV, numHeads, causal);
+    const long numRowsTotal = (long)(dims.numQueries * numHeads * query.GetNumCols());
+
+#pragma omp parallel for
+    for (long r = 0; r < numRowsTotal; r++)
+    {
+        const size_t i = r % dims.numQueries;
+        const size_t h = (r / dims.numQueries) % numHeads;
+        const size_t j = r / (dims.numQueries * numHeads);
+
+        const ElemType* q = query.Data() + j * query.GetNumRows() + dimQK * (i + dims.numQueries * h);
+        const ElemType* k = key.Data() + j * key.GetNumRows() + dimQK * dims.numKeys * h;
+        const ElemType* v = value.Data() + j * value.GetNumRows() + dimV * dims.numKeys * h;
+        const ElemType* o = out.Data() + j * out.GetNumRows() + dimV * (i + dims.numQueries * h);
+        const ElemType* dO = outGrad.Data() + j * outGrad.GetNumRows() + dimV * (i + dims.numQueries * h);
+        ElemType* dq = queryGrad.Data() + j * queryGrad.GetNumRows() + dimQK * (i + dims.numQueries * h);
+
+        const ElemType lse = logSumExp.Data()[r];
+        const ElemType dOdotO = AttentionDot(dO, o, dimV);
+
+        const size_t numVisibleKeys = dims.NumVisibleKeys(i);
+        for (size_t kk = 0; kk < numVisibleKeys; kk++)
+        {
+            const ElemType* kk_ = k + dimQK * kk;
+            const ElemType p = exp((ElemType)scale * AttentionDot(q, kk_, dimQK) - lse);
+            const ElemType dS = p * (AttentionDot(dO, v + dimV * kk, dimV) - dOdotO) * (ElemType)scale;
+            for (size_t d = 0; d < dimQK; d++)
+                dq[d] += dS * kk_[d];
+        }
+    }
+}
+
+// gradient of ScaledDotProductAttentionForward() w.r.t. key and value, added to 'keyGrad' and 'valueGrad'
+//   valueGrad += outGrad P^T, keyGrad += scale * Q dS^T
+// This is parallelized over keys, so that every thread owns the gradient entries it writes.
+template <class ElemType>
+/*static*/ void CPUMatrix<ElemType>::ScaledDotProductAttentionBackwardKeyValue(const CPUMatrix<ElemType>& query, const CPUMatrix<ElemType>& key, const CPUMatrix<ElemType>& value,
+                                                                            const CPUMatrix<ElemType>& out, const CPUMatrix<ElemType>& outGrad, const CPUMatrix<ElemType>& logSumExp,
+                                                                            CPUMatrix<ElemType>& keyGrad, CPUMatrix<ElemType>& valueGrad,
+                                                                            size_t dimQK, size_t dimV, size_t numHeads, double scale, bool causal)
+{
+    const AttentionDims dims(query.GetNumRows(), key.GetNumRows(), value.GetNumRows(), dimQK, dimV, numHeads, causal);
+    const long numQueriesTotal = (long)(dims.numQueries * numHeads * query.GetNumCols());
+    const long numKeysTotal = (long)(dims.numKeys * numHeads * query.GetNumCols());
+
+    // outGrad . out for every query
+    std::vector<ElemType> dOdotO(numQueriesTotal);
+#pragma omp parallel for
+    for (long r = 0; r < numQueriesTotal; r++)
+    {
+        const size_t offset = (r / (dims.numQueries * numHeads)) * out.GetNumRows() + dimV * (r % (dims.numQueries * numHeads));
+        dOdotO[r] = AttentionDot(outGrad.Data() + offset, out.Data() + offset, dimV);
+    }
+
+#pragma omp parallel for
+    for (long r = 0; r < numKeysTotal; r++) // r enumerates (key, head, column)
+    {
+        const size_t kk = r % dims.numKeys;
+        const size_t h = (r / dims.numKeys) % numHeads;
+        const size_t j = r / (dims.numKeys * numHeads);
+
+        const ElemType* k = key.Data() + j * key.GetNumRows() + dimQK * (kk + dims.numKeys * h);
+        const ElemType* v = value.Data() + j * value.GetNumRows() + dimV * (kk + dims.numKeys * h);
+        ElemType* dk = keyGrad.Data() + j * keyGrad.GetNumRows() + dimQK * (kk + dims.numKeys * h);
+        ElemType* dv = valueGrad.Data() + j * valueGrad.GetNumRows() + dimV * (kk + dims.numKeys * h);
+
+        for (size_t i = dims.FirstQuerySeeing(kk); i < dims.numQueries; i++)
+        {
+            const size_t qr = i + dims.numQueries * (h + numHeads * j); // index into logSumExp and dOdotO
+            const ElemType* q = query.Data() + j * query.GetNumRows() + dimQK * (i + dims.numQueries * h);
+            const ElemType* dO = outGrad.Data() + j * outGrad.GetNumRows() + dimV * (i + dims.numQueries * h);
+
+            const ElemType p = exp((ElemType)scale * AttentionDot(q, k, dimQK) - logSumExp.Data()[qr]);
+            for (size_t d = 0; d < dimV; d++)
+                dv[d] += p * dO[d];
+            const ElemType dS = p * (AttentionDot(dO, v, dimV) - dOdotO[qr]) * (ElemType)scale;
+            for (size_t d = 0; d < dimQK; d++)
+                dk[d] += dS * q[d];
+        }
+    }
+}
+
 
 #pragma region Static BLAS Functions
 
@@ -6498,311 +6990,165 @@ void CPUMatrix<ElemType>::RCRFBackwardCompute(const CPUMatrix<ElemType>& alpha,
 
     beta.RequireSize(iNumLab, iNumPos);
 
+    // zeta(j) = log sum_m exp(alpha(m, t) + pair_scores(j, m)) does not depend on the label k of beta(k, t),
+    // so it is computed once per position instead of once per label.
+    std::vector<ElemType> zeta(iNumLab);
     for (int t = iNumPos - 1; t >= 0; t--)
     {
+        if (t < iNumPos - 1)
+            _rcrfBackwardComputeZeta(t, alpha, zeta.data(), pair_scores);
+
 #pragma omp parallel for
         for (int k = 0; k < iNumLab; k++)
         {
-            _rcrfBackwardCompute(t, k, alpha, beta, pair_scores);
+            _rcrfBackwardCompute(t, k, alpha, beta, zeta.data(), pair_scores);
         }
     }
 };
 
-// Calculate alpha in forward-backward calculation. equation (6), (7) in ftp://ftp.idsia.ch/pub/juergen/icml2006.pdf
-// GPU x dimension corresponds to utterances, y dimension corresponds to phone sequence in each utterance
+// Forward-backward calculation of CTC for a single utterance, see ftp://ftp.idsia.ch/pub/juergen/icml2006.pdf
+// The lattice of an utterance only spans its own frames and labels (frameNum x phoneNum), rather than the padded
+// maximum over the minibatch, so that utterances can be processed independently and in parallel.
+// Alpha (equations (6), (7)) and beta (equations (10), (11)) are kept in per-utterance buffers.
+// Returns the total log score of the utterance (equation (8)).
+// CTCscore (output): CTC posteriors, the columns of this utterance are expected to be initialized with LZERO
 // prob (input): the posterior output from the network
-// alpha (output): alpha for forward-backward calculation.
-// phoneSeq (input): phone ID sequence for each utterance in this minibatch, each col is one utterance
-// phoneBound (input): phone boundary (frame index) of each phone for each utterance in this minibatch, each col is one utterance
-// uttToChanInd (input):  map from utterance ID to minibatch channel ID. We need this because each channel may contain more than one utterance.
-// uttFrameNum (input): the frame number of each utterance. The size of this vector =  the number of all utterances in this minibatch
-// uttBeginFrame(input): the position of the first frame of each utterance in the minibatch channel. We need this because each channel may contain more than one utterance.
-// uttPhoneNum (input): the phone number of each utterance. The size of this vector =  the number of all utterances in this minibatch
-// numChannels (input): channel number in this minibatch
-// uttNum (input): number of utterances
-// t (input): time stamp to process
-// maxPhoneNum (input): the max number of phones between utterances
-// totalPhoneNum (input): the total number of phones of all utterances
+// phoneSeq (input): phone ID sequence of this utterance (phoneNum entries, the first and the last one are sentinels)
+// phoneBound (input): phone boundary (frame index) of each phone of this utterance
+// frameNum (input): the frame number of this utterance
+// phoneNum (input): the phone number of this utterance
+// firstFrameCol (input): the minibatch column of the first frame of the utterance
+// numChannels (input): channel number in this minibatch, this is the distance between columns of consecutive frames
+// totalPhoneNum (input): the total number of phones (number of rows of prob)
 // blankTokenId (input): id of the CTC blank token
 // delayConstraint -- label output delay constraint introduced during training that allows to have shorter delay during inference.
 //      Alpha and Beta scores outside of the delay boundary are set to zero.
 //      Setting this parameter smaller will result in shorted delay between label output during decoding.
 //      delayConstraint=-1 means no constraint
 template<class ElemType>
-void _assignAlphaScore(
-    const ElemType *prob,
-    ElemType *alphaScore,
-    ElemType *phoneSeq,
-    ElemType *phoneBound,
-    const std::vector<size_t>& uttToChanInd,
-    const std::vector<size_t>& uttFrameNum,
-    const std::vector<size_t>& uttBeginFrame,
-    const std::vector<size_t>& uttPhoneNum,
-    size_t numChannels,
-    const size_t uttNum,
-    const size_t  t,
-    const size_t maxPhoneNum, // Maximum length of utterance in this MB
-    const size_t totalPhoneNum, // Total number of phones
-    const size_t blankTokenId,
-    const int delayConstraint)
-{
-    for (size_t uttId = 0;uttId < uttNum;uttId++) {
-
-        // Number of phones and frames in this utterance
-        size_t frameNum = uttFrameNum[uttId];
-        if (t >= frameNum) continue;
-
-        size_t phoneNum = uttPhoneNum[uttId];
-
-#pragma omp parallel for
-        for (int phoneSeqId = 1;phoneSeqId < phoneNum - 1;phoneSeqId++) {
-            // Index of the label in the sequence
-
-            // Current and previous phone indices in phoneSeq matrix
-            size_t labelid = uttId*maxPhoneNum + phoneSeqId;
-
-            // Actual current phone label
-            size_t phoneId = (size_t)(phoneSeq[labelid]);
-
-            // Index of the current frame in minibatch
-            size_t timeId = (t + uttBeginFrame[uttId])*numChannels + uttToChanInd[uttId];
-
-            // Index of probability of observing phoneId at frame timeId
-            size_t probId = timeId*totalPhoneNum + phoneId;
-
-            size_t alphaId = maxPhoneNum* timeId + phoneSeqId; // alpha_t(s)
-
-            if (t == 0)
-            {
-                // Initialize recursion
-                if (phoneSeqId == 1 || phoneSeqId == 2)
-                {
-                    alphaScore[alphaId] = prob[probId];
-                }
-            }
-            else
-            {
-                if (phoneSeqId >= 1)
-                {
-                    size_t timeId_1 = timeId - numChannels; // Index corresponding to (t-1)
-                    size_t alphaId_0 = maxPhoneNum* timeId_1 + phoneSeqId; // alpha_{t-1}(s)
-                    size_t alphaId_1 = alphaId_0 - 1; // alpha_{t-1}(s-1)
-                    size_t alphaId_2 = alphaId_0 - 2; // alpha_{t-1}(s-2)
-                    ElemType x = LZERO;
-
-                    ElemType ascore;
-                    if (phoneSeqId > 2)
-                    {
-                        size_t labelid_2 = labelid - 2;
-                        // if current label is not blank and not equal prev non-blank label
-                        if ((size_t)(phoneSeq[labelid]) != blankTokenId && phoneId != (size_t)(phoneSeq[labelid_2]))
-                        {
-                            x = LogAdd(x, alphaScore[alphaId_2]);
-                        }
-                    }
-
-                    if (phoneSeqId > 1)
-                    {
-                        x = LogAdd(x, alphaScore[alphaId_1]);
-                    }
-
-                    x = LogAdd(x, alphaScore[alphaId_0]);
-
-                    if (phoneId != SIZE_MAX)
-                        ascore = prob[probId]; // Probability of observing given label at given time
-                    else
-                        ascore = 0;
-                    alphaScore[alphaId] = (ElemType)x + ascore;
-                    if (delayConstraint != -1)
-                    {
-                        size_t labelid_r = labelid + 2;
-                        size_t phoneBoundId_r = (size_t)(phoneBound[labelid_r]);
-                        if (phoneId == blankTokenId)
-                        {
-                            // only constraint right side
-                            if (t > phoneBoundId_r + delayConstraint - 1)
-                                alphaScore[alphaId] = LZERO;
-                        }
-                        else if (phoneId != blankTokenId)
-                        {
-                            if (t > phoneBoundId_r + delayConstraint)
-                                alphaScore[alphaId] = LZERO;
-                        }
-                    }
-                }
-
-            }
-        }
-    }
-}
-
-// Calculate beta in forward-backward calculation, equation (10), (11) in ftp://ftp.idsia.ch/pub/juergen/icml2006.pdf
-// See _assignAlphaScore for the explanation of parameters
-template<class ElemType>
-void _assignBetaScore(
+ElemType _assignCTCScoreForUtterance(
+    ElemType *CTCscore,
     const ElemType *prob,
-    ElemType *betaScore,
-    ElemType *phoneSeq,
-    ElemType *phoneBound,
-    const std::vector<size_t>& uttToChanInd,
-    const std::vector<size_t>& uttFrameNum,
-    const std::vector<size_t>& uttBeginFrame,
-    const std::vector<size_t>& uttPhoneNum,
+    const ElemType *phoneSeq,
+    const ElemType *phoneBound,
+    const size_t frameNum,
+    const size_t phoneNum,
+    const size_t firstFrameCol,
     const size_t numChannels,
-    const size_t uttNum,
-    const long  t,
-    const size_t maxPhoneNum,
     const size_t totalPhoneNum,
     const size_t blankTokenId,
     const int delayConstraint)
 {
-    for (size_t uttId = 0;uttId < uttNum;uttId++) {
-
-        // Number of phones and frames in this utterance
-        size_t frameNum = uttFrameNum[uttId];
-        if (t >= frameNum) continue;
-
-        size_t phoneNum = uttPhoneNum[uttId];
-
-#pragma omp parallel for
-        for (int phoneSeqId = 1;phoneSeqId < phoneNum - 1;phoneSeqId++) {
+    // Labels of lattice positions, and whether the position can be reached from the one two positions before
+    // in the forward direction (i.e., the label is not blank and differs from the previous non-blank label).
+    std::vector<size_t> labels(phoneNum);
+    std::vector<size_t> rightBounds(phoneNum);
+    std::vector<char> canSkip(phoneNum, 0);
+    for (size_t s = 0; s < phoneNum; s++)
+    {
+        labels[s] = (size_t)phoneSeq[s];
+        // the last blank has no right neighbor, the utterance end is its boundary
+        rightBounds[s] = (size_t)phoneBound[std::min(s + 2, phoneNum - 1)];
+        if (s >= 2)
+            canSkip[s] = labels[s] != blankTokenId && labels[s] != (size_t)phoneSeq[s - 2];
+    }
 
-            size_t labelid = uttId*maxPhoneNum + phoneSeqId;
-            size_t labelid_2 = labelid + 2;
-            size_t phoneId = (LONG64)(phoneSeq[labelid]);
-            size_t timeId = (t + uttBeginFrame[uttId])*numChannels + uttToChanInd[uttId];
-            size_t probId = timeId*totalPhoneNum + phoneId;
-            size_t betaid = maxPhoneNum* timeId + phoneSeqId;
-            size_t timeId_1 = timeId + numChannels;
-            size_t betaid_0 = maxPhoneNum* timeId_1 + phoneSeqId;
-            size_t betaid_1 = betaid_0 + 1;
-            size_t betaid_2 = betaid_0 + 2;
+    // Whether the score of a position at frame t falls outside of the delay boundary.
+    auto isBeyondDelay = [&](size_t t, size_t s)
+    {
+        if (labels[s] == blankTokenId)
+            return t > rightBounds[s] + delayConstraint - 1; // only constraint right side
+        return t > rightBounds[s] + delayConstraint;
+    };
 
-            if (t == frameNum - 1)
-            {
-                if (phoneSeqId == phoneNum - 3 || phoneSeqId == phoneNum - 2)
-                {
-                    betaScore[betaid] = prob[probId];
-                }
-            }
-            else
-            {
-                if (phoneSeqId >= 1)
-                {
-                    ElemType x = LZERO;
-                    ElemType ascore;
-                    if (phoneSeqId < phoneNum - 3)
-                    {
-                        if (phoneSeq[labelid] != blankTokenId && phoneId != phoneSeq[labelid_2])
-                        {
-                            x = LogAdd(x, betaScore[betaid_2]);
-                        }
-                    }
+    auto probOf = [&](size_t t, size_t s) -> ElemType
+    {
+        if (labels[s] == SIZE_MAX)
+            return 0;
+        return prob[(firstFrameCol + t * numChannels) * totalPhoneNum + labels[s]];
+    };
 
-                    if (phoneSeqId < phoneNum - 2)
-                    {
-                        x = LogAdd(x, betaScore[betaid_1]);
-                    }
+    // alpha
+    std::vector<ElemType> alpha(frameNum * phoneNum, (ElemType)LZERO);
+    for (size_t t = 0; t < frameNum; t++)
+    {
+        ElemType* alphaT = alpha.data() + t * phoneNum;
+        if (t == 0)
+        {
+            // Initialize recursion
+            for (size_t s = 1; s < phoneNum - 1 && s <= 2; s++)
+                alphaT[s] = probOf(t, s);
+            continue;
+        }
 
-                    x = LogAdd(x, betaScore[betaid_0]);
+        const ElemType* alphaT_1 = alphaT - phoneNum;
+        for (size_t s = 1; s < phoneNum - 1; s++)
+        {
+            ElemType x = LZERO;
+            if (s > 2 && canSkip[s])
+                x = LogAdd(x, alphaT_1[s - 2]);
+            if (s > 1)
+                x = LogAdd(x, alphaT_1[s - 1]);
+            x = LogAdd(x, alphaT_1[s]);
 
-                    if (phoneId != SIZE_MAX)
-                        ascore = prob[probId];
-                    else
-                        ascore = 0;
-                    betaScore[betaid] = (ElemType)x + ascore;
-                    if (delayConstraint != -1)
-                    {
-                        size_t phoneBoundId_r = (size_t)(phoneBound[labelid_2]);
-                        if (phoneId == blankTokenId)
-                        {
-                            if (t > phoneBoundId_r + delayConstraint - 1)
-                                betaScore[betaid] = LZERO;
-                        }
-                        else if (phoneId != blankTokenId)
-                        {
-                            if (t > phoneBoundId_r + delayConstraint)
-                                betaScore[betaid] = LZERO;
-                        }
-                    }
-                }
-            }
+            alphaT[s] = (delayConstraint != -1 && isBeyondDelay(t, s)) ? (ElemType)LZERO : x + probOf(t, s);
         }
     }
-}
 
-// Calculate CTC score. equation (8) in ftp://ftp.idsia.ch/pub/juergen/icml2006.pdf
-template<class ElemType>
-void _assignTotalScore(ElemType *betaScore,
-    std::vector<ElemType>& totalScore,
-    const size_t uttNum,
-    const std::vector<size_t>& uttToChanInd,
-    const std::vector<size_t>& uttBeginFrame,
-    const size_t numChannels,
-    const size_t maxPhoneNum)
-{
-#pragma omp parallel for
-    for (int uttId = 0; uttId < uttNum; uttId++) {
-        if (uttId < uttNum)
+    // beta
+    std::vector<ElemType> beta(frameNum * phoneNum, (ElemType)LZERO);
+    for (size_t t = frameNum; t-- > 0;)
+    {
+        ElemType* betaT = beta.data() + t * phoneNum;
+        if (t == frameNum - 1)
         {
-            LONG64 alphaId_0 = (uttBeginFrame[uttId] * numChannels + uttToChanInd[uttId]) * maxPhoneNum;
+            // Initialize recursion
+            for (size_t s = std::max<size_t>(phoneNum, 3) - 3; s < phoneNum - 1; s++)
+                if (s >= 1)
+                    betaT[s] = probOf(t, s);
+            continue;
+        }
+
+        const ElemType* betaT1 = betaT + phoneNum;
+        for (size_t s = 1; s < phoneNum - 1; s++)
+        {
+            ElemType x = LZERO;
+            if (s + 3 < phoneNum && labels[s] != blankTokenId && labels[s] != labels[s + 2])
+                x = LogAdd(x, betaT1[s + 2]);
+            if (s + 2 < phoneNum)
+                x = LogAdd(x, betaT1[s + 1]);
+            x = LogAdd(x, betaT1[s]);
 
-            betaScore[alphaId_0] = LogAdd(betaScore[alphaId_0 + 1], betaScore[alphaId_0 + 2]);
-            totalScore[uttId] = betaScore[alphaId_0];
+            betaT[s] = (delayConstraint != -1 && isBeyondDelay(t, s)) ? (ElemType)LZERO : x + probOf(t, s);
         }
     }
-}
 
-// Calculate derivative, equation (15) in ftp://ftp.idsia.ch/pub/juergen/icml2006.pdf
-// See _assignAlphaScore for the explanation of parameters
-template<class ElemType>
-void _assignCTCScore(
-    ElemType *CTCscore,
-    ElemType *prob,
-    ElemType *alphaScore,
-    ElemType *betaScore,
-    ElemType *phoneSeq,
-    const size_t uttNum,
-    const std::vector<size_t>& uttToChanInd,
-    const std::vector<size_t>& uttBeginFrame,
-    const std::vector<size_t>& uttPhoneNum,
-    const std::vector<size_t>& uttFrameNum,
-    const size_t numChannels,
-    const size_t maxPhoneNum,
-    const size_t totalPhoneNum)
-{
-    for (size_t uttId = 0;uttId < uttNum;uttId++) {
-#pragma omp parallel for
-        for (int t = 0; t < uttFrameNum[uttId]; t++) {
-            size_t phoneNum = uttPhoneNum[uttId];
-            size_t alphaId_0 = (uttBeginFrame[uttId] * numChannels + uttToChanInd[uttId]) * maxPhoneNum;
-            size_t timeId = (t + uttBeginFrame[uttId])*numChannels + uttToChanInd[uttId];
-            ElemType P_lx = betaScore[alphaId_0];
-
-            for (int s = 1; s < phoneNum - 1; s++)
-            {
-                long phoneId = phoneSeq[uttId*maxPhoneNum + s];
-                size_t alphaId = maxPhoneNum* timeId + s;
-                size_t probId = timeId*totalPhoneNum + phoneId;
+    // Total score of the utterance, equation (8)
+    ElemType totalScore = LogAdd(beta[1], beta[2]);
 
-                if (phoneId != SIZE_MAX)
-                {
-                    ElemType logoccu = alphaScore[alphaId] + betaScore[alphaId] - prob[probId] - (ElemType)P_lx;
-                    CTCscore[probId] = LogAdd(CTCscore[probId], logoccu);
-                }
-            }
+    // Occupancies, equation (16), converted to the linear domain
+    for (size_t t = 0; t < frameNum; t++)
+    {
+        ElemType* CTCscoreT = CTCscore + (firstFrameCol + t * numChannels) * totalPhoneNum;
+        const ElemType* alphaT = alpha.data() + t * phoneNum;
+        const ElemType* betaT = beta.data() + t * phoneNum;
+        for (size_t s = 1; s < phoneNum - 1; s++)
+        {
+            if (labels[s] != SIZE_MAX)
+                CTCscoreT[labels[s]] = LogAdd(CTCscoreT[labels[s]], alphaT[s] + betaT[s] - probOf(t, s) - totalScore);
+        }
 
-            for (int s = 0; s < totalPhoneNum; s++)
-            {
-                size_t probId = timeId*totalPhoneNum + s;
-                ElemType logoccu = CTCscore[probId];
-                if (logoccu < LZERO)
-                    CTCscore[probId] = 0.0f;
-                else
-                    CTCscore[probId] = exp(logoccu);
-            }
+        for (size_t s = 0; s < totalPhoneNum; s++)
+        {
+            ElemType logoccu = CTCscoreT[s];
+            if (logoccu < LZERO)
+                CTCscoreT[s] = 0.0f;
+            else
+                CTCscoreT[s] = exp(logoccu);
         }
     }
+
+    return totalScore;
 }
 
 template<class ElemType>
@@ -6811,6 +7157,11 @@ CPUMatrix<ElemType>& CPUMatrix<ElemType>::AssignCTCScore(
     const CPUMatrix<ElemType>& phoneSeq, const CPUMatrix<ElemType>& phoneBoundary, CPUMatrix<ElemType> & totalScore, const std::vector<size_t>& uttToChanInd, const std::vector<size_t> & uttBeginFrame, const std::vector<size_t> & uttFrameNum,
     const std::vector<size_t> & uttPhoneNum, const size_t numParallelSequences, const size_t maxFrameNum, const size_t blankTokenId, const int delayConstraint, const bool isColWise)
 {
+    // The lattices are kept per utterance, the minibatch-wide alpha and beta matrices are not used on the CPU.
+    UNUSED(alpha);
+    UNUSED(beta);
+    UNUSED(maxFrameNum);
+
     // Column wise representation of sequences in input matrices (each column is one sequence/utterance)
     if (isColWise)
     {
@@ -6821,24 +7172,21 @@ CPUMatrix<ElemType>& CPUMatrix<ElemType>::AssignCTCScore(
         // Max number of phones in utterances in this minibatch
         size_t maxPhoneNum = phoneSeq.GetNumRows();
 
-        for (size_t t = 0; t < maxFrameNum; t++)
-        {
-            _assignAlphaScore(prob.Data(), alpha.Data(), phoneSeq.Data(), phoneBoundary.Data(), uttToChanInd,
-                uttFrameNum, uttBeginFrame, uttPhoneNum, numParallelSequences, uttNum, t, maxPhoneNum, totalPhoneNum, blankTokenId, delayConstraint);
-        }
+        // Utterances are independent (and write to distinct columns), longer ones come first to balance the load.
+        std::vector<size_t> order(uttNum);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return uttFrameNum[a] * uttPhoneNum[a] > uttFrameNum[b] * uttPhoneNum[b]; });
 
-        for (LONG64 t = maxFrameNum - 1; t >= 0; t--)
+        std::vector<ElemType> scores(uttNum);
+#pragma omp parallel for schedule(dynamic)
+        for (long i = 0; i < (long)uttNum; i++)
         {
-            _assignBetaScore(prob.Data(), beta.Data(), phoneSeq.Data(), phoneBoundary.Data(), uttToChanInd,
-                uttFrameNum, uttBeginFrame, uttPhoneNum, numParallelSequences, uttNum, t, maxPhoneNum, totalPhoneNum, blankTokenId, delayConstraint);
+            size_t uttId = order[i];
+            scores[uttId] = _assignCTCScoreForUtterance(Data(), prob.Data(), phoneSeq.Data() + uttId * maxPhoneNum, phoneBoundary.Data() + uttId * maxPhoneNum,
+                uttFrameNum[uttId], uttPhoneNum[uttId], uttBeginFrame[uttId] * numParallelSequences + uttToChanInd[uttId], numParallelSequences,
+                totalPhoneNum, blankTokenId, delayConstraint);
         }
 
-        std::vector<ElemType> scores(uttNum);
-        _assignTotalScore(beta.Data(), scores, uttNum, uttToChanInd, uttBeginFrame, numParallelSequences, maxPhoneNum);
-
-        _assignCTCScore(Data(), prob.Data(), alpha.Data(), beta.Data(), phoneSeq.Data(), uttNum, uttToChanInd,
-            uttBeginFrame, uttPhoneNum, uttFrameNum, numParallelSequences, maxPhoneNum, totalPhoneNum);
-
         totalScore(0, 0) = 0.0;
         for (size_t utt = 0; utt < uttNum; utt++)
         {
@@ -6855,10 +7203,31 @@ CPUMatrix<ElemType>& CPUMatrix<ElemType>::AssignCTCScore(
     return *this;
 }
 
+/// the kernel function for the normalizers of RCRF backward computation
+template <class ElemType>
+void CPUMatrix<ElemType>::_rcrfBackwardComputeZeta(size_t t, const CPUMatrix<ElemType>& alpha,
+                                                   ElemType* zeta,
+                                                   const CPUMatrix<ElemType>& pair_scores)
+{
+    int iNumLab = (int) alpha.GetNumRows();
+
+#pragma omp parallel for
+    for (int j = 0; j < iNumLab; j++)
+    {
+        ElemType fSum = (ElemType) LZERO;
+        for (int m = 0; m < iNumLab; m++)
+        {
+            fSum = (ElemType) LogAddD(fSum, alpha(m, t) + pair_scores(j, m));
+        }
+        zeta[j] = fSum;
+    }
+}
+
 /// the kernel function for RCRF backward computation
 template <class ElemType>
 void CPUMatrix<ElemType>::_rcrfBackwardCompute(size_t t, size_t k, const CPUMatrix<ElemType>& alpha,
                                                CPUMatrix<ElemType>& beta,
+                                               const ElemType* zeta,
                                                const CPUMatrix<ElemType>& pair_scores)
 {
     size_t iNumLab = alpha.GetNumRows();
@@ -6881,13 +7250,7 @@ void CPUMatrix<ElemType>::_rcrfBackwardCompute(size_t t, size_t k, const CPUMatr
     {
         for (int j = 0; j < iNumLab; j++)
         {
-            fSum = (ElemType) LZERO;
-            for (int m = 0; m < iNumLab; m++)
-            {
-                fSum = (ElemType) LogAddD(fSum, alpha(m, t) + pair_scores(j, m));
-            }
-
-            fTmp = (ElemType) LogAddD(fTmp, beta(j, t + 1) + alpha(k, t) + pair_scores(j, k) - fSum);
+            fTmp = (ElemType) LogAddD(fTmp, beta(j, t + 1) + alpha(k, t) + pair_scores(j, k) - zeta[j]);
         }
         beta(k, t) = fTmp;
     }
@@ -6911,17 +7274,25 @@ void CPUMatrix<ElemType>::RCRFTransGrdCompute(const CPUMatrix<ElemType>& lbls,
             break;
         }
 
+    // alpha of the previous position (or the start constraint at the first position), and its normalizers
+    // zeta(j) = log sum_k exp(alpha(k, tPos - 1) + pair_scores(j, k)), which are shared by all labels i
+    std::vector<ElemType> prevAlpha(iNumLab);
+    std::vector<ElemType> zeta(iNumLab);
     for (size_t tPos = 0; tPos < iNumPos; tPos++)
     {
-        CPUMatrix<ElemType> b = beta.ColumnSlice(tPos, 1);
-        CPUMatrix<ElemType> a;
-        if (tPos > 0)
-            a = alpha.ColumnSlice(tPos - 1, 1);
+        for (int k = 0; k < iNumLab; k++)
+        {
+            if (tPos == 0)
+                prevAlpha[k] = (k == firstLbl) ? (ElemType) 0 : (ElemType) LZERO;
+            else
+                prevAlpha[k] = alpha(k, tPos - 1);
+        }
+        _rcrfTransGrdComputeZeta(prevAlpha.data(), zeta.data(), pair_scores);
 
 #pragma omp parallel for
         for (int i = 0; i < iNumLab; i++)
         {
-            _rcrfTransGrdCompute(i, lbls, alpha, beta, pair_scores, grd, tPos);
+            _rcrfTransGrdCompute(i, prevAlpha.data(), beta, zeta.data(), pair_scores, grd, tPos);
         }
 
         // transition score
@@ -6952,79 +7323,46 @@ void CPUMatrix<ElemType>::RCRFTransGrdCompute(const CPUMatrix<ElemType>& lbls,
     }
 };
 
+/// the kernel function for the normalizers of the RCRF transition gradient
+template <class ElemType>
+void CPUMatrix<ElemType>::_rcrfTransGrdComputeZeta(const ElemType* prevAlpha,
+                                                   ElemType* zeta,
+                                                   const CPUMatrix<ElemType>& pair_scores)
+{
+    int iNumLab = (int) pair_scores.GetNumRows();
+
+#pragma omp parallel for
+    for (int j = 0; j < iNumLab; j++)
+    {
+        ElemType fSum = (ElemType) LZERO;
+        for (int k = 0; k < iNumLab; k++)
+        {
+            fSum = (ElemType) LogAddD(fSum, prevAlpha[k] + pair_scores(j, k));
+        }
+        zeta[j] = fSum;
+    }
+}
+
 template <class ElemType>
 void CPUMatrix<ElemType>::_rcrfTransGrdCompute(size_t i,
-                                               const CPUMatrix<ElemType>& lbls,
-                                               const CPUMatrix<ElemType>& alpha,
+                                               const ElemType* prevAlpha,
                                                const CPUMatrix<ElemType>& beta,
+                                               const ElemType* zeta,
                                                const CPUMatrix<ElemType>& pair_scores,
                                                CPUMatrix<ElemType>& grd,
                                                const size_t tPos // position
                                                )
 {
-    int iNumLab = (int) alpha.GetNumRows();
-
-    int firstLbl = -1;
-    for (int ik = 0; ik < lbls.GetNumRows(); ik++)
-        if (lbls(ik, 0) != 0)
-        {
-            firstLbl = ik;
-            break;
-        }
-
-    CPUMatrix<ElemType> b = beta.ColumnSlice(tPos, 1);
-    CPUMatrix<ElemType> a;
-    if (tPos > 0)
-        a = alpha.ColumnSlice(tPos - 1, 1);
+    int iNumLab = (int) beta.GetNumRows();
 
+    for (int j = 0; j < iNumLab; j++)
     {
-        ElemType fTmp = (ElemType) LZERO;
-        for (int j = 0; j < iNumLab; j++)
-        {
-            if (tPos == 0)
-            {
-                if (i == firstLbl)
-                {
-                    fTmp = 0;
-                }
-                else
-                {
-                    fTmp = (ElemType) LZERO;
-                }
-            }
-            else
-            {
-                fTmp = a(i, 0);
-            }
-            fTmp += pair_scores(j, i);
-
-            ElemType fSum = (ElemType) LZERO;
-            for (int k = 0; k < iNumLab; k++)
-            {
-                ElemType fTmp2;
-                if (tPos == 0)
-                {
-                    if (k == firstLbl)
-                    {
-                        fTmp2 = 0;
-                    }
-                    else
-                    {
-                        fTmp2 = (ElemType) LZERO;
-                    }
-                }
-                else
-                {
-                    fTmp2 = a(k, 0);
-                }
-                fSum = (ElemType) LogAddD(fSum, fTmp2 + pair_scores(j, k));
-            }
-
-            fTmp -= fSum;
-            fTmp += b(j, 0);
+        ElemType fTmp = prevAlpha[i];
+        fTmp += pair_scores(j, i);
+        fTmp -= zeta[j];
+        fTmp += beta(j, tPos);
 
-            grd(j, i) += exp(fTmp);
-        }
+        grd(j, i) += exp(fTmp);
     }
 };
 template <class ElemType>
@@ -8,11 +8,58 @@
 #pragma once
 
 #include "RNGHandle.h"
+#include <algorithm>
 #include <memory>
 #include <random>
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
+// -----------------------------------------------------------------------
+// Philox4x32 -- counter-based random number generator (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3", SC'11).
+// Every call maps a (key, counter) pair to four independent 32-bit random values, so any element of a
+// random stream can be computed on its own. Kernels that use it produce identical results for any number of threads.
+// The 128-bit counter is formed from two 64-bit halves: 'hi' identifies the stream (one per kernel call),
+// 'lo' the block of four values within the stream.
+// -----------------------------------------------------------------------
+
+struct Philox4x32
+{
+    static const int NumRounds = 10;
+
+    static inline void Generate(uint64_t key, uint64_t hi, uint64_t lo, uint32_t out[4])
+    {
+        uint32_t c0 = (uint32_t)lo, c1 = (uint32_t)(lo >> 32), c2 = (uint32_t)hi, c3 = (uint32_t)(hi >> 32);
+        uint32_t k0 = (uint32_t)key, k1 = (uint32_t)(key >> 32);
+        for (int r = 0; r < NumRounds; r++)
+        {
+            if (r > 0)
+            {
+                k0 += 0x9E3779B9; // golden ratio
+                k1 += 0xBB67AE85; // sqrt(3) - 1
+            }
+            const uint64_t p0 = (uint64_t)0xD2511F53 * c0;
+            const uint64_t p1 = (uint64_t)0xCD9E8D57 * c2;
+            const uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+            const uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+            c1 = (uint32_t)p1;
+            c3 = (uint32_t)p0;
+            c0 = n0;
+            c2 = n2;
+        }
+        out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+    }
+
+    // threshold t such that (r < t) for a uniform 32-bit r has probability 'rate'
+    static inline uint64_t Threshold(double rate)
+    {
+        if (rate <= 0)
+            return 0;
+        if (rate >= 1)
+            return (uint64_t)1 << 32;
+        return (uint64_t)(rate * 4294967296.0);
+    }
+};
+
 class CPURNGHandle : public RNGHandle
 {
 public:
@@ -23,8 +70,25 @@ public:
         return m_generator;
     }
 
+    // Key for the counter-based generator (Philox4x32) used by parallel kernels.
+    uint64_t PhiloxKey() const
+    {
+        return m_seed;
+    }
+
+    // Reserve a new Philox stream covering 'count' values. The returned value is used as the 'hi' half of the
+    // counter; it advances with every call so that subsequent calls never reuse a stream.
+    uint64_t ReservePhiloxStream(uint64_t count)
+    {
+        uint64_t stream = m_philoxOffset;
+        m_philoxOffset += std::max<uint64_t>(count, 1);
+        return stream;
+    }
+
 private:
     std::mt19937_64 m_generator;
+    uint64_t m_seed;
+    uint64_t m_philoxOffset;
 };
 
 }}}
@@ -17,6 +17,7 @@
 #include <random>
 #include <chrono>
 #include <iostream>
+#include <unordered_map>
 #ifdef LEAKDETECT
 #include <vld.h>
 #endif
@@ -767,12 +768,27 @@ void CPUSparseMatrix<ElemType>::SetMatrixFromSBCFormat(const size_t* blockIds, c
 
     SetFormat(matrixFormatSparseBlockCol);
     Resize(numRows, numCols, numBlocks * numRows);
+    // Resize() only reallocates for a larger index buffer, the values may still need room for numRows per block
+    RequireSizeAndAllocate(numRows, numCols, numBlocks * numRows);
     SetBlockSize(numBlocks);
 
     memcpy(GetBlockIds(), blockIds, sizeof(size_t)*(numBlocks));
     memcpy(Data(), val, sizeof(ElemType)*numBlocks*numRows);
 }
 
+template <class ElemType>
+void CPUSparseMatrix<ElemType>::GetSBCFormat(std::vector<size_t>& blockIds, std::vector<ElemType>& val) const
+{
+    if (GetFormat() != matrixFormatSparseBlockCol)
+        LogicError("GetSBCFormat: Matrix is not in sparse block column format.");
+
+    const size_t numBlocks = GetBlockSize();
+    blockIds.resize(numBlocks);
+    for (size_t j = 0; j < numBlocks; j++)
+        blockIds[j] = GetBlockIds()[j] - GetBlockIdShift();
+    val.assign(Data(), Data() + numBlocks * GetNumRows());
+}
+
 template <class ElemType>
 ElemType* CPUSparseMatrix<ElemType>::Data()  const
 {
@@ -926,7 +942,21 @@ void CPUSparseMatrix<ElemType>::Reset()
     SetBlockIdShift(0);
 }
 
+// Rows of the dense operands / result processed together by the sparse GEMM kernels below. A block of this many rows of a
+// float column is 8 KB, so the blocks of c and of the dense operand touched by one thread stay in L1/L2 while the nonzeros are applied.
+static const size_t c_sparseGemmBlockRows = 2048;
+
+// Rows per block when splitting 'numRows' rows over the available threads: at most c_sparseGemmBlockRows, but small
+// enough to give every thread a block (down to 16 rows, i.e. one cache line of floats).
+static size_t SparseGemmRowBlockSize(size_t numRows)
+{
+    const size_t numThreads = (size_t)max(omp_get_max_threads(), 1);
+    return max((size_t)16, min(c_sparseGemmBlockRows, (numRows + numThreads - 1) / numThreads));
+}
+
 // Implements product of one sparse and one dense matrix updating a third dense matrix. Input matrices are optionally transposed.
+// The work is split such that every thread owns a disjoint part of c, so no locks or atomics are needed, and the innermost loops
+// run over contiguous memory wherever the layout permits so that the compiler can vectorize them.
 // NOTE: The only for using a class template instead of a function template was that I couldn't make the function template compile.
 template <class ElemType, bool denseTimesSparse /* false means SparseTimesDense */, bool transposeA, bool transposeB>
 class MultiplyDenseAndSparse{
@@ -947,13 +977,6 @@ public:
         if (k != l)
             InvalidArgument("CPUSparseMatrix::MultiplyAndWeightedAdd: The inner dimensions of a (= %lu) and b (= %lu) don't match.", k, l);
 
-        // Determine the dimension of the outer index of the dense matrix.
-        size_t outerDimensionDense;
-        if      ( denseTimesSparse && !transposeA) outerDimensionDense = dense.GetNumRows();
-        else if ( denseTimesSparse &&  transposeA) outerDimensionDense = dense.GetNumCols();
-        else if (!denseTimesSparse && !transposeB) outerDimensionDense = dense.GetNumCols();
-        else if (!denseTimesSparse &&  transposeB) outerDimensionDense = dense.GetNumRows();
-
         if (beta == 0)
             c.RequireSize(m, n);
         else
@@ -985,47 +1008,131 @@ public:
         // * Initialized the output matrix c
 
         // Now do the actual multiplication.
-        ElemType* valueBuffer = sparse.Buffer() + *sparse.SecondaryIndexLocation(); // Points to the value buffer of the current view (i.e. buffer containing values of non-zero elements).
-        int* rowIndexBuffer = sparse.MajorIndexLocation();                          // Points to the index buffer of the current view (i.e. buffer containing indices of non-zero elements).
-        size_t iNonzero = 0;                                                           // Number of nonzero elements handled so far for current slice view.
-        int numPreviosNonzero = sparse.SecondaryIndexLocation()[0];                 // Total number of nonzero values handled in previous slices.
-
-        // Loop over columns of the sparse matrix
-        for (size_t colSparse = 0; colSparse < sparse.GetNumCols(); colSparse++)
+        const ElemType* valueBuffer = sparse.Buffer() + *sparse.SecondaryIndexLocation(); // Points to the value buffer of the current view (i.e. buffer containing values of non-zero elements).
+        const CPUSPARSE_INDEX_TYPE* rowIndexBuffer = sparse.MajorIndexLocation();          // Points to the index buffer of the current view (i.e. buffer containing indices of non-zero elements).
+        const CPUSPARSE_INDEX_TYPE* colStarts = sparse.SecondaryIndexLocation();           // Column starts, relative to the nonzeros of previous slices.
+        const CPUSPARSE_INDEX_TYPE firstNonzero = colStarts[0];
+        const long numSparseCols = (long) sparse.GetNumCols();
+
+        const ElemType* denseData = dense.Data();
+        const size_t ldDense = dense.GetNumRows();
+        ElemType* cData = c.Data();
+        const size_t ldc = c.GetNumRows();
+
+        // Below if-statements are evaluated at compile time.
+        if (denseTimesSparse && !transposeB)
         {
-            size_t numNonzeroInSparseCol = sparse.SecondaryIndexLocation()[colSparse + 1] - numPreviosNonzero;
-            // Loop over the nonzero rows of the current column of the sparse matrix
-            for (; iNonzero < numNonzeroInSparseCol; iNonzero++)
+            // c(:, s) += alpha * sum_r op(dense)(:, r) * sparse(r, s): every sparse column updates its own column of c.
+#pragma omp parallel for schedule(dynamic, 16)
+            for (long s = 0; s < numSparseCols; s++)
             {
-                size_t rowSparse = rowIndexBuffer[iNonzero]; // RowLocation
-                ElemType sparseVal = valueBuffer[iNonzero];
-
-                // Determine the index of the 'outer' dimension of the sparse matrix and the common inner index.
-                size_t outerIndexSparse;
-                size_t innerIndex;
-                // Below if-statements are evaluated at compile time.
-                if      ( denseTimesSparse && !transposeB) { outerIndexSparse = colSparse; innerIndex = rowSparse; }
-                else if ( denseTimesSparse &&  transposeB) { outerIndexSparse = rowSparse; innerIndex = colSparse; }
-                else if (!denseTimesSparse && !transposeA) { outerIndexSparse = rowSparse; innerIndex = colSparse; }
-                else if (!denseTimesSparse &&  transposeA) { outerIndexSparse = colSparse; innerIndex = rowSparse; }
-
-                // Loop over the outer index of the dense matrix
-                for (size_t outerIndexDense = 0; outerIndexDense < outerDimensionDense; outerIndexDense++)
+                ElemType* cCol = cData + s * ldc;
+                const size_t begin = colStarts[s] - firstNonzero;
+                const size_t end = colStarts[s + 1] - firstNonzero;
+                if (!transposeA)
+                {
+                    // op(dense)(:, r) is a column of dense; apply all nonzeros of the column to one block of c(:, s) at a time
+                    for (size_t i0 = 0; i0 < m; i0 += c_sparseGemmBlockRows)
+                    {
+                        const size_t i1 = min(m, i0 + c_sparseGemmBlockRows);
+                        for (size_t p = begin; p < end; p++)
+                        {
+                            const ElemType v = alpha * valueBuffer[p];
+                            const ElemType* denseCol = denseData + rowIndexBuffer[p] * ldDense;
+                            for (size_t i = i0; i < i1; i++)
+                                cCol[i] += v * denseCol[i];
+                        }
+                    }
+                }
+                else
                 {
-                    // Determine the row index of the dense input matrix.
-                    // Below if-statements are evaluated at compile time.
-                    ElemType denseVal;
-                    if      ( denseTimesSparse && !transposeA) denseVal = dense(outerIndexDense,      innerIndex);
-                    else if ( denseTimesSparse &&  transposeA) denseVal = dense(     innerIndex, outerIndexDense);
-                    else if (!denseTimesSparse && !transposeB) denseVal = dense(     innerIndex, outerIndexDense);
-                    else if (!denseTimesSparse &&  transposeB) denseVal = dense(outerIndexDense,      innerIndex);
-
-
-                    // Update matrix c.
-                    if (denseTimesSparse)
-                        c(outerIndexDense, outerIndexSparse) += alpha * denseVal * sparseVal;
-                    else /*Sparse times dense */
-                        c(outerIndexSparse, outerIndexDense) += alpha * denseVal * sparseVal;
+                    // op(dense)(i, r) = dense(r, i): a sparse dot product with column i of dense
+                    for (size_t i = 0; i < m; i++)
+                    {
+                        const ElemType* denseCol = denseData + i * ldDense;
+                        ElemType sum = 0;
+                        for (size_t p = begin; p < end; p++)
+                            sum += valueBuffer[p] * denseCol[rowIndexBuffer[p]];
+                        cCol[i] += alpha * sum;
+                    }
+                }
+            }
+        }
+        else if (denseTimesSparse && transposeB)
+        {
+            // c(:, r) += alpha * op(dense)(:, s) * sparse(r, s): different sparse columns update the same columns of c,
+            // so each thread owns a block of rows of c and applies all nonzeros to it.
+            const size_t blockRows = SparseGemmRowBlockSize(m);
+            const long numRowBlocks = (long) ((m + blockRows - 1) / blockRows);
+#pragma omp parallel for
+            for (long b = 0; b < numRowBlocks; b++)
+            {
+                const size_t i0 = b * blockRows;
+                const size_t i1 = min(m, i0 + blockRows);
+                for (long s = 0; s < numSparseCols; s++)
+                {
+                    for (size_t p = colStarts[s] - firstNonzero; p < colStarts[s + 1] - firstNonzero; p++)
+                    {
+                        const ElemType v = alpha * valueBuffer[p];
+                        ElemType* cCol = cData + rowIndexBuffer[p] * ldc;
+                        if (!transposeA)
+                        {
+                            const ElemType* denseCol = denseData + s * ldDense;
+                            for (size_t i = i0; i < i1; i++)
+                                cCol[i] += v * denseCol[i];
+                        }
+                        else
+                        {
+                            for (size_t i = i0; i < i1; i++)
+                                cCol[i] += v * denseData[s + i * ldDense];
+                        }
+                    }
+                }
+            }
+        }
+        else if (!denseTimesSparse && !transposeA)
+        {
+            // c(r, j) += alpha * sparse(r, s) * op(dense)(s, j): each thread owns columns of c and scatters all sparse columns into them.
+#pragma omp parallel for
+            for (long j = 0; j < (long) n; j++)
+            {
+                ElemType* cCol = cData + j * ldc;
+                for (long s = 0; s < numSparseCols; s++)
+                {
+                    const ElemType d = transposeB ? denseData[j + s * ldDense] : denseData[s + j * ldDense];
+                    if (d == 0)
+                        continue;
+                    const ElemType ad = alpha * d;
+                    for (size_t p = colStarts[s] - firstNonzero; p < colStarts[s + 1] - firstNonzero; p++)
+                        cCol[rowIndexBuffer[p]] += ad * valueBuffer[p];
+                }
+            }
+        }
+        else /* !denseTimesSparse && transposeA */
+        {
+            // c(s, j) += alpha * sum_r sparse(r, s) * op(dense)(r, j): every element of c is a sparse dot product, each sparse column owns a row of c.
+#pragma omp parallel for schedule(dynamic, 16)
+            for (long s = 0; s < numSparseCols; s++)
+            {
+                const size_t begin = colStarts[s] - firstNonzero;
+                const size_t end = colStarts[s + 1] - firstNonzero;
+                if (begin == end)
+                    continue;
+                for (size_t j = 0; j < n; j++)
+                {
+                    ElemType sum = 0;
+                    if (!transposeB)
+                    {
+                        const ElemType* denseCol = denseData + j * ldDense;
+                        for (size_t p = begin; p < end; p++)
+                            sum += valueBuffer[p] * denseCol[rowIndexBuffer[p]];
+                    }
+                    else
+                    {
+                        for (size_t p = begin; p < end; p++)
+                            sum += valueBuffer[p] * denseData[j + rowIndexBuffer[p] * ldDense];
+                    }
+                    cData[s + j * ldc] += alpha * sum;
                 }
             }
         }
@@ -1110,21 +1217,34 @@ void CPUSparseMatrix<ElemType>::MultiplyAndAdd(ElemType alpha, const CPUMatrix<E
             c.RequireSizeAndAllocate(m, n, 0, true); // allocate for blockIds
         }
 
-        map<size_t, size_t> col2BlockId;
+        const CPUSPARSE_INDEX_TYPE* colStarts = rhs.SecondaryIndexLocation();
+        const CPUSPARSE_INDEX_TYPE* rowIndices = rhs.MajorIndexLocation(); // relative to the first nonzero of the view
+        const ElemType* values = rhs.Buffer() + colStarts[0];
+        const size_t nz = colStarts[rhs.GetNumCols()] - colStarts[0]; // NzCount() does not account for column slice views
+
+        // Map the result columns (rows of rhs) to blocks of c; columns that are not in c yet get new blocks in order of appearance.
+        unordered_map<size_t, size_t> col2BlockId;
+        col2BlockId.reserve(blockSizePrev + nz);
         for (size_t blockId = 0; blockId < blockSizePrev; blockId++)
         {
             col2BlockId[c.GetBlockIds()[blockId]] = blockId;
         }
 
         size_t blockSizeCurr = blockSizePrev;
-        for (size_t rhsNz = 0; rhsNz < rhs.NzCount(); rhsNz++)
+        vector<size_t> nzBlockId(nz);
+        vector<size_t> nzCol(nz);
+        for (size_t rhsCol = 0; rhsCol < rhs.GetNumCols(); rhsCol++)
         {
-            size_t resultCol = rhs.MajorIndexLocation()[rhsNz];
-            if (col2BlockId.find(resultCol) == col2BlockId.end())
+            for (size_t p = colStarts[rhsCol] - colStarts[0]; p < colStarts[rhsCol + 1] - colStarts[0]; p++)
             {
-                col2BlockId[resultCol] = blockSizeCurr;
-                c.GetBlockIds()[blockSizeCurr] = resultCol;
-                blockSizeCurr ++;
+                auto inserted = col2BlockId.emplace(rowIndices[p], blockSizeCurr);
+                if (inserted.second)
+                {
+                    c.GetBlockIds()[blockSizeCurr] = rowIndices[p];
+                    blockSizeCurr++;
+                }
+                nzBlockId[p] = inserted.first->second;
+                nzCol[p] = rhsCol;
             }
         }
 
@@ -1135,22 +1255,33 @@ void CPUSparseMatrix<ElemType>::MultiplyAndAdd(ElemType alpha, const CPUMatrix<E
             memset(c.Data() + m * blockSizePrev, 0, sizeof(ElemType) * m * (blockSizeCurr - blockSizePrev));
         }
 
-        for (size_t rhsCol = 0; rhsCol < rhs.GetNumCols(); rhsCol++)
+        // Group the nonzeros by block (counting sort, keeping their order), so that every block of c is accumulated
+        // by a single thread without synchronization and in the same order as a serial loop would.
+        vector<size_t> blockStarts(blockSizeCurr + 1, 0);
+        for (size_t p = 0; p < nz; p++)
+            blockStarts[nzBlockId[p] + 1]++;
+        for (size_t blockId = 0; blockId < blockSizeCurr; blockId++)
+            blockStarts[blockId + 1] += blockStarts[blockId];
+        vector<size_t> nzByBlock(nz);
         {
-            size_t start = rhs.SecondaryIndexLocation()[rhsCol];
-            size_t end = rhs.SecondaryIndexLocation()[rhsCol + 1];
+            vector<size_t> next(blockStarts.begin(), blockStarts.end() - 1);
+            for (size_t p = 0; p < nz; p++)
+                nzByBlock[next[nzBlockId[p]]++] = p;
+        }
 
-            for (size_t p = start; p < end; p++)
+        const ElemType* lhsData = lhs.Data();
+        ElemType* resultData = c.Buffer();
+#pragma omp parallel for schedule(dynamic, 64)
+        for (long blockId = 0; blockId < (long) blockSizeCurr; blockId++)
+        {
+            ElemType* results = resultData + blockId * m;
+            for (size_t q = blockStarts[blockId]; q < blockStarts[blockId + 1]; q++)
             {
-                size_t rhsRow = rhs.MajorIndexLocation()[p];
-                ElemType val = rhs.Buffer()[p];
-
-                ElemType* results = c.Buffer() + col2BlockId[rhsRow] * m;
-                #pragma omp parallel for
-                for (int lhsRow = 0; lhsRow < (int)m; lhsRow++)
-                {
-                    results[lhsRow] += alpha * lhs((size_t)lhsRow, rhsCol) * val;
-                }
+                const size_t p = nzByBlock[q];
+                const ElemType val = alpha * values[p];
+                const ElemType* lhsCol = lhsData + nzCol[p] * m;
+                for (size_t lhsRow = 0; lhsRow < m; lhsRow++)
+                    results[lhsRow] += val * lhsCol[lhsRow];
             }
         }
     }
@@ -1775,6 +1906,25 @@ half CPUSparseMatrix<half>::SumOfElements() const
 {
     RuntimeError("half SumOfElements not supported.");
 }
+template <>
+half CPUSparseMatrix<half>::SumOfAbsElements() const
+{
+    if (IsEmpty())
+        return 0;
+
+    // there is no asum for half, accumulate the converted values instead
+    double sum = 0;
+    long m = (long) NzCount();
+    const half* nzValues = NzValues();
+
+#pragma omp parallel for reduction(+ : sum)
+    for (long i = 0; i < m; i++)
+    {
+        sum += fabs((float) nzValues[i]);
+    }
+
+    return (half)(float) sum;
+}
 
 template <typename ElemType>
 MATH_API File& operator>>(File& stream, CPUSparseMatrix<ElemType>& us)
@@ -124,6 +124,8 @@ public:
                                 const size_t nz, const size_t numRows, const size_t numCols);
 
     void SetMatrixFromSBCFormat(const size_t* blockIds, const ElemType* val, const size_t numBlocks, const size_t numRows, const size_t numCols);
+    // inverse of SetMatrixFromSBCFormat(): column index of each block and the block values (numRows per block)
+    void GetSBCFormat(std::vector<size_t>& blockIds, std::vector<ElemType>& val) const;
 
     // Dense * Sparse -> Dense
     static void MultiplyAndWeightedAdd(ElemType alpha, const CPUMatrix<ElemType>& lhs, const bool transposeA,
@@ -7,6 +7,12 @@
 #include "ConvolutionEngine.h"
 #include "CuDnnFactories.h"
 #include "MklDnnCommon.h"
+#if defined(__AVX512VPOPCNTDQ__)
+#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
@@ -1151,6 +1157,235 @@ public:
     }
 };
 
+//------------------------------------------------------------------
+// Binary (XNOR-popcount) convolution engine implementation.
+// Computes the convolution of the binarized input and kernel: every value v is replaced by sign(v),
+// i.e. +1 if v > 0 and -1 otherwise, so each product is +1 or -1 and the output is the difference of the
+// numbers of matching and mismatching signs over the (unpadded) kernel window. Signs are packed into
+// 64-bit words, and a window of n elements then costs n/64 XOR and popcount operations.
+// The engine uses the same geometry maps as the reference engine and therefore supports any
+// convolution configuration. Input windows (identified by their base column and run) and kernel
+// slices (identified by their weight offset and run) are each packed once and shared by all output
+// cells that use them.
+// Backward passes (and pooling) are those of the reference engine, i.e. gradients are computed as
+// for the real-valued convolution (straight-through estimator), which is how binarized networks are trained.
+//------------------------------------------------------------------
+template <class ElemType>
+class BinaryConvolutionEngine : public ReferenceConvolutionEngine<ElemType>
+{
+public:
+    using Base = ReferenceConvolutionEngine<ElemType>;
+    using typename Base::Mat;
+
+public:
+    BinaryConvolutionEngine(ConvolveGeometryPtr geometry, DEVICEID_TYPE deviceId, ImageLayoutKind imageLayout, size_t maxTempMemSizeInSamples, PoolKind poolKind, bool poolIncludePad)
+        : Base(geometry, deviceId, imageLayout, maxTempMemSizeInSamples, poolKind, poolIncludePad), m_wordsPerWindow(0)
+    {
+    }
+
+    static bool IsSupported(DEVICEID_TYPE deviceId, ConvolveGeometryPtr geometry)
+    {
+        return deviceId < 0 && geometry->Groups() == 1;
+    }
+
+protected:
+    using Base::m_geometry;
+    using Base::m_deviceId;
+    using Base::m_imageLayout;
+
+    void EnsureCompatible() override
+    {
+        if (m_imageLayout != ImageLayoutKind::CHW)
+            LogicError("Binary convolution engine supports only CHW/cudnn layout.");
+        if (IsGpu(m_deviceId))
+            LogicError("Binary convolution engine currently supports only CPU device.");
+    }
+
+    void EnsureConvolutionInitialized() override
+    {
+        Base::EnsureConvolutionInitialized();
+        if (!m_rowWindow.empty())
+            return;
+
+        const auto& mpRowCol = m_geometry->MpRowCol();
+        const auto& mpRowIwht = m_geometry->MpRowIwht();
+        const auto& mpRowRun = m_geometry->MpRowRun();
+        const auto& runs = m_geometry->Runs();
+        const size_t numRows = mpRowCol.size();
+
+        // Decode the runs used by the output cells.
+        std::map<int, size_t> runIndex;
+        std::vector<int> rowRun(numRows);
+        for (size_t row = 0; row < numRows; row++)
+        {
+            int i0 = mpRowRun.empty() ? 0 : mpRowRun[row];
+            rowRun[row] = i0;
+            if (runIndex.find(i0) != runIndex.end())
+                continue;
+            runIndex[i0] = m_runs.size();
+            Run run;
+            run.skip = runs[i0];
+            run.size = runs[i0 + 1];
+            run.dcols.assign(runs.begin() + i0 + 2, runs.begin() + i0 + 2 + run.size);
+            run.numValid = 0;
+            m_runs.push_back(std::move(run));
+        }
+        size_t maxSize = 0;
+        for (const auto& run : m_runs)
+            maxSize = max(maxSize, (size_t)run.size);
+        m_wordsPerWindow = max<size_t>(1, (maxSize + 63) / 64);
+
+        // Valid (unmasked) positions of each run, as bit masks.
+        m_validBits.assign(m_runs.size() * m_wordsPerWindow, 0);
+        for (const auto& entry : runIndex)
+        {
+            auto& run = m_runs[entry.second];
+            const int imask = entry.first + 2 + run.size;
+            uint64_t* valid = m_validBits.data() + entry.second * m_wordsPerWindow;
+            for (int i = 0; i < run.size; i++)
+            {
+                if (runs[imask + i] == 0)
+                    continue;
+                valid[i / 64] |= (uint64_t)1 << (i % 64);
+                run.numValid++;
+            }
+        }
+
+        // Distinct input windows and kernel slices.
+        std::map<std::pair<int, size_t>, size_t> windowIndex, sliceIndex;
+        m_rowWindow.resize(numRows);
+        m_rowSlice.resize(numRows);
+        m_rowRun.resize(numRows);
+        for (size_t row = 0; row < numRows; row++)
+        {
+            size_t run = runIndex[rowRun[row]];
+            m_rowRun[row] = run;
+
+            auto window = std::make_pair(mpRowCol[row], run);
+            auto w = windowIndex.find(window);
+            if (w == windowIndex.end())
+            {
+                w = windowIndex.insert(std::make_pair(window, m_windowCol.size())).first;
+                m_windowCol.push_back(mpRowCol[row]);
+                m_windowRun.push_back(run);
+            }
+            m_rowWindow[row] = w->second;
+
+            auto slice = std::make_pair(mpRowIwht[row] + m_runs[run].skip, run);
+            auto k = sliceIndex.find(slice);
+            if (k == sliceIndex.end())
+            {
+                k = sliceIndex.insert(std::make_pair(slice, m_sliceOffset.size())).first;
+                m_sliceOffset.push_back(slice.first);
+                m_sliceRun.push_back(run);
+            }
+            m_rowSlice[row] = k->second;
+        }
+    }
+
+    void ForwardCore(const Mat& in, const Mat& kernel, Mat& out, Mat& /*workspace*/) override
+    {
+        const size_t W = m_wordsPerWindow;
+        const size_t numRows = m_rowWindow.size();
+        const size_t numWindows = m_windowCol.size();
+        const size_t numSlices = m_sliceOffset.size();
+        const size_t inRows = in.GetNumRows();
+        const ElemType* kernelData = kernel.Data();
+
+        // The kernel changes during training, so it is packed on every call. This is cheap compared to the convolution.
+        m_kernelBits.assign(numSlices * W, 0);
+#pragma omp parallel for
+        for (int64_t s = 0; s < (int64_t)numSlices; s++)
+            PackSigns(kernelData + m_sliceOffset[s], nullptr, m_runs[m_sliceRun[s]], m_kernelBits.data() + s * W);
+
+        m_windowBits.resize(numWindows * W);
+        for (size_t sample = 0; sample < in.GetNumCols(); sample++)
+        {
+            const ElemType* inData = in.Data() + sample * inRows;
+            ElemType* outData = out.Data() + sample * numRows;
+
+#pragma omp parallel for
+            for (int64_t w = 0; w < (int64_t)numWindows; w++)
+            {
+                std::fill_n(m_windowBits.data() + w * W, W, 0);
+                PackSigns(inData + m_windowCol[w], &m_runs[m_windowRun[w]].dcols, m_runs[m_windowRun[w]], m_windowBits.data() + w * W);
+            }
+
+#pragma omp parallel for
+            for (int64_t row = 0; row < (int64_t)numRows; row++)
+            {
+                const size_t run = m_rowRun[row];
+                const size_t mismatches = PopCountXorMasked(m_windowBits.data() + m_rowWindow[row] * W, m_kernelBits.data() + m_rowSlice[row] * W,
+                                                            m_validBits.data() + run * W, W);
+                outData[row] = (ElemType)((int64_t)m_runs[run].numValid - 2 * (int64_t)mismatches);
+            }
+        }
+    }
+
+private:
+    struct Run
+    {
+        int skip;
+        int size;
+        std::vector<int> dcols; // offsets of the window elements relative to the base column
+        size_t numValid;
+    };
+
+    // Set bit i of 'bits' if element i of the window is positive. Elements are data[dcols[i]], or data[i] if no 'dcols'.
+    // Masked elements are packed as well; they are excluded later through the run's valid mask.
+    static void PackSigns(const ElemType* data, const std::vector<int>* dcols, const Run& run, uint64_t* bits)
+    {
+        for (int i = 0; i < run.size; i++)
+        {
+            ElemType v = dcols ? data[(*dcols)[i]] : data[i];
+            if (v > 0)
+                bits[i / 64] |= (uint64_t)1 << (i % 64);
+        }
+    }
+
+    static inline size_t PopCount64(uint64_t x)
+    {
+#ifdef _MSC_VER
+        return (size_t)__popcnt64(x);
+#else
+        return (size_t)__builtin_popcountll(x);
+#endif
+    }
+
+    // Number of positions where 'a' and 'b' differ within the mask 'm' (n words each).
+    static inline size_t PopCountXorMasked(const uint64_t* a, const uint64_t* b, const uint64_t* m, size_t n)
+    {
+        size_t count = 0;
+        size_t i = 0;
+#if defined(__AVX512VPOPCNTDQ__)
+        __m512i acc = _mm512_setzero_si512();
+        for (; i + 8 <= n; i += 8)
+        {
+            __m512i x = _mm512_xor_si512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+            x = _mm512_and_si512(x, _mm512_loadu_si512(m + i));
+            acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(x));
+        }
+        count = (size_t)_mm512_reduce_add_epi64(acc);
+#endif
+        for (; i < n; i++)
+            count += PopCount64((a[i] ^ b[i]) & m[i]);
+        return count;
+    }
+
+    size_t m_wordsPerWindow;                // words per packed window (enough for the largest run)
+    std::vector<Run> m_runs;
+    std::vector<uint64_t> m_validBits;      // [run][word]
+    std::vector<size_t> m_rowWindow;        // output cell -> input window
+    std::vector<size_t> m_rowSlice;         // output cell -> kernel slice
+    std::vector<size_t> m_rowRun;           // output cell -> run
+    std::vector<int> m_windowCol;           // input window -> base column
+    std::vector<size_t> m_windowRun;        // input window -> run
+    std::vector<int> m_sliceOffset;         // kernel slice -> offset of its first weight
+    std::vector<size_t> m_sliceRun;         // kernel slice -> run
+    std::vector<uint64_t> m_kernelBits;     // [slice][word]
+    std::vector<uint64_t> m_windowBits;     // [window][word], for the current sample
+};
+
 template <class ElemType>
 std::unique_ptr<ConvolutionEngine<ElemType>> ConvolutionEngine<ElemType>::Create(ConvolveGeometryPtr geometry, DEVICEID_TYPE deviceId,
                                                                                  ImageLayoutKind imageLayout, size_t maxTempMemSizeInSamples, PoolKind poolKind,
@@ -1178,6 +1413,17 @@ std::unique_ptr<ConvolutionEngine<ElemType>> ConvolutionEngine<ElemType>::Create
         return std::make_unique<LegacyConvolutionEngine<ElemType>>(geometry, deviceId, imageLayout, maxTempMemSizeInSamples, poolKind, poolIncludePad);
     }
 
+    // The binary engine computes a different function, so it is never picked unless requested explicitly.
+    if (isEnabled(ConvolutionEngineKind::Binary) && BinaryConvolutionEngine<ElemType>::IsSupported(deviceId, geometry))
+    {
+        if (GetMathLibTraceLevel() > 0)
+            fprintf(stderr, "%lsusing binary convolution engine for geometry: %s.\n", logPrefix.c_str(), engStr.c_str());
+
+        return std::make_unique<BinaryConvolutionEngine<ElemType>>(geometry, deviceId, imageLayout, maxTempMemSizeInSamples, poolKind, poolIncludePad);
+    }
+    if (enabledEngines == ConvolutionEngineKind::Binary)
+        RuntimeError("Binary convolution is supported only on the CPU and without groups.");
+
     // Check if we can use cuDNN engine. Do not need to validate tensors as ConvolveGeometry has already done that.
     if (isEnabled(ConvolutionEngineKind::CuDnn) &&
         CuDnnConvolutionEngineFactory<ElemType>::IsSupported(deviceId, geometry, poolKind))
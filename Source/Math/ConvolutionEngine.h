@@ -22,6 +22,7 @@ enum class ConvolutionEngineKind
     CuDnn     = 1 << 1, // cuDNN, works only for 2D/3D convos with full sharing.
     Legacy    = 1 << 2, // Legacy, for backwards compatibility. REVIEW alexeyk: implement sparse version and remove Legacy altogether.
     Gemm      = 1 << 3, // Uses convolution unrolling+GEMM technique. Works only for convos with full sharing.
+    Binary    = 1 << 4, // XNOR+popcount convolution of sign-binarized inputs and weights, CPU only. Not part of All as it computes a different function.
 
     All       = Reference | CuDnn | Legacy | Gemm
 };
@@ -1328,11 +1328,32 @@ static void CopyToVector(const Matrix<ElemType>& source, vector<ElemType>& sourc
 
 template<>
 void Matrix<int>::AssignValuesOf(const Matrix<int>&) { NOT_IMPLEMENTED; }
+// dense CPU to dense CPU (e.g. fp16 activation stashes): convert directly, without staging through vectors
+template<class ElemType, class ElemTypeOther>
+static bool TryCastAssignDenseCPU(Matrix<ElemType>& target, const Matrix<ElemTypeOther>& source)
+{
+    if (source.GetMatrixType() != MatrixType::DENSE || target.GetMatrixType() != MatrixType::DENSE ||
+        source.GetDeviceId() != CPUDEVICE || target.GetDeviceId() != CPUDEVICE)
+        return false;
+
+    target.Resize(source.GetNumRows(), source.GetNumCols());
+    const ElemTypeOther* src = source.Data();
+    ElemType* dst = target.Data();
+    const long n = (long)source.GetNumElements();
+#pragma omp parallel for
+    for (long i = 0; i < n; i++)
+        dst[i] = (ElemType)src[i];
+    return true;
+}
+template<class ElemTypeOther>
+static bool TryCastAssignDenseCPU(Matrix<int>&, const Matrix<ElemTypeOther>&) { return false; }
 template<class ElemType, class ElemTypeOther>
 static void DoCastAssignValuesOf(Matrix<ElemType>& target, const Matrix<ElemTypeOther>& source)
 {
     target; source;
-    // this is implemented in a rather tedious way:
+    if (TryCastAssignDenseCPU(target, source))
+        return;
+    // otherwise this is implemented in a rather tedious way:
     //  - copy to a CPU-side STL vector
     //  - type-cast
     //  - copy to target
@@ -1467,6 +1488,46 @@ void Matrix<ElemType>::AdjustSparseBlockColumn(const GPUSPARSE_INDEX_TYPE* cpuCo
         m_GPUSparseMatrix->AdjustCol2BlockId(cpuCol2BlockId, numBlocks, useBlockId2Col));
 }
 
+template <class ElemType>
+void Matrix<ElemType>::GetSparseBlockColumnData(std::vector<size_t>& columnIds, std::vector<ElemType>& values) const
+{
+    if (GetFormat() != matrixFormatSparseBlockCol)
+        LogicError("GetSparseBlockColumnData: Matrix is not in sparse block column format.");
+
+    DISPATCH_MATRIX_ON_FLAG(this,
+        nullptr,
+        NOT_IMPLEMENTED,
+        NOT_IMPLEMENTED,
+        m_CPUSparseMatrix->GetSBCFormat(columnIds, values),
+        {
+            CPUSparseMatrix<ElemType> cpuCopy(matrixFormatSparseBlockCol, GetNumRows(), GetNumCols(), m_GPUSparseMatrix->GetNumNZElements());
+            m_GPUSparseMatrix->CopyToCPUSparseMatrix(cpuCopy);
+            cpuCopy.GetSBCFormat(columnIds, values);
+        });
+}
+
+template <class ElemType>
+void Matrix<ElemType>::SetMatrixFromSBCFormat(const size_t* columnIds, const ElemType* values, const size_t numBlocks, const size_t numRows, const size_t numCols)
+{
+    if (GetFormat() != matrixFormatSparseBlockCol)
+        LogicError("SetMatrixFromSBCFormat: Matrix is not in sparse block column format.");
+
+    if (numBlocks == 0)
+    {
+        if (GetNumRows() != numRows || GetNumCols() != numCols)
+            LogicError("SetMatrixFromSBCFormat: Cannot resize an empty sparse block column matrix.");
+        Reset();
+        return;
+    }
+
+    DISPATCH_MATRIX_ON_FLAG(this,
+        this,
+        NOT_IMPLEMENTED,
+        NOT_IMPLEMENTED,
+        m_CPUSparseMatrix->SetMatrixFromSBCFormat(columnIds, values, numBlocks, numRows, numCols),
+        m_GPUSparseMatrix->SetMatrixFromSBCFormat(columnIds, values, numBlocks, numRows, numCols));
+}
+
 template <class ElemType>
 void Matrix<ElemType>::SetDiagonalValue(const ElemType v)
 {
@@ -1646,6 +1707,73 @@ void Matrix<ElemType>::SetUniformRandomMask(const ElemType maskRate, const ElemT
                             NOT_IMPLEMENTED);
 }
 
+template <class ElemType>
+/*static*/ size_t Matrix<ElemType>::GetBitMaskWordsPerColumn(const size_t numRows)
+{
+    return CPUMatrix<ElemType>::GetBitMaskWordsPerColumn(numRows);
+}
+
+// fills 'maskBits' (GetBitMaskWordsPerColumn(numRows) * numCols words) with a dropout mask; a set bit means the element is kept
+template <class ElemType>
+/*static*/ void Matrix<ElemType>::SetUniformRandomBitMask(uint32_t* maskBits, const size_t numRows, const size_t numCols, const double maskRate, RNGHandle& rngHandle)
+{
+    if (rngHandle.DeviceId() != CPUDEVICE)
+        NOT_IMPLEMENTED;
+
+    CPUMatrix<ElemType>::SetUniformRandomBitMask(maskBits, numRows, numCols, maskRate, rngHandle);
+}
+
+// this = beta * this + scaleValue * (a .* mask), with 'mask' as generated by SetUniformRandomBitMask()
+template <class ElemType>
+Matrix<ElemType>& Matrix<ElemType>::AssignElementProductOfBitMask(const Matrix<ElemType>& a, const uint32_t* maskBits, const ElemType scaleValue, const ElemType beta)
+{
+    if (a.IsEmpty())
+        LogicError("AssignElementProductOfBitMask: Matrix is empty.");
+
+    DecideAndMoveToRightDevice(a, *this);
+
+    DISPATCH_MATRIX_ON_FLAG(&a,
+                            this,
+                            m_CPUMatrix->AssignElementProductOfBitMask(*a.m_CPUMatrix, maskBits, scaleValue, beta),
+                            NOT_IMPLEMENTED,
+                            NOT_IMPLEMENTED,
+                            NOT_IMPLEMENTED);
+
+    return *this;
+}
+
+// sets bit i of 'maskBits' (layout as for SetUniformRandomBitMask()) iff a[i] > 0
+template <class ElemType>
+/*static*/ void Matrix<ElemType>::SetBitMaskOfPositive(uint32_t* maskBits, const Matrix<ElemType>& a)
+{
+    if (a.IsEmpty())
+        LogicError("SetBitMaskOfPositive: Matrix is empty.");
+
+    DISPATCH_MATRIX_ON_FLAG(&a,
+                            nullptr,
+                            CPUMatrix<ElemType>::SetBitMaskOfPositive(maskBits, *a.m_CPUMatrix),
+                            NOT_IMPLEMENTED,
+                            NOT_IMPLEMENTED,
+                            NOT_IMPLEMENTED);
+}
+
+// sets bit i of 'maskBits' (layout as for SetUniformRandomBitMask()) iff a[i] == b[i]
+template <class ElemType>
+/*static*/ void Matrix<ElemType>::SetBitMaskOfEqual(uint32_t* maskBits, const Matrix<ElemType>& a, const Matrix<ElemType>& b)
+{
+    if (a.IsEmpty())
+        LogicError("SetBitMaskOfEqual: Matrix is empty.");
+    if (a.GetDeviceId() != b.GetDeviceId() || a.GetMatrixType() != b.GetMatrixType())
+        InvalidArgument("SetBitMaskOfEqual: The input matrices must be of the same type and on the same device.");
+
+    DISPATCH_MATRIX_ON_FLAG(&a,
+                            nullptr,
+                            CPUMatrix<ElemType>::SetBitMaskOfEqual(maskBits, *a.m_CPUMatrix, *b.m_CPUMatrix),
+                            NOT_IMPLEMENTED,
+                            NOT_IMPLEMENTED,
+                            NOT_IMPLEMENTED);
+}
+
 // Vanilla SGD update.
 // Modifies "this" parameter matrix, on which this method is invoked.
 template <class ElemType>
@@ -3760,7 +3888,7 @@ ElemType Matrix<ElemType>::SumOfAbsElements() const
     DISPATCH_MATRIX_ON_FLAG(this, nullptr,
                             { return m_CPUMatrix->SumOfAbsElements(); },
                             { return m_GPUMatrix->SumOfAbsElements(); },
-                            { NOT_IMPLEMENTED; },
+                            { return m_CPUSparseMatrix->SumOfAbsElements(); },
                             { return m_GPUSparseMatrix->SumOfAbsElements(); });
 }
 
@@ -5027,6 +5155,106 @@ void Matrix<ElemType>::BatchNormalizationBackward(const Matrix<ElemType>& in, Ma
                             NOT_IMPLEMENTED);
 }
 
+// layer normalization over the rows of each column; the fused kernels are CPU-only for now
+template <class ElemType>
+void Matrix<ElemType>::LayerNormalizationForward(const Matrix<ElemType>& scale, const Matrix<ElemType>& bias, double epsilon,
+                                                 Matrix<ElemType>& out, Matrix<ElemType>& saveMean, Matrix<ElemType>& saveInvStdDev) const
+{
+    DecideAndMoveToRightDevice(*this, out);
+
+    DISPATCH_MATRIX_ON_FLAG(this,
+                            &out,
+                            m_CPUMatrix->LayerNormalizationForward(*(scale.m_CPUMatrix), *(bias.m_CPUMatrix), epsilon,
+                                                                   *(out.m_CPUMatrix), *(saveMean.m_CPUMatrix), *(saveInvStdDev.m_CPUMatrix)),
+                            NOT_IMPLEMENTED,
+                            NOT_IMPLEMENTED,
+                            NOT_IMPLEMENTED);
+}
+
+template <class ElemType>
+void Matrix<ElemType>::LayerNormalizationBackward(const Matrix<ElemType>& in, Matrix<ElemType>& grad, const Matrix<ElemType>& scale,
+                                                  const Matrix<ElemType>& saveMean, const Matrix<ElemType>& saveInvStdDev) const
+{
+    DecideAndMoveToRightDevice(*this, in, grad);
+
+    DISPATCH_MATRIX_ON_FLAG(this,
+                            &grad,
+                            m_CPUMatrix->LayerNormalizationBackward(*(in.m_CPUMatrix), *(grad.m_CPUMatrix), *(scale.m_CPUMatrix),
+                                                                    *(saveMean.m_CPUMatrix), *(saveInvStdDev.m_CPUMatrix)),
+                            NOT_IMPLEMENTED,
+                            NOT_IMPLEMENTED,
+                            NOT_IMPLEMENTED);
+}
+
+template <class ElemType>
+void Matrix<ElemType>::LayerNormalizationScaleGradient(const Matrix<ElemType>& in, const Matrix<ElemType>& saveMean, const Matrix<ElemType>& saveInvStdDev,
+                                                       Matrix<ElemType>& scaleGrad) const
+{
+    DecideAndMoveToRightDevice(*this, in, scaleGrad);
+
+    DISPATCH_MATRIX_ON_FLAG(this,
+                            &scaleGrad,
+                            m_CPUMatrix->LayerNormalizationScaleGradient(*(in.m_CPUMatrix), *(saveMean.m_CPUMatrix), *(saveInvStdDev.m_CPUMatrix),
+                                                                         *(scaleGrad.m_CPUMatrix)),
+                            NOT_IMPLEMENTED,
+                            NOT_IMPLEMENTED,
+                            NOT_IMPLEMENTED);
+}
+
+// scaled dot-product attention per column; see CPUMatrix::ScaledDotProductAttentionForward() for the tensor layout
+template <class ElemType>
+/*static*/ void Matrix<ElemType>::ScaledDotProductAttentionForward(const Matrix<ElemType>& query, const Matrix<ElemType>& key, const Matrix<ElemType>& value,
+                                                                Matrix<ElemType>& out, Matrix<ElemType>& logSumExp,
+                                                                size_t dimQK, size_t dimV, size_t numHeads, double scale, bool causal)
+{
+    DecideAndMoveToRightDevice(query, key, value, out);
+
+    DISPATCH_MATRIX_ON_FLAG(&query,
+                            &out,
+                            CPUMatrix<ElemType>::ScaledDotProductAttentionForward(*(query.m_CPUMatrix), *(key.m_CPUMatrix), *(value.m_CPUMatrix),
+                                                                                  *(out.m_CPUMatrix), *(logSumExp.m_CPUMatrix),
+                                                                                  dimQK, dimV, numHeads, scale, causal),
+                            NOT_IMPLEMENTED,
+                            NOT_IMPLEMENTED,
+                            NOT_IMPLEMENTED);
+}
+
+template <class ElemType>
+/*static*/ void Matrix<ElemType>::ScaledDotProductAttentionBackwardQuery(const Matrix<ElemType>& query, const Matrix<ElemType>& key, const Matrix<ElemType>& value,
+                                                                      const Matrix<ElemType>& out, const Matrix<ElemType>& outGrad, const Matrix<ElemType>& logSumExp,
+                                                                      Matrix<ElemType>& queryGrad, size_t dimQK, size_t dimV, size_t numHeads, double scale, bool causal)
+{
+    DecideAndMoveToRightDevice(query, key, value, queryGrad);
+
+    DISPATCH_MATRIX_ON_FLAG(&query,
+                            &queryGrad,
+                            CPUMatrix<ElemType>::ScaledDotProductAttentionBackwardQuery(*(query.m_CPUMatrix), *(key.m_CPUMatrix), *(value.m_CPUMatrix),
+                                                                                        *(out.m_CPUMatrix), *(outGrad.m_CPUMatrix), *(logSumExp.m_CPUMatrix),
+                                                                                        *(queryGrad.m_CPUMatrix), dimQK, dimV, numHeads, scale, causal),
+                            NOT_IMPLEMENTED,
+                            NOT_IMPLEMENTED,
+                            NOT_IMPLEMENTED);
+}
+
+template <class ElemType>
+/*static*/ void Matrix<ElemType>::ScaledDotProductAttentionBackwardKeyValue(const Matrix<ElemType>& query, const Matrix<ElemType>& key, const Matrix<ElemType>& value,
+                                                                         const Matrix<ElemType>& out, const Matrix<ElemType>& outGrad, const Matrix<ElemType>& logSumExp,
+                                                                         Matrix<ElemType>& keyGrad, Matrix<ElemType>& valueGrad,
+                                                                         size_t dimQK, size_t dimV, size_t numHeads, double scale, bool causal)
+{
+    DecideAndMoveToRightDevice(query, key, value, keyGrad);
+
+    DISPATCH_MATRIX_ON_FLAG(&query,
+                            &keyGrad,
+                            CPUMatrix<ElemType>::ScaledDotProductAttentionBackwardKeyValue(*(query.m_CPUMatrix), *(key.m_CPUMatrix), *(value.m_CPUMatrix),
+                                                                                           *(out.m_CPUMatrix), *(outGrad.m_CPUMatrix), *(logSumExp.m_CPUMatrix),
+                                                                                           *(keyGrad.m_CPUMatrix), *(valueGrad.m_CPUMatrix),
+                                                                                           dimQK, dimV, numHeads, scale, causal),
+                            NOT_IMPLEMENTED,
+                            NOT_IMPLEMENTED,
+                            NOT_IMPLEMENTED);
+}
+
 template <class ElemType>
 void Matrix<ElemType>::RNNForward(const Matrix<ElemType> &inputX, const Matrix<ElemType> &paramW, size_t xDim, size_t yDim, const vector<size_t>& numSequencesForFrame, const RnnAttributes& rnnAttributes, Matrix<ElemType>& reserve, Matrix<ElemType>& workspace)
 {
@@ -6191,7 +6419,7 @@ Matrix<ElemType>& Matrix<ElemType>::AssignSequenceError(const ElemType hsmoothin
 
 // Calculate CTC score
 // prob (input): the posterior output from the network
-// alpha, beta (output): alpha and beta for forward-backward calculation.
+// alpha, beta (output): alpha and beta for forward-backward calculation (GPU only, left untouched on the CPU).
 // phoneSeq (input): phone ID sequence for each utterance in this minibatch, each col is one utterance
 // phoneBound (input): phone boundary (frame index) of each phone for each utterance in this minibatch, each col is one utterance
 // totalScore (output): total CTC score
@@ -6212,12 +6440,15 @@ Matrix<ElemType>& Matrix<ElemType>::AssignCTCScore(const Matrix<ElemType>& prob,
     const size_t numParallelSequences, const size_t mbsize, const size_t blankTokenId, const int delayConstraint, const bool isColWise)
 {
     DecideAndMoveToRightDevice(prob, *this);
-    alpha.Resize(phoneSeq.GetNumRows(), prob.GetNumCols());
-    beta.Resize(phoneSeq.GetNumRows(), prob.GetNumCols());
+    // The CPU implementation keeps a compact lattice per utterance, only the GPU one needs the padded alpha and beta.
+    if (prob.GetDeviceId() != CPUDEVICE)
+    {
+        alpha.Resize(phoneSeq.GetNumRows(), prob.GetNumCols());
+        beta.Resize(phoneSeq.GetNumRows(), prob.GetNumCols());
+        alpha.SetValue(LZERO);
+        beta.SetValue(LZERO);
+    }
     Resize(prob.GetNumRows(), prob.GetNumCols());
-
-    alpha.SetValue(LZERO);
-    beta.SetValue(LZERO);
     SetValue(LZERO);
     SwitchToMatrixType(prob.GetMatrixType(), prob.GetFormat(), false);
 
@@ -301,6 +301,9 @@ public:
     void SetColumn(const Matrix<ElemType>& valMat, size_t colInd);
 
     void AdjustSparseBlockColumn(const GPUSPARSE_INDEX_TYPE* cpuCol2BlockId, size_t numBlocks, bool useBlockId2Col);
+    // sparse block column content as CPU-side arrays: the column index of each non-zero column and its values (numRows per column)
+    void GetSparseBlockColumnData(std::vector<size_t>& columnIds, std::vector<ElemType>& values) const;
+    void SetMatrixFromSBCFormat(const size_t* columnIds, const ElemType* values, const size_t numBlocks, const size_t numRows, const size_t numCols);
 
     void SetDiagonalValue(const ElemType v);
     void SetDiagonalValue(const Matrix<ElemType>& vector);
@@ -311,6 +314,13 @@ public:
     void SetGaussianRandomValue(const ElemType mean, const ElemType sigma, unsigned long seed = USE_TIME_BASED_SEED);
     void SetTruncatedNormalRandomValue(const ElemType mean, const ElemType sigma, unsigned long seed = USE_TIME_BASED_SEED);
     void SetUniformRandomMask(const ElemType maskRate, const ElemType scaleValue, RNGHandle& rngHandle);
+    // bit-packed dropout masks (CPU only): one bit per element, each column padded to whole 32-bit words
+    static size_t GetBitMaskWordsPerColumn(const size_t numRows);
+    static void SetUniformRandomBitMask(uint32_t* maskBits, const size_t numRows, const size_t numCols, const double maskRate, RNGHandle& rngHandle);
+    Matrix<ElemType>& AssignElementProductOfBitMask(const Matrix<ElemType>& a, const uint32_t* maskBits, const ElemType scaleValue, const ElemType beta = 0);
+    // bit masks of a condition, in the same layout (for activation compression)
+    static void SetBitMaskOfPositive(uint32_t* maskBits, const Matrix<ElemType>& a);
+    static void SetBitMaskOfEqual(uint32_t* maskBits, const Matrix<ElemType>& a, const Matrix<ElemType>& b);
     void AddGaussianRandomValue(const ElemType mean, const ElemType sigma, unsigned long seed = USE_TIME_BASED_SEED);
     Matrix<ElemType>& AssignNoiseContrastiveEstimation(const Matrix<ElemType>& a, const Matrix<ElemType>& b, const Matrix<ElemType>& c, const Matrix<ElemType>& bias, Matrix<ElemType>& tmp);
 
@@ -591,6 +601,24 @@ public:
     void BatchNormalizationBackward(const Matrix<ElemType>& in, Matrix<ElemType>& grad, const Matrix<StatType>& scale, double blendFactor, const Matrix<StatType>& saveMean, const Matrix<StatType>& saveInvStdDev,
                                     Matrix<StatType>& scaleGrad, Matrix<StatType>& biasGrad) const;
 
+    void LayerNormalizationForward(const Matrix<ElemType>& scale, const Matrix<ElemType>& bias, double epsilon,
+                                   Matrix<ElemType>& out, Matrix<ElemType>& saveMean, Matrix<ElemType>& saveInvStdDev) const;
+    void LayerNormalizationBackward(const Matrix<ElemType>& in, Matrix<ElemType>& grad, const Matrix<ElemType>& scale,
+                                    const Matrix<ElemType>& saveMean, const Matrix<ElemType>& saveInvStdDev) const;
+    void LayerNormalizationScaleGradient(const Matrix<ElemType>& in, const Matrix<ElemType>& saveMean, const Matrix<ElemType>& saveInvStdDev,
+                                         Matrix<ElemType>& scaleGrad) const;
+
+    static void ScaledDotProductAttentionForward(const Matrix<ElemType>& query, const Matrix<ElemType>& key, const Matrix<ElemType>& value,
+                                                 Matrix<ElemType>& out, Matrix<ElemType>& logSumExp,
+                                                 size_t dimQK, size_t dimV, size_t numHeads, double scale, bool causal);
+    static void ScaledDotProductAttentionBackwardQuery(const Matrix<ElemType>& query, const Matrix<ElemType>& key, const Matrix<ElemType>& value,
+                                                       const Matrix<ElemType>& out, const Matrix<ElemType>& outGrad, const Matrix<ElemType>& logSumExp,
+                                                       Matrix<ElemType>& queryGrad, size_t dimQK, size_t dimV, size_t numHeads, double scale, bool causal);
+    static void ScaledDotProductAttentionBackwardKeyValue(const Matrix<ElemType>& query, const Matrix<ElemType>& key, const Matrix<ElemType>& value,
+                                                          const Matrix<ElemType>& out, const Matrix<ElemType>& outGrad, const Matrix<ElemType>& logSumExp,
+                                                          Matrix<ElemType>& keyGrad, Matrix<ElemType>& valueGrad,
+                                                          size_t dimQK, size_t dimV, size_t numHeads, double scale, bool causal);
+
     void RNNForward(const Matrix<ElemType>& inputX, const Matrix<ElemType>& paramW, size_t xDim, size_t yDim, const vector<size_t>& numSequencesForFrame, const struct RnnAttributes& rnnAttributes, Matrix<ElemType>& reserve, Matrix<ElemType>& workspace);
     void RNNBackwardData(const Matrix<ElemType>& outputDY, const Matrix<ElemType>& paramW, Matrix<ElemType>& outputDX, const struct RnnAttributes& rnnAttributes, Matrix<ElemType>& reserve, Matrix<ElemType>& workspace);
     void RNNBackwardWeights(const Matrix<ElemType>& inputX, const Matrix<ElemType>& outputY, Matrix<ElemType>& dw, const struct RnnAttributes& rnnAttributes, Matrix<ElemType>& reserve, Matrix<ElemType>& workspace);
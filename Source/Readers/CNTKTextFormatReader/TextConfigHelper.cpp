@@ -128,6 +128,7 @@ TextConfigHelper::TextConfigHelper(const ConfigParameters& config)
     m_keepDataInMemory = config(L"keepDataInMemory", false);
     m_frameMode = config(L"frameMode", false);
     m_cacheIndex = config(L"cacheIndex", false);
+    m_indexCacheStartTimeout = config(L"indexCacheStartTimeout", g_indexCacheStartTimeoutSeconds);
 
     m_randomizationWindow = GetRandomizationWindowFromConfig(config);
     m_sampleBasedRandomizationWindow = config(L"sampleBasedRandomizationWindow", false);
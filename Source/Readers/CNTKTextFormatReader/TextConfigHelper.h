@@ -33,6 +33,8 @@ public:
 
     bool ShouldCacheIndex() const { return m_cacheIndex; }
 
+    size_t GetIndexCacheStartTimeout() const { return m_indexCacheStartTimeout; }
+
     unsigned int GetMaxAllowedErrors() const { return m_maxErrors; }
 
     unsigned int GetTraceLevel() const { return m_traceLevel; }
@@ -63,6 +65,7 @@ private:
     bool m_frameMode; // if true, the maximum expected sequence length in the dataset is one sample.
     bool m_cacheIndex; // When true, the index will be loaded from a cache file it if exists.
                        // If cache does not exist, the index, once created, will be written out to a file.
+    size_t m_indexCacheStartTimeout; // seconds the other nodes wait for the main node to start writing the index cache
 };
 
 }
@@ -9,6 +9,7 @@
 #include <cfloat>
 #include "BufferedFileReader.h"
 #include "IndexBuilder.h"
+#include "ReaderConstants.h"
 #include "TextParser.h"
 #include "TextReaderConstants.h"
 #include "File.h"
@@ -71,6 +72,7 @@ TextParser(corpus, helper.GetFilePath(), helper.GetStreams(), primary)
     SetSkipSequenceIds(helper.ShouldSkipSequenceIds());
 
     SetCacheIndex(helper.ShouldCacheIndex());
+    SetIndexCacheStartTimeout(helper.GetIndexCacheStartTimeout());
 
     Initialize();
 }
@@ -93,7 +95,8 @@ TextParser<ElemType>::TextParser(CorpusDescriptorPtr corpus, const std::wstring&
     m_numRetries(5),
     m_corpus(corpus),
     m_useMaximumAsSequenceLength(true),
-    m_cacheIndex(false)
+    m_cacheIndex(false),
+    m_indexCacheStartTimeout(g_indexCacheStartTimeoutSeconds)
 {
     assert(streams.size() > 0);
 
@@ -187,7 +190,8 @@ void TextParser<ElemType>::Initialize()
             .SetCorpus(m_corpus)
             .SetPrimary(m_primary)
             .SetChunkSize(m_chunkSizeBytes)
-            .SetCachingEnabled(m_cacheIndex);
+            .SetCachingEnabled(m_cacheIndex)
+            .SetIndexCacheStartTimeout(std::chrono::seconds(m_indexCacheStartTimeout));
 
         if (!m_useMaximumAsSequenceLength)
         {
@@ -1232,6 +1236,12 @@ void TextParser<ElemType>::SetCacheIndex(bool value)
     m_cacheIndex = value;
 }
 
+template <class ElemType>
+void TextParser<ElemType>::SetIndexCacheStartTimeout(size_t seconds)
+{
+    m_indexCacheStartTimeout = seconds;
+}
+
 template<class ElemType>
 inline bool TextParser<ElemType>::CanRead()
 {
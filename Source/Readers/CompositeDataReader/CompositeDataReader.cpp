@@ -125,10 +125,14 @@ CompositeDataReader::CompositeDataReader(const ConfigParameters& config) :
         if (randomize)
         {
             bool sampleBasedRandomizationWindow = config(L"sampleBasedRandomizationWindow", false);
+
+            // Number of chunks loaded on separate threads ahead of the prefetch position.
+            // Only safe for deserializers that support concurrent chunk loading, hence off by default.
+            size_t chunksToLoadAhead = config(L"chunksToLoadAhead", 0);
             m_sequenceEnumerator = std::make_shared<LTTumblingWindowRandomizer>(deserializer,
                 sampleBasedRandomizationWindow, config(L"randomizationWindow", requestDataSize),
                 GetRandomSeed(config),
-                multiThreadedDeserialization, maxErrors);
+                multiThreadedDeserialization, maxErrors, chunksToLoadAhead);
         }
         else
             m_sequenceEnumerator = std::make_shared<LTNoRandomizer>(deserializer, multiThreadedDeserialization, maxErrors);
@@ -7,6 +7,7 @@
 #include "ConfigHelper.h"
 #include "DataReader.h"
 #include "StringUtil.h"
+#include "ReaderConstants.h"
 #include <boost/algorithm/string.hpp>
 
 namespace CNTK {
@@ -441,4 +442,9 @@ bool ConfigHelper::GetCacheIndex() const
     return m_config(L"cacheIndex", false);
 }
 
+size_t ConfigHelper::GetIndexCacheStartTimeout() const
+{
+    return m_config(L"indexCacheStartTimeout", g_indexCacheStartTimeoutSeconds);
+}
+
 }
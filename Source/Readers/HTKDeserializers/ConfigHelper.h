@@ -76,6 +76,9 @@ public:
     // Gets "cacheIndex" config flag.
     bool GetCacheIndex() const;
 
+    // Gets "indexCacheStartTimeout" config value, in seconds.
+    size_t GetIndexCacheStartTimeout() const;
+
     // Gets number of utterances per minibatch for epochs as an array.
     Microsoft::MSR::CNTK::intargvector GetNumberOfUtterancesPerMinibatchForAllEppochs();
 
@@ -130,7 +130,8 @@ LatticeDeserializer::LatticeDeserializer(
     bool primary)
     : DataDeserializerBase(primary),
       m_verbosity(0),
-      m_corpus(corpus)
+      m_corpus(corpus),
+      m_indexCacheStartTimeout(g_indexCacheStartTimeoutSeconds)
 {
     if (primary)
         LogicError("Lattice deserializer does not support primary mode, it cannot control chunking. "
@@ -157,7 +158,9 @@ size_t LatticeDeserializer::RecordChunk(const string& latticePath, const vector<
     attempt(5, [this, latticePathW, tocLines, enableCaching, corpus, lastChunkInTOC]()
     {
         LatticeIndexBuilder builder(FileWrapper(latticePathW, L"rbS"), tocLines, corpus, lastChunkInTOC);
-        builder.SetChunkSize(m_chunkSizeBytes).SetCachingEnabled(enableCaching);
+        builder.SetChunkSize(m_chunkSizeBytes)
+            .SetCachingEnabled(enableCaching)
+            .SetIndexCacheStartTimeout(chrono::seconds(m_indexCacheStartTimeout));
         m_indices.emplace_back(builder.Build());
     });
 
@@ -202,6 +205,7 @@ void LatticeDeserializer::InitializeChunkInfos(CorpusDescriptorPtr corpus, Confi
         RuntimeError("Failed to open input file: '%s'", latticeIndexPath.c_str());
 
     bool enableCaching = corpus->IsHashingEnabled() && config.GetCacheIndex();
+    m_indexCacheStartTimeout = config.GetIndexCacheStartTimeout();
     size_t totalNumSequences = 0;
     vector<string> tocLines;
     string tocPath;
@@ -56,6 +56,7 @@ private:
     std::vector<const ChunkDescriptor*> m_chunks;
     std::map<const ChunkDescriptor*, size_t> m_chunkToFileIndex;
     size_t m_chunkSizeBytes;
+    size_t m_indexCacheStartTimeout; // in seconds
     std::vector<std::shared_ptr<Index>> m_indices;
     std::vector<std::wstring> m_latticeFiles;
 };
@@ -27,19 +27,18 @@ public:
     BinarySequenceChunk(const MLFBinaryDeserializer& parent, const ChunkDescriptor& descriptor, const wstring& fileName, StateTablePtr states)
         : ChunkBase::ChunkBase(parent, descriptor, fileName, states)
     {
-        this->m_sequences.resize(m_descriptor.Sequences().size());
+        vector<vector<MLFFrameRange>> utterances(m_descriptor.Sequences().size());
 
 #pragma omp parallel for schedule(dynamic)
         for (int i = 0; i < descriptor.Sequences().size(); ++i)
-            CacheSequence(descriptor.Sequences()[i], i);
+            CacheSequence(descriptor.Sequences()[i], utterances[i]);
 
         CleanBuffer();
+        m_ranges.Store(utterances);
     }
 
-    void CacheSequence(const SequenceDescriptor& sequence, size_t index)
+    void CacheSequence(const SequenceDescriptor& sequence, vector<MLFFrameRange>& utterance)
     {
-        vector<MLFFrameRange> utterance;
-
         auto start = this->m_buffer.data() + sequence.OffsetInChunk();
 
         ushort stateCount = *(ushort*)start;
@@ -58,15 +57,13 @@ public:
             utterance[i].Save(firstFrame, frameCount, stateLabel);
             firstFrame += stateCount;
         }
-
-        this->m_sequences[index] = move(utterance);
     }
 };
 
 class MLFBinaryDeserializer::BinaryFrameChunk : public MLFDeserializer::ChunkBase
 {
-    // Actual values of frames.
-    vector<ClassIdType> m_classIds;
+    // Actual values of frames, run-length encoded.
+    MLFFrameRuns m_classIds;
 
     //For each sequence this vector contains the sequence offset in samples from the beginning of the chunk.
     std::vector<uint32_t> m_sequenceOffsetInChunkInSamples;
@@ -82,8 +79,6 @@ public:
         if (numSamples != m_descriptor.NumberOfSamples())
             RuntimeError("Exceeded maximum number of samples in a chunk");
 
-        // Preallocate a big array for filling in class ids for the whole chunk.
-        m_classIds.resize(numSamples);
         m_sequenceOffsetInChunkInSamples.resize(m_descriptor.NumberOfSequences());
 
         uint32_t offset = 0;
@@ -97,11 +92,19 @@ public:
             RuntimeError("Unexpected number of samples in a FrameChunk.");
 
         // Parse the data on different threads to avoid locking during GetSequence calls.
+        vector<vector<MLFFrameRange>> utterances(m_descriptor.NumberOfSequences());
 #pragma omp parallel for schedule(dynamic)
         for (auto i = 0; i < m_descriptor.NumberOfSequences(); ++i)
-            CacheSequence(descriptor[i], i);
+            CacheSequence(descriptor[i], utterances[i]);
 
         CleanBuffer();
+
+        for (auto i = 0; i < m_descriptor.NumberOfSequences(); ++i)
+        {
+            m_classIds.AppendUtterance(utterances[i], m_sequenceOffsetInChunkInSamples[i], descriptor[i].m_numberOfSamples, m_deserializer.m_dimension);
+            vector<MLFFrameRange>().swap(utterances[i]);
+        }
+        m_classIds.ShrinkToFit();
     }
 
     // Get utterance by the absolute frame index in chunk.
@@ -132,11 +135,9 @@ public:
         result.push_back(m_deserializer.m_categories[label]);
     }
 
-    // Parses and caches sequence in the buffer for GetSequence fast retrieval.
-    void CacheSequence(const SequenceDescriptor& sequence, size_t index)
+    // Parses the sequence, its ranges are later appended to the runs of the chunk for GetSequence fast retrieval.
+    void CacheSequence(const SequenceDescriptor& sequence, vector<MLFFrameRange>& utterance)
     {
-        vector<MLFFrameRange> utterance;
-
         auto start = this->m_buffer.data() + sequence.OffsetInChunk();
 
         ushort stateCount = *(ushort*)start;
@@ -155,19 +156,6 @@ public:
             utterance[i].Save(firstFrame, frameCount, stateLabel);
             firstFrame += stateCount;
         }
-
-        auto startRange = m_classIds.begin() + m_sequenceOffsetInChunkInSamples[index];
-        for (size_t i = 0; i < utterance.size(); ++i)
-        {
-            const auto& range = utterance[i];
-            if (range.ClassId() >= m_deserializer.m_dimension)
-                // TODO: Possibly set m_valid to false, but currently preserving the old behavior.
-                RuntimeError("Class id '%ud' exceeds the model output dimension '%d'.", range.ClassId(), (int)m_deserializer.m_dimension);
-
-            fill(startRange, startRange + range.NumFrames(), range.ClassId());
-            startRange += range.NumFrames();
-        }
-
     }
 };
 
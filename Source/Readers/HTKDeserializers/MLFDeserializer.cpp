@@ -98,19 +98,20 @@ void MLFDeserializer::InitializeChunkInfos(CorpusDescriptorPtr corpus, const Con
     size_t totalNumSequences = 0;
     size_t totalNumFrames = 0;
     bool enableCaching = corpus->IsHashingEnabled() && config.GetCacheIndex();
+    auto startTimeout = chrono::seconds(config.GetIndexCacheStartTimeout());
     for (const auto& path : mlfPaths)
     {
-        attempt(5, [this, path, enableCaching, corpus, stateListPath]() {
+        attempt(5, [this, path, enableCaching, startTimeout, corpus, stateListPath]() {
             if (m_textReader)
             {
                 MLFIndexBuilder builder(FileWrapper(path, L"rbS"), corpus);
-                builder.SetChunkSize(m_chunkSizeBytes).SetCachingEnabled(enableCaching);
+                builder.SetChunkSize(m_chunkSizeBytes).SetCachingEnabled(enableCaching).SetIndexCacheStartTimeout(startTimeout);
                 m_indices.emplace_back(builder.Build());
             }
             else
             {
                 MLFBinaryIndexBuilder builder(FileWrapper(path, L"rbS"), corpus);
-                builder.SetChunkSize(m_chunkSizeBytes).SetCachingEnabled(enableCaching);
+                builder.SetChunkSize(m_chunkSizeBytes).SetCachingEnabled(enableCaching).SetIndexCacheStartTimeout(startTimeout);
                 m_indices.emplace_back(builder.Build());
             }
         });
@@ -65,6 +65,107 @@ struct MLFSequenceData : SparseSequenceData
     }
 };
 
+// Run-length encoded class ids of all frames in a chunk, used in frame mode.
+// Labels are long runs of the same class, so only the first frame and the class id of each run are stored.
+class MLFFrameRuns
+{
+    std::vector<uint32_t> m_firstFrames; // [run] first frame of the run in the chunk
+    std::vector<ClassIdType> m_classIds; // [run] class id of all frames of the run
+
+public:
+    // Appends the ranges of an utterance that starts at the given frame of the chunk.
+    void AppendUtterance(const std::vector<MLFFrameRange>& utterance, uint32_t firstFrame, uint32_t numFrames, size_t dimension)
+    {
+        uint32_t frame = firstFrame;
+        for (const auto& range : utterance)
+        {
+            if (range.ClassId() >= dimension)
+                // TODO: Possibly set m_valid to false, but currently preserving the old behavior.
+                RuntimeError("Class id '%ud' exceeds the model output dimension '%d'.", range.ClassId(), (int) dimension);
+
+            Append(frame, range.ClassId());
+            frame += range.NumFrames();
+        }
+
+        // Frames not covered by the ranges get class 0.
+        if (frame < firstFrame + numFrames)
+            Append(frame, 0);
+    }
+
+    // Gets the class id of a frame by its index in the chunk.
+    ClassIdType operator[](size_t frameIndex) const
+    {
+        auto run = upper_bound(m_firstFrames.begin(), m_firstFrames.end(), frameIndex,
+            [](size_t fi, uint32_t first) { return fi < first; });
+        if (run == m_firstFrames.begin())
+            return 0;
+        return m_classIds[run - 1 - m_firstFrames.begin()];
+    }
+
+    void ShrinkToFit()
+    {
+        m_firstFrames.shrink_to_fit();
+        m_classIds.shrink_to_fit();
+    }
+
+private:
+    void Append(uint32_t frame, ClassIdType classId)
+    {
+        if (!m_classIds.empty() && m_firstFrames.back() == frame) // previous run is empty
+            m_classIds.back() = classId;
+        else if (m_classIds.empty() || m_classIds.back() != classId)
+        {
+            m_firstFrames.push_back(frame);
+            m_classIds.push_back(classId);
+        }
+    }
+};
+
+// Frame ranges of all utterances in a chunk, used in sequence mode.
+// The ranges are stored back to back in a single buffer, with the index of the first range of each utterance.
+class MLFUtteranceRanges
+{
+    std::vector<MLFFrameRange> m_ranges; // sequential frame ranges of all utterances
+    std::vector<size_t> m_offsets;       // [utterance] index of the first range of the utterance in m_ranges, plus the end
+
+public:
+    // Moves the parsed utterances into the flat range buffer.
+    void Store(std::vector<std::vector<MLFFrameRange>>& utterances)
+    {
+        size_t numRanges = 0;
+        for (const auto& utterance : utterances)
+            numRanges += utterance.size();
+
+        m_ranges.reserve(numRanges);
+        m_offsets.reserve(utterances.size() + 1);
+        for (auto& utterance : utterances)
+        {
+            m_offsets.push_back(m_ranges.size());
+            m_ranges.insert(m_ranges.end(), utterance.begin(), utterance.end());
+            std::vector<MLFFrameRange>().swap(utterance);
+        }
+        m_offsets.push_back(m_ranges.size());
+    }
+
+    const MLFFrameRange* Begin(size_t utterance) const { return m_ranges.data() + m_offsets[utterance]; }
+    const MLFFrameRange* End(size_t utterance) const { return m_ranges.data() + m_offsets[utterance + 1]; }
+
+    // Fills the class ids of the frames of an utterance, frame by frame.
+    void ExpandClassIds(size_t utterance, IndexType* classIds, size_t dimension) const
+    {
+        for (const auto* range = Begin(utterance); range != End(utterance); ++range)
+        {
+            if (range->ClassId() >= dimension)
+                // TODO: Possibly set m_valid to false, but currently preserving the old behavior.
+                RuntimeError("Class id '%ud' exceeds the model output dimension '%d'.", range->ClassId(), (int) dimension);
+
+            // Filling all range of frames with the corresponding class id.
+            std::fill(classIds, classIds + range->NumFrames(), static_cast<IndexType>(range->ClassId()));
+            classIds += range->NumFrames();
+        }
+    }
+};
+
 // Class represents an MLF deserializer.
 // Provides a set of chunks/sequences to the upper layers.
 class MLFDeserializer : public DataDeserializerBase, boost::noncopyable
@@ -105,7 +206,7 @@ public:
     class ChunkBase : public Chunk
     {
     public:
-        vector<vector<MLFFrameRange>> m_sequences; // Each sequence is a vector of sequential frame ranges.
+        MLFUtteranceRanges m_ranges; // Sequential frame ranges of all sequences.
 
         ChunkBase(const MLFDeserializer& deserializer, const ChunkDescriptor& descriptor, const wstring& fileName, const StateTablePtr& states)
             : m_parser(states),
@@ -165,29 +266,20 @@ public:
                 return;
             }
 
-            const auto& utterance = m_sequences[sequenceIndex];
+            const auto* utteranceBegin = m_ranges.Begin(sequenceIndex);
+            const auto* utteranceEnd = m_ranges.End(sequenceIndex);
             const auto& sequence = m_descriptor.Sequences()[sequenceIndex];
 
             // Packing labels for the utterance into sparse sequence.
-            vector<size_t> sequencePhoneBoundaries(m_deserializer.m_withPhoneBoundaries ? utterance.size() : 0);
+            vector<size_t> sequencePhoneBoundaries(m_deserializer.m_withPhoneBoundaries ? utteranceEnd - utteranceBegin : 0);
             if (m_deserializer.m_withPhoneBoundaries)
             {
-                for (size_t i = 0; i < utterance.size(); ++i)
-                    sequencePhoneBoundaries[i] = utterance[i].FirstFrame();
+                for (size_t i = 0; i < sequencePhoneBoundaries.size(); ++i)
+                    sequencePhoneBoundaries[i] = utteranceBegin[i].FirstFrame();
             }
 
             auto s = make_shared<MLFSequenceData<ElementType>>(sequence.m_numberOfSamples, sequencePhoneBoundaries, m_deserializer.m_streams.front().m_sampleLayout);
-            auto* startRange = s->m_indices;
-            for (const auto& range : utterance)
-            {
-                if (range.ClassId() >= m_deserializer.m_dimension)
-                    // TODO: Possibly set m_valid to false, but currently preserving the old behavior.
-                    RuntimeError("Class id '%ud' exceeds the model output dimension '%d'.", range.ClassId(), (int) m_deserializer.m_dimension);
-
-                // Filling all range of frames with the corresponding class id.
-                fill(startRange, startRange + range.NumFrames(), static_cast<IndexType>(range.ClassId()));
-                startRange += range.NumFrames();
-            }
+            m_ranges.ExpandClassIds(sequenceIndex, s->m_indices, m_deserializer.m_dimension);
 
             result.push_back(s);
         }
@@ -207,31 +299,29 @@ public:
         SequenceChunk(const MLFDeserializer& parent, const ChunkDescriptor& descriptor, const wstring& fileName, StateTablePtr states)
             : ChunkBase(parent, descriptor, fileName, states)
         {
-            this->m_sequences.resize(m_descriptor.Sequences().size());
+            vector<vector<MLFFrameRange>> utterances(m_descriptor.Sequences().size());
 
 #pragma omp parallel for schedule(dynamic)
             for (int i = 0; i < descriptor.Sequences().size(); ++i)
-                CacheSequence(descriptor.Sequences()[i], i);
+                CacheSequence(descriptor.Sequences()[i], i, utterances[i]);
 
             CleanBuffer();
+            m_ranges.Store(utterances);
         }
 
-        void CacheSequence(const SequenceDescriptor& sequence, size_t index)
+        void CacheSequence(const SequenceDescriptor& sequence, size_t index, vector<MLFFrameRange>& utterance)
         {
             auto start = m_buffer.data() + sequence.OffsetInChunk();
             auto end = start + sequence.SizeInBytes();
 
-            vector<MLFFrameRange> utterance;
             auto absoluteOffset = m_descriptor.StartOffset() + sequence.OffsetInChunk();
             bool parsed = m_parser.Parse(boost::make_iterator_range(start, end), utterance, absoluteOffset);
             if (!parsed) // cannot parse
             {
                 fprintf(stderr, "WARNING: Cannot parse the utterance '%s'\n", KeyOf(sequence).c_str());
                 m_valid[index] = false;
-                return;
+                utterance.clear();
             }
-
-            m_sequences[index] = move(utterance);
         }
     };
 
@@ -241,8 +331,8 @@ public:
     // sequence caching, so that GetSequence only works with read only data structures.
     class FrameChunk : public ChunkBase
     {
-        // Actual values of frames.
-        vector<ClassIdType> m_classIds;
+        // Actual values of frames, run-length encoded.
+        MLFFrameRuns m_classIds;
 
         //For each sequence this vector contains the sequence offset in samples from the beginning of the chunk.
         std::vector<uint32_t> m_sequenceOffsetInChunkInSamples;
@@ -258,8 +348,6 @@ public:
             if (numSamples != m_descriptor.NumberOfSamples())
                 RuntimeError("Exceeded maximum number of samples in a chunk");
 
-            // Preallocate a big array for filling in class ids for the whole chunk.
-            m_classIds.resize(numSamples);
             m_sequenceOffsetInChunkInSamples.resize(m_descriptor.NumberOfSequences());
 
             uint32_t offset = 0;
@@ -272,12 +360,23 @@ public:
             if (numSamples != offset)
                 RuntimeError("Unexpected number of samples in a FrameChunk.");
 
-                // Parse the data on different threads to avoid locking during GetSequence calls.
+            // Parse the data on different threads to avoid locking during GetSequence calls.
+            vector<vector<MLFFrameRange>> utterances(m_descriptor.NumberOfSequences());
 #pragma omp parallel for schedule(dynamic)
             for (auto i = 0; i < m_descriptor.NumberOfSequences(); ++i)
-                CacheSequence(descriptor[i], i);
+                CacheSequence(descriptor[i], i, utterances[i]);
 
             CleanBuffer();
+
+            // Utterances that could not be parsed get no runs, so their frames read as the class of the preceding run
+            // rather than class 0. GetSequence never reads them, it returns an invalid sequence instead.
+            for (auto i = 0; i < m_descriptor.NumberOfSequences(); ++i)
+            {
+                if (m_valid[i])
+                    m_classIds.AppendUtterance(utterances[i], m_sequenceOffsetInChunkInSamples[i], descriptor[i].m_numberOfSamples, m_deserializer.m_dimension);
+                vector<MLFFrameRange>().swap(utterances[i]);
+            }
+            m_classIds.ShrinkToFit();
         }
 
         // Get utterance by the absolute frame index in chunk.
@@ -308,32 +407,18 @@ public:
             result.push_back(m_deserializer.m_categories[label]);
         }
 
-        // Parses and caches sequence in the buffer for GetSequence fast retrieval.
-        void CacheSequence(const SequenceDescriptor& sequence, size_t index)
+        // Parses the sequence, its ranges are later appended to the runs of the chunk for GetSequence fast retrieval.
+        void CacheSequence(const SequenceDescriptor& sequence, size_t index, vector<MLFFrameRange>& utterance)
         {
             auto start = m_buffer.data() + sequence.OffsetInChunk();
             auto end = start + sequence.SizeInBytes();
 
-            vector<MLFFrameRange> utterance;
             auto absoluteOffset = m_descriptor.StartOffset() + sequence.OffsetInChunk();
             bool parsed = m_parser.Parse(boost::make_iterator_range(start, end), utterance, absoluteOffset);
             if (!parsed)
             {
                 m_valid[index] = false;
                 fprintf(stderr, "WARNING: Cannot parse the utterance %s\n", KeyOf(sequence).c_str());
-                return;
-            }
-
-            auto startRange = m_classIds.begin() + m_sequenceOffsetInChunkInSamples[index];
-            for (size_t i = 0; i < utterance.size(); ++i)
-            {
-                const auto& range = utterance[i];
-                if (range.ClassId() >= m_deserializer.m_dimension)
-                    // TODO: Possibly set m_valid to false, but currently preserving the old behavior.
-                    RuntimeError("Class id '%ud' exceeds the model output dimension '%d'.", range.ClassId(), (int) m_deserializer.m_dimension);
-
-                fill(startRange, startRange + range.NumFrames(), range.ClassId());
-                startRange += range.NumFrames();
             }
         }
     };
@@ -12,6 +12,7 @@
 #include "ReaderUtil.h"
 #include "Index.h"
 #include "IndexBuilder.h"
+#include "ReaderConstants.h"
 
 namespace CNTK {
     using namespace Microsoft::MSR::CNTK;
@@ -147,8 +148,9 @@ namespace CNTK {
         m_fileName.assign(mapFile.begin(), mapFile.end());
 
         bool cacheIndex = config(L"cacheIndex", false);
+        auto startTimeout = std::chrono::seconds(config(L"indexCacheStartTimeout", g_indexCacheStartTimeoutSeconds));
 
-        attempt(5, [this, cacheIndex, corpus]()
+        attempt(5, [this, cacheIndex, startTimeout, corpus]()
         {
             if (!m_dataFile || ferror(m_dataFile.get()) != 0)
                 m_dataFile.reset(fopenOrDie(m_fileName, L"rbS"), [](FILE* f) { if (f) fclose(f); });
@@ -158,6 +160,7 @@ namespace CNTK {
                 .SetPrimary(m_primary)
                 .SetCorpus(corpus)
                 .SetCachingEnabled(cacheIndex)
+                .SetIndexCacheStartTimeout(startTimeout)
                 .Build();
         });
     }
@@ -7,15 +7,18 @@
 #define _CRT_SECURE_NO_WARNINGS
 #include <inttypes.h>
 #include <future>
+#include <thread>
 #include "IndexBuilder.h"
 #include "ReaderConstants.h"
 #include "FileWrapper.h"
 #include "EnvironmentUtil.h"
 #include <sstream>
+#include <chrono>
 
 namespace CNTK {
 
 using namespace std;
+using Microsoft::MSR::CNTK::EnvironmentUtil;
 
 IndexBuilder::IndexBuilder(const FileWrapper& input)
     : m_input(input),
@@ -23,9 +26,20 @@ IndexBuilder::IndexBuilder(const FileWrapper& input)
     m_isCacheEnabled(false),
     m_chunkSize(g_32MB),
     m_bufferSize(g_2MB),
-    m_primary(true)
+    m_primary(true),
+    m_nodeRank(EnvironmentUtil::GetLocalMPINodeRank()),
+    m_numberOfNodes(EnvironmentUtil::GetTotalNumberOfMPINodes()),
+    m_indexCacheStartTimeout(chrono::seconds(g_indexCacheStartTimeoutSeconds))
 {}
 
+// In a distributed run with caching enabled, only the main node builds the index of a file and writes
+// it to the cache. Before indexing, it creates the temporary cache file as a marker; if it cannot, it
+// builds the index without sharing or caching it. Other nodes wait for the cache to show up, instead of reading the
+// whole file again. If the marker does not show up within m_indexCacheStartTimeout (the "indexCacheStartTimeout"
+// reader option), or the cache is not finished within s_indexCacheBuildTimeout, the other nodes
+// fall back to building the index themselves.
+static const chrono::hours s_indexCacheBuildTimeout(4);
+
 shared_ptr<Index> IndexBuilder::Build()
 {
     if (m_isCacheEnabled) 
@@ -44,31 +58,84 @@ shared_ptr<Index> IndexBuilder::Build()
             }
         }
     }
-    
+
+    // For now, we do not cache index if input contains non-numeric sequence ids 
+    // and the corpus does not use a (deterministic and stateless) hashing procedure
+    // to transform sequence ids into numeric keys.
+    bool isCacheable = !m_corpus || m_corpus->IsNumericSequenceKeys() || m_corpus->IsHashingEnabled();
+
+    bool isIndexShared = m_isCacheEnabled && isCacheable && m_numberOfNodes > 1;
+    bool isMainNode = m_nodeRank == 0;
+    if (isIndexShared && !isMainNode)
+    {
+        auto index = WaitForIndexCache(GetCacheFilename());
+        if (index != nullptr)
+        {
+            if (!m_primary)
+                index->MapSequenceKeyToLocation();
+            return index;
+        }
+
+        fprintf(stderr, "WARNING: The index cache of '%ls' was not written by the main node in time, building the index locally.\n",
+            m_input.Filename().c_str());
+        isIndexShared = false;
+    }
+    else if (isIndexShared)
+    {
+        // Let the other nodes know that the cache is being built.
+        auto cacheFilename = GetCacheFilename();
+        _wunlink(cacheFilename.c_str());
+        FileWrapper marker(cacheFilename + L".tmp", L"wb");
+        if (!marker.IsOpen())
+        {
+            fprintf(stderr, "WARNING: Cannot create the index cache of '%ls', the index is not shared with the other nodes.\n",
+                m_input.Filename().c_str());
+            isIndexShared = false;
+            isCacheable = false; // the cache cannot be written either
+        }
+    }
+
     auto index = make_shared<Index>(m_chunkSize);
     
     Populate(index);
 
-    if (!m_corpus || m_corpus->IsNumericSequenceKeys() || m_corpus->IsHashingEnabled())
-    {
-        // For now, we do not cache index if input contains non-numeric sequence ids 
-        // and the corpus does not use a (deterministic and stateless) hashing procedure
-        // to transform sequence ids into numeric keys.
+    if (isIndexShared)
+        WriteIndexCache(GetCacheFilename(), index);
+    else if (isCacheable)
         WriteIndexCacheAsync(index);
-    }
 
     if (!m_primary)
         index->MapSequenceKeyToLocation();
     return index;
 }
 
+shared_ptr<Index> IndexBuilder::WaitForIndexCache(const wstring& cacheFilename)
+{
+    auto temp = cacheFilename + L".tmp";
+    auto start = chrono::steady_clock::now();
+    for (;;)
+    {
+        if (msra::files::fuptodate(cacheFilename, m_input.Filename(), true))
+        {
+            auto index = TryLoadFromCache(cacheFilename, m_chunkSize);
+            if (index != nullptr)
+                return index;
+        }
+
+        auto waited = chrono::steady_clock::now() - start;
+        if (waited > s_indexCacheBuildTimeout || (waited > m_indexCacheStartTimeout && !fexists(temp)))
+            return nullptr;
+
+        Sleep(1000);
+    }
+}
 
 void IndexBuilder::WriteIndexCacheAsync(shared_ptr<Index>& index) 
 {
     if (!m_isCacheEnabled)
         return;
 
-    if (Microsoft::MSR::CNTK::EnvironmentUtil::GetLocalMPINodeRank() != 0)
+    if (m_nodeRank != 0)
         return; // only the main node should write the cache file.
     
     auto cacheFilename = GetCacheFilename();
@@ -77,48 +144,60 @@ void IndexBuilder::WriteIndexCacheAsync(shared_ptr<Index>& index)
     // async destructor.
     thread([cacheFilename, index]()
     {
-        // At this point, it's safe to assume that the previous cache is stale,
-        // remove the cache file if it exists (return value is ignored).
-        _wunlink(cacheFilename.c_str());
+        WriteIndexCache(cacheFilename, index);
+    }).detach();
+}
 
-        bool isCacheEnabled = true;
-        auto temp = cacheFilename + L".tmp";
-        {
-            FileWrapper cache(temp, L"wb");
-            isCacheEnabled = cache.IsOpen();
+/*static*/ bool IndexBuilder::WriteIndexCache(const wstring& cacheFilename, const shared_ptr<Index>& index)
+{
+    // At this point, it's safe to assume that the previous cache is stale,
+    // remove the cache file if it exists (return value is ignored).
+    _wunlink(cacheFilename.c_str());
+
+    bool isCacheEnabled = true;
+    auto temp = cacheFilename + L".tmp";
+    {
+        FileWrapper cache(temp, L"wb");
+        isCacheEnabled = cache.IsOpen();
 
-            Prefix prefix(s_magic, s_version, index->NumberOfSequences(), uint64_t(sizeof(Prefix)));
+        Prefix prefix(s_magic, s_version, index->NumberOfSequences(), uint64_t(sizeof(Prefix)));
 
-            isCacheEnabled = isCacheEnabled && cache.TryWrite(prefix);
+        isCacheEnabled = isCacheEnabled && cache.TryWrite(prefix);
 
-            IndexedSequence cachedSequence;
-            for (auto& chunk : index->Chunks())
+        IndexedSequence cachedSequence;
+        for (auto& chunk : index->Chunks())
+        {
+            for (auto& sequence : chunk.Sequences())
             {
-                for (auto& sequence : chunk.Sequences())
-                {
-                    cachedSequence.SetKey(sequence.m_key)
-                        .SetNumberOfSamples(sequence.NumberOfSamples())
-                        .SetSize(sequence.SizeInBytes())
-                        .SetOffset(chunk.StartOffset() + sequence.OffsetInChunk());
+                cachedSequence.SetKey(sequence.m_key)
+                    .SetNumberOfSamples(sequence.NumberOfSamples())
+                    .SetSize(sequence.SizeInBytes())
+                    .SetOffset(chunk.StartOffset() + sequence.OffsetInChunk());
 
-                    isCacheEnabled = isCacheEnabled && cache.TryWrite(cachedSequence);
-                }
+                isCacheEnabled = isCacheEnabled && cache.TryWrite(cachedSequence);
             }
-
-            isCacheEnabled = isCacheEnabled && cache.TryFlush();
         }
-        
 
-        if (isCacheEnabled) 
+        isCacheEnabled = isCacheEnabled && cache.TryFlush();
+    }
+    
+
+    if (isCacheEnabled) 
+    {
+        try 
         {
-            try 
-            {
-                // TODO: add TryRename that does not throw.
-                renameOrDie(temp, cacheFilename);
-            }
-            catch (...) {}
+            // TODO: add TryRename that does not throw.
+            renameOrDie(temp, cacheFilename);
         }
-    }).detach();
+        catch (...) 
+        {
+            isCacheEnabled = false;
+        }
+    }
+
+    if (!isCacheEnabled)
+        _wunlink(temp.c_str()); // do not leave a marker behind that other nodes would wait for
+    return isCacheEnabled;
 }
 
 const static size_t s_sequenceSize = sizeof(IndexedSequence);
@@ -159,7 +238,10 @@ TextInputIndexBuilder::TextInputIndexBuilder(const FileWrapper& input)
     m_skipSequenceIds(false),
     m_streamPrefix('|'),
     m_mainStream(""),
-    m_fileSize(0)
+    m_fileSize(0),
+    m_minRangeSize(g_64MB),
+    m_maxRangeSize(16 * g_64MB),
+    m_numberOfThreads(max<size_t>(thread::hardware_concurrency(), 1))
 {}
 
 /*virtual*/ wstring TextInputIndexBuilder::GetCacheFilename() /*override*/
@@ -239,7 +321,8 @@ static const char s_BOM[3] = { '\xEF', '\xBB', '\xBF' };
     if (m_reader->Empty())
         RuntimeError("Input file is empty");
 
-    if (m_skipSequenceIds || (!m_reader->Empty() && m_reader->Peek() == m_streamPrefix))
+    bool fromLines = m_skipSequenceIds || (!m_reader->Empty() && m_reader->Peek() == m_streamPrefix);
+    if (fromLines)
     {
         // Skip sequence id parsing, treat lines as individual sequences
         // In this case the sequences do not have ids, they are assigned corresponding line numbers
@@ -247,13 +330,180 @@ static const char s_BOM[3] = { '\xEF', '\xBB', '\xBF' };
         if (m_corpus && !m_corpus->IsNumericSequenceKeys())
             RuntimeError("Corpus expects non-numeric sequence keys present but the input file does not have them."
                 "Please use the configuration to enable numeric keys instead.");
+    }
 
+    // Large inputs are split into byte ranges scanned by several threads. Symbolic keys (unless hashed)
+    // are registered with the corpus in the order they are read, such inputs are always scanned sequentially.
+    bool canSplit = fromLines || !m_corpus || m_corpus->IsNumericSequenceKeys() || m_corpus->IsHashingEnabled();
+    size_t numberOfThreads = max<size_t>(m_numberOfThreads, 1);
+    size_t remaining = m_fileSize - m_reader->GetFileOffset();
+    size_t rangeSize = max<size_t>(min(max((remaining + numberOfThreads - 1) / numberOfThreads, m_minRangeSize), m_maxRangeSize), 1);
+
+    if (canSplit && numberOfThreads > 1 && remaining > rangeSize)
+        PopulateInParallel(index, fromLines, rangeSize);
+    else if (fromLines)
         PopulateFromLines(index);
+    else
+        PopulateImpl(index);
+}
+
+void TextInputIndexBuilder::PopulateInParallel(shared_ptr<Index>& index, bool fromLines, size_t rangeSize)
+{
+    size_t numberOfThreads = max<size_t>(m_numberOfThreads, 1);
+    size_t begin = m_reader->GetFileOffset();
+    size_t numberOfRanges = (m_fileSize - begin + rangeSize - 1) / rangeSize;
+
+    // Ranges are scanned in waves of numberOfThreads, results of each wave are added to the index
+    // before the next one starts, so that only a bounded number of segments is kept in memory.
+    // The last segment of a wave may continue in the next one, it stays pending until then.
+    IndexedSequence sequence;
+    Segment pending{};
+    bool hasPending = false;
+    // Line numbers are counted from the beginning of the file, including the leading lines skipped so far.
+    size_t lineOffset = m_reader->CurrentLineNumber();
+
+    auto addToIndex = [&](const Segment& segment)
+    {
+        if (!segment.foundMainStream)
+            return;
+
+        sequence.SetKey(segment.key)
+            .SetNumberOfSamples(segment.numberOfSamples)
+            .SetOffset(segment.offset)
+            .SetSize(segment.end - segment.offset);
+        index->AddSequence(sequence);
+    };
+
+    vector<RangeScan> scans(numberOfThreads);
+    for (size_t first = 0; first < numberOfRanges; first += numberOfThreads)
+    {
+        size_t last = min(first + numberOfThreads, numberOfRanges);
+
+        vector<future<void>> tasks;
+        for (size_t r = first; r < last; ++r)
+        {
+            RangeScan& scan = scans[r - first];
+            scan.segments.clear();
+            scan.numberOfLines = 0;
+
+            size_t end = (r + 1 == numberOfRanges) ? m_fileSize : begin + (r + 1) * rangeSize;
+            if (r == 0)
+            {
+                // The first range continues from the current position of the main reader 
+                // (i.e., right after the BOM and leading spaces).
+                tasks.push_back(async(launch::async, [this, &scan, end, fromLines]()
+                {
+                    ScanRange(*m_reader, end, fromLines, scan);
+                }));
+                continue;
+            }
+
+            size_t start = begin + r * rangeSize;
+            tasks.push_back(async(launch::async, [this, &scan, start, end, fromLines]()
+            {
+                // Position the reader at the first line that starts at or after the 'start' offset.
+                // The line break preceding it was consumed by the previous range.
+                auto file = FileWrapper::OpenOrDie(m_input.Filename(), L"rbS");
+                file.SeekOrDie(start - 1, SEEK_SET);
+                BufferedFileReader reader(m_bufferSize, file);
+                if (reader.Peek() == g_eol)
+                    reader.Pop();
+                else
+                    reader.TryMoveToNextLine();
+
+                ScanRange(reader, end, fromLines, scan);
+            }));
+        }
+
+        // Wait for all tasks before rethrowing, they reference the scans.
+        for (auto& task : tasks)
+            task.wait();
+        for (auto& task : tasks)
+            task.get();
+
+        for (size_t r = first; r < last; ++r)
+        {
+            RangeScan& scan = scans[r - first];
+            for (auto& segment : scan.segments)
+            {
+                if (fromLines)
+                {
+                    segment.key += lineOffset;
+                    addToIndex(segment);
+                    continue;
+                }
+
+                if (hasPending && (!segment.hasKey || segment.key == pending.key))
+                {
+                    // The sequence crosses the range boundary.
+                    pending.end = segment.end;
+                    pending.numberOfSamples += segment.numberOfSamples;
+                    pending.foundMainStream |= segment.foundMainStream;
+                    continue;
+                }
+
+                if (!segment.hasKey)
+                    RuntimeError("Expected a sequence id at the offset %zu, none was found.", segment.offset);
+
+                if (hasPending)
+                    addToIndex(pending);
+                pending = segment;
+                hasPending = true;
+            }
+
+            lineOffset += scan.numberOfLines;
+        }
     }
-    else 
+
+    if (hasPending)
+        addToIndex(pending);
+}
+
+void TextInputIndexBuilder::ScanRange(BufferedFileReader& reader, size_t end, bool fromLines, RangeScan& scan)
+{
+    size_t firstLine = reader.CurrentLineNumber();
+    size_t id = 0;
+    while (!reader.Empty() && reader.GetFileOffset() < end)
     {
-        PopulateImpl(index);
+        size_t offset = reader.GetFileOffset();
+        if (fromLines)
+        {
+            if (!FindMainStream(reader))
+            {
+                // skip lines that do not contain main stream name.
+                reader.TryMoveToNextLine();
+                continue;
+            }
+
+            scan.segments.push_back({ reader.CurrentLineNumber() - firstLine, offset, 0, 1, true, true });
+        }
+        else
+        {
+            if (TryGetSequenceId(reader, id))
+            {
+                if (scan.segments.empty() || !scan.segments.back().hasKey || scan.segments.back().key != id)
+                    scan.segments.push_back({ id, offset, 0, 0, true, false });
+            }
+            else if (scan.segments.empty())
+            {
+                // Lines of a sequence that started in the previous range.
+                scan.segments.push_back({ 0, offset, 0, 0, false, false });
+            }
+
+            if (FindMainStream(reader))
+            {
+                scan.segments.back().numberOfSamples++;
+                scan.segments.back().foundMainStream = true;
+            }
+        }
+
+        reader.TryMoveToNextLine(); // ignore whatever is left on this line.
+
+        // The line either has just started a segment or continues the last one.
+        scan.segments.back().end = reader.Empty() ? m_fileSize : reader.GetFileOffset();
     }
+
+    scan.numberOfLines = reader.CurrentLineNumber() - firstLine;
 }
 
 void TextInputIndexBuilder::PopulateFromLines(shared_ptr<Index>& index)
@@ -263,7 +513,7 @@ void TextInputIndexBuilder::PopulateFromLines(shared_ptr<Index>& index)
     {
         size_t offset = m_reader->GetFileOffset();
 
-        if (!FindMainStream())
+        if (!FindMainStream(*m_reader))
         { 
             // skip lines that do not contain main stream name.
             m_reader->TryMoveToNextLine();
@@ -296,14 +546,14 @@ void TextInputIndexBuilder::PopulateImpl(shared_ptr<Index>& index)
     size_t prevId = 0, nextId = 0, prevOffset = m_reader->GetFileOffset();
 
     // Go ahead and read the id of the very first sequence.
-    if (!TryGetSequenceId(prevId))
+    if (!TryGetSequenceId(*m_reader, prevId))
     {
         RuntimeError("Expected a sequence id at the offset %zu, none was found.", prevOffset);
     }
 
     while (!m_reader->Empty())
     {
-        if (FindMainStream())
+        if (FindMainStream(*m_reader))
         {
             numberOfSamples++;
             foundMainStream = true;
@@ -313,7 +563,7 @@ void TextInputIndexBuilder::PopulateImpl(shared_ptr<Index>& index)
 
         auto offset = m_reader->GetFileOffset(); // a new line starts at this offset;
         
-        if (TryGetSequenceId(nextId) && nextId != prevId)
+        if (TryGetSequenceId(*m_reader, nextId) && nextId != prevId)
         {
             // found a new sequence, which starts at the [offset] bytes into the file
             // adding the previous one to the index.
@@ -344,9 +594,9 @@ void TextInputIndexBuilder::PopulateImpl(shared_ptr<Index>& index)
     }
 }
 
-inline bool TextInputIndexBuilder::FindMainStream()
+inline bool TextInputIndexBuilder::FindMainStream(BufferedFileReader& reader)
 {
-    if (m_reader->Empty())
+    if (reader.Empty())
         return false;
     
     if (m_mainStream.empty())
@@ -357,7 +607,7 @@ inline bool TextInputIndexBuilder::FindMainStream()
     int i = 0;
     do  
     {
-        char c = m_reader->Peek();
+        char c = reader.Peek();
         if (i == length)
         {
             // we found a match, check to see if it's followed by either a space, 
@@ -375,30 +625,30 @@ inline bool TextInputIndexBuilder::FindMainStream()
 
         if (c == g_eol)
             break;
-    } while (m_reader->Pop());
+    } while (reader.Pop());
 
     // we hit either the EOL or the EOF, see if we have a match
     return (i == length);
 }
 
-inline bool TextInputIndexBuilder::TryGetSequenceId(size_t& id)
+inline bool TextInputIndexBuilder::TryGetSequenceId(BufferedFileReader& reader, size_t& id)
 {
     if (m_corpus && !m_corpus->IsNumericSequenceKeys())
-        return TryGetSymbolicSequenceId(id, m_corpus->KeyToId);
+        return TryGetSymbolicSequenceId(reader, id, m_corpus->KeyToId);
 
-    return TryGetNumericSequenceId(id);
+    return TryGetNumericSequenceId(reader, id);
 }
 
-inline bool TextInputIndexBuilder::TryGetNumericSequenceId(size_t& id)
+inline bool TextInputIndexBuilder::TryGetNumericSequenceId(BufferedFileReader& reader, size_t& id)
 {
-    if (m_reader->Empty())
+    if (reader.Empty())
         return false;
 
     bool found = false;
     id = 0;
     do
     {
-        char c = m_reader->Peek();
+        char c = reader.Peek();
         if (!isdigit(c))
             // Stop as soon as there's a non-digit character
             return found;
@@ -409,16 +659,16 @@ inline bool TextInputIndexBuilder::TryGetNumericSequenceId(size_t& id)
             RuntimeError("Overflow while reading a numeric sequence id (%zu-bit value).", sizeof(id));
         
         found = true;
-    } while (m_reader->Pop());
+    } while (reader.Pop());
 
     // reached EOF without hitting the pipe character,
     // ignore it for now, parser will have to deal with it.
     return false;
 }
 
-inline bool TextInputIndexBuilder::TryGetSymbolicSequenceId(size_t& id, function<size_t(const string&)> keyToId)
+inline bool TextInputIndexBuilder::TryGetSymbolicSequenceId(BufferedFileReader& reader, size_t& id, function<size_t(const string&)> keyToId)
 {
-    if (m_reader->Empty())
+    if (reader.Empty())
         return false;
 
     bool found = false;
@@ -427,7 +677,7 @@ inline bool TextInputIndexBuilder::TryGetSymbolicSequenceId(size_t& id, function
     key.reserve(256);
     do
     {
-        char c = m_reader->Peek();
+        char c = reader.Peek();
         if (isspace(c))
         {
             if (found)
@@ -437,7 +687,7 @@ inline bool TextInputIndexBuilder::TryGetSymbolicSequenceId(size_t& id, function
 
         key += c;
         found = true;
-    } while (m_reader->Pop());
+    } while (reader.Pop());
 
     // reached EOF without hitting the pipe character,
     // ignore it for now, parser will have to deal with it.
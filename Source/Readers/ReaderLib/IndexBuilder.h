@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 #include <vector>
+#include <chrono>
 #include <boost/noncopyable.hpp>
 #include "Index.h"
 #include "CorpusDescriptor.h"
@@ -76,6 +77,12 @@ public:
 
     IndexBuilder& SetCachingEnabled(bool value) { m_isCacheEnabled = value; return *this; }
 
+    // Rank of this node and number of nodes of the distributed run, taken from the MPI environment by default.
+    IndexBuilder& SetNodeRank(size_t rank, size_t numberOfNodes) { m_nodeRank = rank; m_numberOfNodes = numberOfNodes; return *this; }
+
+    // How long the other nodes wait for the main node to start building the index cache before building the index themselves.
+    IndexBuilder& SetIndexCacheStartTimeout(std::chrono::milliseconds timeout) { m_indexCacheStartTimeout = timeout; return *this; }
+
     virtual std::wstring GetCacheFilename() = 0;
 
 protected:
@@ -93,11 +100,18 @@ protected:
 
     bool m_isCacheEnabled;
 
+    size_t m_nodeRank;
+    size_t m_numberOfNodes;
+    std::chrono::milliseconds m_indexCacheStartTimeout;
+
     static const uint64_t s_version = 1;
 
 private:
     static std::shared_ptr<Index> TryLoadFromCache(const std::wstring& cacheFilename, size_t chunkSize);
+    static bool WriteIndexCache(const std::wstring& cacheFilename, const std::shared_ptr<Index>& index);
     void WriteIndexCacheAsync(std::shared_ptr<Index>& index);
+    // Waits until the main node has written the index cache and loads it, returns nullptr on timeout.
+    std::shared_ptr<Index> WaitForIndexCache(const std::wstring& cacheFilename);
     std::shared_ptr<Index> m_index;
 
     static const uint64_t s_magic = 0x636e746b5f696478; // 'cntk_idx'
@@ -119,6 +133,12 @@ public:
 
     TextInputIndexBuilder& SetStreamPrefix(char prefix) { m_streamPrefix = prefix; return *this; }
 
+    // Inputs are split into byte ranges of 'minSize' to 'maxSize' bytes (one range per thread if possible)
+    // that are scanned concurrently. Inputs that fit into a single range are scanned sequentially.
+    TextInputIndexBuilder& SetRangeSize(size_t minSize, size_t maxSize) { m_minRangeSize = minSize; m_maxRangeSize = maxSize; return *this; }
+
+    TextInputIndexBuilder& SetNumberOfThreads(size_t numberOfThreads) { m_numberOfThreads = numberOfThreads; return *this; }
+
     virtual std::wstring GetCacheFilename() override;
 
 private:
@@ -137,6 +157,9 @@ private:
     bool m_skipSequenceIds; // true, when input contains one sequence per line 
                            // or when sequence id column was ignored during indexing.
     char m_streamPrefix;
+    size_t m_minRangeSize;
+    size_t m_maxRangeSize;
+    size_t m_numberOfThreads;
 
     // Stream that defines the size of the sequence.
     std::string m_mainStream;
@@ -144,29 +167,56 @@ private:
 
     std::unique_ptr<BufferedFileReader> m_reader;
 
+    // Sequences (or parts of sequences) found while scanning a byte range of the input, in file order.
+    // A segment without a key starts with lines that carry no sequence id, it continues the last 
+    // sequence of the preceding range. When indexing by lines, each segment is a single line.
+    struct Segment
+    {
+        size_t key;
+        size_t offset;
+        size_t end;
+        uint32_t numberOfSamples;
+        bool hasKey;
+        bool foundMainStream;
+    };
+
+    struct RangeScan
+    {
+        std::vector<Segment> segments;
+        size_t numberOfLines; // number of line breaks consumed while scanning the range.
+    };
+
     // Returns true if main stream name if found on the current line.
-    bool FindMainStream();
+    bool FindMainStream(BufferedFileReader& reader);
 
     // Invokes either TryGetNumericSequenceId or TryGetSymbolicSequenceId depending
     // on the specified corpus settings.
-    bool TryGetSequenceId(size_t& id);
+    bool TryGetSequenceId(BufferedFileReader& reader, size_t& id);
 
     // Tries to get numeric sequence id.
     // Throws an exception if a non-numerical is read until the pipe character or 
     // EOF is reached without hitting the pipe character.
     // Returns false if no numerical characters are found preceding the pipe.
     // Otherwise, writes sequence id value to the provided reference, returns true.
-    bool TryGetNumericSequenceId(size_t& id);
+    bool TryGetNumericSequenceId(BufferedFileReader& reader, size_t& id);
 
     // Same as above but for symbolic ids.
     // It reads a symbolic key and converts it to numeric id using provided keyToId function.
-    bool TryGetSymbolicSequenceId(size_t& id, std::function<size_t(const std::string&)> keyToId);
+    bool TryGetSymbolicSequenceId(BufferedFileReader& reader, size_t& id, std::function<size_t(const std::string&)> keyToId);
 
     void PopulateImpl(std::shared_ptr<Index>& index);
 
     // Parses input line by line, treating each line as an individual sequence.
     // Ignores sequence id information, using the line number instead as the id.
     void PopulateFromLines(std::shared_ptr<Index>& index);
+
+    // Splits the input (starting at the current position of m_reader) into byte ranges that are 
+    // scanned concurrently, each with its own reader, and stitches the results back together.
+    // Produces exactly the same index as PopulateImpl/PopulateFromLines.
+    void PopulateInParallel(std::shared_ptr<Index>& index, bool fromLines, size_t rangeSize);
+
+    // Scans all lines that start before the 'end' offset.
+    void ScanRange(BufferedFileReader& reader, size_t end, bool fromLines, RangeScan& scan);
 };
 
 }
@@ -24,13 +24,18 @@ LTTumblingWindowRandomizer::LTTumblingWindowRandomizer(
     size_t randomizationRange,
     size_t seedOffset,
     bool multithreadedGetNextSequences,
-    size_t maxNumberOfInvalidSequences)
+    size_t maxNumberOfInvalidSequences,
+    size_t numberOfChunksToLoadAhead)
     : Base(deserializer, { { s_chunkPositionProperty, 0}, { s_sweepIndexProperty, 0} }, multithreadedGetNextSequences, maxNumberOfInvalidSequences),
   m_randomizationRange(randomizationRange),
   m_seedOffset(seedOffset),
   m_chunkPosition(0),
   m_sampleBasedRandomizationWindow(sampleBasedRandomizationWindow),
-  m_sweepCount(0)
+  m_numberOfChunksToLoadAhead(numberOfChunksToLoadAhead),
+  m_sweepCount(0),
+  m_loadAheadSweepIndex(0),
+  m_loadAheadPosition(0),
+  m_nextSweepIndex(SIZE_MAX)
 {
     RandomizeChunks(m_sweepCount);
 }
@@ -43,9 +48,86 @@ void LTTumblingWindowRandomizer::RandomizeWindow(size_t sweepCount, size_t chunk
 
 void LTTumblingWindowRandomizer::RandomizeChunks(size_t sweepCount) const
 {
-    m_prefetchedChunkDescriptions = m_originalChunkDescriptions;
+    RandomizeChunks(sweepCount, m_prefetchedChunkDescriptions);
+}
+
+void LTTumblingWindowRandomizer::RandomizeChunks(size_t sweepCount, std::vector<ChunkInfo>& chunks) const
+{
+    chunks = m_originalChunkDescriptions;
     m_rng.seed((unsigned long)sweepCount + m_seedOffset);
-    RandomShuffleMT(m_prefetchedChunkDescriptions, m_rng);
+    RandomShuffleMT(chunks, m_rng);
+}
+
+void LTTumblingWindowRandomizer::MoveToNextPositionOfWorker(size_t& sweepIndex, size_t& position) const
+{
+    do
+    {
+        if (++position == m_originalChunkDescriptions.size())
+        {
+            position = 0;
+            sweepIndex++;
+        }
+    } while (position % Config().m_numberOfWorkers != Config().m_workerRank);
+}
+
+ChunkPtr LTTumblingWindowRandomizer::GetChunk(size_t sweepIndex, size_t position, ChunkIdType chunkId) const
+{
+    if (m_numberOfChunksToLoadAhead == 0)
+        return m_deserializer->GetChunk(chunkId);
+
+    // Loads issued for other positions are stale, i.e. the state of the randomizer has been reset.
+    if (!m_chunkLoads.empty() && (m_chunkLoads.front().m_sweepIndex != sweepIndex || m_chunkLoads.front().m_position != position))
+        m_chunkLoads.clear();
+
+    ChunkPtr data;
+    if (m_chunkLoads.empty())
+    {
+        data = m_deserializer->GetChunk(chunkId);
+        m_loadAheadSweepIndex = sweepIndex;
+        m_loadAheadPosition = position;
+    }
+    else
+    {
+        data = m_chunkLoads.front().m_data.get();
+        m_chunkLoads.pop_front();
+    }
+
+    LoadAhead(sweepIndex);
+    return data;
+}
+
+// Issues chunk loads for the positions following the last issued one, keeping m_numberOfChunksToLoadAhead of them in flight.
+// Loads do not stop at the end of the window, so the next window starts loading while the current one is consumed.
+void LTTumblingWindowRandomizer::LoadAhead(size_t sweepIndex) const
+{
+    while (m_chunkLoads.size() < m_numberOfChunksToLoadAhead)
+    {
+        size_t nextSweepIndex = m_loadAheadSweepIndex;
+        size_t nextPosition = m_loadAheadPosition;
+        MoveToNextPositionOfWorker(nextSweepIndex, nextPosition);
+
+        // Positions in the following sweep are taken from its chunk order; we never look further.
+        ChunkIdType chunkId;
+        if (nextSweepIndex == sweepIndex)
+            chunkId = m_prefetchedChunkDescriptions[nextPosition].m_id;
+        else if (nextSweepIndex == sweepIndex + 1)
+        {
+            if (m_nextSweepIndex != nextSweepIndex)
+            {
+                RandomizeChunks(nextSweepIndex, m_nextSweepChunkDescriptions);
+                m_nextSweepIndex = nextSweepIndex;
+            }
+            chunkId = m_nextSweepChunkDescriptions[nextPosition].m_id;
+        }
+        else
+            break;
+
+        auto deserializer = m_deserializer;
+        m_chunkLoads.push_back(ChunkLoad{ nextSweepIndex, nextPosition,
+            std::async(std::launch::async, [deserializer, chunkId]() { return deserializer->GetChunk(chunkId); }) });
+        m_loadAheadSweepIndex = nextSweepIndex;
+        m_loadAheadPosition = nextPosition;
+    }
 }
 
 void LTTumblingWindowRandomizer::Prefetch() const
@@ -69,7 +151,7 @@ void LTTumblingWindowRandomizer::Prefetch() const
             size_t oldSize = m_prefetchedSequences.size();
 
             // Query deserializer.
-            ChunkPtr data = m_deserializer->GetChunk(desc.m_id);
+            ChunkPtr data = GetChunk(sweepIndex, position, desc.m_id);
             data->SequenceInfos(m_prefetchedSequences);
             m_prefetchedChunks.push_back(std::make_tuple(desc, data));
 
@@ -110,13 +192,16 @@ void LTTumblingWindowRandomizer::Prefetch() const
 void LTTumblingWindowRandomizer::RefillSequenceWindow(SequenceWindow& window)
 {
     window.m_dataChunks.clear();
-    window.m_sequences = m_prefetchedSequences;
+    // The prefetched sequences are rebuilt by the next prefetch, so they can be taken over.
+    window.m_sequences.swap(m_prefetchedSequences);
     for (const auto& s : window.m_sequences)
         if (IsEndOfSweep(s))
             m_sweepCount++;
 
+    // Positions of other workers have no data, and must not shadow a chunk with the same (default) id.
     for (const auto& c : m_prefetchedChunks)
-        window.m_dataChunks.insert(std::make_pair(std::get<0>(c).m_id, std::get<1>(c)));
+        if (std::get<1>(c))
+            window.m_dataChunks.insert(std::make_pair(std::get<0>(c).m_id, std::get<1>(c)));
 
     m_chunkPosition = (ChunkIdType)(m_chunkPosition + m_prefetchedChunks.size()) % m_originalChunkDescriptions.size();
 }
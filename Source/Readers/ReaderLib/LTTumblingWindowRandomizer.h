@@ -6,12 +6,17 @@
 #pragma once
 
 #include <vector>
+#include <deque>
+#include <future>
 #include "LocalTimelineRandomizerBase.h"
 
 namespace CNTK {
 
 // LT - LocalTimeline
 // A randomizer that firstly randomizes chunks and then sequences inside a tumbling window of chunks.
+// Optionally, chunks are loaded ahead of the prefetch position on separate threads, so that loading
+// of the next window overlaps across chunks and across window boundaries. This requires a deserializer
+// that supports concurrent GetChunk calls, hence it is off by default.
 class LTTumblingWindowRandomizer : public LocalTimelineRandomizerBase
 {
     typedef LocalTimelineRandomizerBase Base;
@@ -23,7 +28,8 @@ public:
         size_t randomizationRange,
         size_t seedOffset = 0,
         bool multithreadedGetNextSequences = false,
-        size_t maxNumberOfInvalidSequences= 0); // per worker
+        size_t maxNumberOfInvalidSequences= 0, // per worker
+        size_t numberOfChunksToLoadAhead = 0);
 
     std::map<std::wstring, size_t> GetInnerState() override;
     void SetInnerState(const std::map<std::wstring, size_t>& state) override;
@@ -33,10 +39,17 @@ public:
 private:
     void RandomizeWindow(size_t sweepCount, size_t chunkPositionOfWindow, size_t sequencePositionInWindow) const;
     void RandomizeChunks(size_t sweepCount) const;
+    void RandomizeChunks(size_t sweepCount, std::vector<ChunkInfo>& chunks) const;
+
+    // Gets the data of the chunk at the given position of the sweep, and keeps the chunk loads ahead of it going.
+    ChunkPtr GetChunk(size_t sweepIndex, size_t position, ChunkIdType chunkId) const;
+    void LoadAhead(size_t sweepIndex) const;
+    void MoveToNextPositionOfWorker(size_t& sweepIndex, size_t& position) const;
 
     const size_t m_randomizationRange;
     const size_t m_seedOffset;
     const bool m_sampleBasedRandomizationWindow;
+    const size_t m_numberOfChunksToLoadAhead;
 
     // Current chunk position that the randomizer works with.
     ChunkIdType m_chunkPosition;
@@ -49,6 +62,19 @@ private:
     mutable std::vector<ChunkInfo> m_prefetchedChunkDescriptions;
     mutable std::vector<SequenceInfo> m_prefetchedSequences;
     mutable std::vector<std::tuple<ChunkInfo, ChunkPtr>> m_prefetchedChunks;
+
+    // Chunk loads issued ahead of the prefetch position, in the order of their positions.
+    struct ChunkLoad
+    {
+        size_t m_sweepIndex;
+        size_t m_position;
+        std::future<ChunkPtr> m_data;
+    };
+    mutable std::deque<ChunkLoad> m_chunkLoads;
+    mutable size_t m_loadAheadSweepIndex;                   // sweep and position of the last issued chunk load
+    mutable size_t m_loadAheadPosition;
+    mutable size_t m_nextSweepIndex;                        // sweep of m_nextSweepChunkDescriptions
+    mutable std::vector<ChunkInfo> m_nextSweepChunkDescriptions;
 };
 
 }
@@ -53,14 +53,14 @@ protected:
     // at the offset equal to value index * elementSize. sampleOffset specifies the offset of the
     // first value from the given sample in the sequence data/indices array (sampleOffset is equal
     // to the sum of non-zero value counts of all preceding samples).
-    void PackSparseSampleAsDense(char* destination, SparseSequenceDataPtr sequence,
+    void PackSparseSampleAsDense(char* destination, const SparseSequenceDataPtr& sequence,
         size_t sampleIndex, size_t sampleOffset, size_t sampleSize, size_t elementSize);
 
     // Packs a dense sample as dense. Copies sampleSize bytes staring at the sampleOffset from 
     // the data portion of the source sequence to the destination block of memory. sampleOffset 
     // specifies the offset of the first value from the given sample in the sequence data/ array 
     // (sampleOffset is equal to the sum of sample sizes of all preceding samples).
-    void PackDenseSample(char* destination, SequenceDataPtr sequence, size_t sampleOffset, size_t sampleSize);
+    void PackDenseSample(char* destination, const SequenceDataPtr& sequence, size_t sampleOffset, size_t sampleSize);
 
     // Establishes a mapping between id inside the mb layout and the global key in the corpus.
     // Assumes the sequences inside MBLayout have the same order as Sequences.
@@ -104,7 +104,7 @@ public:
     virtual void SetConfiguration(const ReaderConfiguration& config, const std::vector<MemoryProviderPtr>& memoryProviders) override;
 };
 
-inline void PackerBase::PackSparseSampleAsDense(char* destination, SparseSequenceDataPtr sequence,
+inline void PackerBase::PackSparseSampleAsDense(char* destination, const SparseSequenceDataPtr& sequence,
     size_t sampleIndex, size_t sampleOffset, size_t sampleSize, size_t elementSize)
 {
     //The sample is sparse, first, need to zero out the buffer.
@@ -127,7 +127,7 @@ inline void PackerBase::PackSparseSampleAsDense(char* destination, SparseSequenc
     }
 }
 
-inline void PackerBase::PackDenseSample(char* destination, SequenceDataPtr sequence, size_t sampleOffset, size_t sampleSize)
+inline void PackerBase::PackDenseSample(char* destination, const SequenceDataPtr& sequence, size_t sampleOffset, size_t sampleSize)
 {
     // Because the sample is dense - simply copying it to the output.
     memcpy(destination, (const char*)(sequence->GetDataBuffer()) + sampleOffset, sampleSize);
@@ -21,6 +21,10 @@ namespace CNTK {
 
     static size_t const g_4GB = 0x100000000L;
 
+    // Default of the "indexCacheStartTimeout" reader option: how long (in seconds) the other nodes of a distributed
+    // run wait for the main node to start writing a shared index cache, which covers the skew of the node start up.
+    static size_t const g_indexCacheStartTimeoutSeconds = 60;
+
     const static char g_eol = '\n';
 
     const static wchar_t* g_minibatchSourcePosition = L"minibatchSourcePosition";
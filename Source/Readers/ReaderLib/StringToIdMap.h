@@ -8,85 +8,175 @@
 #include <string>
 #include <memory>
 #include <vector>
-#include <map>
 #include <deque>
+#include <limits>
+#include <type_traits>
 #include "Basics.h"
 
 namespace CNTK {
 
 // This class represents a string registry pattern to share strings between different deserializers if needed.
 // It associates a unique key for a given string.
+// Strings are stored back to back in a block-allocated arena, and looked up through an open-addressing
+// hash table (linear probing) that holds ids only, so registering a key does not allocate per key.
 // Currently it is implemented in-memory, but can be unloaded to external disk if needed.
 // TODO: Move this class to Basics.h when it is required by more than one reader.
 template<class TString>
 class TStringToIdMap
 {
+    typedef typename TString::value_type CharType;
+    typedef typename TString::traits_type CharTraits;
+
 public:
-    TStringToIdMap()
+    TStringToIdMap() : m_slots(s_initialNumberOfSlots, 0), m_blockPosition(0)
     {}
 
     // Adds string value to the registry.
     void AddValue(const TString& value)
     {
-        auto iter = m_values.insert(std::make_pair(value, m_indexedValues.size()));
-        m_indexedValues.push_back(&((iter.first)->first));
+        AddIfNotExists(value);
     }
 
     // Tries to get a value by id.
     bool TryGet(const TString& value, size_t& id) const
     {
-        const auto& it = m_values.find(value);
-        if (it == m_values.end())
-        {
+        size_t slot = m_slots[FindSlot(value.data(), value.size(), Hash(value.data(), value.size()))];
+        if (slot == 0)
             return false;
-        }
-        else
-        {
-            id = it->second;
-            return true;
-        }
+
+        id = slot - 1;
+        return true;
     }
 
     // Get integer id for the string value, adding if not exists.
     size_t AddIfNotExists(const TString& value)
     {
-        const auto& it = m_values.find(value);
-        if (it == m_values.end())
-        {
-            AddValue(value);
-            return m_values[value];
-        }
-        return it->second;
+        uint32_t hash = Hash(value.data(), value.size());
+        size_t position = FindSlot(value.data(), value.size(), hash);
+        if (m_slots[position] != 0)
+            return m_slots[position] - 1;
+
+        if (value.size() > (std::numeric_limits<uint32_t>::max)())
+            RuntimeError("String value is too long to be registered.");
+
+        size_t id = m_entries.size();
+        m_entries.push_back(Entry{ StoreInArena(value.data(), value.size()), (uint32_t)value.size(), hash });
+        m_slots[position] = id + 1;
+
+        // keep the load factor below 3/4
+        if (4 * m_entries.size() > 3 * m_slots.size())
+            Rehash(2 * m_slots.size());
+        return id;
     }
 
     // Get integer id for the string value.
     size_t operator[](const TString& value) const
     {
-        const auto& it = m_values.find(value);
-        assert(it != m_values.end());
-        return it->second;
+        size_t slot = m_slots[FindSlot(value.data(), value.size(), Hash(value.data(), value.size()))];
+        assert(slot != 0);
+        return slot - 1;
     }
 
     // Get string value by its integer id.
-    const TString& operator[](size_t id) const
+    TString operator[](size_t id) const
     {
-        if (id >= m_indexedValues.size())
+        if (id >= m_entries.size())
             RuntimeError("Unknown id requested");
-        return *m_indexedValues[id];
+        const auto& entry = m_entries[id];
+        return TString(entry.m_data, entry.m_length);
     }
 
     // Checks whether the value exists.
     bool Contains(const TString& value) const
     {
-        return m_values.find(value) != m_values.end();
+        return m_slots[FindSlot(value.data(), value.size(), Hash(value.data(), value.size()))] != 0;
+    }
+
+    // Number of registered values.
+    size_t Size() const
+    {
+        return m_entries.size();
     }
 
 private:
     // TODO: Move NonCopyable as a separate class to Basics.h
     DISABLE_COPY_AND_MOVE(TStringToIdMap);
 
-    std::map<TString, size_t> m_values;
-    std::deque<const TString*> m_indexedValues;
+    static const size_t s_initialNumberOfSlots = 1024;      // must be a power of two
+    static const size_t s_arenaBlockSize = 1024 * 1024;     // in characters
+
+    // A registered value: its location in the arena, length and hash.
+    struct Entry
+    {
+        const CharType* m_data;
+        uint32_t m_length;
+        uint32_t m_hash;
+    };
+
+    // 64-bit FNV-1a, folded to 32 bits.
+    static uint32_t Hash(const CharType* data, size_t length)
+    {
+        uint64_t result = 14695981039346656037ull;
+        for (size_t i = 0; i < length; ++i)
+        {
+            result ^= (uint64_t)(typename std::make_unsigned<CharType>::type)data[i];
+            result *= 1099511628211ull;
+        }
+        return (uint32_t)(result ^ (result >> 32));
+    }
+
+    // Returns the position of the slot holding the value, or of the empty slot where it would be inserted.
+    size_t FindSlot(const CharType* data, size_t length, uint32_t hash) const
+    {
+        const size_t mask = m_slots.size() - 1;
+        for (size_t position = hash & mask;; position = (position + 1) & mask)
+        {
+            size_t slot = m_slots[position];
+            if (slot == 0)
+                return position;
+
+            const auto& entry = m_entries[slot - 1];
+            if (entry.m_hash == hash && entry.m_length == length && CharTraits::compare(entry.m_data, data, length) == 0)
+                return position;
+        }
+    }
+
+    void Rehash(size_t numberOfSlots)
+    {
+        std::vector<size_t> slots(numberOfSlots, 0);
+        const size_t mask = numberOfSlots - 1;
+        for (size_t id = 0; id < m_entries.size(); ++id)
+        {
+            size_t position = m_entries[id].m_hash & mask;
+            while (slots[position] != 0)
+                position = (position + 1) & mask;
+            slots[position] = id + 1;
+        }
+        m_slots.swap(slots);
+    }
+
+    // Copies the characters into the arena. Values never span blocks, so they stay contiguous.
+    const CharType* StoreInArena(const CharType* data, size_t length)
+    {
+        if (m_blocks.empty() || m_blockPosition + length > m_blockSizes.back())
+        {
+            size_t blockSize = length > s_arenaBlockSize ? length : s_arenaBlockSize;
+            m_blocks.emplace_back(new CharType[blockSize]);
+            m_blockSizes.push_back(blockSize);
+            m_blockPosition = 0;
+        }
+
+        CharType* result = m_blocks.back().get() + m_blockPosition;
+        CharTraits::copy(result, data, length);
+        m_blockPosition += length;
+        return result;
+    }
+
+    std::vector<size_t> m_slots;                        // [position] id + 1, or 0 for an empty slot
+    std::deque<Entry> m_entries;                        // [id] registered values
+    std::vector<std::unique_ptr<CharType[]>> m_blocks;  // arena holding the characters of all values
+    std::vector<size_t> m_blockSizes;
+    size_t m_blockPosition;                             // first unused character in the last block
 };
 
 typedef TStringToIdMap<std::wstring> WStringToIdMap;
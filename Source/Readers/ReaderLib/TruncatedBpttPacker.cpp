@@ -17,16 +17,25 @@ using namespace std;
 
 // Represents a slot where we accumulate sequences from which the minibatch is created.
 // The number of slots equals number of parallel sequences we want to pack.
+// Sequences are kept in a ring buffer that only grows when needed, so that in the steady state
+// pushing and popping sequences does not allocate. The sequence data itself is not copied.
 class Slot
 {
+    struct Entry
+    {
+        SequenceDataPtr m_sequence;
+        // Indicates whether the sequence data comes from the end of a sweep.
+        bool m_endOfSweep;
+    };
+
 public:
-    Slot() : m_length(0), m_sampleCursor(0), m_sampleOffset(0)
+    Slot() : m_sampleCursor(0), m_sampleOffset(0), m_head(0), m_count(0), m_length(0)
     {}
 
     // Checks if slot is empty.
     bool IsEmpty() const
     {
-        return m_sequences.empty();
+        return m_count == 0;
     }
 
     void Reset() 
@@ -34,46 +43,63 @@ public:
         m_length = 0;
         m_sampleCursor = 0;
         m_sampleOffset = 0;
-        m_sequences.clear();
-        m_endOfSweepFlags.clear();
+        for (; m_count > 0; --m_count)
+        {
+            m_entries[m_head].m_sequence = nullptr;
+            m_head = (m_head + 1) & (m_entries.size() - 1);
+        }
+        m_head = 0;
     }
 
     // Gets the number of available samples in the slot.
     size_t AvailableNumberOfSamples() const
     {
         assert(m_length >= m_sampleCursor);
-        assert(m_sequences.empty() ? m_sampleCursor == 0 : FrontSequence()->m_numberOfSamples >= m_sampleCursor);
+        assert(IsEmpty() ? m_sampleCursor == 0 : FrontSequence()->m_numberOfSamples >= m_sampleCursor);
         return m_length - m_sampleCursor;
     }
 
     // Adds a new sequence to the end of the slot.
-    void PushSequence(SequenceDataPtr s, bool endOfSweep)
+    void PushSequence(const SequenceDataPtr& s, bool endOfSweep)
     {
-        m_sequences.push_back(s);
-        m_endOfSweepFlags.push_back(endOfSweep);
+        if (m_count == m_entries.size())
+        {
+            // Grow the ring (its size is always a power of two), unrolling the entries to the front.
+            vector<Entry> entries(max<size_t>(4, 2 * m_entries.size()));
+            for (size_t i = 0; i < m_count; ++i)
+                entries[i] = std::move(m_entries[(m_head + i) & (m_entries.size() - 1)]);
+            m_entries.swap(entries);
+            m_head = 0;
+        }
+
+        auto& entry = m_entries[(m_head + m_count) & (m_entries.size() - 1)];
+        entry.m_sequence = s;
+        entry.m_endOfSweep = endOfSweep;
+        m_count++;
         m_length += s->m_numberOfSamples;
     }
 
-    SequenceDataPtr FrontSequence() const
+    const SequenceDataPtr& FrontSequence() const
     {
-        assert(!m_sequences.empty());
-        return m_sequences.front();
+        assert(!IsEmpty());
+        return m_entries[m_head].m_sequence;
     }
 
     // Pops the front sequence at the beginning of the slot.
     bool PopSequence()
     {
-        assert(!m_sequences.empty());
+        assert(!IsEmpty());
         m_sampleCursor = 0;
         m_sampleOffset = 0;
-        m_length -= m_sequences.front()->m_numberOfSamples;
-        m_sequences.pop_front();
-        bool endOfSweepFlag = m_endOfSweepFlags.front();
-        m_endOfSweepFlags.pop_front();
-        return endOfSweepFlag;
+        auto& entry = m_entries[m_head];
+        m_length -= entry.m_sequence->m_numberOfSamples;
+        entry.m_sequence = nullptr; // release the data as soon as possible.
+        m_head = (m_head + 1) & (m_entries.size() - 1);
+        m_count--;
+        return entry.m_endOfSweep;
     }
 
-    // Contains the current sample cursor in the first sequence(m_sequences.front()) of the slot.
+    // Contains the current sample cursor in the first sequence (FrontSequence()) of the slot.
     size_t m_sampleCursor;
 
     // offset of the current sample into the data region of the first sequence.
@@ -83,17 +109,41 @@ public:
     size_t m_sampleOffset; 
 
 private:
-    // Prepared sequences.
-    deque<SequenceDataPtr> m_sequences;
-    
-    // For each 'in-flight' sequence we keep a flag that indicate whether 
-    // the sequence data comes from an the end of a sweep.
-    std::deque<bool> m_endOfSweepFlags;
-
-    // Contains the size of the slot in samples (accumulated over all m_sequences).
+    // Prepared sequences, m_count entries starting at m_head.
+    vector<Entry> m_entries;
+    size_t m_head;
+    size_t m_count;
+
+    // Contains the size of the slot in samples (accumulated over all sequences in the slot).
     size_t m_length;
 };
 
+// Copies 'count' consecutive dense samples into the destination, placing them 'stride' bytes apart.
+// Samples of the common small sizes are copied with fixed-size moves instead of memcpy calls.
+static void CopyDenseSamples(char* destination, const char* source, size_t count, size_t sampleSize, size_t stride)
+{
+    if (stride == sampleSize)
+    {
+        memcpy(destination, source, count * sampleSize);
+        return;
+    }
+
+    switch (sampleSize)
+    {
+    case 4:
+        for (size_t i = 0; i < count; ++i, destination += stride, source += 4)
+            memcpy(destination, source, 4);
+        break;
+    case 8:
+        for (size_t i = 0; i < count; ++i, destination += stride, source += 8)
+            memcpy(destination, source, 8);
+        break;
+    default:
+        for (size_t i = 0; i < count; ++i, destination += stride, source += sampleSize)
+            memcpy(destination, source, sampleSize);
+    }
+}
+
 // Represents a buffer of slots from which the minibatch is created.
 struct SequenceBuffer
 {
@@ -301,8 +351,10 @@ bool TruncatedBPTTPacker::PackSlot(size_t streamIndex, size_t slotIndex, size_t&
     // Those are currently skipped during LC-BLSTM training
     bool crossBoundary = false;
 
-    // Ok, now fill in the buffer with data.
-    for (size_t currentTimestep = 0; currentTimestep < numberOfSamples; ++currentTimestep)
+    char* destination = m_streamBuffers[m_currentBufferIndex][streamIndex].m_data.get() + slotIndex * sampleSize;
+
+    // Ok, now fill in the buffer with data, a run of samples of the same sequence at a time.
+    for (size_t currentTimestep = 0; currentTimestep < numberOfSamples;)
     {
         // Check if reach the end of the front sequence.
         if (slot.m_sampleCursor >= slot.FrontSequence()->m_numberOfSamples)
@@ -322,35 +374,42 @@ bool TruncatedBPTTPacker::PackSlot(size_t streamIndex, size_t slotIndex, size_t&
         }
 
         // Fill in the data from the first sequence in the slot.
-        auto data = slot.FrontSequence();
-        // Get buffer destination for the current sample.
-        auto& buffer = m_streamBuffers[m_currentBufferIndex][streamIndex];
-        auto offset = strideSize * currentTimestep + slotIndex * sampleSize;
-        assert(offset >= 0 && offset < buffer.m_size);
-        char* destination = buffer.m_data.get() + offset;
-
-        // Pack the sample.
+        const auto& data = slot.FrontSequence();
+        size_t count = min(numberOfSamples - currentTimestep, data->m_numberOfSamples - slot.m_sampleCursor);
+        assert(strideSize * (currentTimestep + count - 1) + slotIndex * sampleSize < m_streamBuffers[m_currentBufferIndex][streamIndex].m_size);
+
+        // Number of samples in this run that lie in the right splice region.
+        size_t spliceBegin = max(currentTimestep, nc);
+        size_t numberOfSplicedSamples = spliceBegin < currentTimestep + count ? currentTimestep + count - spliceBegin : 0;
+
+        // Pack the samples.
         if (storageType == StorageFormat::Dense)
         {
             assert(slot.m_sampleOffset == slot.m_sampleCursor * sampleSize);
-            PackDenseSample(destination, data, slot.m_sampleOffset, sampleSize);
-            slot.m_sampleOffset += sampleSize;
-            if (currentTimestep >= nc) padding += sampleSize;
+            CopyDenseSamples(destination + strideSize * currentTimestep, 
+                (const char*)data->GetDataBuffer() + slot.m_sampleOffset, count, sampleSize, strideSize);
+            slot.m_sampleOffset += count * sampleSize;
+            padding += numberOfSplicedSamples * sampleSize;
         }
         else
         {
             assert(storageType == StorageFormat::SparseCSC);
             // TODO: make type casts members of the SparseSequenceData
             SparseSequenceDataPtr sparseSequence = static_pointer_cast<SparseSequenceData>(data);
-            assert(slot.m_sampleCursor < sparseSequence->m_nnzCounts.size());
-            PackSparseSampleAsDense(destination, sparseSequence, slot.m_sampleCursor, 
-                slot.m_sampleOffset, sampleSize, elementSize);
-            slot.m_sampleOffset += sparseSequence->m_nnzCounts[slot.m_sampleCursor];
-            assert(slot.m_sampleOffset <= sparseSequence->m_totalNnzCount);
-            if (currentTimestep >= nc) padding += sparseSequence->m_nnzCounts[slot.m_sampleCursor];
+            for (size_t i = 0; i < count; ++i)
+            {
+                size_t sampleIndex = slot.m_sampleCursor + i;
+                assert(sampleIndex < sparseSequence->m_nnzCounts.size());
+                PackSparseSampleAsDense(destination + strideSize * (currentTimestep + i), sparseSequence, sampleIndex,
+                    slot.m_sampleOffset, sampleSize, elementSize);
+                slot.m_sampleOffset += sparseSequence->m_nnzCounts[sampleIndex];
+                assert(slot.m_sampleOffset <= sparseSequence->m_totalNnzCount);
+                if (currentTimestep + i >= nc) padding += sparseSequence->m_nnzCounts[sampleIndex];
+            }
         }
 
-        slot.m_sampleCursor++;
+        slot.m_sampleCursor += count;
+        currentTimestep += count;
     }
 
     // For latency control BLSTM LC-BLSTM
@@ -13,9 +13,12 @@
 #include "CUDAPageLockedMemAllocator.h"
 #include "NcclComm.h"
 #include <future>
+#include <numeric>
+#include <algorithm>
 #include "GPUDataTransferer.h"
 #include "TimerUtility.h"
 #include "MatrixQuantizerImpl.h"
+#include "SparseGradientMerge.h"
 
 namespace Microsoft { namespace MSR { namespace CNTK {
 
@@ -178,6 +181,18 @@ private:
             size_t packedGradientsSizeInElements = 0;
             for (size_t i = 0; i < gradients.size(); i++)
             {
+                // Sparse gradients (e.g. of embeddings) are exchanged as lists of non-zero columns, see AggregateSparseGradient()
+                if (gradients[i]->GetMatrixType() != DENSE)
+                {
+                    if (gradients[i]->GetFormat() != matrixFormatSparseBlockCol)
+                        RuntimeError("Gradient aggregation for sparse gradient matrices is only supported for the sparse block column format!");
+                    if (m_useAsyncAggregation)
+                        RuntimeError("Asynchronous gradient aggregation for sparse gradient matrices is currently unsupported!");
+
+                    m_sparseGradientsIndex.push_back(i);
+                    continue;
+                }
+
                 if (!m_useAsyncAggregation && sizeof(ElemType) * gradients[i]->GetNumElements() <= m_packThresholdSizeInBytes)
                 {
                     packedGradientsSizeInElements += gradients[i]->GetNumElements();
@@ -188,10 +203,6 @@ private:
                     m_gradientIndexToAggregate.push_back(i);
                 }
 
-                // Make sure none of the gradient matrixes are sparse - we currently do not support aggregation of sparse gradient matrices
-                if (gradients[i]->GetMatrixType() != DENSE)
-                    RuntimeError("Gradient aggregation for sparse gradient matrices is currently unsupported!");
-
                 if (m_useAsyncAggregation)
                     m_bufferedGradients[gradients[i]].reset(new Matrix<ElemType>(gradients[i]->GetNumRows(), gradients[i]->GetNumCols(), deviceId));
             }
@@ -211,7 +222,8 @@ private:
                 // Reuse "@param m_gradientIndexToAggregate" for following code, if no continous buffer allocated
                 for (size_t i = 0; i < gradients.size(); i++)
                 {
-                    m_gradientIndexToAggregate.push_back(i);
+                    if (gradients[i]->GetMatrixType() == DENSE)
+                        m_gradientIndexToAggregate.push_back(i);
                 }
             }
             else
@@ -242,19 +254,32 @@ private:
                     m_recvHeaders.push_back(DistGradHeader::Create(numEvalNodes));
             }
         }
-        else if (resetState)
+        else
         {
-            // Make sure there is no pending async aggregation
-            if (m_useAsyncAggregation && m_pendingAsyncAggregation.valid())
-                LogicError("Unexpected pending async gradient aggregation found when resetting aggregator state!");
+            // The set of sparse gradients is fixed on the first call; the dense code paths cannot handle a type change
+            for (size_t i = 0, j = 0; i < gradients.size(); i++)
+            {
+                bool isSparse = (j < m_sparseGradientsIndex.size()) && (m_sparseGradientsIndex[j] == i);
+                if (isSparse)
+                    j++;
+                if (isSparse != (gradients[i]->GetMatrixType() != DENSE))
+                    LogicError("Gradient matrix %d changed between dense and sparse storage after the first gradient aggregation.", (int)i);
+            }
 
-            // Zero out the buffered gradients if resetting state
-            if (m_useAsyncAggregation)
+            if (resetState)
             {
-                for (size_t i = 0; i < gradients.size(); i++)
-                    m_bufferedGradients[gradients[i]]->SetValue(0);
+                // Make sure there is no pending async aggregation
+                if (m_useAsyncAggregation && m_pendingAsyncAggregation.valid())
+                    LogicError("Unexpected pending async gradient aggregation found when resetting aggregator state!");
 
-                m_bufferedGradHeader->Clear();
+                // Zero out the buffered gradients if resetting state
+                if (m_useAsyncAggregation)
+                {
+                    for (size_t i = 0; i < gradients.size(); i++)
+                        m_bufferedGradients[gradients[i]]->SetValue(0);
+
+                    m_bufferedGradHeader->Clear();
+                }
             }
         }
     }
@@ -281,7 +306,12 @@ private:
 
             // If the current node did not process any samples, the gradients should be zero'd
             for (size_t i = 0; i < numGradMatrices; ++i)
-                gradients[i]->SetValue(0);
+            {
+                if (gradients[i]->GetMatrixType() == DENSE)
+                    gradients[i]->SetValue(0);
+                else
+                    gradients[i]->Reset();
+            }
 
             if (m_useAsyncAggregation)
             {
@@ -464,6 +494,10 @@ private:
             }
         }
 
+        // Sparse gradients are exchanged synchronously after the dense ones
+        for (size_t i : m_sparseGradientsIndex)
+            AggregateSparseGradient(*gradients[i]);
+
         // Copy data back to the packed gradients from the continous buffer
         offset = 0;
         for (size_t i : m_packedGradientsIndex)
@@ -484,6 +518,55 @@ private:
         }
     }
 
+    // Aggregate a sparse block column gradient (e.g. of an embedding, where each worker only touches the columns of the
+    // words in its minibatch). Instead of all-reducing the full dense matrix, every worker contributes the indices and
+    // values of its non-zero columns through an allgather, and each worker merges the lists into the summed gradient.
+    // If the gathered lists would not be clearly smaller than the dense matrix, the gradient is all-reduced densely,
+    // a slice of columns at a time (see SparseGradientMerge.h).
+    // All workers see the same gathered counts, so all of them take the same path.
+    void AggregateSparseGradient(Matrix<ElemType>& gradient)
+    {
+        const size_t numRows = gradient.GetNumRows();
+        const size_t numCols = gradient.GetNumCols();
+        const size_t numProc = NumProc();
+
+        std::vector<size_t> columnIds;
+        std::vector<ElemType> values;
+        gradient.GetSparseBlockColumnData(columnIds, values);
+
+        size_t numBlocks = columnIds.size();
+        std::vector<size_t> numBlocksPerProc(numProc);
+        m_mpi->AllGather(&numBlocks, 1, numBlocksPerProc.data(), 1);
+
+        size_t maxBlocks = *std::max_element(numBlocksPerProc.begin(), numBlocksPerProc.end());
+        size_t totalBlocks = std::accumulate(numBlocksPerProc.begin(), numBlocksPerProc.end(), (size_t)0);
+        if (totalBlocks == 0)
+            return;
+
+        std::vector<size_t> mergedColumnIds;
+        std::vector<ElemType> mergedValues;
+        if (ShouldGatherSparseGradient(numProc, maxBlocks, numRows, numCols))
+        {
+            // Allgather needs equal contributions, so every worker's lists are padded to the largest block count
+            columnIds.resize(maxBlocks, SIZE_MAX);
+            values.resize(maxBlocks * numRows, 0);
+            std::vector<size_t> allColumnIds(numProc * maxBlocks);
+            std::vector<ElemType> allValues(numProc * maxBlocks * numRows);
+            m_mpi->AllGather(columnIds.data(), maxBlocks, allColumnIds.data(), maxBlocks);
+            m_mpi->AllGather(values.data(), maxBlocks * numRows, allValues.data(), maxBlocks * numRows);
+            MergeGatheredBlockColumns(numBlocksPerProc, maxBlocks, numRows, allColumnIds, allValues, mergedColumnIds, mergedValues);
+        }
+        else
+        {
+            // Dense fallback: all-reduce the matrix in slices of columns, each with one flag per column that marks the columns touched by any worker
+            MergeBlockColumnsDensely(columnIds, values, numRows, numCols, SparseGradientDenseSliceMaxElements,
+                                     [this](std::vector<ElemType>& slice, size_t, size_t) { m_mpi->AllReduce(slice.data(), slice.size()); },
+                                     mergedColumnIds, mergedValues);
+        }
+
+        gradient.SetMatrixFromSBCFormat(mergedColumnIds.data(), mergedValues.data(), mergedColumnIds.size(), numRows, numCols);
+    }
+
 private:
     std::unique_ptr<CUDAPageLockedMemAllocator> m_allocator;
 
@@ -508,6 +591,7 @@ private:
     std::unique_ptr<Matrix<ElemType>> m_aggregationBuffer;
     std::vector<size_t> m_packedGradientsIndex;
     std::vector<size_t> m_gradientIndexToAggregate;
+    std::vector<size_t> m_sparseGradientsIndex;
 
     int m_syncStatsTrace;
 
@@ -0,0 +1,114 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+// SparseGradientMerge.h -- summation of the sparse block column gradients of all workers, see SimpleDistGradAggregator::AggregateSparseGradient().
+// A gradient is given as the ids of its non-zero columns and their values, numRows values per column, in the order of the ids.
+//
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+namespace Microsoft { namespace MSR { namespace CNTK {
+
+// Column lists are gathered only while the gathered data stays below this fraction of the dense matrix
+static const double SparseGradientGatherDensityThreshold = 0.25;
+
+// Maximum size of the host buffer (in elements) through which the dense fallback all-reduces the gradient
+static const size_t SparseGradientDenseSliceMaxElements = 1 << 24;
+
+// Whether to gather the column lists of a numRows x numCols gradient from numProc workers, each of which holds at most
+// maxBlocks columns, rather than to all-reduce it densely. Every worker's list is padded to maxBlocks columns,
+// and each column also carries its id.
+inline bool ShouldGatherSparseGradient(size_t numProc, size_t maxBlocks, size_t numRows, size_t numCols)
+{
+    return numProc * maxBlocks * (numRows + 1) <= SparseGradientGatherDensityThreshold * numRows * numCols;
+}
+
+// Sums gathered column lists into their union, in sorted order so that all workers produce the identical matrix.
+// Worker p contributed the first numBlocksPerProc[p] of the maxBlocks columns at allColumnIds[p * maxBlocks],
+// with their values at allValues[p * maxBlocks * numRows].
+template <class ElemType>
+void MergeGatheredBlockColumns(const std::vector<size_t>& numBlocksPerProc, size_t maxBlocks, size_t numRows,
+                               const std::vector<size_t>& allColumnIds, const std::vector<ElemType>& allValues,
+                               std::vector<size_t>& mergedColumnIds, std::vector<ElemType>& mergedValues)
+{
+    const size_t numProc = numBlocksPerProc.size();
+    mergedColumnIds.clear();
+    for (size_t p = 0; p < numProc; p++)
+        mergedColumnIds.insert(mergedColumnIds.end(), allColumnIds.begin() + p * maxBlocks, allColumnIds.begin() + p * maxBlocks + numBlocksPerProc[p]);
+    std::sort(mergedColumnIds.begin(), mergedColumnIds.end());
+    mergedColumnIds.erase(std::unique(mergedColumnIds.begin(), mergedColumnIds.end()), mergedColumnIds.end());
+
+    mergedValues.assign(mergedColumnIds.size() * numRows, 0);
+    for (size_t p = 0; p < numProc; p++)
+    {
+        for (size_t j = 0; j < numBlocksPerProc[p]; j++)
+        {
+            size_t k = p * maxBlocks + j;
+            size_t block = std::lower_bound(mergedColumnIds.begin(), mergedColumnIds.end(), allColumnIds[k]) - mergedColumnIds.begin();
+            const ElemType* src = allValues.data() + k * numRows;
+            ElemType* dst = mergedValues.data() + block * numRows;
+            for (size_t r = 0; r < numRows; r++)
+                dst[r] += src[r];
+        }
+    }
+}
+
+// Writes the columns with ids in [firstCol, endCol) into a dense slice buffer: numRows values per column of the range,
+// followed by one flag per column of the range that is 1 for the columns held. Columns not held are zero.
+template <class ElemType>
+void ScatterBlockColumns(const std::vector<size_t>& columnIds, const std::vector<ElemType>& values, size_t numRows,
+                         size_t firstCol, size_t endCol, std::vector<ElemType>& slice)
+{
+    const size_t numSliceCols = endCol - firstCol;
+    slice.assign(numSliceCols * (numRows + 1), 0);
+    for (size_t j = 0; j < columnIds.size(); j++)
+    {
+        if (columnIds[j] < firstCol || columnIds[j] >= endCol)
+            continue;
+        size_t col = columnIds[j] - firstCol;
+        std::copy(values.begin() + j * numRows, values.begin() + (j + 1) * numRows, slice.begin() + col * numRows);
+        slice[numSliceCols * numRows + col] = 1;
+    }
+}
+
+// Appends the flagged columns of a slice buffer (see ScatterBlockColumns()) to the column lists.
+template <class ElemType>
+void AppendFlaggedBlockColumns(const std::vector<ElemType>& slice, size_t numRows, size_t firstCol, size_t endCol,
+                               std::vector<size_t>& columnIds, std::vector<ElemType>& values)
+{
+    const size_t numSliceCols = endCol - firstCol;
+    for (size_t col = 0; col < numSliceCols; col++)
+    {
+        if (slice[numSliceCols * numRows + col] == 0)
+            continue;
+        columnIds.push_back(firstCol + col);
+        values.insert(values.end(), slice.begin() + col * numRows, slice.begin() + (col + 1) * numRows);
+    }
+}
+
+// Dense fallback: sums the column lists of all workers by all-reducing the gradient one slice of columns at a time,
+// so that the buffer stays within maxSliceElements (but holds at least one column). allReduce(slice, firstCol, endCol)
+// must sum the slice buffers of all workers in place. The summed columns come out in sorted order.
+template <class ElemType, class AllReduceFunction>
+void MergeBlockColumnsDensely(const std::vector<size_t>& columnIds, const std::vector<ElemType>& values, size_t numRows, size_t numCols,
+                              size_t maxSliceElements, const AllReduceFunction& allReduce,
+                              std::vector<size_t>& mergedColumnIds, std::vector<ElemType>& mergedValues)
+{
+    const size_t numSliceCols = std::max((size_t)1, maxSliceElements / (numRows + 1));
+    mergedColumnIds.clear();
+    mergedValues.clear();
+    std::vector<ElemType> slice;
+    for (size_t firstCol = 0; firstCol < numCols; firstCol += numSliceCols)
+    {
+        size_t endCol = std::min(numCols, firstCol + numSliceCols);
+        ScatterBlockColumns(columnIds, values, numRows, firstCol, endCol, slice);
+        allReduce(slice, firstCol, endCol);
+        AppendFlaggedBlockColumns(slice, numRows, firstCol, endCol, mergedColumnIds, mergedValues);
+    }
+}
+
+}}}
@@ -9,6 +9,7 @@
 //#include "Windows.h"
 #include "Matrix.h"
 #include "CPUMatrix.h"
+#include "CPUSparseMatrix.h"
 #include "TensorView.h"
 #include "Sequences.h"
 #include <chrono>
@@ -336,6 +337,48 @@ void MandSTest(int count, int devId)
     delete[] data3;
 }
 
+// Times the sparse GEMM kernels on embedding shapes: forward W(dim x vocab) * X(vocab x samples, sparse) and the
+// gradient dY(dim x samples) * X^T, which is accumulated into a SparseBlockCol matrix.
+template <class ElemType>
+void SparseEmbeddingMultiplyTest(size_t vocabSize, size_t embeddingDim, size_t numSamples, double density)
+{
+    cout << "Embedding: vocab " << vocabSize << ", dim " << embeddingDim << ", " << numSamples << " samples, density " << density << endl;
+
+    const size_t nzPerColumn = max((size_t) 1, (size_t) (vocabSize * density));
+    mt19937 rng(1);
+    uniform_int_distribution<size_t> rowDist(0, vocabSize - 1);
+    vector<CPUSPARSE_INDEX_TYPE> colStarts(numSamples + 1), rows;
+    vector<ElemType> values;
+    for (size_t j = 0; j < numSamples; j++)
+    {
+        colStarts[j] = (CPUSPARSE_INDEX_TYPE) rows.size();
+        vector<CPUSPARSE_INDEX_TYPE> colRows(nzPerColumn);
+        generate(colRows.begin(), colRows.end(), [&] { return (CPUSPARSE_INDEX_TYPE) rowDist(rng); });
+        sort(colRows.begin(), colRows.end());
+        colRows.erase(unique(colRows.begin(), colRows.end()), colRows.end());
+        rows.insert(rows.end(), colRows.begin(), colRows.end());
+        values.resize(rows.size(), (ElemType) 1);
+    }
+    colStarts[numSamples] = (CPUSPARSE_INDEX_TYPE) rows.size();
+
+    CPUSparseMatrix<ElemType> X(MatrixFormat::matrixFormatSparseCSC, vocabSize, numSamples, rows.size());
+    X.SetMatrixFromCSCFormat(colStarts.data(), rows.data(), values.data(), rows.size(), vocabSize, numSamples);
+
+    CPUMatrix<ElemType> W(embeddingDim, vocabSize);
+    W.SetUniformRandomValue(-1, 1, 1);
+    CPUMatrix<ElemType> Y(embeddingDim, numSamples);
+    auto t_start = chrono::high_resolution_clock::now();
+    CPUSparseMatrix<ElemType>::MultiplyAndWeightedAdd(1, W, false, X, false, 0, Y);
+    auto t_end = chrono::high_resolution_clock::now();
+    cout << "forward W * X in: " << chrono::duration<double>(t_end - t_start).count() << " seconds" << endl;
+
+    CPUSparseMatrix<ElemType> dW(MatrixFormat::matrixFormatSparseBlockCol, embeddingDim, vocabSize, 0);
+    t_start = chrono::high_resolution_clock::now();
+    CPUSparseMatrix<ElemType>::MultiplyAndAdd(1, Y, false, X, true, dW);
+    t_end = chrono::high_resolution_clock::now();
+    cout << "gradient dY * X^T in: " << chrono::duration<double>(t_end - t_start).count() << " seconds" << endl;
+}
+
 int wmain()
 {
     // MandSTest<float>(100, 2);
@@ -355,5 +398,9 @@ int wmain()
     MultiplyAndWeightedAddTest<float>(1100,1000,1200);    
     MultiplyAndWeightedAddTest<float>(11000,10000,12000);*/
 
+    cout<<endl<<"********************CPUSparseMatrix embedding TEST********************"<<endl;
+    SparseEmbeddingMultiplyTest<float>(1000000, 300, 1024, 0.0001);
+    SparseEmbeddingMultiplyTest<float>(10000000, 64, 1024, 0.0001);
+
     return 0;
 }
@@ -4,6 +4,8 @@
 //
 #include "stdafx.h"
 #include "../../../Source/Math/CPUMatrix.h"
+#include <omp.h>
+#include <functional>
 
 using namespace Microsoft::MSR::CNTK;
 
@@ -642,6 +644,32 @@ BOOST_FIXTURE_TEST_CASE(CPUMatrixNorms, RandomSeedFixture)
     BOOST_CHECK(mResult.IsEqualTo(m2, c_epsilonFloatE4));
 }
 
+BOOST_FIXTURE_TEST_CASE(CPUMatrixVectorMaxTopK, RandomSeedFixture)
+{
+    // 3x4 matrix with ties, stored column-major
+    float src[] = {
+        1.0f, 7.0f, 7.0f,
+        2.0f, 2.0f, 9.0f,
+        5.0f, 0.0f, 5.0f,
+        3.0f, 8.0f, 4.0f};
+    SMatrix m0(3, 4, src, matrixFlagNormal);
+    SMatrix maxIndexes, maxValues;
+
+    // column-wise, ties keep the lower index first
+    m0.VectorMax(maxIndexes, maxValues, true, 2);
+    float expectedColIdx[] = {1, 2, 2, 0, 0, 2, 1, 2};
+    float expectedColVal[] = {7, 7, 9, 2, 5, 5, 8, 4};
+    BOOST_CHECK(maxIndexes.IsEqualTo(SMatrix(2, 4, expectedColIdx, matrixFlagNormal)));
+    BOOST_CHECK(maxValues.IsEqualTo(SMatrix(2, 4, expectedColVal, matrixFlagNormal)));
+
+    // row-wise
+    m0.VectorMax(maxIndexes, maxValues, false, 3);
+    float expectedRowIdx[] = {2, 3, 1, 3, 0, 0, 1, 1, 2};
+    float expectedRowVal[] = {5, 8, 9, 3, 7, 7, 2, 2, 5};
+    BOOST_CHECK(maxIndexes.IsEqualTo(SMatrix(3, 3, expectedRowIdx, matrixFlagNormal)));
+    BOOST_CHECK(maxValues.IsEqualTo(SMatrix(3, 3, expectedRowVal, matrixFlagNormal)));
+}
+
 BOOST_FIXTURE_TEST_CASE(CPUMatrixSetValues, RandomSeedFixture)
 {
     DMatrix m0(3, 3);
@@ -1215,6 +1243,569 @@ BOOST_FIXTURE_TEST_CASE(CPUMatrixGatherFromTarget, RandomSeedFixture)
     BOOST_CHECK(m2.IsEqualTo(expect, 1e-6));
 }
 
+BOOST_FIXTURE_TEST_CASE(CPUMatrixPhiloxKnownAnswer, RandomSeedFixture)
+{
+    // test vectors from the Random123 distribution (philox4x32_10)
+    uint32_t r[4];
+    Philox4x32::Generate(0, 0, 0, r);
+    BOOST_CHECK_EQUAL(r[0], 0x6627e8d5u);
+    BOOST_CHECK_EQUAL(r[1], 0xe169c58du);
+    BOOST_CHECK_EQUAL(r[2], 0xbc57ac4cu);
+    BOOST_CHECK_EQUAL(r[3], 0x9b00dbd8u);
+
+    Philox4x32::Generate(~0ull, ~0ull, ~0ull, r);
+    BOOST_CHECK_EQUAL(r[0], 0x408f276du);
+    BOOST_CHECK_EQUAL(r[1], 0x41c83b0eu);
+    BOOST_CHECK_EQUAL(r[2], 0xa20bc7c6u);
+    BOOST_CHECK_EQUAL(r[3], 0x6d5451fdu);
+}
+
+BOOST_FIXTURE_TEST_CASE(CPUMatrixSetUniformRandomMask, RandomSeedFixture)
+{
+    const float dropRate = 0.3f;
+    const float scale = 1.0f / (1.0f - dropRate);
+
+    // the mask must not depend on the number of threads
+    int savedThreads = omp_get_max_threads();
+    omp_set_num_threads(1);
+    CPURNGHandle rng1(CPUDEVICE, 1234);
+    SMatrix m1(257, 131);
+    m1.SetUniformRandomMask(dropRate, scale, rng1);
+
+    omp_set_num_threads(4);
+    CPURNGHandle rng4(CPUDEVICE, 1234);
+    SMatrix m4(257, 131);
+    m4.SetUniformRandomMask(dropRate, scale, rng4);
+    omp_set_num_threads(savedThreads);
+
+    BOOST_CHECK(m1.IsEqualTo(m4));
+
+    size_t dropped = 0;
+    foreach_coord (i, j, m1)
+    {
+        BOOST_CHECK(m1(i, j) == 0 || m1(i, j) == scale);
+        dropped += m1(i, j) == 0;
+    }
+    BOOST_CHECK_CLOSE((double)dropped / m1.GetNumElements(), dropRate, 5.0);
+
+    // a subsequent call uses a fresh stream
+    m1.SetUniformRandomMask(dropRate, scale, rng1);
+    BOOST_CHECK(!m1.IsEqualTo(m4));
+}
+
+BOOST_FIXTURE_TEST_CASE(CPUMatrixUniformRandomBitMask, RandomSeedFixture)
+{
+    const size_t numRows = 70, numCols = 33;
+    const double dropRate = 0.4;
+    const float scale = (float)(1.0 / (1.0 - dropRate));
+    const size_t wordsPerColumn = SMatrix::GetBitMaskWordsPerColumn(numRows);
+    BOOST_CHECK_EQUAL(wordsPerColumn, 3);
+
+    CPURNGHandle rng(CPUDEVICE, 42);
+    std::vector<uint32_t> mask(wordsPerColumn * numCols);
+    SMatrix::SetUniformRandomBitMask(mask.data(), numRows, numCols, dropRate, rng);
+
+    SMatrix input(numRows, numCols);
+    input.SetUniformRandomValue(-1, 1, IncrementCounter());
+
+    SMatrix output;
+    output.AssignElementProductOfBitMask(input, mask.data(), scale, 0);
+    BOOST_CHECK_EQUAL(output.GetNumRows(), numRows);
+    BOOST_CHECK_EQUAL(output.GetNumCols(), numCols);
+
+    size_t dropped = 0;
+    foreach_coord (i, j, output)
+    {
+        bool keep = ((mask[j * wordsPerColumn + i / 32] >> (i % 32)) & 1) != 0;
+        BOOST_CHECK_EQUAL(output(i, j), keep ? scale * input(i, j) : 0.0f);
+        dropped += !keep;
+    }
+    BOOST_CHECK_CLOSE((double)dropped / output.GetNumElements(), dropRate, 10.0);
+
+    // padding bits beyond the last row are cleared
+    for (size_t j = 0; j < numCols; j++)
+        BOOST_CHECK_EQUAL(mask[j * wordsPerColumn + 2] >> (numRows - 64), 0u);
+
+    // accumulation with beta = 1
+    SMatrix accum(output);
+    accum.AssignElementProductOfBitMask(input, mask.data(), scale, 1);
+    SMatrix::Scale(2.0f, output);
+    BOOST_CHECK(accum.IsEqualTo(output, 1e-6f));
+}
+
+BOOST_FIXTURE_TEST_CASE(CPUMatrixBitMaskOfCondition, RandomSeedFixture)
+{
+    const size_t numRows = 45, numCols = 7;
+    const size_t wordsPerColumn = SMatrix::GetBitMaskWordsPerColumn(numRows);
+
+    SMatrix input(numRows, numCols);
+    input.SetUniformRandomValue(-1, 1, IncrementCounter());
+    SMatrix relu(input);
+    relu.InplaceTruncateBottom(0);
+
+    // ReLU: the stashed mask reproduces the derivative computed from the output
+    std::vector<uint32_t> mask(wordsPerColumn * numCols, 0xffffffff);
+    SMatrix::SetBitMaskOfPositive(mask.data(), relu);
+    SMatrix gradient(numRows, numCols);
+    gradient.SetUniformRandomValue(-1, 1, IncrementCounter());
+    SMatrix fromMask;
+    fromMask.AssignElementProductOfBitMask(gradient, mask.data(), 1.0f, 0);
+    foreach_coord (i, j, fromMask)
+        BOOST_CHECK_EQUAL(fromMask(i, j), relu(i, j) > 0 ? gradient(i, j) : 0.0f);
+    for (size_t j = 0; j < numCols; j++)
+        BOOST_CHECK_EQUAL(mask[j * wordsPerColumn + 1] >> (numRows - 32), 0u);
+
+    // Clip: the gradient passes where input and output agree
+    SMatrix clipped(input);
+    clipped.InplaceTruncate(0.5f);
+    SMatrix::SetBitMaskOfEqual(mask.data(), input, clipped);
+    foreach_coord (i, j, input)
+    {
+        bool bit = ((mask[j * wordsPerColumn + i / 32] >> (i % 32)) & 1) != 0;
+        BOOST_CHECK_EQUAL(bit, fabs(input(i, j)) <= 0.5f);
+    }
+
+    SMatrix other(numRows + 1, numCols);
+    BOOST_CHECK_THROW(SMatrix::SetBitMaskOfEqual(mask.data(), input, other), std::exception);
+}
+
+BOOST_FIXTURE_TEST_CASE(CPUMatrixLayerNormalization, RandomSeedFixture)
+{
+    const size_t numRows = 37, numCols = 5;
+    const double epsilon = 1e-5;
+
+    DMatrix input(numRows, numCols), scale(numRows, 1), bias(numRows, 1);
+    input.SetUniformRandomValue(-2, 3, IncrementCounter());
+    scale.SetUniformRandomValue(0.5, 1.5, IncrementCounter());
+    bias.SetUniformRandomValue(-1, 1, IncrementCounter());
+
+    DMatrix output, saveMean, saveInvStdDev;
+    input.LayerNormalizationForward(scale, bias, epsilon, output, saveMean, saveInvStdDev);
+
+    // compare to a two-pass reference
+    for (size_t j = 0; j < numCols; j++)
+    {
+        double mean = 0, var = 0;
+        for (size_t i = 0; i < numRows; i++)
+            mean += input(i, j) / numRows;
+        for (size_t i = 0; i < numRows; i++)
+            var += (input(i, j) - mean) * (input(i, j) - mean) / numRows;
+        BOOST_CHECK_CLOSE(saveMean(0, j), mean, 1e-8);
+        for (size_t i = 0; i < numRows; i++)
+            BOOST_CHECK_CLOSE(output(i, j), scale(i, 0) * (input(i, j) - mean) / sqrt(var + epsilon) + bias(i, 0), 1e-8);
+    }
+
+    // gradients of L = sum(output .* weights), compared to finite differences
+    DMatrix weights(numRows, numCols);
+    weights.SetUniformRandomValue(-1, 1, IncrementCounter());
+    auto loss = [&](const DMatrix& x, const DMatrix& s)
+    {
+        DMatrix y, m, v;
+        x.LayerNormalizationForward(s, bias, epsilon, y, m, v);
+        double sum = 0;
+        foreach_coord (i, j, y)
+            sum += y(i, j) * weights(i, j);
+        return sum;
+    };
+
+    DMatrix inputGrad(numRows, numCols), scaleGrad(numRows, 1);
+    inputGrad.SetValue(0);
+    scaleGrad.SetValue(0);
+    weights.LayerNormalizationBackward(input, inputGrad, scale, saveMean, saveInvStdDev);
+    weights.LayerNormalizationScaleGradient(input, saveMean, saveInvStdDev, scaleGrad);
+
+    const double delta = 1e-6;
+    for (size_t i = 0; i < numRows; i += 6)
+    {
+        DMatrix xp(input), xm(input);
+        xp(i, 2) += delta;
+        xm(i, 2) -= delta;
+        BOOST_CHECK_CLOSE(inputGrad(i, 2), (loss(xp, scale) - loss(xm, scale)) / (2 * delta), 1e-3);
+
+        DMatrix sp(scale), sm(scale);
+        sp(i, 0) += delta;
+        sm(i, 0) -= delta;
+        BOOST_CHECK_CLOSE(scaleGrad(i, 0), (loss(input, sp) - loss(input, sm)) / (2 * delta), 1e-3);
+    }
+}
+
+// reference attention that materializes the full score matrix
+static void ReferenceAttention(const DMatrix& query, const DMatrix& key, const DMatrix& value, DMatrix& out,
+                               size_t dimQK, size_t dimV, size_t numHeads, double scale, bool causal)
+{
+    const size_t numQueries = query.GetNumRows() / (dimQK * numHeads);
+    const size_t numKeys = key.GetNumRows() / (dimQK * numHeads);
+    out.Resize(dimV * numQueries * numHeads, query.GetNumCols());
+    for (size_t j = 0; j < query.GetNumCols(); j++)
+        for (size_t h = 0; h < numHeads; h++)
+            for (size_t i = 0; i < numQueries; i++)
+            {
+                std::vector<double> p(numKeys, 0);
+                double maxScore = -1e300, sum = 0;
+                size_t numVisible = causal ? i + 1 + numKeys - numQueries : numKeys;
+                for (size_t k = 0; k < numVisible; k++)
+                {
+                    for (size_t d = 0; d < dimQK; d++)
+                        p[k] += scale * query(d + dimQK * (i + numQueries * h), j) * key(d + dimQK * (k + numKeys * h), j);
+                    maxScore = std::max(maxScore, p[k]);
+                }
+                for (size_t k = 0; k < numVisible; k++)
+                    sum += p[k] = exp(p[k] - maxScore);
+                for (size_t d = 0; d < dimV; d++)
+                {
+                    double o = 0;
+                    for (size_t k = 0; k < numVisible; k++)
+                        o += p[k] / sum * value(d + dimV * (k + numKeys * h), j);
+                    out(d + dimV * (i + numQueries * h), j) = o;
+                }
+            }
+}
+
+BOOST_FIXTURE_TEST_CASE(CPUMatrixScaledDotProductAttention, RandomSeedFixture)
+{
+    // more keys than one block, so that the online softmax has to rescale
+    const size_t dimQK = 8, dimV = 6, numHeads = 2, numQueries = 70, numKeys = 75, numCols = 2;
+    const double scale = 1 / sqrt((double)dimQK);
+
+    DMatrix query(dimQK * numQueries * numHeads, numCols), key(dimQK * numKeys * numHeads, numCols), value(dimV * numKeys * numHeads, numCols);
+    query.SetUniformRandomValue(-2, 2, IncrementCounter());
+    key.SetUniformRandomValue(-2, 2, IncrementCounter());
+    value.SetUniformRandomValue(-1, 1, IncrementCounter());
+
+    for (bool causal : { false, true })
+    {
+        DMatrix output, logSumExp, expected;
+        DMatrix::ScaledDotProductAttentionForward(query, key, value, output, logSumExp, dimQK, dimV, numHeads, scale, causal);
+        ReferenceAttention(query, key, value, expected, dimQK, dimV, numHeads, scale, causal);
+        BOOST_CHECK(output.IsEqualTo(expected, 1e-10));
+
+        // gradients of L = sum(output .* weights), compared to finite differences
+        DMatrix weights(output.GetNumRows(), numCols);
+        weights.SetUniformRandomValue(-1, 1, IncrementCounter());
+        auto loss = [&](const DMatrix& q, const DMatrix& k, const DMatrix& v)
+        {
+            DMatrix y;
+            ReferenceAttention(q, k, v, y, dimQK, dimV, numHeads, scale, causal);
+            double sum = 0;
+            foreach_coord (i, j, y)
+                sum += y(i, j) * weights(i, j);
+            return sum;
+        };
+
+        DMatrix queryGrad(query.GetNumRows(), numCols), keyGrad(key.GetNumRows(), numCols), valueGrad(value.GetNumRows(), numCols);
+        queryGrad.SetValue(0);
+        keyGrad.SetValue(0);
+        valueGrad.SetValue(0);
+        DMatrix::ScaledDotProductAttentionBackwardQuery(query, key, value, output, weights, logSumExp, queryGrad, dimQK, dimV, numHeads, scale, causal);
+        DMatrix::ScaledDotProductAttentionBackwardKeyValue(query, key, value, output, weights, logSumExp, keyGrad, valueGrad, dimQK, dimV, numHeads, scale, causal);
+
+        const double delta = 1e-6;
+        auto checkGradient = [&](DMatrix& grad, size_t which)
+        {
+            for (size_t i = 0; i < grad.GetNumRows(); i += 97)
+            {
+                DMatrix q(query), k(key), v(value);
+                DMatrix& x = which == 0 ? q : which == 1 ? k : v;
+                x(i, 1) += delta;
+                double lp = loss(q, k, v);
+                x(i, 1) -= 2 * delta;
+                double lm = loss(q, k, v);
+                BOOST_CHECK_SMALL(grad(i, 1) - (lp - lm) / (2 * delta), 1e-6);
+            }
+        };
+        checkGradient(queryGrad, 0);
+        checkGradient(keyGrad, 1);
+        checkGradient(valueGrad, 2);
+    }
+}
+
+// reference CTC that enumerates every alignment of an utterance, i.e. every path through the lattice of
+// (blank, label, blank, ..., blank) positions, and drops the paths visiting a position beyond its delay boundary
+static void ReferenceCTC(const DMatrix& prob, const std::vector<size_t>& phoneSeq, const std::vector<size_t>& phoneBound,
+                         size_t firstCol, size_t numChannels, size_t numFrames, size_t blankTokenId, int delayConstraint,
+                         DMatrix& occupancy, double& logTotal)
+{
+    const size_t phoneNum = phoneSeq.size(); // including the two sentinels
+    std::vector<size_t> path(numFrames);
+    std::vector<double> logPaths;
+    std::vector<std::vector<size_t>> paths;
+    std::function<void(size_t, size_t, double)> extend = [&](size_t t, size_t s, double logProb)
+    {
+        size_t label = phoneSeq[s];
+        size_t bound = phoneBound[std::min(s + 2, phoneNum - 1)];
+        if (delayConstraint != -1 && (int)t > (int)bound + delayConstraint - (label == blankTokenId ? 1 : 0))
+            return;
+        path[t] = s;
+        logProb += prob(label, firstCol + t * numChannels);
+        if (t + 1 == numFrames)
+        {
+            if (s + 3 >= phoneNum) // ends in the last label or the last blank
+            {
+                paths.push_back(path);
+                logPaths.push_back(logProb);
+            }
+            return;
+        }
+        extend(t + 1, s, logProb);
+        if (s + 2 < phoneNum)
+            extend(t + 1, s + 1, logProb);
+        if (s + 3 < phoneNum && label != blankTokenId && phoneSeq[s + 2] != label)
+            extend(t + 1, s + 2, logProb);
+    };
+    extend(0, 1, 0);
+    if (phoneNum > 3)
+        extend(0, 2, 0);
+
+    BOOST_REQUIRE(!paths.empty());
+    double maxLogPath = *std::max_element(logPaths.begin(), logPaths.end()), total = 0;
+    for (double logPath : logPaths)
+        total += exp(logPath - maxLogPath);
+    logTotal = maxLogPath + log(total);
+
+    for (size_t t = 0; t < numFrames; t++)
+        for (size_t i = 0; i < occupancy.GetNumRows(); i++)
+            occupancy(i, firstCol + t * numChannels) = 0;
+    for (size_t p = 0; p < paths.size(); p++)
+        for (size_t t = 0; t < numFrames; t++)
+            occupancy(phoneSeq[paths[p][t]], firstCol + t * numChannels) += exp(logPaths[p] - logTotal);
+}
+
+template <class ElemType>
+static void TestAssignCTCScore(int delayConstraint, double tolerance, unsigned long seed)
+{
+    // two channels of 7 frames: channel 0 holds one utterance, channel 1 holds two, the second one with a repeated label
+    const size_t numLabels = 4, blankTokenId = 3, numChannels = 2, numFrames = 7;
+    const std::vector<size_t> uttToChanInd = { 0, 1, 1 }, uttBeginFrame = { 0, 0, 3 }, uttFrameNum = { 7, 3, 4 };
+    const std::vector<std::vector<size_t>> labels = { { 1, 2 }, { 0 }, { 2, 2 } };
+    const std::vector<std::vector<size_t>> labelFrames = { { 1, 4 }, { 1 }, { 0, 2 } };
+
+    // phone sequences and boundaries as built by GammaCalculation::doCTC
+    std::vector<std::vector<size_t>> phoneSeqs, phoneBounds;
+    std::vector<size_t> uttPhoneNum;
+    size_t maxPhoneNum = 0;
+    for (size_t u = 0; u < labels.size(); u++)
+    {
+        std::vector<size_t> phoneSeq = { SIZE_MAX }, phoneBound = { 0 };
+        for (size_t k = 0; k < labels[u].size(); k++)
+        {
+            phoneSeq.insert(phoneSeq.end(), { blankTokenId, labels[u][k] });
+            phoneBound.insert(phoneBound.end(), { labelFrames[u][k], labelFrames[u][k] });
+        }
+        phoneSeq.insert(phoneSeq.end(), { blankTokenId, SIZE_MAX });
+        phoneBound.insert(phoneBound.end(), { uttFrameNum[u], uttFrameNum[u] });
+        phoneSeqs.push_back(phoneSeq);
+        phoneBounds.push_back(phoneBound);
+        uttPhoneNum.push_back(phoneSeq.size());
+        maxPhoneNum = std::max(maxPhoneNum, phoneSeq.size());
+    }
+
+    CPUMatrix<ElemType> phoneSeqMatrix(maxPhoneNum, labels.size()), phoneBoundMatrix(maxPhoneNum, labels.size());
+    phoneSeqMatrix.SetValue(0);
+    phoneBoundMatrix.SetValue(0);
+    for (size_t u = 0; u < labels.size(); u++)
+        for (size_t j = 0; j < uttPhoneNum[u]; j++)
+        {
+            phoneSeqMatrix(j, u) = (ElemType)phoneSeqs[u][j];
+            phoneBoundMatrix(j, u) = (ElemType)phoneBounds[u][j];
+        }
+
+    // log posteriors
+    DMatrix logits(numLabels, numChannels * numFrames), prob(numLabels, numChannels * numFrames);
+    logits.SetUniformRandomValue(-2, 2, seed);
+    CPUMatrix<ElemType> probElem(numLabels, numChannels * numFrames);
+    for (size_t j = 0; j < prob.GetNumCols(); j++)
+    {
+        double norm = 0;
+        for (size_t i = 0; i < numLabels; i++)
+            norm += exp(logits(i, j));
+        for (size_t i = 0; i < numLabels; i++)
+            probElem(i, j) = (ElemType)(logits(i, j) - log(norm));
+    }
+    foreach_coord (i, j, prob)
+        prob(i, j) = probElem(i, j);
+
+    CPUMatrix<ElemType> ctcScore(numLabels, numChannels * numFrames), alpha, beta, totalScore(1, 1);
+    ctcScore.SetValue((ElemType)LZERO);
+    ctcScore.AssignCTCScore(probElem, alpha, beta, phoneSeqMatrix, phoneBoundMatrix, totalScore, uttToChanInd, uttBeginFrame, uttFrameNum,
+                            uttPhoneNum, numChannels, numFrames, blankTokenId, delayConstraint, /*isColWise=*/true);
+
+    DMatrix expectedScore(numLabels, numChannels * numFrames);
+    double expectedTotal = 0;
+    for (size_t u = 0; u < labels.size(); u++)
+    {
+        double logTotal;
+        ReferenceCTC(prob, phoneSeqs[u], phoneBounds[u], uttBeginFrame[u] * numChannels + uttToChanInd[u], numChannels, uttFrameNum[u],
+                     blankTokenId, delayConstraint, expectedScore, logTotal);
+        expectedTotal -= logTotal;
+    }
+
+    BOOST_CHECK_CLOSE(totalScore(0, 0), expectedTotal, tolerance);
+    foreach_coord (i, j, expectedScore)
+        BOOST_CHECK_SMALL(ctcScore(i, j) - expectedScore(i, j), tolerance / 100);
+}
+
+BOOST_FIXTURE_TEST_CASE(CPUMatrixAssignCTCScore, RandomSeedFixture)
+{
+    for (int delayConstraint : { -1, 1, 0 })
+    {
+        TestAssignCTCScore<double>(delayConstraint, 1e-8, IncrementCounter());
+        TestAssignCTCScore<float>(delayConstraint, 1e-3, IncrementCounter());
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(CPUMatrixHalfConversion, RandomSeedFixture)
+{
+    // the bulk converters must agree with the scalar ones for every non-NaN half value
+    std::vector<unsigned short> bits, roundTrip(0x10000);
+    for (unsigned v = 0; v < 0x10000; v++)
+        if ((v & 0x7c00) != 0x7c00 || (v & 0x3ff) == 0)
+            bits.push_back((unsigned short)v);
+    std::vector<float> bulk(bits.size());
+    ::CNTK::float16ToFloatN(bits.data(), bulk.data(), bits.size());
+    for (size_t i = 0; i < bits.size(); i++)
+    {
+        float scalar;
+        ::CNTK::float16ToFloat(&bits[i], &scalar);
+        BOOST_CHECK_EQUAL(*(unsigned*)&bulk[i], *(unsigned*)&scalar);
+    }
+    ::CNTK::floatToFloat16N(bulk.data(), roundTrip.data(), bits.size());
+    for (size_t i = 0; i < bits.size(); i++)
+        BOOST_CHECK_EQUAL(roundTrip[i], bits[i]);
+}
+
+BOOST_FIXTURE_TEST_CASE(CPUMatrixHalfOperations, RandomSeedFixture)
+{
+    // half results are compared against float computations on the same (half-rounded) values
+    auto toHalf = [](const SMatrix& f)
+    {
+        CPUMatrix<half> h(f.GetNumRows(), f.GetNumCols());
+        foreach_coord (i, j, f)
+            h(i, j) = (half)f(i, j);
+        return h;
+    };
+    auto toFloat = [](const CPUMatrix<half>& h)
+    {
+        SMatrix f(h.GetNumRows(), h.GetNumCols());
+        foreach_coord (i, j, h)
+            f(i, j) = (float)h(i, j);
+        return f;
+    };
+
+    SMatrix x(37, 300);
+    x.SetUniformRandomValue(-1, 1, IncrementCounter());
+    CPUMatrix<half> xh = toHalf(x);
+    x = toFloat(xh);
+
+    BOOST_CHECK_CLOSE((float)xh.SumOfElements(), x.SumOfElements(), 0.2);
+    BOOST_CHECK_CLOSE((float)xh.SumOfAbsElements(), x.SumOfAbsElements(), 0.1);
+    BOOST_CHECK_CLOSE((float)xh.MatrixNorm1(), x.MatrixNorm1(), 0.1);
+    BOOST_CHECK_CLOSE((float)xh.FrobeniusNorm(), x.FrobeniusNorm(), 0.1);
+
+    // row-wise results are sums over 300 columns, so allow for the half rounding of values around 150
+    for (bool isColWise : { true, false })
+    {
+        const float tolerance = isColWise ? 0.02f : 0.1f;
+        CPUMatrix<half> ch;
+        SMatrix c;
+        CPUMatrix<half>::VectorSum(xh, ch, isColWise);
+        SMatrix::VectorSum(x, c, isColWise);
+        BOOST_CHECK(toFloat(ch).IsEqualTo(c, tolerance));
+        xh.VectorNorm1(ch, isColWise);
+        x.VectorNorm1(c, isColWise);
+        BOOST_CHECK(toFloat(ch).IsEqualTo(c, tolerance));
+    }
+
+    CPUMatrix<half>::Scale((half)0.5f, xh);
+    SMatrix::Scale(0.5f, x);
+    BOOST_CHECK(toFloat(xh).IsEqualTo(x, 1e-3f));
+
+    // GEMM: dimensions large enough that the product is computed in several blocks of the inner dimension and column panels
+    const size_t m = 64, k = 20000, n = 150;
+    for (bool transposeA : { false, true })
+        for (bool transposeB : { false, true })
+        {
+            SMatrix a(transposeA ? k : m, transposeA ? m : k), b(transposeB ? n : k, transposeB ? k : n), c(m, n);
+            a.SetUniformRandomValue(-0.1f, 0.1f, IncrementCounter());
+            b.SetUniformRandomValue(-0.1f, 0.1f, IncrementCounter());
+            c.SetUniformRandomValue(-1, 1, IncrementCounter());
+            CPUMatrix<half> ah = toHalf(a), bh = toHalf(b), chalf = toHalf(c);
+            a = toFloat(ah);
+            b = toFloat(bh);
+            c = toFloat(chalf);
+
+            SMatrix::MultiplyAndWeightedAdd(0.5f, a, transposeA, b, transposeB, 2.0f, c);
+            CPUMatrix<half>::MultiplyAndWeightedAdd((half)0.5f, ah, transposeA, bh, transposeB, (half)2.0f, chalf);
+            BOOST_CHECK(toFloat(chalf).IsEqualTo(c, 0.01f));
+        }
+}
+
+BOOST_FIXTURE_TEST_CASE(CPUMatrixRCRFBackwardAndTransitionGradient, RandomSeedFixture)
+{
+    // Reference: evaluate the recursions directly, recomputing the normalizers for every label (O(L^3) per position).
+    const size_t numLabels = 7, numPositions = 6;
+    DMatrix alpha = DMatrix::RandomUniform(numLabels, numPositions, -3, 0, IncrementCounter());
+    DMatrix pairScores = DMatrix::RandomUniform(numLabels, numLabels, -1, 1, IncrementCounter());
+    auto labelAt = [&](size_t t) { return (3 * t + 2) % numLabels; };
+    DMatrix labels(numLabels, numPositions);
+    labels.SetValue(0);
+    for (size_t t = 0; t < numPositions; t++)
+        labels(labelAt(t), t) = 1;
+
+    auto logSum = [](size_t n, const std::function<double(size_t)>& term)
+    {
+        double sum = LZERO;
+        for (size_t i = 0; i < n; i++)
+        {
+            double x = term(i), y = sum;
+            if (x < y)
+                std::swap(x, y);
+            sum = x + log1p(exp(y - x));
+        }
+        return sum;
+    };
+
+    DMatrix betaRef(numLabels, numPositions);
+    for (int t = (int) numPositions - 1; t >= 0; t--)
+    {
+        for (size_t k = 0; k < numLabels; k++)
+        {
+            if (t == numPositions - 1)
+                betaRef(k, t) = alpha(k, t) - logSum(numLabels, [&](size_t j) { return alpha(j, t); });
+            else
+                betaRef(k, t) = logSum(numLabels, [&](size_t j)
+                {
+                    double zeta = logSum(numLabels, [&](size_t m) { return alpha(m, t) + pairScores(j, m); });
+                    return betaRef(j, t + 1) + alpha(k, t) + pairScores(j, k) - zeta;
+                });
+        }
+    }
+
+    DMatrix beta;
+    DMatrix::RCRFBackwardCompute(alpha, beta, labels, pairScores);
+    BOOST_CHECK(beta.IsEqualTo(betaRef, 1e-9));
+
+    DMatrix grdRef(numLabels, numLabels);
+    grdRef.SetValue(0);
+    for (size_t t = 0; t < numPositions; t++)
+    {
+        auto prevAlpha = [&](size_t k) { return t == 0 ? (k == labelAt(0) ? 0 : LZERO) : alpha(k, t - 1); };
+        for (size_t i = 0; i < numLabels; i++)
+        {
+            for (size_t j = 0; j < numLabels; j++)
+            {
+                double zeta = logSum(numLabels, [&](size_t k) { return prevAlpha(k) + pairScores(j, k); });
+                grdRef(j, i) += exp(prevAlpha(i) + pairScores(j, i) - zeta + betaRef(j, t));
+            }
+        }
+        grdRef(labelAt(t), labelAt(t == 0 ? 0 : t - 1)) -= 1;
+    }
+
+    DMatrix grd(numLabels, numLabels);
+    grd.SetValue(0);
+    DMatrix::RCRFTransGrdCompute(labels, alpha, beta, pairScores, grd);
+    BOOST_CHECK(grd.IsEqualTo(grdRef, 1e-9));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }
 } } }
@@ -116,6 +116,103 @@ BOOST_FIXTURE_TEST_CASE(CPUSparseMatrixMultiplyAndAdd, RandomSeedFixture)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(CPUSparseMatrixMultiplyAndAddColumnSlice, RandomSeedFixture)
+{
+    // the sparse matrix is a column slice, whose nonzeros do not start at the beginning of the buffer
+    const size_t m = 100;
+    const size_t n = 50;
+    const size_t startColumn = 15;
+    const size_t numCols = 20;
+
+    DenseMatrix dm0(m, numCols);
+    dm0.SetUniformRandomValue(-1, 1, IncrementCounter());
+
+    DenseMatrix dm1(m, n);
+    dm1.SetUniformRandomValue(-10, 1, IncrementCounter());
+    dm1.InplaceTruncateBottom(0);
+
+    SparseMatrix sm1(MatrixFormat::matrixFormatSparseCSC, m, n, 0);
+    foreach_coord(row, col, dm1)
+    {
+        if (dm1(row, col) != 0)
+        {
+            sm1.SetValue(row, col, dm1(row, col));
+        }
+    }
+
+    DenseMatrix dmMul(m, m);
+    DenseMatrix dm1Slice = dm1.ColumnSlice(startColumn, numCols);
+    DenseMatrix::MultiplyAndAdd(dm0, false, dm1Slice, true, dmMul);
+
+    SparseMatrix smMul(MatrixFormat::matrixFormatSparseBlockCol, m, m, 0);
+    SparseMatrix sm1Slice = sm1.ColumnSlice(startColumn, numCols);
+    SparseMatrix::MultiplyAndAdd(1, dm0, false, sm1Slice, true, smMul);
+
+    foreach_coord(row, col, dmMul)
+    {
+        BOOST_CHECK(abs(smMul(row, col) - dmMul(row, col)) < c_epsilonFloatE4);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(CPUSparseMatrixMultiplyAndWeightedAdd, RandomSeedFixture)
+{
+    // all combinations of dense * sparse and sparse * dense with transposes, compared to the dense product
+    const size_t m = 70, k = 90, n = 40;
+    const double alpha = 0.7, beta = 0.3;
+
+    auto makeSparse = [this](size_t rows, size_t cols, DenseMatrix& dense)
+    {
+        dense.Resize(rows, cols);
+        dense.SetUniformRandomValue(-10, 1, IncrementCounter());
+        dense.InplaceTruncateBottom(0);
+        SparseMatrix sparse(MatrixFormat::matrixFormatSparseCSC, rows, cols, 0);
+        foreach_coord (row, col, dense)
+        {
+            if (dense(row, col) != 0)
+                sparse.SetValue(row, col, dense(row, col));
+        }
+        return sparse;
+    };
+
+    for (bool transposeA : { false, true })
+    {
+        for (bool transposeB : { false, true })
+        {
+            DenseMatrix c0(m, n), expected;
+            c0.SetUniformRandomValue(-1, 1, IncrementCounter());
+
+            // dense * sparse
+            DenseMatrix a(transposeA ? k : m, transposeA ? m : k), bDense;
+            a.SetUniformRandomValue(-1, 1, IncrementCounter());
+            SparseMatrix b = makeSparse(transposeB ? n : k, transposeB ? k : n, bDense);
+            expected = c0;
+            DenseMatrix::MultiplyAndWeightedAdd(alpha, a, transposeA, bDense, transposeB, beta, expected);
+            DenseMatrix c = c0;
+            SparseMatrix::MultiplyAndWeightedAdd(alpha, a, transposeA, b, transposeB, beta, c);
+            BOOST_CHECK(c.IsEqualTo(expected, c_epsilonFloatE4));
+
+            // sparse * dense
+            DenseMatrix aDense, bd(transposeB ? n : k, transposeB ? k : n);
+            SparseMatrix as = makeSparse(transposeA ? k : m, transposeA ? m : k, aDense);
+            bd.SetUniformRandomValue(-1, 1, IncrementCounter());
+            expected = c0;
+            DenseMatrix::MultiplyAndWeightedAdd(alpha, aDense, transposeA, bd, transposeB, beta, expected);
+            c = c0;
+            SparseMatrix::MultiplyAndWeightedAdd(alpha, as, transposeA, bd, transposeB, beta, c);
+            BOOST_CHECK(c.IsEqualTo(expected, c_epsilonFloatE4));
+        }
+    }
+
+    // a column slice of the sparse matrix, whose nonzeros do not start at the beginning of the buffer
+    DenseMatrix a(m, k), bDense, expected(m, 10), c(m, 10);
+    a.SetUniformRandomValue(-1, 1, IncrementCounter());
+    SparseMatrix b = makeSparse(k, n, bDense);
+    DenseMatrix bSliceDense = bDense.ColumnSlice(15, 10);
+    DenseMatrix::MultiplyAndWeightedAdd(alpha, a, false, bSliceDense, false, 0, expected);
+    SparseMatrix::MultiplyAndWeightedAdd(alpha, a, false, b.ColumnSlice(15, 10), false, 0, c);
+    BOOST_CHECK(c.IsEqualTo(expected, c_epsilonFloatE4));
+}
+
 BOOST_FIXTURE_TEST_CASE(CPUSparseMatrixDoGatherColumnsOf, RandomSeedFixture)
 {
     const size_t m = 100;
@@ -195,6 +292,39 @@ BOOST_FIXTURE_TEST_CASE(CPUSparseMatrixOneHot, RandomSeedFixture)
     BOOST_CHECK(sm3(4, 3) == 1);
 }
 
+BOOST_FIXTURE_TEST_CASE(CPUSparseMatrixSBCFormatRoundTrip, RandomSeedFixture)
+{
+    const size_t m = 3;
+    const size_t n = 10;
+
+    std::vector<size_t> blockIds = { 7, 2, 5 };
+    std::vector<double> values(m * blockIds.size());
+    for (size_t i = 0; i < values.size(); i++)
+        values[i] = (double)i + 1;
+
+    SparseMatrix sm(MatrixFormat::matrixFormatSparseBlockCol, m, n, 0);
+    sm.SetMatrixFromSBCFormat(blockIds.data(), values.data(), blockIds.size(), m, n);
+    BOOST_CHECK(sm(1, 7) == 2);
+    BOOST_CHECK(sm(0, 5) == 7);
+    BOOST_CHECK(sm(0, 0) == 0);
+
+    std::vector<size_t> blockIds2;
+    std::vector<double> values2;
+    sm.GetSBCFormat(blockIds2, values2);
+    BOOST_CHECK(blockIds2 == blockIds);
+    BOOST_CHECK(values2 == values);
+}
+
+BOOST_FIXTURE_TEST_CASE(CPUSparseMatrixHalfSumOfAbsElements, RandomSeedFixture)
+{
+    std::vector<size_t> blockIds = { 4, 1 };
+    std::vector<half> values = { (half)1.5f, (half)-2.0f, (half)0.25f, (half)-0.75f };
+
+    CPUSparseMatrix<half> sm(MatrixFormat::matrixFormatSparseBlockCol, 2, 6, 0);
+    sm.SetMatrixFromSBCFormat(blockIds.data(), values.data(), blockIds.size(), 2, 6);
+    BOOST_CHECK_EQUAL((float)sm.SumOfAbsElements(), 4.5f);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }
 } } }
@@ -283,6 +283,50 @@ BOOST_AUTO_TEST_CASE(ConvolutionForward)
     }
 }
 
+BOOST_AUTO_TEST_CASE(BinaryConvolutionForward)
+{
+    std::mt19937 rng(0);
+    boost::random::uniform_int_distribution<> batchSizeG(1, 8);
+    boost::random::normal_distribution<float> nd;
+    auto sign = [](float v) { return v > 0 ? 1.0f : -1.0f; };
+
+    int deviceId = -1;
+    for (const auto& g : GenerateConvTestConfigs())
+    {
+        auto baseEng = ConvEng::Create(g, deviceId, ImageLayoutKind::CHW, 0, PoolKind::None, ConvolutionEngineKind::Reference);
+        auto testEng = ConvEng::Create(g, deviceId, ImageLayoutKind::CHW, 0, PoolKind::None, ConvolutionEngineKind::Binary);
+
+        size_t n = batchSizeG(rng);
+        vec buf(g->InputShape().GetNumElements() * n);
+        std::generate(begin(buf), end(buf), [&] { return nd(rng); });
+        SingleMatrix in(g->InputShape().GetNumElements(), n, buf.data(), deviceId, matrixFlagNormal);
+        std::transform(begin(buf), end(buf), begin(buf), sign);
+        SingleMatrix inB(g->InputShape().GetNumElements(), n, buf.data(), deviceId, matrixFlagNormal);
+
+        size_t mapCount = g->GetMapCount(g->InputShape().GetRank() - 1);
+        buf.resize(g->KernelShape().GetNumElements() * mapCount);
+        std::generate(begin(buf), end(buf), [&] { return nd(rng); });
+        SingleMatrix kernel(mapCount, g->KernelShape().GetNumElements(), buf.data(), deviceId, matrixFlagNormal);
+        std::transform(begin(buf), end(buf), begin(buf), sign);
+        SingleMatrix kernelB(mapCount, g->KernelShape().GetNumElements(), buf.data(), deviceId, matrixFlagNormal);
+
+        size_t crowOut = g->OutputShape().GetNumElements();
+        SingleMatrix out(crowOut, n, deviceId);
+        SingleMatrix outB(crowOut, n, deviceId);
+        SingleMatrix workspace(deviceId);
+        SingleMatrix workspaceB(deviceId);
+
+        // The binary engine must match the reference convolution of the binarized values exactly.
+        testEng->Forward(in, kernel, out, workspace);
+        baseEng->Forward(inB, kernelB, outB, workspaceB);
+
+        std::stringstream tmsg;
+        tmsg << "Geometry: " << (std::string)(*g) << ", Batch: " << n;
+        std::string emsg;
+        BOOST_REQUIRE_MESSAGE(CheckEqual(out, outB, emsg, 0.0f, 0.0f), "out are not equal, " << tmsg.str() << ". " << emsg);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(ConvolutionBackwardData)
 {
     std::mt19937 rng(0);
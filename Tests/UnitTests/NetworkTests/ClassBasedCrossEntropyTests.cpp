@@ -0,0 +1,203 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+
+#include "../../../Source/ComputationNetworkLib/TrainingNodes.h"
+#include <cmath>
+#include <memory>
+
+using namespace Microsoft::MSR::CNTK;
+using namespace std;
+
+namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
+
+// We perform test on CPU.
+const DEVICEID_TYPE c_deviceId = CPUDEVICE;
+
+// Input node with a given value, with or without a minibatch layout.
+template <class ElemType>
+class ClassBasedCrossEntropyInputNode : public ComputationNode<ElemType>
+{
+public:
+    typedef ComputationNode<ElemType> Base;
+    UsingComputationNodeMembersBoilerplate;
+    static const std::wstring TypeName() { return L"ClassBasedCrossEntropyInput"; }
+
+    ClassBasedCrossEntropyInputNode(DEVICEID_TYPE deviceId, const wstring& name)
+        : Base(deviceId, name)
+    {
+    }
+
+    ClassBasedCrossEntropyInputNode(const MBLayoutPtr& pMBLayout, size_t numRows, size_t numCols, const vector<ElemType>& data)
+        : Base(c_deviceId, L"ClassBasedCrossEntropyInput")
+    {
+        if (pMBLayout)
+        {
+            this->LinkToMBLayout(pMBLayout);
+            this->SetDims(TensorShape(numRows), true);
+        }
+        else
+            this->SetDims(TensorShape(numRows, numCols), false);
+        this->CreateValueMatrixIfNull();
+        this->Value().SetValue(numRows, numCols, c_deviceId, const_cast<ElemType*>(data.data()));
+        this->CreateGradientMatrixIfNull();
+        this->Gradient().Resize(numRows, numCols);
+        this->Gradient().SetValue(0);
+    }
+
+    virtual void /*ComputationNode::*/ ForwardProp(const FrameRange&) override {}
+    virtual void /*ComputationNode::*/ BackpropTo(const size_t, const FrameRange&) override {}
+
+    Matrix<ElemType>& GetGradient() { return this->Gradient(); }
+};
+
+// Extends the node to provide access to protected members.
+template <class ElemType>
+class ClassBasedCrossEntropyWithSoftmaxNodeTest : public ClassBasedCrossEntropyWithSoftmaxNode<ElemType>
+{
+public:
+    ClassBasedCrossEntropyWithSoftmaxNodeTest()
+        : ClassBasedCrossEntropyWithSoftmaxNode<ElemType>(c_deviceId, L"ClassBasedCrossEntropyWithSoftmaxNodeTest")
+    {
+    }
+
+    // forward and backprop to all inputs but the labels, with a root gradient of 1
+    void ForwardBackwardPass(const FrameRange& fr)
+    {
+        this->CreateValueMatrixIfNull();
+        this->Value().Resize(1, 1);
+        this->CreateGradientMatrixIfNull();
+        this->Gradient().Resize(1, 1);
+        this->Gradient().SetValue(1);
+
+        this->ForwardProp(fr);
+        for (size_t inputIndex = 1; inputIndex < 4; inputIndex++)
+            this->BackpropTo(inputIndex, fr);
+    }
+};
+
+template <class ElemType>
+void CheckClose(const Matrix<ElemType>& actual, const vector<double>& expected, const char* what)
+{
+    BOOST_REQUIRE_EQUAL(actual.GetNumElements(), expected.size());
+    for (size_t i = 0; i < expected.size(); i++)
+        BOOST_CHECK_MESSAGE(fabs(actual.Data()[i] - expected[i]) <= 1e-4 * max(1.0, fabs(expected[i])),
+                            what << "[" << i << "] is " << actual.Data()[i] << ", expected " << expected[i]);
+}
+
+// Compare the criterion and the gradients of its three inputs with a token-by-token computation,
+// which is how the node used to compute them, on a minibatch with gaps and several classes.
+template <class ElemType>
+void ClassBasedCrossEntropyWithSoftmaxTestImpl()
+{
+    const size_t numParallelSequences = 3;
+    const size_t numTimeSteps = 5;
+    const size_t numCols = numParallelSequences * numTimeSteps;
+    const size_t hiddenDim = 4;
+    const size_t numClasses = 3;
+    const size_t classBegin[numClasses + 1] = { 0, 2, 5, 7 }; // classes of 2, 3 and 2 words
+
+    auto pMBLayout = make_shared<MBLayout>(numParallelSequences, numTimeSteps, L"X");
+    pMBLayout->AddSequence(0, 0, 0, 5);
+    pMBLayout->AddSequence(1, 1, 0, 3);
+    pMBLayout->AddGap(1, 3, 5);
+    pMBLayout->AddSequence(2, 2, 1, 4);
+    pMBLayout->AddGap(2, 0, 1);
+    pMBLayout->AddGap(2, 4, 5);
+
+    // labels: word, class, begin and end of the class; all zero in the gaps
+    const size_t words[numCols] = { 3, 1, 0, 6, 4, 0, 1, 2, 5, 2, 0, 3, 4, 0, 0 };
+    vector<ElemType> labelData(4 * numCols, 0);
+    for (size_t j = 0; j < numCols; j++)
+    {
+        if (pMBLayout->IsGap(FrameRange(pMBLayout, j / numParallelSequences).Sequence(j % numParallelSequences)))
+            continue;
+        size_t c = 0;
+        while (words[j] >= classBegin[c + 1])
+            c++;
+        labelData[4 * j + 0] = (ElemType)words[j];
+        labelData[4 * j + 1] = (ElemType)c;
+        labelData[4 * j + 2] = (ElemType)classBegin[c];
+        labelData[4 * j + 3] = (ElemType)classBegin[c + 1];
+    }
+
+    srand(1);
+    auto randomData = [](size_t size) {
+        vector<ElemType> data(size);
+        for (auto& value : data)
+            value = (ElemType)rand() / RAND_MAX - (ElemType)0.5;
+        return data;
+    };
+    vector<ElemType> hiddenData = randomData(hiddenDim * numCols);
+    vector<ElemType> weightData = randomData(hiddenDim * classBegin[numClasses]);
+    vector<ElemType> classData = randomData(numClasses * numCols);
+
+    auto labels = make_shared<ClassBasedCrossEntropyInputNode<ElemType>>(pMBLayout, 4, numCols, labelData);
+    auto hidden = make_shared<ClassBasedCrossEntropyInputNode<ElemType>>(pMBLayout, hiddenDim, numCols, hiddenData);
+    auto weights = make_shared<ClassBasedCrossEntropyInputNode<ElemType>>(nullptr, hiddenDim, classBegin[numClasses], weightData);
+    auto classes = make_shared<ClassBasedCrossEntropyInputNode<ElemType>>(pMBLayout, numClasses, numCols, classData);
+
+    auto node = make_shared<ClassBasedCrossEntropyWithSoftmaxNodeTest<ElemType>>();
+    node->AttachInputs({ labels, hidden, weights, classes });
+    node->Validate(true);
+    node->ForwardBackwardPass(FrameRange(pMBLayout));
+
+    // reference, token by token
+    double expectedLoss = 0;
+    vector<double> expectedHiddenGradient(hiddenData.size(), 0), expectedWeightGradient(weightData.size(), 0), expectedClassGradient(classData.size(), 0);
+    for (size_t j = 0; j < numCols; j++)
+    {
+        if (pMBLayout->IsGap(FrameRange(pMBLayout, j / numParallelSequences).Sequence(j % numParallelSequences)))
+            continue;
+        const size_t y = (size_t)labelData[4 * j + 0], c = (size_t)labelData[4 * j + 1];
+        const size_t lftBnd = (size_t)labelData[4 * j + 2], nbrWrd = (size_t)labelData[4 * j + 3] - lftBnd;
+
+        // class posterior
+        double classNorm = 0;
+        for (size_t k = 0; k < numClasses; k++)
+            classNorm += exp((double)classData[numClasses * j + k]);
+        expectedLoss -= classData[numClasses * j + c] - log(classNorm);
+        for (size_t k = 0; k < numClasses; k++)
+            expectedClassGradient[numClasses * j + k] = exp((double)classData[numClasses * j + k]) / classNorm - (k == c ? 1 : 0);
+
+        // word posterior within the class
+        vector<double> z(nbrWrd, 0);
+        double wordNorm = 0;
+        for (size_t k = 0; k < nbrWrd; k++)
+        {
+            for (size_t h = 0; h < hiddenDim; h++)
+                z[k] += (double)weightData[hiddenDim * (lftBnd + k) + h] * hiddenData[hiddenDim * j + h];
+            wordNorm += exp(z[k]);
+        }
+        expectedLoss -= z[y - lftBnd] - log(wordNorm);
+        for (size_t k = 0; k < nbrWrd; k++)
+        {
+            double dz = exp(z[k]) / wordNorm - (k == y - lftBnd ? 1 : 0);
+            for (size_t h = 0; h < hiddenDim; h++)
+            {
+                expectedHiddenGradient[hiddenDim * j + h] += weightData[hiddenDim * (lftBnd + k) + h] * dz;
+                expectedWeightGradient[hiddenDim * (lftBnd + k) + h] += hiddenData[hiddenDim * j + h] * dz;
+            }
+        }
+    }
+
+    CheckClose(node->Value(), { expectedLoss }, "criterion");
+    CheckClose(hidden->GetGradient(), expectedHiddenGradient, "gradient to the input");
+    CheckClose(weights->GetGradient(), expectedWeightGradient, "gradient to the weights");
+    CheckClose(classes->GetGradient(), expectedClassGradient, "gradient to the class log posteriors");
+}
+
+BOOST_AUTO_TEST_SUITE(ClassBasedCrossEntropyTests)
+
+BOOST_AUTO_TEST_CASE(ClassBasedCrossEntropyWithSoftmaxMatchesPerTokenComputation)
+{
+    ClassBasedCrossEntropyWithSoftmaxTestImpl<float>();
+    ClassBasedCrossEntropyWithSoftmaxTestImpl<double>();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} } } }
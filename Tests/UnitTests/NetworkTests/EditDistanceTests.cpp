@@ -8,6 +8,55 @@
 using namespace Microsoft::MSR::CNTK;
 namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
 
+// Number of edits on the best path of the weighted edit distance, from the full O(nm) DP with the tie-breaking
+// of EditDistanceErrorNode (match, then substitution, deletion, insertion)
+static size_t FullDPNumEdits(const vector<float>& first, const vector<float>& second, float subPen, float delPen, float insPen)
+{
+    vector<vector<float>> grid(first.size() + 1, vector<float>(second.size() + 1));
+    vector<vector<size_t>> edits(first.size() + 1, vector<size_t>(second.size() + 1));
+    for (size_t i = 0; i <= first.size(); i++)
+    {
+        grid[i][0] = i * delPen;
+        edits[i][0] = i;
+    }
+    for (size_t j = 0; j <= second.size(); j++)
+    {
+        grid[0][j] = j * insPen;
+        edits[0][j] = j;
+    }
+    for (size_t i = 1; i <= first.size(); i++)
+    {
+        for (size_t j = 1; j <= second.size(); j++)
+        {
+            if (first[i - 1] == second[j - 1])
+            {
+                grid[i][j] = grid[i - 1][j - 1];
+                edits[i][j] = edits[i - 1][j - 1];
+                continue;
+            }
+            float del = grid[i - 1][j] + delPen;
+            float ins = grid[i][j - 1] + insPen;
+            float sub = grid[i - 1][j - 1] + subPen;
+            if (sub <= del && sub <= ins)
+            {
+                grid[i][j] = sub;
+                edits[i][j] = edits[i - 1][j - 1] + 1;
+            }
+            else if (del < ins)
+            {
+                grid[i][j] = del;
+                edits[i][j] = edits[i - 1][j] + 1;
+            }
+            else
+            {
+                grid[i][j] = ins;
+                edits[i][j] = edits[i][j - 1] + 1;
+            }
+        }
+    }
+    return edits[first.size()][second.size()];
+}
+
 BOOST_AUTO_TEST_SUITE(EditDistanceTests)
 
 BOOST_AUTO_TEST_CASE(ComputeEditDistanceErrorTest)
@@ -44,6 +93,88 @@ BOOST_AUTO_TEST_CASE(ComputeEditDistanceErrorTest)
     assert((int)ed == 1);
 }
 
+BOOST_AUTO_TEST_CASE(ComputeEditDistanceErrorParallelSequencesTest)
+{
+    // two parallel sequences longer than a machine word, the second input has 3 and 5 substituted samples
+    Matrix<float> firstSeq(CPUDEVICE);
+    Matrix<float> secondSeq(CPUDEVICE);
+    vector<size_t> tokensToIgnore;
+    size_t seqSize = 150;
+    firstSeq.Resize(1, 2 * seqSize);
+    secondSeq.Resize(1, 2 * seqSize);
+    for (size_t t = 0; t < seqSize; t++)
+    {
+        for (size_t s = 0; s < 2; s++)
+        {
+            firstSeq(0, t * 2 + s) = (float)t;
+            secondSeq(0, t * 2 + s) = (float)t;
+        }
+    }
+    for (size_t t : { 0, 70, 149 })
+        secondSeq(0, t * 2) = (float)(1000 + t);
+    for (size_t t : { 10, 63, 64, 65, 128 })
+        secondSeq(0, t * 2 + 1) = (float)(1000 + t);
+
+    MBLayoutPtr pMBLayout = make_shared<MBLayout>(2, seqSize, L"X");
+    pMBLayout->AddSequence(0, 0, 0, seqSize);
+    pMBLayout->AddSequence(1, 1, 0, seqSize);
+    unique_ptr<EditDistanceErrorNode<float>> pEDNode(new EditDistanceErrorNode<float>(-1, L"ednode"));
+
+    // equal penalties
+    float ed = pEDNode->ComputeEditDistanceError(firstSeq, secondSeq, pMBLayout, 1, 1, 1, false, tokensToIgnore);
+    BOOST_CHECK_EQUAL(ed, 8);
+
+    // substitutions are still cheapest
+    ed = pEDNode->ComputeEditDistanceError(firstSeq, secondSeq, pMBLayout, 1, 2, 2, false, tokensToIgnore);
+    BOOST_CHECK_EQUAL(ed, 8);
+
+    // a deletion and an insertion are cheaper than a substitution
+    ed = pEDNode->ComputeEditDistanceError(firstSeq, secondSeq, pMBLayout, 3, 1, 1, false, tokensToIgnore);
+    BOOST_CHECK_EQUAL(ed, 16);
+}
+
+BOOST_AUTO_TEST_CASE(ComputeEditDistanceErrorLongInsertionRunTest)
+{
+    // the second input inserts a run of 20 samples at the front and drops the last 20, so the best path leaves
+    // the initial band of 16 diagonals and the band has to be widened; swapped, the runs become deletions and insertions
+    const size_t seqSize = 60;
+    const size_t runLength = 20;
+    vector<float> first(seqSize), second(seqSize);
+    for (size_t t = 0; t < seqSize; t++)
+    {
+        first[t] = (float)t;
+        second[t] = t < runLength ? (float)(100 + t) : first[t - runLength];
+    }
+    // a few substitutions outside the runs
+    for (size_t t : { 25, 40, 41 })
+        second[t] = (float)(200 + t);
+
+    Matrix<float> firstSeq(CPUDEVICE);
+    Matrix<float> secondSeq(CPUDEVICE);
+    firstSeq.Resize(1, seqSize);
+    secondSeq.Resize(1, seqSize);
+    MBLayoutPtr pMBLayout = make_shared<MBLayout>(1, seqSize, L"X");
+    pMBLayout->AddSequence(0, 0, 0, seqSize);
+    unique_ptr<EditDistanceErrorNode<float>> pEDNode(new EditDistanceErrorNode<float>(-1, L"ednode"));
+    vector<size_t> tokensToIgnore;
+
+    for (bool swapped : { false, true })
+    {
+        const auto& a = swapped ? second : first;
+        const auto& b = swapped ? first : second;
+        for (size_t t = 0; t < seqSize; t++)
+        {
+            firstSeq(0, t) = a[t];
+            secondSeq(0, t) = b[t];
+        }
+        for (auto penalties : vector<vector<float>>{ { 3, 1, 1 }, { 1.5f, 1, 1 }, { 2, 1, 0.5f }, { 4, 0.5f, 2 } })
+        {
+            float ed = pEDNode->ComputeEditDistanceError(firstSeq, secondSeq, pMBLayout, penalties[0], penalties[1], penalties[2], false, tokensToIgnore);
+            BOOST_CHECK_EQUAL(ed, (float)FullDPNumEdits(a, b, penalties[0], penalties[1], penalties[2]));
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } } } }
\ No newline at end of file
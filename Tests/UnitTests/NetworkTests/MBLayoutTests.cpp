@@ -0,0 +1,100 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+
+#include "stdafx.h"
+#include "Sequences.h"
+#include "BestGpu.h"
+
+using namespace Microsoft::MSR::CNTK;
+using namespace std;
+
+namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
+
+// Builds a layout of 2 parallel sequences and 4 time steps. Sequence 0 fills its slot,
+// sequence 1 spans [1, gapBegin) and is followed by a gap up to the end.
+static MBLayoutPtr CreateLayout(UniqueSequenceId firstId, size_t gapBegin)
+{
+    auto pMBLayout = make_shared<MBLayout>(2, 4, L"X");
+    pMBLayout->AddSequence(firstId, 0, 0, 4);
+    pMBLayout->AddGap(1, 0, 1);
+    pMBLayout->AddSequence(firstId + 1, 1, 1, gapBegin);
+    pMBLayout->AddGap(1, gapBegin, 4);
+    return pMBLayout;
+}
+
+static void CheckMask(const MBLayoutPtr& pMBLayout, const Matrix<char>& mask)
+{
+    BOOST_REQUIRE_EQUAL(mask.GetNumElements(), 8);
+    std::unique_ptr<char[]> values(mask.CopyToArray()); // mask may live on the GPU
+    for (size_t t = 0; t < 4; t++)
+    {
+        for (size_t s = 0; s < 2; s++)
+        {
+            bool isGap = pMBLayout->IsGap(FrameRange(pMBLayout, t).Sequence(s));
+            BOOST_CHECK_EQUAL(values[t * 2 + s], isGap ? 0 : 1);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE(MBLayoutTests)
+
+BOOST_AUTO_TEST_CASE(ColumnsValidityMaskIsSharedByEqualGapStructures)
+{
+    // same gaps, different sequence ids
+    auto layout1 = CreateLayout(0, 3);
+    auto layout2 = CreateLayout(7, 3);
+    // different gaps
+    auto layout3 = CreateLayout(0, 2);
+
+    const auto& mask1 = layout1->GetColumnsValidityMask(CPUDEVICE);
+    const auto& mask2 = layout2->GetColumnsValidityMask(CPUDEVICE);
+    const auto& mask3 = layout3->GetColumnsValidityMask(CPUDEVICE);
+
+    BOOST_CHECK_EQUAL(&mask1, &mask2);
+    BOOST_CHECK_NE(&mask1, &mask3);
+    CheckMask(layout1, mask1);
+    CheckMask(layout3, mask3);
+
+    // copies share the mask of the original
+    auto copy = make_shared<MBLayout>();
+    copy->CopyFrom(layout3);
+    BOOST_CHECK_EQUAL(&copy->GetColumnsValidityMask(CPUDEVICE), &mask3);
+}
+
+#ifndef CPUONLY
+BOOST_AUTO_TEST_CASE(ColumnsValidityMaskIsSharedOnGpu)
+{
+    if (GetAllGpusData().empty())
+    {
+        BOOST_TEST_MESSAGE("No GPU available, skipping.");
+        return;
+    }
+    const DEVICEID_TYPE deviceId = 0;
+
+    auto layout1 = CreateLayout(0, 3);
+    auto layout2 = CreateLayout(7, 3);
+    auto layout3 = CreateLayout(0, 2);
+
+    const auto& mask1 = layout1->GetColumnsValidityMask(deviceId);
+    const auto& mask2 = layout2->GetColumnsValidityMask(deviceId);
+    const auto& mask3 = layout3->GetColumnsValidityMask(deviceId);
+
+    BOOST_CHECK_EQUAL(mask1.GetDeviceId(), deviceId);
+    BOOST_CHECK_EQUAL(&mask1, &mask2);
+    BOOST_CHECK_NE(&mask1, &mask3);
+
+    // the CPU mask of the same gap structure is a different matrix
+    auto layout4 = CreateLayout(3, 3);
+    const auto& cpuMask = layout4->GetColumnsValidityMask(CPUDEVICE);
+    BOOST_CHECK_NE(&cpuMask, &mask1);
+    CheckMask(layout4, cpuMask);
+    CheckMask(layout1, mask1);
+    CheckMask(layout3, mask3);
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} } } }
@@ -0,0 +1,45 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+#include "stdafx.h"
+#include "ComputationNetwork.h"
+#include "ComputationNetworkBuilder.h"
+
+using namespace Microsoft::MSR::CNTK;
+
+namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
+
+BOOST_AUTO_TEST_SUITE(NetworkValidationTests)
+
+// A parameter shared by two nodes gets its dimensions inferred by the one inside a recurrent loop,
+// which can only do so once the loop has been validated. The other node precedes the loop in evaluation
+// order (roots are ordered by name), so it has been validated by then, and must be revisited before the
+// final validation pass.
+BOOST_AUTO_TEST_CASE(SharedParameterInferredInsideRecurrentLoop)
+{
+    const size_t dim = 3;
+    auto net = make_shared<ComputationNetwork>(CPUDEVICE);
+    ComputationNetworkBuilder<float> builder(*net);
+
+    auto features = builder.CreateInputNode(L"features", dim);
+    auto weights = builder.CreateLearnableParameter(L"W", dim, 0); // number of columns is inferred
+    auto negatedWeights = builder.Negate(weights, L"negatedW");
+    auto pastValue = builder.PastValue(nullptr, 0.1f, 0, 1, L"pastValue"); // dimension is inferred
+    auto hidden = builder.Plus(builder.Times(weights, pastValue, 1, L"recurrence"), features, L"recurrentOutput");
+    pastValue->AttachInputs({ hidden });
+
+    net->AddToNodeGroup(L"feature", features);
+    net->AddToNodeGroup(L"output", negatedWeights);
+    net->AddToNodeGroup(L"output", hidden);
+
+    BOOST_REQUIRE_NO_THROW(net->CompileNetwork());
+    BOOST_CHECK(weights->GetSampleLayout() == TensorShape(dim, dim));
+    BOOST_CHECK(negatedWeights->GetSampleLayout() == TensorShape(dim, dim));
+    BOOST_CHECK(pastValue->GetSampleLayout() == TensorShape(dim));
+    BOOST_CHECK(hidden->GetSampleLayout() == TensorShape(dim));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}}}}
@@ -0,0 +1,107 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE.md file in the project root for full license information.
+//
+#include "stdafx.h"
+#include "../../../Source/SGDLib/SparseGradientMerge.h"
+
+using namespace Microsoft::MSR::CNTK;
+using namespace std;
+
+namespace Microsoft { namespace MSR { namespace CNTK { namespace Test {
+
+const size_t numRows = 2;
+const size_t numCols = 10;
+
+// The non-zero columns of a worker's gradient
+struct WorkerColumns
+{
+    vector<size_t> columnIds;
+    vector<float> values;
+};
+
+// Column 1 is held by two workers, worker 1 holds no columns
+static vector<WorkerColumns> CreateWorkers()
+{
+    return {
+        { { 5, 1 }, { 1, 2, 3, 4 } },
+        { {}, {} },
+        { { 1, 7, 3 }, { 10, 20, 30, 40, 50, 60 } },
+    };
+}
+
+static void CheckMerged(const vector<size_t>& mergedColumnIds, const vector<float>& mergedValues)
+{
+    const vector<size_t> expectedColumnIds = { 1, 3, 5, 7 };
+    const vector<float> expectedValues = { 13, 24, 50, 60, 1, 2, 30, 40 };
+    BOOST_CHECK_EQUAL_COLLECTIONS(mergedColumnIds.begin(), mergedColumnIds.end(), expectedColumnIds.begin(), expectedColumnIds.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(mergedValues.begin(), mergedValues.end(), expectedValues.begin(), expectedValues.end());
+}
+
+BOOST_AUTO_TEST_SUITE(SparseGradientMergeTests)
+
+BOOST_AUTO_TEST_CASE(GatheredColumnsAreSummed)
+{
+    auto workers = CreateWorkers();
+
+    // lay the lists out as the allgather does, padded to the largest number of columns
+    const size_t maxBlocks = 3;
+    vector<size_t> numBlocksPerProc;
+    vector<size_t> allColumnIds;
+    vector<float> allValues;
+    for (auto& worker : workers)
+    {
+        numBlocksPerProc.push_back(worker.columnIds.size());
+        worker.columnIds.resize(maxBlocks, SIZE_MAX);
+        worker.values.resize(maxBlocks * numRows, 0);
+        allColumnIds.insert(allColumnIds.end(), worker.columnIds.begin(), worker.columnIds.end());
+        allValues.insert(allValues.end(), worker.values.begin(), worker.values.end());
+    }
+
+    vector<size_t> mergedColumnIds;
+    vector<float> mergedValues;
+    MergeGatheredBlockColumns(numBlocksPerProc, maxBlocks, numRows, allColumnIds, allValues, mergedColumnIds, mergedValues);
+    CheckMerged(mergedColumnIds, mergedValues);
+}
+
+BOOST_AUTO_TEST_CASE(DenseFallbackIsSummedInSlices)
+{
+    auto workers = CreateWorkers();
+
+    // Slice buffers of at most 1 (still one column), 7 (two columns) and all columns
+    for (size_t maxSliceElements : { 1, 7, 1000 })
+    {
+        size_t numSlices = 0;
+        auto allReduce = [&](vector<float>& slice, size_t firstCol, size_t endCol)
+        {
+            BOOST_CHECK_LE(slice.size(), max(maxSliceElements, numRows + 1));
+            vector<float> otherSlice;
+            for (size_t p = 1; p < workers.size(); p++)
+            {
+                ScatterBlockColumns(workers[p].columnIds, workers[p].values, numRows, firstCol, endCol, otherSlice);
+                for (size_t i = 0; i < slice.size(); i++)
+                    slice[i] += otherSlice[i];
+            }
+            numSlices++;
+        };
+
+        vector<size_t> mergedColumnIds;
+        vector<float> mergedValues;
+        MergeBlockColumnsDensely(workers[0].columnIds, workers[0].values, numRows, numCols, maxSliceElements, allReduce, mergedColumnIds, mergedValues);
+        CheckMerged(mergedColumnIds, mergedValues);
+        BOOST_CHECK_EQUAL(numSlices, maxSliceElements == 1 ? numCols : maxSliceElements == 7 ? numCols / 2 : 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(GatherThreshold)
+{
+    // A 3 x 16 gradient, a quarter of which is 12 elements: the gathered lists take numProc * maxBlocks * (3 + 1) elements
+    BOOST_CHECK(ShouldGatherSparseGradient(1, 0, 3, 16));
+    BOOST_CHECK(ShouldGatherSparseGradient(1, 3, 3, 16));
+    BOOST_CHECK(!ShouldGatherSparseGradient(1, 4, 3, 16));
+    BOOST_CHECK(!ShouldGatherSparseGradient(4, 1, 3, 16));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} } } }
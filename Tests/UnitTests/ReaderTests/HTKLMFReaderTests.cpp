@@ -5,6 +5,8 @@
 #include "stdafx.h"
 #include "Common/ReaderTestHelper.h"
 #include "CPUMatrix.h"
+#include "../../../Source/Readers/HTKDeserializers/MLFDeserializer.h"
+#include <random>
 
 using namespace Microsoft::MSR::CNTK;
 
@@ -846,6 +848,97 @@ BOOST_AUTO_TEST_CASE(HTKIVectorBptt)
 
 BOOST_AUTO_TEST_SUITE_END()
 
+// Class ids of all frames of a chunk, decoded the way the MLF chunks used to keep them:
+// a dense vector with frames not covered by the ranges of their utterance set to class 0.
+vector<::CNTK::ClassIdType> DenseClassIds(const vector<vector<::CNTK::MLFFrameRange>>& utterances, const vector<uint32_t>& utteranceLengths)
+{
+    vector<::CNTK::ClassIdType> classIds;
+    for (size_t i = 0; i < utterances.size(); ++i)
+    {
+        size_t start = classIds.size();
+        classIds.resize(start + utteranceLengths[i], 0);
+        for (const auto& range : utterances[i])
+        {
+            fill(classIds.begin() + start, classIds.begin() + start + range.NumFrames(), range.ClassId());
+            start += range.NumFrames();
+        }
+    }
+    return classIds;
+}
+
+BOOST_AUTO_TEST_SUITE(MLFLabelsTestSuite)
+
+// Frame mode (run-length encoded runs) and sequence mode (flat ranges) must give the labels of the dense decoding.
+BOOST_AUTO_TEST_CASE(MLFLabelsMatchDenseDecoding)
+{
+    const size_t dimension = 6;
+    std::mt19937 rng(7);
+
+    // Utterances of runs of classes, with repeated classes within and across utterances,
+    // utterances whose ranges do not cover all their frames, and an utterance without ranges.
+    vector<vector<::CNTK::MLFFrameRange>> utterances(20);
+    vector<uint32_t> utteranceLengths(utterances.size());
+    for (size_t i = 0; i < utterances.size(); ++i)
+    {
+        uint32_t frame = 0;
+        size_t numRanges = i == 5 ? 0 : 1 + rng() % 6;
+        for (size_t r = 0; r < numRanges; ++r)
+        {
+            uint32_t numFrames = rng() % 5; // including empty ranges
+            utterances[i].emplace_back();
+            utterances[i].back().Save(frame, numFrames, rng() % 3 == 0 ? 0 : rng() % dimension);
+            frame += numFrames;
+        }
+        utteranceLengths[i] = frame + (i % 3 == 0 ? rng() % 3 : 0);
+    }
+    utteranceLengths[5] = 2;
+
+    auto expected = DenseClassIds(utterances, utteranceLengths);
+
+    // frame mode
+    ::CNTK::MLFFrameRuns runs;
+    uint32_t utteranceStart = 0;
+    for (size_t i = 0; i < utterances.size(); ++i)
+    {
+        runs.AppendUtterance(utterances[i], utteranceStart, utteranceLengths[i], dimension);
+        utteranceStart += utteranceLengths[i];
+    }
+    runs.ShrinkToFit();
+
+    for (size_t frame = 0; frame < expected.size(); ++frame)
+        BOOST_CHECK_MESSAGE(runs[frame] == expected[frame], "frame " << frame << " has class " << runs[frame] << ", expected " << expected[frame]);
+
+    // sequence mode
+    ::CNTK::MLFUtteranceRanges ranges;
+    auto utterancesToStore = utterances;
+    ranges.Store(utterancesToStore);
+
+    utteranceStart = 0;
+    for (size_t i = 0; i < utterances.size(); ++i)
+    {
+        BOOST_REQUIRE_EQUAL(ranges.End(i) - ranges.Begin(i), utterances[i].size());
+        for (size_t r = 0; r < utterances[i].size(); ++r)
+            BOOST_CHECK_EQUAL(ranges.Begin(i)[r].FirstFrame(), utterances[i][r].FirstFrame());
+
+        vector<::CNTK::IndexType> classIds(utteranceLengths[i], 0);
+        ranges.ExpandClassIds(i, classIds.data(), dimension);
+        BOOST_CHECK_EQUAL_COLLECTIONS(classIds.begin(), classIds.end(), expected.begin() + utteranceStart, expected.begin() + utteranceStart + utteranceLengths[i]);
+        utteranceStart += utteranceLengths[i];
+    }
+
+    // class ids beyond the output dimension are rejected by both
+    vector<vector<::CNTK::MLFFrameRange>> invalidUtterances(1, vector<::CNTK::MLFFrameRange>(1));
+    invalidUtterances[0][0].Save(0, 2, dimension);
+    ::CNTK::MLFFrameRuns invalidRuns;
+    BOOST_CHECK_THROW(invalidRuns.AppendUtterance(invalidUtterances[0], 0, 2, dimension), std::exception);
+    ::CNTK::MLFUtteranceRanges invalidRanges;
+    invalidRanges.Store(invalidUtterances);
+    vector<::CNTK::IndexType> invalidClassIds(2);
+    BOOST_CHECK_THROW(invalidRanges.ExpandClassIds(0, invalidClassIds.data(), dimension), std::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
 }
 
 }}}
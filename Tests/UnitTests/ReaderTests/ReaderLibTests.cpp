@@ -9,6 +9,7 @@
 #include <set>
 #include "NoRandomizer.h"
 #include "LTNoRandomizer.h"
+#include "LTTumblingWindowRandomizer.h"
 #include "DataDeserializer.h"
 #include "BlockRandomizer.h"
 #include "CorpusDescriptor.h"
@@ -1078,6 +1079,59 @@ BOOST_AUTO_TEST_CASE(LTNoRandomizerCheckNoDuplicateSequence)
     }
 }
 
+// Loading chunks ahead must not change the order of sequences.
+BOOST_AUTO_TEST_CASE(LTTumblingWindowRandomizerLoadAhead)
+{
+    const size_t numChunks = 7;
+    const size_t numSequencesPerChunk = 5;
+    const size_t numWorkers = 2;
+    vector<float> data(numChunks * numSequencesPerChunk);
+    iota(data.begin(), data.end(), 0.0f);
+
+    auto readAll = [&](size_t workerRank, size_t chunksToLoadAhead)
+    {
+        auto mockDeserializer = make_shared<MockDeserializer>(numChunks, numSequencesPerChunk, data);
+        LTTumblingWindowRandomizer randomizer(mockDeserializer, false, 2, 0, false, 0, chunksToLoadAhead);
+
+        EpochConfiguration config;
+        config.m_numberOfWorkers = numWorkers;
+        config.m_workerRank = workerRank;
+        config.m_minibatchSizeInSamples = 3;
+        config.m_totalEpochSizeInSweeps = 3;
+        config.m_epochIndex = 0;
+        randomizer.StartEpoch(config);
+
+        vector<float> result;
+        for (;;)
+        {
+            Sequences sequences = randomizer.GetNextSequences(3, 3);
+            if (!sequences.m_data.empty())
+                for (const auto& sequence : sequences.m_data[0])
+                    result.push_back(*static_cast<const float*>(sequence->GetDataBuffer()));
+            if (sequences.m_endOfEpoch)
+                break;
+        }
+        return result;
+    };
+
+    for (size_t workerRank = 0; workerRank < numWorkers; ++workerRank)
+    {
+        // Every sweep returns the sequences of the chunks of this worker, in a different order per sweep,
+        // so the loads that run past the end of a sweep have to follow the order of the next sweep.
+        auto expected = readAll(workerRank, 0);
+        const size_t numChunksOfWorker = (numChunks - workerRank + numWorkers - 1) / numWorkers;
+        const size_t sweepSize = numChunksOfWorker * numSequencesPerChunk;
+        BOOST_REQUIRE_EQUAL(expected.size(), 3 * sweepSize);
+        BOOST_CHECK(!equal(expected.begin(), expected.begin() + sweepSize, expected.begin() + sweepSize));
+
+        for (size_t chunksToLoadAhead : { 1, 3, 20 })
+        {
+            auto actual = readAll(workerRank, chunksToLoadAhead);
+            BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), actual.begin(), actual.end());
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(DefaultCorpusDescriptor)
 {
     const int seed = 13;
@@ -1094,6 +1148,32 @@ BOOST_AUTO_TEST_CASE(DefaultCorpusDescriptor)
     BOOST_CHECK_EQUAL(1, corpus.KeyToId(""));
 }
 
+BOOST_AUTO_TEST_CASE(StringToIdMapManyKeys)
+{
+    // enough keys to force several rehashes and arena blocks
+    const size_t numKeys = 200000;
+    StringToIdMap map;
+    for (size_t i = 0; i < numKeys; ++i)
+        BOOST_CHECK_EQUAL(i, map.AddIfNotExists("utterance_" + std::to_string(i) + string(i % 17, 'x')));
+    BOOST_CHECK_EQUAL(numKeys, map.Size());
+
+    for (size_t i = 0; i < numKeys; i += 997)
+    {
+        string key = "utterance_" + std::to_string(i) + string(i % 17, 'x');
+        size_t id = SIZE_MAX;
+        BOOST_CHECK(map.TryGet(key, id));
+        BOOST_CHECK_EQUAL(i, id);
+        BOOST_CHECK_EQUAL(i, map.AddIfNotExists(key));
+        BOOST_CHECK_EQUAL(key, map[i]);
+    }
+
+    BOOST_CHECK(!map.Contains("utterance_"));
+    BOOST_CHECK_EQUAL(numKeys, map.AddIfNotExists(""));
+    BOOST_CHECK(map.Contains(""));
+    BOOST_CHECK_EQUAL(string(), map[numKeys]);
+    BOOST_CHECK_THROW(map[numKeys + 1], std::exception);
+}
+
 BOOST_AUTO_TEST_CASE(CorpusDescriptorHashing)
 {
     auto hashVersion = CorpusDescriptor::s_hashVersion;
@@ -1906,6 +1986,61 @@ BOOST_AUTO_TEST_CASE(TestTruncatedBpttPacker)
     BOOST_TEST(!mb.m_endOfSweep);
 }
 
+BOOST_AUTO_TEST_CASE(TestTruncatedBpttPackerData)
+{
+    size_t chunkSizeInSamples = 100;
+    size_t sweepNumberOfSamples = 1000;
+    uint32_t maxSequenceLength = 10;
+    auto deserializer = make_shared<SequentialDeserializer>(0, chunkSizeInSamples, sweepNumberOfSamples, maxSequenceLength);
+    auto noRandomizer = make_shared<NoRandomizer>(deserializer, true);
+    auto packer = std::make_shared<TruncatedBPTTPacker>(noRandomizer, deserializer->StreamInfos());
+
+    EpochConfiguration config;
+    config.m_numberOfWorkers = 1;
+    config.m_minibatchSizeInSamples = 28;
+    config.m_truncationSize = 4;
+    config.m_totalEpochSizeInSweeps = 1;
+    config.m_epochIndex = 0;
+
+    noRandomizer->StartEpoch(config);
+    packer->SetConfiguration(config,
+        std::vector<MemoryProviderPtr> { std::make_shared<HeapMemoryProvider>() });
+
+    // Every sample of the sweep (with values 0 .. N-1) has to be packed exactly once,
+    // and consecutive samples of a sequence have consecutive values.
+    std::vector<size_t> counts(sweepNumberOfSamples, 0);
+    for (size_t i = 0; i < sweepNumberOfSamples; ++i)
+    {
+        auto mb = packer->ReadMinibatch();
+        if (mb.m_data.empty())
+            break;
+
+        const auto& layout = mb.m_data[0]->m_layout;
+        const float* data = (const float*)mb.m_data[0]->m_data;
+        for (const auto& sequence : layout->GetAllSequences())
+        {
+            if (sequence.seqId == GAP_SEQUENCE_ID)
+                continue;
+
+            size_t begin = (size_t)max(sequence.tBegin, (ptrdiff_t)0);
+            size_t end = min(sequence.tEnd, layout->GetNumTimeSteps());
+            for (size_t t = begin; t < end; ++t)
+            {
+                float value = data[t * layout->GetNumParallelSequences() + sequence.s];
+                BOOST_REQUIRE(value >= 0 && value < sweepNumberOfSamples);
+                counts[(size_t)value]++;
+                if (t > begin)
+                    BOOST_REQUIRE_EQUAL(value, data[(t - 1) * layout->GetNumParallelSequences() + sequence.s] + 1);
+            }
+        }
+
+        if (mb.m_endOfEpoch)
+            break;
+    }
+
+    BOOST_REQUIRE(std::all_of(counts.begin(), counts.end(), [](size_t c) { return c == 1; }));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } } } }
@@ -354,8 +354,8 @@ static void CheckIdentical(const shared_ptr<Index>& index1, const shared_ptr<Ind
         Check(chunk1, chunk2.NumberOfSequences(), chunk2.NumberOfSamples(), chunk2.StartOffset(), chunk2.SizeInBytes());
         for (int j = 0; j < chunk1.NumberOfSequences(); j++)
         {
-            auto& seq1 = chunk1[i];
-            auto& seq2 = chunk2[i];
+            auto& seq1 = chunk1[j];
+            auto& seq2 = chunk2[j];
             Check(seq1, seq2.m_key, seq2.NumberOfSamples(), seq2.OffsetInChunk(), seq2.SizeInBytes());
         }
     }
@@ -714,6 +714,61 @@ BOOST_AUTO_TEST_CASE(Index_with_multi_line_sequences)
     }
 }
 
+BOOST_AUTO_TEST_CASE(Index_in_parallel_with_tiny_ranges)
+{
+    // Ranges of a few bytes make sequences and lines straddle range boundaries, the index must not depend on the split.
+    auto crlf = boost::replace_all_copy(s_textData, "\n", "\r\n");
+    string bom{ '\xEF', '\xBB', '\xBF' };
+    string multiLine =
+        "1|x\n"
+        "    |x\n"
+        "1   |x\n"
+        "0 |y  \n"
+        "0 |y   \n"
+        "0  \n"
+        "2  |y\r\n"
+        "2  |x\r\n"
+        "\r\n"
+        "2  |y\n"
+        "3 |x    \n"
+        "|y      |x";
+
+    struct Input
+    {
+        string content;
+        string mainStream;
+        bool skipSequenceIds;
+    };
+
+    for (const auto& input : vector<Input>
+    {
+        { s_textData, "", false },
+        { s_textData, "b", false },
+        { crlf, "a", false },
+        { crlf.substr(0, crlf.size() - 2), "", false }, // the final line has no line break
+        { bom + "  " + multiLine, "x", false },
+        { multiLine, "y", false },
+        { "|a 1\n|a 2\r\n\n|b 3\n |a 4\r\n|a 5\n\n\n|a 6", "a", true },
+        { bom + crlf, "", true },
+    })
+    {
+        auto sequential = GetIndexBuilder(input.content)->SetNumberOfThreads(1)
+            .SetMainStream(input.mainStream).SetSkipSequenceIds(input.skipSequenceIds).SetChunkSize(32).Build();
+        BOOST_REQUIRE(sequential);
+        BOOST_REQUIRE(!sequential->IsEmpty());
+
+        for (size_t numberOfThreads : { 2, 3 })
+        {
+            for (size_t rangeSize : { 1, 2, 3, 5, 7, 16, 64 })
+            {
+                auto parallel = GetIndexBuilder(input.content)->SetNumberOfThreads(numberOfThreads).SetRangeSize(rangeSize, rangeSize)
+                    .SetMainStream(input.mainStream).SetSkipSequenceIds(input.skipSequenceIds).SetChunkSize(32).Build();
+                CheckIdentical(parallel, sequential);
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(Index_non_primary)
 {
     auto size = s_textData.size();
@@ -764,6 +819,62 @@ BOOST_AUTO_TEST_CASE(Index_with_caching)
     CheckIdentical(index, cachedIndex);
 }
 
+// In a distributed run, the main node builds the index and writes the cache before returning, the other
+// nodes load it from there. A node that cannot share the index must not wait for it.
+BOOST_AUTO_TEST_CASE(Index_shared_between_nodes)
+{
+    auto filename = L"shared.test.tmp";
+    CreateTestFile(s_textData, filename);
+    auto expected = TextInputIndexBuilder(FileWrapper::OpenOrDie(filename, L"rb")).Build();
+
+    auto secondsToBuild = [](IndexBuilder& indexBuilder, shared_ptr<Index>& index)
+    {
+        auto start = chrono::steady_clock::now();
+        index = indexBuilder.Build();
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    };
+
+    // Another node does not wait longer than the start timeout for a cache that nobody builds.
+    {
+        TextInputIndexBuilder indexBuilder(FileWrapper::OpenOrDie(filename, L"rb"));
+        indexBuilder.SetCachingEnabled(true).SetNodeRank(1, 2).SetIndexCacheStartTimeout(chrono::milliseconds(0));
+        shared_ptr<Index> index;
+        BOOST_REQUIRE_LT(secondsToBuild(indexBuilder, index), 1.0);
+        CheckIdentical(index, expected);
+        BOOST_REQUIRE(!fexists(indexBuilder.GetCacheFilename().c_str()));
+    }
+
+    // The main node writes the cache right away, the other nodes load it without waiting.
+    {
+        TextInputIndexBuilder mainBuilder(FileWrapper::OpenOrDie(filename, L"rb"));
+        auto mainIndex = mainBuilder.SetCachingEnabled(true).SetNodeRank(0, 2).Build();
+        CheckIdentical(mainIndex, expected);
+        BOOST_REQUIRE(fexists(mainBuilder.GetCacheFilename().c_str()));
+        BOOST_REQUIRE(!fexists((mainBuilder.GetCacheFilename() + L".tmp").c_str()));
+
+        TextInputIndexBuilder indexBuilder(FileWrapper::OpenOrDie(filename, L"rb"));
+        indexBuilder.SetCachingEnabled(true).SetNodeRank(1, 2);
+        shared_ptr<Index> index;
+        BOOST_REQUIRE_LT(secondsToBuild(indexBuilder, index), 1.0);
+        CheckIdentical(index, expected);
+        _wunlink(indexBuilder.GetCacheFilename().c_str());
+    }
+
+    // The main node builds the index without sharing or caching it if it cannot create the cache.
+    {
+        TextInputIndexBuilder indexBuilder(FileWrapper::OpenOrDie(filename, L"rb"));
+        indexBuilder.SetCachingEnabled(true).SetNodeRank(0, 2);
+        auto temp = indexBuilder.GetCacheFilename() + L".tmp";
+        boost::filesystem::create_directory(temp); // cannot be opened for writing
+        auto index = indexBuilder.Build();
+        boost::filesystem::remove(temp);
+        CheckIdentical(index, expected);
+        BOOST_REQUIRE(!fexists(indexBuilder.GetCacheFilename().c_str()));
+    }
+
+    _wunlink(filename);
+}
+
 BOOST_AUTO_TEST_CASE(Index_64MB_with_caching_check_perf)
 {
     if (true)
@@ -703,6 +703,59 @@ void RunConvDilTest(const DeviceDescriptor& device, bool sequential = false)
         PrintOutput<ElementType>(6, outputData);
 }
 
+// The binary engine convolves the signs of the input and the kernel (+1 for positive values, -1 otherwise),
+// with padded positions left out, so it must match a regular convolution of the sign values.
+template <typename ElementType>
+void RunBinaryConvolutionTest(const DeviceDescriptor& device)
+{
+    const NDShape inputShape = {6, 5, 2};
+    const NDShape kernelShape = {3, 3, 2, 4};
+    const size_t batchSize = 3;
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    auto randomData = [&](size_t size) {
+        std::vector<ElementType> data(size);
+        for (auto& value : data)
+            value = (ElementType)dist(rng);
+        return data;
+    };
+    auto signs = [](std::vector<ElementType> data) {
+        for (auto& value : data)
+            value = value > 0 ? (ElementType)1 : (ElementType)-1;
+        return data;
+    };
+
+    auto kernelData = randomData(kernelShape.TotalSize());
+    auto inputData = randomData(inputShape.TotalSize() * batchSize);
+    auto kernelSigns = signs(kernelData);
+
+    auto kernel = Parameter(MakeSharedObject<NDArrayView>(kernelShape, kernelData, false)->DeepClone(device));
+    auto kernelSign = Parameter(MakeSharedObject<NDArrayView>(kernelShape, kernelSigns, false)->DeepClone(device));
+
+    for (const NDShape& strides : std::vector<NDShape>{{1, 1, 2}, {2, 2, 2}})
+    {
+        auto input = InputVariable(inputShape, AsDataType<ElementType>());
+        auto binary = BinaryConvolution(kernel, input, strides);
+        auto reference = Convolution(kernelSign, input, strides);
+
+        auto evaluate = [&](const FunctionPtr& function, const std::vector<ElementType>& data) {
+            std::unordered_map<Variable, ValuePtr> outputs = {{function->Output(), nullptr}};
+            function->Evaluate({{input, Value::CreateBatch(inputShape, data, device)}}, outputs, device);
+            std::vector<std::vector<ElementType>> result;
+            outputs[function->Output()]->CopyVariableValueTo(function->Output(), result);
+            return result;
+        };
+        auto binaryOutput = evaluate(binary, inputData);
+        auto referenceOutput = evaluate(reference, signs(inputData));
+
+        BOOST_TEST((binary->Output().Shape() == reference->Output().Shape()));
+        BOOST_TEST(binaryOutput.size() == batchSize);
+        for (size_t i = 0; i < binaryOutput.size(); ++i)
+            FloatingPointVectorCompare(binaryOutput[i], referenceOutput[i], "BinaryConvolution output does not match the convolution of the signs");
+    }
+}
+
 BOOST_AUTO_TEST_SUITE(ConvolutionFunctionSuite)
 
 BOOST_AUTO_TEST_CASE(ConvolutionNetworkDifferentRankInCPU)
@@ -770,6 +823,15 @@ BOOST_AUTO_TEST_CASE(ConvolutionNetworkSequentialValueTestInCPU)
     }
 }
 
+BOOST_AUTO_TEST_CASE(BinaryConvolutionInCPU)
+{
+    if (ShouldRunOnCpu())
+    {
+        auto device = DeviceDescriptor::CPUDevice();
+        RunBinaryConvolutionTest<float>(device);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(ConvolutionNetworkDifferentRankInGPU)
 {
     if (ShouldRunOnGpu())
@@ -450,6 +450,151 @@ void TestTimesReduceSequenceAxis(
     }
 }
 
+// Gradients of the parameters of a small classifier for one minibatch, in Parameters() order. The network is
+// created anew on each call, so that it is compiled with the memory-sharing options in effect at that point.
+std::vector<std::vector<float>> ComputeClassifierParameterGradients(const DeviceDescriptor& device, const std::function<FunctionPtr(const FunctionPtr&)>& nonLinearity)
+{
+    const size_t inputDim = 37;
+    const size_t numOutputClasses = 11;
+    const size_t numHiddenLayers = 6;
+    const size_t hiddenLayersDim = 64;
+    const size_t numSamples = 5;
+
+    auto inputVar = InputVariable({ inputDim }, DataType::Float, L"features");
+    auto labelsVar = InputVariable({ numOutputClasses }, DataType::Float, L"labels");
+    auto classifierOutput = FullyConnectedFeedForwardClassifierNet(inputVar, numOutputClasses, hiddenLayersDim, numHiddenLayers, device, nonLinearity, L"classifierOutput");
+    auto trainingLoss = ReduceSum(CrossEntropyWithSoftmax(classifierOutput, labelsVar), Axis::AllAxes(), L"LossFunction");
+
+    srand(3);
+    std::vector<float> inputData(inputDim * numSamples);
+    for (size_t i = 0; i < inputData.size(); ++i)
+        inputData[i] = ((float)rand()) / RAND_MAX - 0.5f;
+
+    std::vector<float> labelData(numOutputClasses * numSamples, 0);
+    for (size_t i = 0; i < numSamples; ++i)
+        labelData[(i * numOutputClasses) + (rand() % numOutputClasses)] = 1;
+
+    NDShape inputShape = inputVar.Shape().AppendShape({ 1, numSamples });
+    ValuePtr inputValue = MakeSharedObject<Value>(MakeSharedObject<NDArrayView>(inputShape, inputData.data(), inputData.size(), DeviceDescriptor::CPUDevice(), true));
+    NDShape labelShape = labelsVar.Shape().AppendShape({ 1, numSamples });
+    ValuePtr labelValue = MakeSharedObject<Value>(MakeSharedObject<NDArrayView>(labelShape, labelData.data(), labelData.size(), DeviceDescriptor::CPUDevice(), true));
+
+    std::unordered_map<Variable, ValuePtr> outputs = { { trainingLoss, nullptr } };
+    auto backpropState = trainingLoss->Forward({ { inputVar, inputValue }, { labelsVar, labelValue } }, outputs, device, { trainingLoss });
+
+    NDShape outputShape = trainingLoss->Output().Shape();
+    std::vector<float> rootGradientsData(outputShape.TotalSize(), 1);
+    ValuePtr rootGradientValue = MakeSharedObject<Value>(MakeSharedObject<NDArrayView>(outputShape, rootGradientsData.data(), rootGradientsData.size(), DeviceDescriptor::CPUDevice(), true));
+    std::unordered_map<Variable, ValuePtr> paramGradients;
+    auto allParams = trainingLoss->Parameters();
+    for (const auto& param : allParams)
+        paramGradients[param] = nullptr;
+    trainingLoss->Backward(backpropState, { { trainingLoss, rootGradientValue } }, paramGradients);
+
+    std::vector<std::vector<float>> gradients;
+    for (const auto& param : allParams)
+    {
+        auto gradient = paramGradients[param]->Data()->DeepClone(DeviceDescriptor::CPUDevice());
+        gradients.push_back(std::vector<float>(gradient->DataBuffer<float>(), gradient->DataBuffer<float>() + gradient->Shape().TotalSize()));
+    }
+    return gradients;
+}
+
+// Activation recomputation must not change the gradients: the recomputed values are the same as the released ones.
+void TestActivationRecomputationGradients(const DeviceDescriptor& device)
+{
+    using namespace std::placeholders;
+
+    for (auto nonLinearity : { std::function<FunctionPtr(const FunctionPtr&)>(std::bind(ReLU, _1, L"")), std::function<FunctionPtr(const FunctionPtr&)>(std::bind(Tanh, _1, L"")) })
+    {
+        auto expectedGradients = ComputeClassifierParameterGradients(device, nonLinearity);
+
+        Internal::EnableActivationRecomputation();
+        std::vector<std::vector<float>> actualGradients;
+        try
+        {
+            actualGradients = ComputeClassifierParameterGradients(device, nonLinearity);
+        }
+        catch (...)
+        {
+            Internal::DisableActivationRecomputation();
+            throw;
+        }
+        Internal::DisableActivationRecomputation();
+
+        BOOST_TEST(actualGradients.size() == expectedGradients.size());
+        for (size_t i = 0; i < actualGradients.size(); ++i)
+            FloatingPointVectorCompare(actualGradients[i], expectedGradients[i], "Parameter gradient with activation recomputation differs from the one without");
+    }
+}
+
+// Activation compression must not change the gradients. The bit masks kept for ReLU and Clip are exact, so the
+// gradients are the same; the fp16 copies kept for Sigmoid and Tanh in lossy mode only lose precision.
+// An output is only stashed if no consumer needs it for its own gradient, which Times() does; so each
+// nonlinearity is followed by a Plus(), as in a residual connection.
+void TestActivationCompressionGradients(const DeviceDescriptor& device)
+{
+    using namespace std::placeholders;
+    typedef std::function<FunctionPtr(const FunctionPtr&)> NonLinearity;
+
+    auto shifted = [](const NonLinearity& nonLinearity)
+    {
+        return NonLinearity([nonLinearity](const FunctionPtr& operand) { return Plus(nonLinearity(operand), Constant::Scalar(0.1f)); });
+    };
+    auto clip = [](const FunctionPtr& operand) { return Clip(operand, Constant::Scalar(-0.2f), Constant::Scalar(0.3f)); };
+    for (bool lossy : { false, true })
+    {
+        // ReLU and Clip keep bit masks on the CPU only, Sigmoid and Tanh keep fp16 copies in lossy mode only
+        for (auto nonLinearity : { std::make_pair(NonLinearity(std::bind(ReLU, _1, L"")), device.Type() == DeviceKind::CPU),
+                                   std::make_pair(NonLinearity(clip), device.Type() == DeviceKind::CPU),
+                                   std::make_pair(NonLinearity(std::bind(Sigmoid, _1, L"")), lossy),
+                                   std::make_pair(NonLinearity(std::bind(Tanh, _1, L"")), lossy) })
+        {
+            auto expectedGradients = ComputeClassifierParameterGradients(device, shifted(nonLinearity.first));
+
+            Internal::EnableActivationCompression(lossy);
+            auto numStashesBefore = Internal::GetNumActivationStashes();
+            std::vector<std::vector<float>> actualGradients;
+            try
+            {
+                actualGradients = ComputeClassifierParameterGradients(device, shifted(nonLinearity.first));
+            }
+            catch (...)
+            {
+                Internal::DisableActivationCompression();
+                throw;
+            }
+            Internal::DisableActivationCompression();
+
+            auto numStashes = Internal::GetNumActivationStashes() - numStashesBefore;
+            if (nonLinearity.second)
+                BOOST_TEST(numStashes > 0, "No activation was stashed with activation compression");
+            else
+                BOOST_TEST(numStashes == 0, "An activation was stashed although its nonlinearity has no stash format");
+
+            BOOST_TEST(actualGradients.size() == expectedGradients.size());
+            for (size_t i = 0; i < actualGradients.size(); ++i)
+            {
+                if (!lossy)
+                {
+                    FloatingPointVectorCompare(actualGradients[i], expectedGradients[i], "Parameter gradient with activation compression differs from the one without");
+                    continue;
+                }
+
+                // fp16 keeps about 3 decimal digits; compare relative to the largest gradient of the parameter
+                float maxGradient = 0;
+                for (auto gradient : expectedGradients[i])
+                    maxGradient = std::max(maxGradient, std::abs(gradient));
+                BOOST_TEST(actualGradients[i].size() == expectedGradients[i].size());
+                for (size_t j = 0; j < actualGradients[i].size(); ++j)
+                    if (std::abs(actualGradients[i][j] - expectedGradients[i][j]) > 1e-2f * maxGradient)
+                        ReportFailure("Parameter gradient with lossy activation compression differs from the one without; Expected=%g, Actual=%g",
+                                      expectedGradients[i][j], actualGradients[i][j]);
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE(FeedForwardSuite)
 
 BOOST_AUTO_TEST_CASE(FFTimesAndPlusInCPU)
@@ -510,6 +655,30 @@ BOOST_AUTO_TEST_CASE(FFNetworkCreationInCPU)
     }
 }
 
+BOOST_AUTO_TEST_CASE(ActivationRecomputationGradientsInCPU)
+{
+    if (ShouldRunOnCpu())
+        TestActivationRecomputationGradients(DeviceDescriptor::CPUDevice());
+}
+
+BOOST_AUTO_TEST_CASE(ActivationRecomputationGradientsInGPU)
+{
+    if (ShouldRunOnGpu())
+        TestActivationRecomputationGradients(DeviceDescriptor::GPUDevice(0));
+}
+
+BOOST_AUTO_TEST_CASE(ActivationCompressionGradientsInCPU)
+{
+    if (ShouldRunOnCpu())
+        TestActivationCompressionGradients(DeviceDescriptor::CPUDevice());
+}
+
+BOOST_AUTO_TEST_CASE(ActivationCompressionGradientsInGPU)
+{
+    if (ShouldRunOnGpu())
+        TestActivationCompressionGradients(DeviceDescriptor::GPUDevice(0));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }}
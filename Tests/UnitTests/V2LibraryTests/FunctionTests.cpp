@@ -1200,6 +1200,216 @@ void TestMatMul(const DeviceDescriptor& device)
     }
 }
 
+// With zero-copy input binding, the argument data must come out of Forward and Backward unchanged: reduce-style
+// consumers overwrite the masked samples of their input, which must therefore not be the caller's storage.
+void TestZeroCopyInputBindingKeepsArguments(const DeviceDescriptor& device)
+{
+    const size_t dim = 3;
+    const size_t sequenceLength = 4;
+    const size_t numValidSteps = sequenceLength - 1;
+
+    auto input = InputVariable({ dim }, DataType::Float, /*needsGradient =*/ true, L"input");
+    auto reduced = Sequence::ReduceSum(input, L"reduced");
+
+    std::vector<float> expectedInputData(dim * sequenceLength);
+    for (size_t i = 0; i < expectedInputData.size(); ++i)
+        expectedInputData[i] = (float)(i + 1);
+
+    Internal::SetZeroCopyInputBinding(true);
+    enum ArgumentKind { Masked, ReadOnly, Writable };
+    for (auto argumentKind : { Masked, ReadOnly, Writable })
+    {
+        NDShape valueShape = input.Shape().AppendShape({ sequenceLength, 1 });
+        std::vector<float> inputData(expectedInputData);
+        auto inputView = MakeSharedObject<NDArrayView>(valueShape, inputData.data(), inputData.size(), DeviceDescriptor::CPUDevice(), /*readOnly =*/ false)->DeepClone(device, /*readOnly =*/ argumentKind == ReadOnly);
+        NDMaskPtr inputMask;
+        if (argumentKind == Masked)
+        {
+            inputMask = MakeSharedObject<NDMask>(NDShape({ sequenceLength, 1 }), device);
+            inputMask->InvalidateSection({ numValidSteps, 0 }, { sequenceLength - numValidSteps, 1 });
+        }
+        auto inputValue = MakeSharedObject<Value>(inputView, inputMask);
+
+        std::unordered_map<Variable, ValuePtr> outputs = { { reduced->Output(), nullptr } };
+        auto backpropState = reduced->Forward({ { input, inputValue } }, outputs, device, { reduced->Output() });
+
+        // the sum covers the valid steps only
+        size_t numSummedSteps = (argumentKind == Masked) ? numValidSteps : sequenceLength;
+        std::vector<float> expectedOutputData(dim, 0);
+        for (size_t t = 0; t < numSummedSteps; ++t)
+            for (size_t i = 0; i < dim; ++i)
+                expectedOutputData[i] += expectedInputData[t * dim + i];
+        auto outputView = outputs[reduced->Output()]->Data()->DeepClone(DeviceDescriptor::CPUDevice());
+        std::vector<float> outputData(outputView->DataBuffer<float>(), outputView->DataBuffer<float>() + outputView->Shape().TotalSize());
+        FloatingPointVectorCompare(outputData, expectedOutputData, "TestZeroCopyInputBindingKeepsArguments: Forward prop results do not match expected results.");
+
+        std::vector<float> rootGradientData(outputs[reduced->Output()]->Shape().TotalSize(), 1);
+        ValuePtr rootGradientValue = MakeSharedObject<Value>(MakeSharedObject<NDArrayView>(outputs[reduced->Output()]->Shape(), rootGradientData.data(), rootGradientData.size(), DeviceDescriptor::CPUDevice(), true));
+        std::unordered_map<Variable, ValuePtr> inputGradients = { { input, nullptr } };
+        reduced->Backward(backpropState, { { reduced->Output(), rootGradientValue } }, inputGradients);
+
+        auto inputViewAfter = inputValue->Data()->DeepClone(DeviceDescriptor::CPUDevice());
+        std::vector<float> inputDataAfter(inputViewAfter->DataBuffer<float>(), inputViewAfter->DataBuffer<float>() + inputViewAfter->Shape().TotalSize());
+        BOOST_TEST(inputDataAfter == expectedInputData, "TestZeroCopyInputBindingKeepsArguments: the argument data was modified by Forward/Backward.");
+    }
+    Internal::SetZeroCopyInputBinding(false);
+}
+
+// A Function caches the networks compiled for different outputs, backprop roots and excluded inputs, and reactivates
+// them when a later Forward asks for the same signature. A reactivated network must see the current Parameter values.
+// Cycling through more signatures than are cached also evicts and recompiles networks.
+void TestCompiledNetworkCaching(const DeviceDescriptor& device)
+{
+    const size_t inputDim = 3;
+    const size_t outputDim = 2;
+    const size_t numSamples = 2;
+
+    std::vector<float> weightData = { 0.5f, -1.0f, 2.0f, 0.25f, -0.75f, 1.5f }; // column-major outputDim x inputDim
+    std::vector<float> biasData = { 0.1f, -0.2f };
+    std::vector<float> inputData = { 1.0f, 2.0f, -1.0f, 0.5f, -2.0f, 3.0f };
+
+    auto weight = Parameter(MakeSharedObject<NDArrayView>(NDShape({ outputDim, inputDim }), weightData, false)->DeepClone(device), L"weight");
+    auto bias = Parameter(MakeSharedObject<NDArrayView>(NDShape({ outputDim }), biasData, false)->DeepClone(device), L"bias");
+    auto input = InputVariable({ inputDim }, DataType::Float, L"input");
+    auto hidden = Times(weight, input, L"hidden");
+    auto lossA = ReduceSum(Plus(hidden, bias), Axis::AllAxes(), L"lossA");
+    auto lossB = ReduceSum(ElementTimes(hidden, hidden), Axis::AllAxes(), L"lossB");
+    auto combined = Combine({ lossA, lossB });
+
+    ValuePtr inputValue = MakeSharedObject<Value>(MakeSharedObject<NDArrayView>(input.Shape().AppendShape({ 1, numSamples }), inputData, true));
+
+    auto toVector = [](const ValuePtr& value) {
+        auto view = value->Data()->DeepClone(DeviceDescriptor::CPUDevice());
+        return std::vector<float>(view->DataBuffer<float>(), view->DataBuffer<float>() + view->Shape().TotalSize());
+    };
+
+    // reference results for the current parameter values
+    auto hiddenOf = [&]() {
+        std::vector<float> h(outputDim * numSamples, 0);
+        for (size_t s = 0; s < numSamples; ++s)
+            for (size_t i = 0; i < outputDim; ++i)
+                for (size_t j = 0; j < inputDim; ++j)
+                    h[s * outputDim + i] += weightData[j * outputDim + i] * inputData[s * inputDim + j];
+        return h;
+    };
+    auto expectedLossA = [&]() {
+        auto h = hiddenOf();
+        float loss = 0;
+        for (size_t k = 0; k < h.size(); ++k)
+            loss += h[k] + biasData[k % outputDim];
+        return loss;
+    };
+    auto expectedLossB = [&]() {
+        auto h = hiddenOf();
+        float loss = 0;
+        for (auto v : h)
+            loss += v * v;
+        return loss;
+    };
+    auto expectedWeightGradient = [&](bool isLossB) {
+        auto h = hiddenOf();
+        std::vector<float> gradient(outputDim * inputDim, 0);
+        for (size_t s = 0; s < numSamples; ++s)
+            for (size_t i = 0; i < outputDim; ++i)
+                for (size_t j = 0; j < inputDim; ++j)
+                    gradient[j * outputDim + i] += (isLossB ? 2 * h[s * outputDim + i] : 1.0f) * inputData[s * inputDim + j];
+        return gradient;
+    };
+
+    // the signatures: evaluation of the root outputs, evaluation of an intermediate output, and
+    // backpropagation from either loss, with and without excluding the bias from gradient computation
+    enum Signature { EvaluateRoots, EvaluateHidden, BackpropA, BackpropB, BackpropAExcludingBias, BackpropBExcludingBias, NumSignatures };
+    auto runSignature = [&](int signature) {
+        if (signature == EvaluateRoots)
+        {
+            std::unordered_map<Variable, ValuePtr> outputs = { { lossA, nullptr }, { lossB, nullptr } };
+            combined->Forward({ { input, inputValue } }, outputs, device);
+            FloatingPointCompare(toVector(outputs[lossA])[0], expectedLossA(), "TestCompiledNetworkCaching: lossA does not match");
+            FloatingPointCompare(toVector(outputs[lossB])[0], expectedLossB(), "TestCompiledNetworkCaching: lossB does not match");
+        }
+        else if (signature == EvaluateHidden)
+        {
+            std::unordered_map<Variable, ValuePtr> outputs = { { hidden, nullptr } };
+            combined->Forward({ { input, inputValue } }, outputs, device);
+            FloatingPointVectorCompare(toVector(outputs[hidden]), hiddenOf(), "TestCompiledNetworkCaching: hidden output does not match");
+        }
+        else
+        {
+            bool isLossB = (signature == BackpropB) || (signature == BackpropBExcludingBias);
+            bool excludeBias = (signature == BackpropAExcludingBias) || (signature == BackpropBExcludingBias);
+            Variable root = isLossB ? lossB : lossA;
+
+            std::unordered_map<Variable, ValuePtr> outputs = { { root, nullptr } };
+            std::unordered_set<Variable> inputsToExclude;
+            if (excludeBias)
+                inputsToExclude.insert(bias);
+            auto backpropState = combined->Forward({ { input, inputValue } }, outputs, device, { root }, inputsToExclude);
+            FloatingPointCompare(toVector(outputs[root])[0], isLossB ? expectedLossB() : expectedLossA(), "TestCompiledNetworkCaching: loss does not match");
+
+            std::vector<float> rootGradientData(1, 1);
+            ValuePtr rootGradientValue = MakeSharedObject<Value>(MakeSharedObject<NDArrayView>(root.Shape(), rootGradientData, true));
+            // lossB does not depend on the bias
+            bool getBiasGradient = !excludeBias && !isLossB;
+            std::unordered_map<Variable, ValuePtr> gradients = { { weight, nullptr } };
+            if (getBiasGradient)
+                gradients[bias] = nullptr;
+            combined->Backward(backpropState, { { root, rootGradientValue } }, gradients);
+
+            FloatingPointVectorCompare(toVector(gradients[weight]), expectedWeightGradient(isLossB), "TestCompiledNetworkCaching: weight gradient does not match");
+            if (getBiasGradient)
+                FloatingPointVectorCompare(toVector(gradients[bias]), std::vector<float>(outputDim, (float)numSamples), "TestCompiledNetworkCaching: bias gradient does not match");
+        }
+    };
+
+    auto updateParameters = [&](float scale) {
+        for (auto& w : weightData)
+            w *= scale;
+        for (auto& b : biasData)
+            b += scale;
+        weight.SetValue(MakeSharedObject<NDArrayView>(NDShape({ outputDim, inputDim }), weightData, true));
+        bias.SetValue(MakeSharedObject<NDArrayView>(NDShape({ outputDim }), biasData, true));
+    };
+
+    // alternating between two signatures reactivates cached networks
+    for (int i = 0; i < 3; ++i)
+    {
+        runSignature(EvaluateRoots);
+        runSignature(BackpropA);
+        runSignature(BackpropB);
+    }
+    updateParameters(0.5f);
+    runSignature(BackpropA);
+    runSignature(EvaluateRoots);
+
+    // more signatures than the cache holds: the least recently used networks are evicted and compiled again
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (int signature = 0; signature < NumSignatures; ++signature)
+            runSignature(signature);
+        updateParameters(-1.5f);
+        for (int signature = NumSignatures - 1; signature >= 0; --signature)
+            runSignature(signature);
+    }
+    BOOST_TEST(Internal::GetNumCachedComputationNetworks(combined) == Internal::GetMaxCachedComputationNetworks());
+
+    // an explicit release keeps only the active network, and released signatures are compiled again
+    Internal::ReleaseCachedComputationNetworks(combined);
+    BOOST_TEST(Internal::GetNumCachedComputationNetworks(combined) == 0);
+    runSignature(BackpropB);
+    BOOST_TEST(Internal::GetNumCachedComputationNetworks(combined) == 1);
+
+    // a lower limit evicts on the next switch, and 0 keeps no retired network at all
+    const size_t defaultMaxCachedNetworks = Internal::GetMaxCachedComputationNetworks();
+    for (size_t maxCachedNetworks : { (size_t)1, (size_t)0 })
+    {
+        Internal::SetMaxCachedComputationNetworks(maxCachedNetworks);
+        for (int signature = 0; signature < NumSignatures; ++signature)
+            runSignature(signature);
+        BOOST_TEST(Internal::GetNumCachedComputationNetworks(combined) == maxCachedNetworks);
+    }
+    Internal::SetMaxCachedComputationNetworks(defaultMaxCachedNetworks);
+}
+
 BOOST_AUTO_TEST_SUITE(FunctionSuite)
 
 BOOST_AUTO_TEST_CASE(FindNameInCPU)
@@ -1334,6 +1544,30 @@ BOOST_AUTO_TEST_CASE(MatMul)
         TestMatMul(DeviceDescriptor::GPUDevice(0));
 }
 
+BOOST_AUTO_TEST_CASE(ZeroCopyInputBindingKeepsArgumentsInCPU)
+{
+    if (ShouldRunOnCpu())
+        TestZeroCopyInputBindingKeepsArguments(DeviceDescriptor::CPUDevice());
+}
+
+BOOST_AUTO_TEST_CASE(ZeroCopyInputBindingKeepsArgumentsInGPU)
+{
+    if (ShouldRunOnGpu())
+        TestZeroCopyInputBindingKeepsArguments(DeviceDescriptor::GPUDevice(0));
+}
+
+BOOST_AUTO_TEST_CASE(CompiledNetworkCachingInCPU)
+{
+    if (ShouldRunOnCpu())
+        TestCompiledNetworkCaching(DeviceDescriptor::CPUDevice());
+}
+
+BOOST_AUTO_TEST_CASE(CompiledNetworkCachingInGPU)
+{
+    if (ShouldRunOnGpu())
+        TestCompiledNetworkCaching(DeviceDescriptor::GPUDevice(0));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }}
@@ -350,6 +350,90 @@ void TestSweepBasedSchedule()
     }
 }
 
+// Accumulating the gradients of K minibatches must update the parameters like one minibatch of all their samples.
+void TestGradientAccumulation(const DeviceDescriptor& device)
+{
+    const size_t inputDim = 7;
+    const size_t numOutputClasses = 5;
+    const size_t numMicroBatches = 3;
+    const size_t microBatchSize = 4;
+    const size_t numWindows = 2;
+
+    auto input = InputVariable({ inputDim }, DataType::Float, L"features");
+    auto labels = InputVariable({ numOutputClasses }, DataType::Float, L"labels");
+    auto createTrainer = [&]() {
+        auto classifierOutput = FullyConnectedFeedForwardClassifierNet(input, numOutputClasses, 6, 2, device, std::bind(ReLU, std::placeholders::_1, L""), L"classifierOutput", 7);
+        auto trainingLoss = CNTK::CrossEntropyWithSoftmax(classifierOutput, labels, L"lossFunction");
+        auto prediction = CNTK::ClassificationError(classifierOutput, labels, L"classificationError");
+        return CreateTrainer(classifierOutput, trainingLoss, prediction, { SGDLearner(classifierOutput->Parameters(), TrainingParameterPerSampleSchedule(0.1)) });
+    };
+
+    srand(5);
+    std::vector<float> inputData(inputDim * microBatchSize * numMicroBatches * numWindows);
+    for (auto& value : inputData)
+        value = ((float)rand()) / RAND_MAX - 0.5f;
+    std::vector<float> labelData(numOutputClasses * microBatchSize * numMicroBatches * numWindows, 0);
+    for (size_t i = 0; i < labelData.size(); i += numOutputClasses)
+        labelData[i + (rand() % numOutputClasses)] = 1;
+
+    auto batch = [&](size_t firstSample, size_t numSamples) {
+        std::vector<float> features(inputData.begin() + firstSample * inputDim, inputData.begin() + (firstSample + numSamples) * inputDim);
+        std::vector<float> targets(labelData.begin() + firstSample * numOutputClasses, labelData.begin() + (firstSample + numSamples) * numOutputClasses);
+        return std::unordered_map<Variable, ValuePtr>{ { input, Value::CreateBatch(input.Shape(), features, device) }, { labels, Value::CreateBatch(labels.Shape(), targets, device) } };
+    };
+
+    auto accumulatingTrainer = createTrainer();
+    accumulatingTrainer->SetGradientAccumulation(numMicroBatches);
+    auto trainer = createTrainer();
+    for (size_t window = 0; window < numWindows; ++window)
+    {
+        for (size_t i = 0; i < numMicroBatches; ++i)
+        {
+            if (i > 0)
+                VerifyException([&]() { accumulatingTrainer->SaveCheckpoint(L"GradientAccumulation.ckp"); }, "Was able to save a checkpoint in the middle of a gradient accumulation window.");
+            accumulatingTrainer->TrainMinibatch(batch((window * numMicroBatches + i) * microBatchSize, microBatchSize), false, device);
+        }
+        trainer->TrainMinibatch(batch(window * numMicroBatches * microBatchSize, numMicroBatches * microBatchSize), false, device);
+        BOOST_TEST(accumulatingTrainer->TotalNumberOfSamplesSeen() == trainer->TotalNumberOfSamplesSeen());
+
+        auto accumulatingParameters = accumulatingTrainer->Model()->Parameters();
+        auto parameters = trainer->Model()->Parameters();
+        BOOST_TEST(accumulatingParameters.size() == parameters.size());
+        for (size_t i = 0; i < parameters.size(); ++i)
+        {
+            auto accumulatingValue = accumulatingParameters[i].Value()->DeepClone(DeviceDescriptor::CPUDevice());
+            auto value = parameters[i].Value()->DeepClone(DeviceDescriptor::CPUDevice());
+            FloatingPointVectorCompare(std::vector<float>(accumulatingValue->DataBuffer<float>(), accumulatingValue->DataBuffer<float>() + accumulatingValue->Shape().TotalSize()),
+                                       std::vector<float>(value->DataBuffer<float>(), value->DataBuffer<float>() + value->Shape().TotalSize()),
+                                       "Parameters trained with gradient accumulation differ from the ones trained with one large minibatch");
+        }
+    }
+}
+
+void TestLossScalingOverflowAtUnitScale(const DeviceDescriptor& device)
+{
+    auto input = InputVariable({ 3 }, DataType::Float, L"features");
+    auto weights = Parameter({ 2, 3 }, DataType::Float, 0.5, device, L"weights");
+    auto loss = ReduceSum(Times(weights, input), Axis::AllStaticAxes(), L"loss");
+    auto trainer = CreateTrainer(loss, loss, { SGDLearner({ weights }, TrainingParameterPerSampleSchedule(0.1)) });
+    trainer->EnableDynamicLossScaling(1, 100);
+
+    // the gradient of the weights is the input, which is not finite
+    std::vector<float> features = { 1, std::numeric_limits<float>::infinity(), 2 };
+    std::unordered_map<Variable, ValuePtr> batch = { { input, Value::CreateBatch(input.Shape(), features, device) } };
+
+    // overflows at loss scale 1 skip the update, until they persist
+    for (size_t i = 0; i < 9; ++i)
+        trainer->TrainMinibatch(batch, false, device);
+    BOOST_TEST(trainer->LossScale() == 1);
+    auto value = weights.Value()->DeepClone(DeviceDescriptor::CPUDevice());
+    FloatingPointVectorCompare(std::vector<float>(value->DataBuffer<float>(), value->DataBuffer<float>() + value->Shape().TotalSize()),
+                               std::vector<float>(value->Shape().TotalSize(), 0.5f),
+                               "Parameters were updated from gradients that overflowed");
+
+    VerifyException([&]() { trainer->TrainMinibatch(batch, false, device); }, "Was able to keep training with gradients overflowing at loss scale 1.");
+}
+
 struct LearnerSuiteFixture
 {
     LearnerSuiteFixture()
@@ -477,6 +561,18 @@ BOOST_AUTO_TEST_CASE(CreateAndUpdateAdamaxLearner)
     }
 }
 
+BOOST_AUTO_TEST_CASE(GradientAccumulation)
+{
+    for (auto& device : devices)
+        TestGradientAccumulation(device);
+}
+
+BOOST_AUTO_TEST_CASE(LossScalingOverflowAtUnitScale)
+{
+    for (auto& device : devices)
+        TestLossScalingOverflowAtUnitScale(device);
+}
+
 BOOST_AUTO_TEST_CASE(TestResettingLearningRate)
 {
     NDShape shape = { 1 };
@@ -357,7 +357,9 @@ void CheckEnumValuesNotModified() {
                   static_cast<size_t>(PrimitiveOpType::StraightThrough) == 94 &&
                   static_cast<size_t>(PrimitiveOpType::Tan) == 95 &&
                   static_cast<size_t>(PrimitiveOpType::Atan) == 96 &&
-                  static_cast<size_t>(PrimitiveOpType::ConvolutionSequenceShape) == 97,
+                  static_cast<size_t>(PrimitiveOpType::ConvolutionSequenceShape) == 97 &&
+                  static_cast<size_t>(PrimitiveOpType::LayerNormalization) == 98 &&
+                  static_cast<size_t>(PrimitiveOpType::ScaledDotProductAttention) == 99,
                   "PrimitiveOpType enum value was modified.");
 }
 
@@ -962,6 +964,55 @@ void TestLoadingModelFromMemoryBufferWithException()
     delete[] modelBuffer;
 }
 
+std::vector<float> EvaluateOnBatch(const FunctionPtr& function, const std::vector<float>& batchData, const DeviceDescriptor& device)
+{
+    auto input = function->Arguments()[0];
+    auto output = function->Output();
+    std::unordered_map<Variable, ValuePtr> outputDataMap = { { output, nullptr } };
+    function->Evaluate({ { input, Value::CreateBatch(input.Shape(), batchData, device, true) } }, outputDataMap, device);
+
+    std::vector<std::vector<float>> outputData;
+    outputDataMap[output]->CopyVariableValueTo(output, outputData);
+    std::vector<float> result;
+    for (const auto& sample : outputData)
+        result.insert(result.end(), sample.begin(), sample.end());
+    return result;
+}
+
+// Save a model to ONNX with its large parameters in the external data file, load it back and
+// check that it computes the same as the original model.
+void TestONNXSaveAndLoadWithExternalParameters(const DeviceDescriptor& device)
+{
+    const size_t inputDim = 64;
+    const size_t hiddenDim = 48;
+    const size_t outputDim = 40;
+    const size_t batchSize = 3;
+
+    auto input = InputVariable({ inputDim }, DataType::Float, L"features");
+    auto hidden = FullyConnectedDNNLayer(input, hiddenDim, device, std::bind(Sigmoid, std::placeholders::_1, L""), L"hidden", /*seed*/ 1);
+    auto model = FullyConnectedLinearLayer(hidden, outputDim, device, L"output", /*seed*/ 2);
+
+    const std::wstring modelFile = L"external.parameters.onnx";
+    model->Save(modelFile, ModelFormat::ONNX, /*useExternalFilesToStoreParameters*/ true);
+
+    // both weight matrices are large enough to be stored externally, the biases stay in the model
+    ifstream dataFileStream("external.parameters.onnx.data", ifstream::binary | ifstream::ate);
+    if (!dataFileStream)
+        ReportFailure("The external data file of the ONNX model was not written.");
+    size_t expectedDataSize = sizeof(float) * (inputDim * hiddenDim + hiddenDim * outputDim);
+    if ((size_t)dataFileStream.tellg() != expectedDataSize)
+        ReportFailure("The external data file of the ONNX model has %d bytes, expected %d.", (int)dataFileStream.tellg(), (int)expectedDataSize);
+
+    auto reloadedModel = Function::Load(modelFile, device, ModelFormat::ONNX);
+
+    std::vector<float> batchData(inputDim * batchSize);
+    for (size_t i = 0; i < batchData.size(); ++i)
+        batchData[i] = float_dist(rng) - 0.5f;
+
+    FloatingPointVectorCompare(EvaluateOnBatch(reloadedModel, batchData, device), EvaluateOnBatch(model, batchData, device),
+        "The ONNX model reloaded with external parameters computes a different output");
+}
+
 BOOST_AUTO_TEST_SUITE(SerializationSuite)
 
 BOOST_AUTO_TEST_CASE(LoadingModelFromMemoryBuffer)
@@ -1044,6 +1095,11 @@ BOOST_AUTO_TEST_CASE(CheckpointingWithStatefulNodesInCPU)
     TestCheckpointingWithStatefulNodes(DeviceDescriptor::CPUDevice());
 }
 
+BOOST_AUTO_TEST_CASE(ONNXSaveAndLoadWithExternalParametersInCPU)
+{
+    TestONNXSaveAndLoadWithExternalParameters(DeviceDescriptor::CPUDevice());
+}
+
 BOOST_AUTO_TEST_CASE(LearnerSerializationInGPU)
 {
     if (ShouldRunOnGpu())
@@ -1077,6 +1133,14 @@ BOOST_AUTO_TEST_CASE(FunctionSerializationInGPU)
     }
 }
 
+BOOST_AUTO_TEST_CASE(ONNXSaveAndLoadWithExternalParametersInGPU)
+{
+    if (ShouldRunOnGpu())
+    {
+        TestONNXSaveAndLoadWithExternalParameters(DeviceDescriptor::GPUDevice(0));
+    }
+}
+
 BOOST_AUTO_TEST_CASE(ModelSerializationDuringTrainingInGPU)
 {
     if (ShouldRunOnGpu())